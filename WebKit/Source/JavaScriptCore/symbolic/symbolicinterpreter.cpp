@@ -25,6 +25,8 @@
 #include "JavaScriptCore/instrumentation/bytecodeinfo.h"
 #include "JavaScriptCore/runtime/JSString.h"
 #include "JavaScriptCore/runtime/CallData.h"
+#include "JavaScriptCore/runtime/JSGlobalObject.h"
+#include "WTF/wtf/CurrentTime.h"
 
 #include "instrumentation/jscexecutionlistener.h"
 #include "statistics/statsstorage.h"
@@ -49,6 +51,9 @@ bool SymbolicInterpreter::m_featureSymbolicCheckedPropertyEnabled = true;
 bool SymbolicInterpreter::m_featureConcreteValuePropertyEnabled = true;
 bool SymbolicInterpreter::m_featureSymbolicTriggeringEnabled = true;
 
+SymbolicInterpreter::SessionGCPolicy SymbolicInterpreter::m_sessionGCPolicy = SymbolicInterpreter::GC_ALWAYS;
+size_t SymbolicInterpreter::m_sessionGCParameter = 0;
+
 // Symbolic target is not for benchmarking, it is a different mode of operation, disabled unless specifically requested.
 bool SymbolicInterpreter::m_featureSymbolicEventTargetEnabled = false;
 
@@ -78,7 +83,10 @@ SymbolicInterpreter::SymbolicInterpreter() :
     m_nextSymbolicValue(0),
     m_inSession(false),
     m_sessionId(0),
-    m_shouldGC(false)
+    m_shouldGC(false),
+    m_sessionsSinceGC(0),
+    m_heapSizeAfterGC(0),
+    m_lastSessionGlobalObject(NULL)
 {
 }
 
@@ -449,22 +457,75 @@ void SymbolicInterpreter::preExecution(JSC::CallFrame* callFrame)
 {
     if (m_shouldGC) {
         /*
-         * Disable GC, and only GC at the beginning of each session.
+         * Disable GC, and only GC at the beginning of each session (as allowed by the session GC policy).
          * DomNodes (the JS bindings) are GC'ed, removing any symbolic
          * information stored in them.
          */
 
         JSC::JSGlobalData* jsGlobalData = &callFrame->globalData();
         JSC::Heap* heap = &jsGlobalData->heap;
+        JSC::JSGlobalObject* globalObject = callFrame->lexicalGlobalObject();
+
+        m_sessionsSinceGC++;
+
+        if (shouldCollectGarbage(heap, globalObject)) {
+            size_t sizeBefore = heap->size();
+            double start = WTF::currentTime();
+
+            heap->notifyIsSafeToCollect();
+            heap->collectAllGarbage();
+
+            double time = WTF::currentTime() - start;
+            m_heapSizeAfterGC = heap->size();
+            m_sessionsSinceGC = 0;
+
+            Statistics::statistics()->accumulate("Concolic::GC::Collections", 1);
+            Statistics::statistics()->accumulate("Concolic::GC::TotalTime", time);
+            Statistics::statistics()->accumulate("Concolic::GC::TotalHeapSizeBeforeKB", (int)(sizeBefore / 1024));
+            Statistics::statistics()->accumulate("Concolic::GC::TotalHeapSizeAfterKB", (int)(m_heapSizeAfterGC / 1024));
+            Statistics::statistics()->set("Concolic::GC::LastHeapSizeBeforeKB", (int)(sizeBefore / 1024));
+            Statistics::statistics()->set("Concolic::GC::LastHeapSizeAfterKB", (int)(m_heapSizeAfterGC / 1024));
+        } else {
+            Statistics::statistics()->accumulate("Concolic::GC::SkippedCollections", 1);
+        }
 
-        heap->notifyIsSafeToCollect();
-        heap->collectAllGarbage();
         heap->notifyIsNotSafeToCollect();
 
+        // No collection can happen until the next session, so this can not be freed and reused by another global object.
+        m_lastSessionGlobalObject = globalObject;
         m_shouldGC = false;
     }
 }
 
+bool SymbolicInterpreter::shouldCollectGarbage(JSC::Heap* heap, JSC::JSGlobalObject* globalObject)
+{
+    if (m_sessionGCPolicy == GC_ALWAYS) {
+        return true;
+    }
+
+    // Before the first session the heap collects by itself, and nothing is known about it.
+    if (m_lastSessionGlobalObject == NULL) {
+        return true;
+    }
+
+    // The bindings made symbolic in the previous session are still cached in this global object.
+    if (m_lastSessionGlobalObject == globalObject) {
+        Statistics::statistics()->accumulate("Concolic::GC::SamePageCollections", 1);
+        return true;
+    }
+
+    switch (m_sessionGCPolicy) {
+    case GC_HEAP_GROWTH:
+        return heap->size() > m_heapSizeAfterGC + m_sessionGCParameter;
+    case GC_EVERY_N_SESSIONS:
+        return m_sessionsSinceGC >= m_sessionGCParameter;
+    case GC_NEVER:
+        return false;
+    default:
+        return true;
+    }
+}
+
 void SymbolicInterpreter::beginSession()
 {
     beginSession(0);
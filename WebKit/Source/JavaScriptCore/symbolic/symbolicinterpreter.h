@@ -32,6 +32,8 @@
 namespace JSC {
     class ExecState;
     class Instruction;
+    class Heap;
+    class JSGlobalObject;
 }
 
 namespace Symbolic
@@ -94,6 +96,32 @@ public:
         SymbolicInterpreter::m_isOpGetByValWithSymbolicArg = val;
     }
 
+    /*
+     * Session GC policy.
+     *
+     * GC is disabled while a session executes, and done at the beginning of a session instead. DomNodes (the JS
+     * bindings) are GC'ed, removing any symbolic information stored in them. A full collection per session is
+     * expensive, so Artemis can choose how often to collect:
+     *
+     * GC_ALWAYS - (default) At the beginning of every session.
+     * GC_HEAP_GROWTH - When the heap has grown by more than the given number of bytes since the last collection.
+     * GC_EVERY_N_SESSIONS - At the beginning of every n'th session.
+     * GC_NEVER - Only when it is needed to keep symbolic values from leaking (see below).
+     *
+     * Whichever policy is set, a session which starts in the same global object as the previous session is always
+     * collected first, as the bindings created (and made symbolic) in the previous session are still cached there.
+     * A session on a newly loaded page can not reach the values left behind by earlier sessions, so skipping the
+     * collection only costs memory.
+     */
+    typedef enum {
+        GC_ALWAYS, GC_HEAP_GROWTH, GC_EVERY_N_SESSIONS, GC_NEVER
+    } SessionGCPolicy;
+
+    static void setSessionGCPolicy(SessionGCPolicy policy, size_t parameter) {
+        SymbolicInterpreter::m_sessionGCPolicy = policy;
+        SymbolicInterpreter::m_sessionGCParameter = parameter;
+    }
+
     /*
      * Feature bits.
      *
@@ -144,6 +172,8 @@ public:
 private:
     void fatalError(JSC::CodeBlock* codeBlock, std::string reason) __attribute__((noreturn));
 
+    bool shouldCollectGarbage(JSC::Heap* heap, JSC::JSGlobalObject* globalObject);
+
     NativeLookup m_nativeFunctions;
     int m_nextSymbolicValue;
 
@@ -151,6 +181,12 @@ private:
     unsigned int m_sessionId;
 
     bool m_shouldGC;
+    unsigned int m_sessionsSinceGC;
+    size_t m_heapSizeAfterGC;
+    JSC::JSGlobalObject* m_lastSessionGlobalObject; // Only compared, never dereferenced.
+
+    static SessionGCPolicy m_sessionGCPolicy;
+    static size_t m_sessionGCParameter;
 
     static bool m_isOpGetByValWithSymbolicArg;
 
@@ -34,6 +34,10 @@
 #include "TextBreakIterator.h"
 #include "WebKitMutationObserver.h"
 
+#ifdef ARTEMIS
+#include "instrumentation/executionlistener.h"
+#endif
+
 using namespace std;
 
 namespace WebCore {
@@ -180,6 +184,19 @@ void CharacterData::setDataAndUpdate(const String& newData, unsigned offsetOfRep
     m_data = newData;
     updateRenderer(offsetOfReplacedData, oldLength);
     document()->incDOMTreeVersion();
+#ifdef ARTEMIS
+    // Only the replaced range is reported, so text which was already reported is not reported again. It is extended
+    // to whole words at either end where it starts or ends inside a word, so words which span it are not split.
+    if (newLength && inDocument() && isTextNode()) {
+        unsigned start = offsetOfReplacedData;
+        unsigned end = offsetOfReplacedData + newLength;
+        while (start > 0 && !isSpaceOrNewline(m_data[start - 1]) && !isSpaceOrNewline(m_data[start]))
+            start--;
+        while (end < m_data.length() && !isSpaceOrNewline(m_data[end]) && !isSpaceOrNewline(m_data[end - 1]))
+            end++;
+        inst::getListener()->dom_text_inserted(m_data.substring(start, end - start));
+    }
+#endif
     dispatchModifiedEvent(oldData);
 }
 
@@ -101,6 +101,10 @@
 #include "htmlediting.h"
 #include <wtf/HashSet.h>
 #include <wtf/PassOwnPtr.h>
+
+#ifdef ARTEMIS
+#include "instrumentation/executionlistener.h"
+#endif
 #include <wtf/RefCountedLeakCounter.h>
 #include <wtf/UnusedParam.h>
 #include <wtf/Vector.h>
@@ -2423,6 +2427,10 @@ Node::InsertionNotificationRequest Node::insertedInto(Node* insertionPoint)
     ASSERT(insertionPoint->inDocument() || isContainerNode());
     if (insertionPoint->inDocument())
         setFlag(InDocumentFlag);
+#ifdef ARTEMIS
+    if (insertionPoint->inDocument() && isTextNode())
+        inst::getListener()->dom_text_inserted(static_cast<CharacterData*>(this)->data());
+#endif
     return InsertionDone;
 }
 
@@ -16,6 +16,10 @@ namespace WebCore {
     class LazyXMLHttpRequest;
 }
 
+namespace WTF {
+    class String;
+}
+
 namespace JSC {
     class Debugger;
     class SourceProvider;
@@ -94,6 +98,12 @@ public:
       */
     virtual void page_load_scheduled(const char* url) = 0;
 
+    /**
+      DOM modifications: the data of text nodes as they are inserted into a document, or the part of it which changed
+      while in one
+      */
+    virtual void dom_text_inserted(const WTF::String& text) = 0;
+
 };
 
 extern ExecutionListener* listener;
@@ -928,6 +928,47 @@ Element* QWebElement::getElement()
     return m_element;
 }
 
+// Finds all elements in this subtree (including this element) with event listeners attached, together with the
+// attributes and form ancestry Artemis needs to classify them, in a single pass over the DOM.
+QList<QWebEventTarget> QWebElement::findEventTargets()
+{
+    QList<QWebEventTarget> result;
+    if (m_element == NULL) {
+        return result;
+    }
+
+    for (Node* node = m_element; node != NULL; node = node->traverseNextNode(m_element)) {
+        if (!node->isElementNode() || !node->hasEventListeners()) {
+            continue;
+        }
+
+        Element* element = static_cast<Element*>(node);
+
+        QWebEventTarget target;
+        target.element = QWebElement(element);
+        target.xPath = QString::fromStdString(element->getXPath());
+        target.tagName = element->tagName();
+        target.type = element->hasAttribute("type") ? QString(element->getAttribute("type")) : QString();
+
+        Vector<AtomicString> eventTypes = node->eventTargetData()->eventListenerMap.eventTypes();
+        for (size_t i = 0; i < eventTypes.size(); i++) {
+            target.eventTypes.append(eventTypes[i]);
+        }
+
+        target.insideForm = false;
+        for (Element* ancestor = element; ancestor != NULL; ancestor = ancestor->parentElement()) {
+            if (equalIgnoringCase(ancestor->tagName(), "form")) {
+                target.insideForm = true;
+                break;
+            }
+        }
+
+        result.append(target);
+    }
+
+    return result;
+}
+
 #endif // ARTEMIS
 
 
@@ -28,6 +28,7 @@
 
 #ifdef ARTEMIS
 #include <QUrl>
+#include <QStringList>
 #endif
 
 #include "qwebkitglobal.h"
@@ -38,6 +39,7 @@ namespace WebCore {
 
 #ifdef ARTEMIS
 class QWebExecutionListener;
+struct QWebEventTarget;
 #endif
 
 QT_BEGIN_NAMESPACE
@@ -147,6 +149,7 @@ public:
     QList<QWebElement> getAllUserClickableElements(int min_x, int min_y, int max_x, int max_y, int step);
     int numberOfChildren(QString cssSelector);
     WebCore::Element* getElement();
+    QList<QWebEventTarget> findEventTargets();
 
 #else
     QVariant evaluateJavaScript(const QString& scriptSource);
@@ -185,6 +188,21 @@ private:
     WebCore::Element* m_element;
 };
 
+#ifdef ARTEMIS
+// An element with event listeners attached, as found by QWebElement::findEventTargets().
+struct QWEBKIT_EXPORT QWebEventTarget
+{
+    QWebEventTarget() : insideForm(false) {}
+
+    QWebElement element;
+    QString xPath;
+    QString tagName;
+    QString type; // The type attribute, or null if it is not set.
+    QStringList eventTypes; // The events which have listeners on the element.
+    bool insideForm; // The element is a form or has a form ancestor.
+};
+#endif
+
 class QWebElementCollectionPrivate;
 
 class QWEBKIT_EXPORT QWebElementCollection
@@ -60,6 +60,8 @@ QWebExecutionListener::QWebExecutionListener(QObject *parent)
     , m_reportHeapMode(0)
     , m_heapReportNumber(0)
     , m_heapReportFactor(1)
+    , m_sampleRequested(0)
+    , m_reportDomText(false)
 {
 }
 
@@ -101,6 +103,10 @@ QList<QString> QWebExecutionListener::getHeapReport(int &heapReportNumber){
     return m_heapReport;
 }
 
+bool QWebExecutionListener::requestSample() {
+    return m_sampleRequested.testAndSetOrdered(0, 1);
+}
+
 void QWebExecutionListener::eventCleared(WebCore::EventTarget * target, const char* type) {
     std::string typeString = std::string(type);
 
@@ -184,6 +190,18 @@ void QWebExecutionListener::page_load_scheduled(const char* url) {
     emit sigPageLoadScheduled(newUrl);
 }
 
+// DOM modification detection
+
+void QWebExecutionListener::dom_text_inserted(const WTF::String& text) {
+    if (m_reportDomText && !text.isEmpty()) {
+        emit sigDomTextInserted(QString(text));
+    }
+}
+
+void QWebExecutionListener::enableDomTextReporting(bool enabled) {
+    m_reportDomText = enabled;
+}
+
 // TIMERS START
 
 void QWebExecutionListener::timerAdded(WebCore::ScriptExecutionContext* context, int timerId, int timeout, bool singleShot) {
@@ -462,8 +480,18 @@ void QWebExecutionListener::javascript_bytecode_executed(JSC::Interpreter* inter
                                                          JSC::CodeBlock* codeBlock,
                                                          JSC::Instruction* instruction,
                                                          const JSC::BytecodeInfo& info) {
-    
-    
+
+    // Sampling profiler safepoint. This is checked before the instrumentation flag, so time spent in our own injected
+    // JavaScript is also sampled.
+    if (m_sampleRequested && m_sampleRequested.fetchAndStoreOrdered(0)) {
+        uint sampledOffset = instruction - codeBlock->instructions().begin();
+        emit sigJavascriptSampled(sampledOffset,
+                                  codeBlock->lineNumberForBytecodeOffset(sampledOffset),
+                                  codeBlock->sourceOffset(),
+                                  m_sourceRegistry.get(codeBlock->source()),
+                                  JSC::Interpreter::m_enableInstrumentations);
+    }
+
     if (!JSC::Interpreter::m_enableInstrumentations)
         return;
 
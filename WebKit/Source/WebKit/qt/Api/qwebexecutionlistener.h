@@ -15,6 +15,7 @@
  */
 
 #include <QtCore/qobject.h>
+#include <QAtomicInt>
 #include <QUrl>
 #include <QMap>
 #include "qwebkitglobal.h"
@@ -93,6 +94,10 @@ public:
 
     void page_load_scheduled(const char* url);
 
+    // Text inserted into the DOM is only reported (as sigDomTextInserted) while enabled, as it is frequent.
+    virtual void dom_text_inserted(const WTF::String& text);
+    void enableDomTextReporting(bool enabled);
+
     virtual void timerAdded(WebCore::ScriptExecutionContext* context, int timerId, int timeout, bool singleShot);
     virtual void timerRemoved(WebCore::ScriptExecutionContext* context, int timerId);
     void timerFire(int timerId);
@@ -102,6 +107,11 @@ public:
     void enableHeapReport(bool namedOnly, int heapReportNumber, int factor);
     QList<QString> getHeapReport(int &heapReportNumber);
 
+    // Sampling profiler support, may be called from any thread.
+    // Asks for the location of the next executed bytecode to be reported with sigJavascriptSampled. Returns false if the
+    // previous request is still pending, i.e. no JavaScript was executed since then.
+    bool requestSample();
+
     void beginSymbolicSession();
     void endSymbolicSession();
     unsigned int getSymbolicSessionId();
@@ -121,6 +131,10 @@ private:
     int m_reportHeapMode;
     int m_heapReportNumber;
     int m_heapReportFactor;
+
+    QAtomicInt m_sampleRequested;
+
+    bool m_reportDomText;
 signals:
     void addedEventListener(QWebElement*, QString, QString);
     void removedEventListener(QWebElement*, QString);
@@ -153,9 +167,13 @@ signals:
     void sigJavascriptBytecodeExecuted(const ByteCodeInfoStruct byteInfo, uint sourceOffset, QSource* source);
     void sigJavascriptBranchExecuted(bool jump, Symbolic::Expression* condition, uint sourceOffset, QSource* source, const ByteCodeInfoStruct byteInfo);
     void sigJavascriptSymbolicFieldRead(QString variable, bool isSymbolic);
+    void sigJavascriptSampled(uint bytecodeOffset, uint linenumber, uint sourceOffset, QSource* source, bool instrumented);
 
     /* Page Load Instrumentation */
     void sigPageLoadScheduled(QUrl url);
+
+    /* DOM Modification Instrumentation */
+    void sigDomTextInserted(QString text);
 };
 
 
@@ -18,6 +18,21 @@ QMAKE_CXXFLAGS += -g \
 DEFINES += ARTEMIS=1
 DEFINES += WTF_PLATFORM_QT=1
 
+# The in-process solver (--smt-solver z3str-inprocess) links Z3 and the Z3-str string theory into Artemis.
+# It is only built with "qmake CONFIG+=z3inprocess", after "make constraintsolver".
+z3inprocess {
+    DEFINES += ARTEMIS_Z3_INPROCESS=1
+
+    INCLUDEPATH += $$PWD/../contrib/Z3/lib \
+        $$PWD/../contrib/Z3-str
+    LIBS += -L$$PWD/../contrib/Z3-str -lz3str \
+        -L$$PWD/../contrib/Z3/bin/external -lz3 \
+        -fopenmp -lrt
+
+    HEADERS += src/concolic/solver/z3inprocesssolver.h
+    SOURCES += src/concolic/solver/z3inprocesssolver.cpp
+}
+
 HEADERS += src/runtime/input/ajaxinput.h \
     src/strategies/prioritizer/constantprioritizer.h \
     src/strategies/prioritizer/prioritizerstrategy.h \
@@ -26,6 +41,13 @@ HEADERS += src/runtime/input/ajaxinput.h \
     src/runtime/options.h \
     src/runtime/browser/ajax/ajaxrequest.h \
     src/runtime/browser/ajax/ajaxrequestlistener.h \
+    src/runtime/browser/ajax/networkcache.h \
+    src/runtime/browser/ajax/cachednetworkreply.h \
+    src/runtime/browser/ajax/recordingnetworkreply.h \
+    src/runtime/browser/ajax/prettifycache.h \
+    src/runtime/browser/ajax/prettifyingnetworkreply.h \
+    src/util/javascriptprettifier.h \
+    src/model/coverage/prettifymapping.h \
     src/runtime/browser/cookies/immutablecookiejar.h \
     src/runtime/input/events/baseeventparameters.h \
     src/runtime/input/events/domelementdescriptor.h \
@@ -64,6 +86,7 @@ HEADERS += src/runtime/input/ajaxinput.h \
     src/util/urlutil.h \
     src/exceptionhandlingqapp.h \
     src/runtime/browser/executionresultbuilder.h \
+    src/runtime/browser/eventhandlerfilter.h \
     src/strategies/inputgenerator/form/forminputgenerator.h \
     src/strategies/inputgenerator/form/staticforminputgenerator.h \
     src/strategies/inputgenerator/event/eventparametergenerator.h \
@@ -72,10 +95,12 @@ HEADERS += src/runtime/input/ajaxinput.h \
     src/strategies/prioritizer/coverageprioritizer.h \
     src/runtime/appmodel.h \
     src/model/javascriptstatistics.h \
+    src/model/samplingprofiler.h \
     src/strategies/prioritizer/readwriteprioritizer.h \
     src/strategies/prioritizer/collectedprioritizer.h \
     src/runtime/input/events/toucheventparameters.h \
     src/model/pathtracer.h \
+    src/model/pathtracelogreader.h \
     src/runtime/toplevel/artemisruntime.h \
     src/runtime/browser/artemiswebview.h \
     src/runtime/browser/artemiswebpage.h \
@@ -95,8 +120,10 @@ HEADERS += src/runtime/input/ajaxinput.h \
     src/runtime/toplevel/manualruntime.h \
     src/runtime/input/events/unknowneventparameters.h \
     src/concolic/traceeventdetectors.h \
+    src/concolic/indicatorwordmatcher.h \
     src/concolic/tracestatistics.h \
     src/concolic/solver/solution.h \
+    src/concolic/solver/solvermodelparser.h \
     src/concolic/solver/expressionprinter.h \
     src/runtime/demomode/traceviewerdialog.h \
     src/concolic/pathcondition.h \
@@ -106,6 +133,7 @@ HEADERS += src/runtime/input/ajaxinput.h \
     src/concolic/executiontree/nodes/tracesymbolicbranch.h \
     src/concolic/executiontree/tracenodes.h \
     src/concolic/executiontree/tracemerger.h \
+    src/concolic/executiontree/tracepath.h \
     src/concolic/executiontree/tracedisplay.h \
     src/concolic/solver/expressionvalueprinter.h \
     src/concolic/solver/expressionfreevariablelister.h \
@@ -113,6 +141,7 @@ HEADERS += src/runtime/input/ajaxinput.h \
     src/concolic/solver/constraintwriter/kaluza.h \
     src/concolic/solver/constraintwriter/z3str.h \
     src/concolic/solver/z3solver.h \
+    src/concolic/solver/slicingsolver.h \
     src/concolic/solver/kaluzasolver.h \
     src/runtime/toplevel/artformruntime.h \
     src/runtime/input/forms/formfielddescriptor.h \
@@ -123,6 +152,7 @@ HEADERS += src/runtime/input/ajaxinput.h \
     src/concolic/mockentrypointdetector.h \
     src/runtime/input/clickinput.h \
     src/concolic/executiontree/tracedisplayoverview.h \
+    src/concolic/executiontree/tracedisplaywriter.h \
     src/concolic/solver/cvc4solver.h \
     src/concolic/solver/constraintwriter/cvc4.h \
     src/concolic/solver/constraintwriter/smt.h \
@@ -154,6 +184,9 @@ HEADERS += src/runtime/input/ajaxinput.h \
     src/concolic/executiontree/treemanager.h \
     src/concolic/executiontree/nodes/traceunexploredqueued.h \
     src/concolic/executiontree/traceindexer.h \
+    src/concolic/executiontree/nodes/tracespilled.h \
+    src/concolic/executiontree/tracespillstore.h \
+    src/concolic/executiontree/tracespiller.h \
     src/runtime/toplevel/analysisserverruntime.h \
     src/runtime/analysisserver/analysisserver.h \
     src/runtime/analysisserver/command.h \
@@ -172,7 +205,8 @@ HEADERS += src/runtime/input/ajaxinput.h \
     src/runtime/toplevel/concolicreorderingruntime.h \
     src/concolic/reordering/reachablepathsconstraintgenerator.h \
     src/concolic/reordering/reachablepathsconstraint.h \
-    src/concolic/reordering/reorderingconstraintinfo.h
+    src/concolic/reordering/reorderingconstraintinfo.h \
+    src/concolic/reordering/reorderingscheduler.h
 
 SOURCES += src/runtime/input/ajaxinput.cpp \
     src/strategies/prioritizer/constantprioritizer.cpp \
@@ -180,6 +214,13 @@ SOURCES += src/runtime/input/ajaxinput.cpp \
     src/strategies/inputgenerator/targets/targetgenerator.cpp \
     src/runtime/browser/ajax/ajaxrequest.cpp \
     src/runtime/browser/ajax/ajaxrequestlistener.cpp \
+    src/runtime/browser/ajax/networkcache.cpp \
+    src/runtime/browser/ajax/cachednetworkreply.cpp \
+    src/runtime/browser/ajax/recordingnetworkreply.cpp \
+    src/runtime/browser/ajax/prettifycache.cpp \
+    src/runtime/browser/ajax/prettifyingnetworkreply.cpp \
+    src/util/javascriptprettifier.cpp \
+    src/model/coverage/prettifymapping.cpp \
     src/runtime/browser/cookies/immutablecookiejar.cpp \
     src/runtime/input/events/baseeventparameters.cpp \
     src/runtime/input/events/domelementdescriptor.cpp \
@@ -214,16 +255,19 @@ SOURCES += src/runtime/input/ajaxinput.cpp \
     src/util/urlutil.cpp \
     src/exceptionhandlingqapp.cpp \
     src/runtime/browser/executionresultbuilder.cpp \
+    src/runtime/browser/eventhandlerfilter.cpp \
     src/strategies/inputgenerator/event/staticeventparametergenerator.cpp \
     src/strategies/inputgenerator/form/staticforminputgenerator.cpp \
     src/strategies/inputgenerator/form/constantstringforminputgenerator.cpp \
     src/strategies/prioritizer/coverageprioritizer.cpp \
     src/runtime/appmodel.cpp \
     src/model/javascriptstatistics.cpp \
+    src/model/samplingprofiler.cpp \
     src/strategies/prioritizer/readwriteprioritizer.cpp \
     src/strategies/prioritizer/collectedprioritizer.cpp \
     src/runtime/input/events/toucheventparameters.cpp \
     src/model/pathtracer.cpp \
+    src/model/pathtracelogreader.cpp \
     src/runtime/toplevel/artemisruntime.cpp \
     src/concolic/solver/expressionprinter.cpp \
     src/concolic/solver/solver.cpp \
@@ -238,8 +282,10 @@ SOURCES += src/runtime/input/ajaxinput.cpp \
     src/runtime/toplevel/manualruntime.cpp \
     src/runtime/input/events/unknowneventparameters.cpp \
     src/concolic/traceeventdetectors.cpp \
+    src/concolic/indicatorwordmatcher.cpp \
     src/concolic/tracestatistics.cpp \
     src/concolic/solver/solution.cpp \
+    src/concolic/solver/solvermodelparser.cpp \
     src/runtime/demomode/traceviewerdialog.cpp \
     src/strategies/inputgenerator/form/forminputgenerator.cpp \
     src/concolic/pathcondition.cpp \
@@ -248,6 +294,7 @@ SOURCES += src/runtime/input/ajaxinput.cpp \
     src/concolic/executiontree/nodes/traceconcretebranch.cpp \
     src/concolic/executiontree/nodes/tracesymbolicbranch.cpp \
     src/concolic/executiontree/tracemerger.cpp \
+    src/concolic/executiontree/tracepath.cpp \
     src/concolic/executiontree/tracedisplay.cpp \
     src/concolic/search/searchdfs.cpp \
     src/concolic/solver/expressionvalueprinter.cpp \
@@ -256,6 +303,7 @@ SOURCES += src/runtime/input/ajaxinput.cpp \
     src/concolic/solver/constraintwriter/kaluza.cpp \
     src/concolic/solver/constraintwriter/z3str.cpp \
     src/concolic/solver/z3solver.cpp \
+    src/concolic/solver/slicingsolver.cpp \
     src/concolic/solver/kaluzasolver.cpp \
     src/runtime/toplevel/artformruntime.cpp \
     src/runtime/input/forms/formfielddescriptor.cpp \
@@ -266,6 +314,7 @@ SOURCES += src/runtime/input/ajaxinput.cpp \
     src/concolic/mockentrypointdetector.cpp \
     src/runtime/input/clickinput.cpp \
     src/concolic/executiontree/tracedisplayoverview.cpp \
+    src/concolic/executiontree/tracedisplaywriter.cpp \
     src/concolic/solver/cvc4solver.cpp \
     src/concolic/solver/constraintwriter/cvc4.cpp \
     src/concolic/solver/constraintwriter/smt.cpp \
@@ -291,6 +340,9 @@ SOURCES += src/runtime/input/ajaxinput.cpp \
     src/concolic/executiontree/treemanager.cpp \
     src/concolic/executiontree/nodes/traceunexploredqueued.cpp \
     src/concolic/executiontree/traceindexer.cpp \
+    src/concolic/executiontree/nodes/tracespilled.cpp \
+    src/concolic/executiontree/tracespillstore.cpp \
+    src/concolic/executiontree/tracespiller.cpp \
     src/runtime/toplevel/analysisserverruntime.cpp \
     src/runtime/analysisserver/analysisserver.cpp \
     src/runtime/analysisserver/requesthandler.cpp \
@@ -308,6 +360,7 @@ SOURCES += src/runtime/input/ajaxinput.cpp \
     src/runtime/toplevel/concolicreorderingruntime.cpp \
     src/concolic/reordering/reachablepathsconstraintgenerator.cpp \
     src/concolic/reordering/reachablepathsconstraint.cpp \
-    src/concolic/reordering/reorderingconstraintinfo.cpp
+    src/concolic/reordering/reorderingconstraintinfo.cpp \
+    src/concolic/reordering/reorderingscheduler.cpp
 
 QT += network
@@ -0,0 +1,165 @@
+#!/usr/bin/env python
+
+"""
+Turns a concolic tree log (*.gvlog) written by Artemis into GraphViz .gv files.
+
+Usage:
+    gvlog2gv.py tree.gvlog                  Writes the final tree to tree.gv
+    gvlog2gv.py tree.gvlog -i 12            Writes the tree as it was after iteration 12 to tree_12.gv
+    gvlog2gv.py tree.gvlog --all            Writes one tree_<n>.gv for each update in the log (e.g. for graphs2mp4.sh)
+
+The log is a list of tab-separated events, see TraceDisplay::openGraphLog() for the format.
+"""
+
+from __future__ import print_function
+
+import argparse
+import os
+import re
+import sys
+
+INDENT = "  "
+ESCAPES = {"\\\\": "\\", "\\t": "\t", "\\n": "\n"}
+
+
+def unescape(field):
+    return re.sub(r"\\\\|\\t|\\n", lambda match: ESCAPES[match.group(0)], field)
+
+
+class TreeLog(object):
+
+    def __init__(self):
+        self.title = None
+        self.legend = ""
+        self.styles = []  # (subgraph, style), in output order
+        self.nodes = {}  # name -> (subgraph, marker index, declaration)
+        self.node_order = []
+        self.edges = {}  # from -> {slot -> (to, extras)}
+
+    def apply(self, fields):
+        kind = fields[0]
+        if kind == "title":
+            self.title = unescape(fields[1])
+        elif kind == "legend":
+            self.legend = unescape(fields[1])
+        elif kind == "style":
+            self.styles.append((fields[1], unescape(fields[2])))
+        elif kind == "node":
+            self.declare(fields[1], None, unescape(fields[2]))
+        elif kind == "marker":
+            self.declare("markers", unescape(fields[1]), unescape(fields[2]))
+        elif kind == "edge":
+            self.edges.setdefault(fields[1], {})[int(fields[2])] = (fields[3], unescape(fields[4]))
+        else:
+            raise Exception("Unknown event in tree log: %s" % kind)
+
+    def declare(self, subgraph, index, declaration):
+        name = declaration.split(" ", 1)[0]
+        if name not in self.nodes:
+            self.node_order.append(name)
+        self.nodes[name] = (subgraph, index, declaration)
+
+    def reachable_edges(self):
+        # Nodes which were replaced in the tree are still in the log, so only keep what is reachable from the start.
+        edges = []
+        reachable = set()
+        stack = ["start"]
+        while stack:
+            node = stack.pop()
+            children = self.edges.get(node, {})
+            for slot in sorted(children.keys()):
+                edges.append((node, children[slot][0], children[slot][1]))
+            for slot in sorted(children.keys(), reverse=True):
+                child = children[slot][0]
+                if child not in reachable:
+                    reachable.add(child)
+                    stack.append(child)
+        return edges, reachable
+
+    def graph(self):
+        edges, reachable = self.reachable_edges()
+
+        result = "digraph tree1 {\n" + INDENT + "graph [ordering = out];\n\n"
+
+        if self.title:
+            result += INDENT + "labelloc=\"t\";\n"
+            result += INDENT + "label=\"" + self.title + "\";\n\n"
+
+        for subgraph, style in self.styles:
+            declarations = [self.nodes[name] for name in self.node_order
+                            if name in reachable and self.nodes[name][0] == subgraph]
+
+            result += INDENT + "subgraph " + subgraph + " {\n" + INDENT * 2 + "node " + style + ";\n\n"
+            if subgraph == "markers":
+                indices = []
+                for _, index, _ in declarations:
+                    if index not in indices:
+                        indices.append(index)
+                for index in indices:
+                    result += INDENT * 2 + "{\n"
+                    result += INDENT * 3 + "rank = same;\n"
+                    result += INDENT * 3 + "node [label = \"%s\"];\n" % index
+                    for _, node_index, declaration in declarations:
+                        if node_index == index:
+                            result += INDENT * 3 + declaration + ";\n"
+                    result += INDENT * 2 + "}\n\n"
+            else:
+                for _, _, declaration in declarations:
+                    result += INDENT * 2 + declaration + ";\n"
+            result += INDENT + "}\n\n"
+
+        result += INDENT + "start [label = \"Start\"];\n\n"
+
+        for source, target, extras in edges:
+            result += INDENT + source + " -> " + target + (" " + extras if extras else "") + ";\n"
+
+        result += self.legend
+        result += "\n}\n"
+        return result
+
+
+def write(filename, data):
+    with open(filename, "w") as f:
+        f.write(data)
+    print("Wrote", filename)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Turns a concolic tree log (*.gvlog) into GraphViz .gv files.")
+    parser.add_argument("log", help="The .gvlog file written by Artemis.")
+    parser.add_argument("-i", "--iteration", type=int, help="Write the tree as it was after this iteration.")
+    parser.add_argument("--all", action="store_true", help="Write the tree after each update in the log.")
+    args = parser.parse_args()
+
+    base = os.path.splitext(args.log)[0]
+    tree = TreeLog()
+    iteration = None
+
+    with open(args.log) as f:
+        for line in f:
+            fields = line.rstrip("\n").split("\t")
+            if fields[0] == "iteration":
+                # The events so far make up the tree of the previous update.
+                if args.all and iteration is not None:
+                    write("%s_%d.gv" % (base, iteration), tree.graph())
+                if args.iteration is not None and int(fields[1]) > args.iteration:
+                    break
+                iteration = int(fields[1])
+            else:
+                tree.apply(fields)
+
+    if iteration is None:
+        print("The log does not contain any trees.", file=sys.stderr)
+        return 1
+
+    if args.all:
+        write("%s_%d.gv" % (base, iteration), tree.graph())
+    elif args.iteration is not None:
+        write("%s_%d.gv" % (base, args.iteration), tree.graph())
+    else:
+        write(base + ".gv", tree.graph())
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
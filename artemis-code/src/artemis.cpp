@@ -134,6 +134,16 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
             "           none - (default) Path trace report is omitted\n"
             "           html - HTML trace report is generated in the folder you run Artemis from\n"
             "\n"
+            "           The traces are streamed to a temporary log (artemis-traces-XXXXXX.log in the system temporary\n"
+            "           directory) as they are recorded. The report is generated from that log at the end of the run, and\n"
+            "           the log is removed when Artemis exits.\n"
+            "\n"
+            "--path-trace-max-items <n>:\n"
+            "           Stop recording path trace items (function calls and alerts) after the first n. Default: no limit.\n"
+            "\n"
+            "--path-trace-sample <n>:\n"
+            "           Only record one in every n path traces (i.e. events). Default: 1 (all traces).\n"
+            "\n"
             "--concolic-button <XPath>:\n"
             "           Use the given XPath to locate the button to be used in concolic mode.\n"
             "           If not supplied, the concolic mode will use its built-in button finding, which is not robust.\n"
@@ -144,6 +154,12 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
             "           final-overview - Like final but also includes a simplified overview graph.\n"
             "           all - Generate a graph of the tree at every iteration.\n"
             "           all-overview - Like all but also includes simplified overview graphs.\n"
+            "           While running, only the changes to the tree are appended to a .gvlog file, which is removed at the\n"
+            "           end in the final modes. Use scripts/gvlog2gv.py to generate the graphs of each iteration from it.\n"
+            "\n"
+            "--concolic-tree-output-interval <n>|<n>s\n"
+            "           Update the tree output at most every <n> iterations, or with a suffix of 's' at most every <n>\n"
+            "           seconds. Default: 1\n"
             "\n"
             "--concolic-search-procedure <search>\n"
             "           Choose the search procedure used to choose new areas of the concolic execution tree to explore.\n"
@@ -185,7 +201,8 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
             "           It is also possible to remove handlers from the event sequence, e.g. [1,2,4]\n"
             "\n"
             "--concolic-event-handler-report\n"
-            "           Outputs a graph of the symbolic variables which are read from each event handler.\n"
+            "           Outputs a graph of the symbolic variables which are read from each event handler, as graphviz\n"
+            "           (handlers.gv) and as a JSON adjacency list (handlers.json).\n"
             "           (Requires major-mode concolic and concolic-event-sequences)\n"
             "\n"
             "--concolic-disable-features <features-list>\n"
@@ -194,7 +211,34 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
             "           radio-restriction, select-restriction, select-restriction-dynamic, select-symbolic-index,\n"
             "           select-link-value-index, select-indirection-option-index, radio-checkbox-symbolic,\n"
             "           concrete-value-property, symbolic-after-injection, cvc4-coercion-opt,\n"
-            "           event-sequence-sync-injections\n"
+            "           event-sequence-sync-injections, constraint-slicing\n"
+            "\n"
+            "--concolic-session-gc <policy>\n"
+            "           How often the JavaScript heap is garbage collected at the start of a symbolic session.\n"
+            "           A session on the same page as the previous one is always collected, so no symbolic values leak.\n"
+            "\n"
+            "           always - (default) Collect at the start of every session.\n"
+            "           growth:<mb> - Collect once the heap has grown by more than <mb> MB since the last collection.\n"
+            "           every:<n> - Collect at the start of every <n>th session.\n"
+            "           never - Only collect when a session starts on the same page as the previous one.\n"
+            "\n"
+            "--concolic-reordering-scheduler <scheduler>\n"
+            "           Sets how major-mode concolic-reordering chooses the action to explore next.\n"
+            "\n"
+            "           round-robin (default) - take the actions in turn.\n"
+            "           ranked - prefer actions with a large unexplored frontier, which recently gave solvable constraints\n"
+            "                    with few solver calls, and whose explorations added new paths to the trees.\n"
+            "\n"
+            "--concolic-dom-indicators <words>\n"
+            "           The words which indicate an error message when they are added to the page during a concolic trace,\n"
+            "           for concolic-trace-classifier form-submission. Enabled by default in the concolic modes.\n"
+            "           <words> is a comma separated list of words, 'default' for the list: error, please, problem,\n"
+            "           warning, valid, invalid, required, require, sorry, field, selected, select, enter, important,\n"
+            "           correct, incorrect, or 'none' to disable the detection.\n"
+            "\n"
+            "--concolic-tree-memory-limit <mb>\n"
+            "           Approximate memory limit for each concolic execution tree. Above it, the fully explored parts of the\n"
+            "           tree are moved to a temporary file and only loaded again when needed. Default: 0 (no limit).\n"
             "\n"
             "--concolic-test-mode-js <js-file>\n"
             "           Specifies the JavaScript source file to be used by major-mode concolic-test.\n"
@@ -208,6 +252,8 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
             "\n"
             "--smt-solver <solver>:\n"
             "           z3str - Use the Z3-str SMT solver as backend.\n"
+            "           z3str-inprocess - Use the Z3-str SMT solver as backend, linked into Artemis instead of run as a separate process.\n"
+            "                             Only available if Artemis was built with qmake CONFIG+=z3inprocess.\n"
             "           cvc4 (default) - Use the CVC4 SMT solver as backend.\n"
             "           kaluza - Use the Kaluza solver as backend.\n"
             "\n"
@@ -239,6 +285,29 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
             "--analysis-server-log\n"
             "           The analysis server will dump a log of all commands and responses.\n"
             "\n"
+            "--network-cache <mode>\n"
+            "           Record and replay network responses in-process, keyed by method, URL, cookies and request body.\n"
+            "\n"
+            "           off - (default) every request goes to the network\n"
+            "           record - every request goes to the network, and the responses (including errors) are recorded\n"
+            "           replay - GET and HEAD requests with a recorded HTTP response are served from the cache, all other\n"
+            "                    requests go to the network and are recorded\n"
+            "           offline - serve recorded responses only, requests which were never recorded fail (for CI)\n"
+            "\n"
+            "--network-cache-dir <path>\n"
+            "           The directory used to store recorded responses. Default: network-cache\n"
+            "\n"
+            "--prettify-javascript [<cache-dir>]\n"
+            "           Prettify JavaScript files as they are loaded (replaces proxies/prettifyproxy.js) to get line-level coverage on minified code.\n"
+            "           Results are cached by content in <cache-dir> across runs. Default: prettify-cache\n"
+            "\n"
+            "--sampling-profiler <file>\n"
+            "           Sample the running bytecode and the Artemis phase (page load, injection, event, solver or merge) and write\n"
+            "           flat and call-tree profiles to <file> as JSON when Artemis terminates.\n"
+            "\n"
+            "--sampling-profiler-interval <us>\n"
+            "           The sampling interval of --sampling-profiler in microseconds. Default: 1000\n"
+            "\n"
             "--testing-concolic-send-iteration-count-to-server\n"
             "           Only used as part of our test suite. Adds a query of ArtemisIteration=X to each URL in concolic mode.\n"
             "\n"
@@ -254,9 +323,15 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
     {"coverage-report-ignore", required_argument, NULL, 'k'},
     {"major-mode", required_argument, NULL, 'm'},
     {"path-trace-report", required_argument, NULL, 'a'},
+    {"path-trace-max-items", required_argument, NULL, '3'},
+    {"path-trace-sample", required_argument, NULL, '4'},
+    {"concolic-reordering-scheduler", required_argument, NULL, '6'},
+    {"concolic-dom-indicators", required_argument, NULL, '7'},
+    {"concolic-tree-memory-limit", required_argument, NULL, '8'},
     {"function-call-heap-report", required_argument, NULL, 'g'},
     {"function-call-heap-report-random-factor", required_argument, NULL, 'l'},
     {"concolic-tree-output", required_argument, NULL, 'd'},
+    {"concolic-tree-output-interval", required_argument, NULL, '1'},
     {"concolic-button", required_argument, NULL, 'b'},
     {"concolic-search-procedure", required_argument, NULL, 'S'},
     {"concolic-dfs-unlimited-depth", no_argument, NULL, 'u'},
@@ -285,6 +360,12 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
     {"testing-concolic-send-iteration-count-to-server", no_argument, NULL, 'M'},
     {"event-delegation-testing", no_argument, NULL, 'N'},
     {"concolic-trace-classifier", required_argument, NULL, 'O'},
+    {"network-cache", required_argument, NULL, 'P'},
+    {"network-cache-dir", required_argument, NULL, 'Q'},
+    {"prettify-javascript", optional_argument, NULL, 'Y'},
+    {"sampling-profiler", required_argument, NULL, 'Z'},
+    {"sampling-profiler-interval", required_argument, NULL, '0'},
+    {"concolic-session-gc", required_argument, NULL, '2'},
     {0, 0, 0, 0}
     };
 
@@ -347,6 +428,8 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
                     Symbolic::SymbolicInterpreter::setFeatureSymbolicTriggeringEnabled(false);
                 } else if (feature == "event-sequence-sync-injections") {
                     options.concolicDisabledFeatures |= artemis::EVENT_SEQUENCE_SYNC_INJECTIONS;
+                } else if (feature == "constraint-slicing") {
+                    options.concolicDisabledFeatures |= artemis::CONSTRAINT_SLICING;
                 } else {
                     cerr << "ERROR: Invalid choice of concolic-disable-features " << optarg << endl;
                     exit(1);
@@ -522,6 +605,8 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
                 options.solver = artemis::KALUZA;
             } else if (string(optarg).compare("z3str") == 0) {
                 options.solver = artemis::Z3STR;
+            } else if (string(optarg).compare("z3str-inprocess") == 0) {
+                options.solver = artemis::Z3STR_INPROCESS;
             } else if (string(optarg).compare("cvc4") == 0) {
                 options.solver = artemis::CVC4;
             } else {
@@ -563,6 +648,149 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
             break;
         }
 
+        case '6': {
+            if(string(optarg).compare("ranked") == 0){
+                options.concolicReorderingScheduler = artemis::SCHEDULE_RANKED;
+            } else if(string(optarg).compare("round-robin") == 0){
+                options.concolicReorderingScheduler = artemis::SCHEDULE_ROUND_ROBIN;
+            } else {
+                cerr << "ERROR: Invalid choice of concolic-reordering-scheduler " << optarg << endl;
+                exit(1);
+            }
+            break;
+        }
+
+        case '7': {
+            options.concolicDomIndicatorDetection = true;
+            options.concolicDomIndicators.clear();
+            if(string(optarg).compare("none") == 0){
+                options.concolicDomIndicatorDetection = false;
+            } else if(string(optarg).compare("default") != 0){
+                options.concolicDomIndicators = QString(optarg).split(",", QString::SkipEmptyParts);
+                if (options.concolicDomIndicators.isEmpty()) {
+                    cerr << "ERROR: Invalid choice of concolic-dom-indicators " << optarg << endl;
+                    exit(1);
+                }
+            }
+            break;
+        }
+
+        case '8': {
+            bool ok;
+            options.concolicTreeMemoryLimit = QString(optarg).toUInt(&ok);
+            if(!ok) {
+                cerr << "ERROR: Invalid choice of concolic-tree-memory-limit " << optarg << endl;
+                exit(1);
+            }
+            break;
+        }
+
+        case 'P': {
+            if (string(optarg).compare("off") == 0) {
+                options.networkCacheMode = artemis::NETWORK_CACHE_OFF;
+            } else if (string(optarg).compare("record") == 0) {
+                options.networkCacheMode = artemis::NETWORK_CACHE_RECORD;
+            } else if (string(optarg).compare("replay") == 0) {
+                options.networkCacheMode = artemis::NETWORK_CACHE_REPLAY;
+            } else if (string(optarg).compare("offline") == 0) {
+                options.networkCacheMode = artemis::NETWORK_CACHE_OFFLINE;
+            } else {
+                cerr << "ERROR: Invalid choice of network-cache " << optarg << endl;
+                exit(1);
+            }
+            break;
+        }
+
+        case 'Q': {
+            options.networkCacheDir = QString(optarg);
+            break;
+        }
+
+        case 'Y': {
+            options.prettifyJavaScript = true;
+            if (optarg) {
+                options.prettifyCacheDir = QString(optarg);
+            }
+            break;
+        }
+
+        case 'Z': {
+            options.samplingProfilerFile = QString(optarg);
+            break;
+        }
+
+        case '0': {
+            bool ok;
+            options.samplingProfilerInterval = QString(optarg).toUInt(&ok);
+            if (!ok || options.samplingProfilerInterval == 0) {
+                cerr << "ERROR: Invalid choice of sampling-profiler-interval " << optarg << endl;
+                exit(1);
+            }
+            break;
+        }
+
+        case '1': {
+            bool ok;
+            QString interval = QString(optarg);
+            uint value = interval.endsWith("s") ? interval.left(interval.length() - 1).toUInt(&ok) : interval.toUInt(&ok);
+            if (!ok || value == 0) {
+                cerr << "ERROR: Invalid choice of concolic-tree-output-interval " << optarg << endl;
+                exit(1);
+            }
+            if (interval.endsWith("s")) {
+                options.concolicTreeOutputIterations = 0;
+                options.concolicTreeOutputSeconds = value;
+            } else {
+                options.concolicTreeOutputIterations = value;
+                options.concolicTreeOutputSeconds = 0;
+            }
+            break;
+        }
+
+        case '2': {
+            QString policy = QString(optarg);
+            bool ok = true;
+            if (policy == "always") {
+                Symbolic::SymbolicInterpreter::setSessionGCPolicy(Symbolic::SymbolicInterpreter::GC_ALWAYS, 0);
+            } else if (policy == "never") {
+                Symbolic::SymbolicInterpreter::setSessionGCPolicy(Symbolic::SymbolicInterpreter::GC_NEVER, 0);
+            } else if (policy.startsWith("growth:")) {
+                uint megabytes = policy.mid(7).toUInt(&ok);
+                Symbolic::SymbolicInterpreter::setSessionGCPolicy(Symbolic::SymbolicInterpreter::GC_HEAP_GROWTH, (size_t)megabytes * 1024 * 1024);
+            } else if (policy.startsWith("every:")) {
+                uint sessions = policy.mid(6).toUInt(&ok);
+                ok = ok && sessions > 0;
+                Symbolic::SymbolicInterpreter::setSessionGCPolicy(Symbolic::SymbolicInterpreter::GC_EVERY_N_SESSIONS, sessions);
+            } else {
+                ok = false;
+            }
+            if (!ok) {
+                cerr << "ERROR: Invalid choice of concolic-session-gc " << optarg << endl;
+                exit(1);
+            }
+            break;
+        }
+
+        case '3': {
+            bool ok;
+            options.pathTraceMaxItems = QString(optarg).toUInt(&ok);
+            if (!ok) {
+                cerr << "ERROR: Invalid choice of path-trace-max-items " << optarg << endl;
+                exit(1);
+            }
+            break;
+        }
+
+        case '4': {
+            bool ok;
+            options.pathTraceSampling = QString(optarg).toUInt(&ok);
+            if (!ok || options.pathTraceSampling == 0) {
+                cerr << "ERROR: Invalid choice of path-trace-sample " << optarg << endl;
+                exit(1);
+            }
+            break;
+        }
+
         case 'p': {
             bool ok;
             options.analysisServerPort = QString(optarg).toUShort(&ok);
@@ -596,9 +824,15 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
                 } else if(string(optarg).compare("--function-call-heap-report") == 0){
                     std::cout << "all named none";
                 } else if(string(optarg).compare("--smt-solver") == 0){
-                    std::cout << "z3str cvc4 kaluza";
+                    std::cout << "z3str z3str-inprocess cvc4 kaluza";
                 } else if(string(optarg).compare("--export-event-sequence") == 0){
                     std::cout << "selenium";
+                } else if(string(optarg).compare("--network-cache") == 0){
+                    std::cout << "off record replay offline";
+                } else if(string(optarg).compare("--concolic-session-gc") == 0){
+                    std::cout << "always never";
+                } else if(string(optarg).compare("--concolic-reordering-scheduler") == 0){
+                    std::cout << "ranked round-robin";
                 }
 
             } else {
@@ -607,14 +841,21 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
                              "--coverage-report "
                              "--coverage-report-ignore "
                              "--path-trace-report "
+                             "--path-trace-max-items "
+                             "--path-trace-sample "
                              "--concolic-button "
                              "--concolic-tree-output "
+                             "--concolic-tree-output-interval "
                              "--concolic-search-procedure "
                              "--concolic-dfs-depth "
                              "--concolic-dfs-unlimited-depth "
                              "--concolic-selection-procedure "
                              "--concolic-selection-budget "
                              "--concolic-event-sequences "
+                             "--concolic-session-gc "
+                             "--concolic-reordering-scheduler "
+                             "--concolic-dom-indicators "
+                             "--concolic-tree-memory-limit "
                              "--strategy-priority "
                              "--smt-solver "
                              "--export-event-sequence "
@@ -622,7 +863,12 @@ QUrl parseCmd(int argc, char* argv[], artemis::Options& options)
                              "--function-call-heap-report "
                              "--function-call-heap-report-random-factor "
                              "--export-event-sequence "
-                             "--analysis-server-port ";
+                             "--analysis-server-port "
+                             "--network-cache "
+                             "--network-cache-dir "
+                             "--prettify-javascript "
+                             "--sampling-profiler "
+                             "--sampling-profiler-interval ";
             }
 
             exit(0);
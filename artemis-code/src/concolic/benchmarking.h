@@ -30,7 +30,8 @@ enum ConcolicBenchmarkFeatureValues {
     SELECT_LINK_VALUE_INDEX = 8,
     CVC4_COERCION_OPT = 16,
     CONCRETE_VALUE_PROPERTY = 32,
-    EVENT_SEQUENCE_SYNC_INJECTIONS = 64
+    EVENT_SEQUENCE_SYNC_INJECTIONS = 64,
+    CONSTRAINT_SLICING = 128
 };
 
 Q_DECLARE_FLAGS(ConcolicBenchmarkFeatures, ConcolicBenchmarkFeatureValues)
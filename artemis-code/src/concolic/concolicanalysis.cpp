@@ -24,6 +24,9 @@
 #include "concolic/search/roundrobinselector.h"
 #include "concolic/executiontree/treemanager.h"
 #include "concolic/executiontree/traceindexer.h"
+#include "concolic/solver/slicingsolver.h"
+#include "concolic/tracestatistics.h"
+#include "model/samplingprofiler.h"
 
 #include <assert.h>
 
@@ -36,17 +39,28 @@ ConcolicAnalysis::ConcolicAnalysis(Options options, OutputMode output)
     : mOptions(options)
     , mOutput(output)
     , mExecutionTree(TraceNodePtr())
+    , mExecutionTreeVersion(0)
+    , mNumNewTraces(0)
+    , mFrontierSize(0)
+    , mTraceSpiller(options.concolicTreeMemoryLimit)
     , mSearchStrategy(TreeSearchPtr())
+    , mLastTarget()
     , mDomSnapshotStorage(DomSnapshotStoragePtr(new DomSnapshotStorage()))
     , mReachablePathsConstraints()
     , mReorderingInfo()
+    , mSolver(SlicingSolverPtr(new SlicingSolver(options.concolicDisabledFeatures, Solver::getSolver(options))))
+    , mSolverCalls(0)
     , mExplorationIndex(1)
     , mPreviousConstraintID()
 {
+    QObject::connect(&mTraceMerger, SIGNAL(sigTraceJoined(TraceNodePtr, int, TraceNodePtr, TraceNodePtr)),
+                     &mTraceSpiller, SLOT(slNewTraceAdded(TraceNodePtr, int, TraceNodePtr, TraceNodePtr)));
+    QObject::connect(&mTraceMerger, SIGNAL(sigTraceJoined(TraceNodePtr, int, TraceNodePtr, TraceNodePtr)),
+                     this, SLOT(slTraceJoined(TraceNodePtr, int, TraceNodePtr, TraceNodePtr)));
 }
 
 // Add a new trace to the tree.
-void ConcolicAnalysis::addTrace(TraceNodePtr trace, ExplorationHandle target)
+void ConcolicAnalysis::addTrace(TraceNodePtr trace, ExplorationHandle target, const TracePath& path)
 {
     // If there is no exploration target we do not know the trace index, unless it is the initial trace.
     // For these "unknown" traces, leave the index blank.
@@ -60,9 +74,18 @@ void ConcolicAnalysis::addTrace(TraceNodePtr trace, ExplorationHandle target)
     // pointer to the tree, which will be replaced in that case.
     if (mExecutionTree.isNull()) {
         mExecutionTree = trace;
+        mExecutionTreeVersion++;
+        mNumNewTraces++;
+        mTraceSpiller.addedToTree(trace);
+        mFrontierSize = countFrontier(trace);
         initSearchProcedure();
     } else {
-        mergeTraceIntoTree(trace, target);
+        mergeTraceIntoTree(trace, target, path);
+    }
+
+    // Over the memory limit, the fully explored parts of the tree are moved to disk.
+    if (mTraceSpiller.spillIfNeeded(mExecutionTree, mLastTarget)) {
+        mExecutionTreeVersion++;
     }
 
     emit sigExecutionTreeUpdated(mExecutionTree, mConcolicAnalysisName);
@@ -98,15 +121,26 @@ void ConcolicAnalysis::initSearchProcedure()
     }
 }
 
-void ConcolicAnalysis::mergeTraceIntoTree(TraceNodePtr trace, ExplorationHandle target)
+void ConcolicAnalysis::mergeTraceIntoTree(TraceNodePtr trace, ExplorationHandle target, const TracePath& path)
 {
     assert(!mExecutionTree.isNull());
 
-    mExecutionTree = mTraceMerger.merge(trace, mExecutionTree, &mExecutionTree);
+    {
+        SamplingProfiler::PhaseScope phase(SamplingProfiler::MERGE);
+        // If the run was aimed at a target, the merge can skip the part of the tree above it.
+        TraceSymbolicBranchPtr targetBranch = target.noExplorationTarget ? TraceSymbolicBranchPtr() : target.target.branch;
+        mExecutionTree = mTraceMerger.merge(trace, mExecutionTree, &mExecutionTree, targetBranch, path);
+    }
+
+    if (mTraceMerger.changedTree()) {
+        mExecutionTreeVersion++;
+        mNumNewTraces++;
+    }
 
     // Check if we actually explored the intended target.
     if (!target.noExplorationTarget && TreeManager::isQueuedOrNotAttempted(target.target)) {
         TreeManager::markNodeMissed(target.target);
+        mExecutionTreeVersion++;
         concolicRuntimeInfo("  Recorded trace did not take the expected path.");
     }
 }
@@ -163,7 +197,11 @@ ConcolicAnalysis::ExplorationResult ConcolicAnalysis::nextExploration()
         return nothingToExplore();
     }
 
+    // The search marks the nodes it tries (queued, unsat, unsolvable, ...).
+    mExecutionTreeVersion++;
+
     // Search until we find a solution for new exploration
+    uint solverCallsBefore = mSolverCalls;
     foundResult = false;
     while (!foundResult) {
         // Call the search procedure to find an unexplored PC.
@@ -173,6 +211,7 @@ ConcolicAnalysis::ExplorationResult ConcolicAnalysis::nextExploration()
 
             handle.noExplorationTarget = false;
             handle.target = mSearchStrategy->getTargetDescriptor();
+            mLastTarget = handle.target.branch;
             handle.explorationIndex = mExplorationIndex;
 
             pc = mSearchStrategy->getTargetPC();
@@ -199,6 +238,7 @@ ConcolicAnalysis::ExplorationResult ConcolicAnalysis::nextExploration()
     }
 
     // Returns the solved result, or nothingToExplore() if no SAT PC could be found.
+    result.solverCalls = mSolverCalls - solverCallsBefore;
     return result;
 }
 
@@ -226,9 +266,13 @@ SolutionPtr ConcolicAnalysis::solveTargetPC()
     TreeManager::markExplorationIndex(target, mExplorationIndex);
 
     // Try to solve this PC to get some concrete input.
-    SolverPtr solver = Solver::getSolver(mOptions);
-    SolutionPtr solution = solver->solve(pc, dynamicRestrictions, mDomSnapshotStorage, mReachablePathsConstraints, mReorderingInfo);
-    mPreviousConstraintID = solver->getLastConstraintID();
+    SolutionPtr solution;
+    {
+        SamplingProfiler::PhaseScope phase(SamplingProfiler::SOLVER);
+        solution = mSolver->solve(pc, dynamicRestrictions, mDomSnapshotStorage, mReachablePathsConstraints, mReorderingInfo);
+        mSolverCalls++;
+    }
+    mPreviousConstraintID = mSolver->getLastConstraintID();
 
     // If the constraint could not be solved, then we have an oppourtunity to retry.
     bool canRetry = true;
@@ -271,8 +315,10 @@ SolutionPtr ConcolicAnalysis::solveTargetPC()
                 canRetry = false;
             } else {
 
-                solution = solver->solve(pc, dynamicRestrictions, mDomSnapshotStorage, mReachablePathsConstraints, mReorderingInfo);
-                mPreviousConstraintID = solver->getLastConstraintID();
+                SamplingProfiler::PhaseScope phase(SamplingProfiler::SOLVER);
+                solution = mSolver->solve(pc, dynamicRestrictions, mDomSnapshotStorage, mReachablePathsConstraints, mReorderingInfo);
+                mSolverCalls++;
+                mPreviousConstraintID = mSolver->getLastConstraintID();
 
             }
 
@@ -348,6 +394,43 @@ TraceNodePtr ConcolicAnalysis::getExecutionTree()
     return mExecutionTree;
 }
 
+uint ConcolicAnalysis::getExecutionTreeVersion()
+{
+    return mExecutionTreeVersion;
+}
+
+uint ConcolicAnalysis::getNumNewTraces()
+{
+    return mNumNewTraces;
+}
+
+uint ConcolicAnalysis::getFrontierSize()
+{
+    return mFrontierSize;
+}
+
+// A new suffix replaces an unexplored child of parent, so the frontier changes by the unexplored children in the suffix
+// and the one it replaced. This only visits the suffix, not the whole tree.
+void ConcolicAnalysis::slTraceJoined(TraceNodePtr parent, int direction, TraceNodePtr suffix, TraceNodePtr fullTrace)
+{
+    TraceSymbolicBranchPtr branch = parent.dynamicCast<TraceSymbolicBranch>();
+    if (!branch.isNull()) {
+        TraceNodePtr child = direction ? branch->getTrueBranch() : branch->getFalseBranch();
+        if (child == suffix && mFrontierSize > 0) {
+            mFrontierSize--;
+        }
+    }
+
+    mFrontierSize += countFrontier(suffix);
+}
+
+uint ConcolicAnalysis::countFrontier(TraceNodePtr trace)
+{
+    TraceStatistics statistics;
+    statistics.processTrace(trace);
+    return statistics.mNumUnexploredSymbolicChild;
+}
+
 uint ConcolicAnalysis::getExplorationIndex()
 {
     return mExplorationIndex;
@@ -407,6 +490,7 @@ ConcolicAnalysis::ExplorationResult ConcolicAnalysis::nothingToExplore()
 {
     ExplorationResult noExploration;
     noExploration.newExploration = false;
+    noExploration.solverCalls = 0;
     return noExploration;
 }
 
@@ -20,6 +20,7 @@
 
 #include "concolic/executiontree/tracenodes.h"
 #include "concolic/executiontree/tracemerger.h"
+#include "concolic/executiontree/tracespiller.h"
 #include "concolic/search/explorationdescriptor.h"
 #include "concolic/search/search.h"
 #include "concolic/search/abstractselector.h"
@@ -101,6 +102,9 @@ public:
         // Opaque handle to be passed back to addTrace() when this result is executed as a new trace.
         ExplorationHandle target;
 
+        // The number of solver calls made to find this result, including the retries of unsolvable PCs.
+        uint solverCalls;
+
         // Logging and output stuff
         QString constraintID;
     };
@@ -109,7 +113,8 @@ public:
 
     ConcolicAnalysis(Options options, OutputMode output);
 
-    void addTrace(TraceNodePtr trace, ExplorationHandle target);
+    // The path recorded with the trace (see TraceBuilder::path) lets the merge start at the target.
+    void addTrace(TraceNodePtr trace, ExplorationHandle target, const TracePath& path = TracePath());
 
     ExplorationResult nextExploration();
 
@@ -141,21 +146,42 @@ public:
     TraceNodePtr getExecutionTree();
     uint getExplorationIndex();
 
+    // Increases whenever the execution tree or the marking of its nodes (queued, unsat, missed, ...) may have changed,
+    // so anything derived from the tree can be cached against it.
+    uint getExecutionTreeVersion();
+
+    // The number of traces added so far which added a new path (or divergence) to the execution tree.
+    uint getNumNewTraces();
+
+    // The number of symbolic branches with an unexplored child in the tree (as in TraceStatistics), kept up to date as
+    // traces are merged. Divergent traces are not searched, so their branches are not counted.
+    uint getFrontierSize();
+
     void setName(QString name);
 
 signals:
     void sigExecutionTreeUpdated(TraceNodePtr tree, QString name);
 
+protected slots:
+    void slTraceJoined(TraceNodePtr parent, int direction, TraceNodePtr suffix, TraceNodePtr fullTrace);
+
 protected:
 
     Options mOptions;
     OutputMode mOutput;
 
     TraceNodePtr mExecutionTree;
+    uint mExecutionTreeVersion;
+    uint mNumNewTraces;
+    uint mFrontierSize;
 
     TraceMerger mTraceMerger;
+    TraceSpiller mTraceSpiller;
     TreeSearchPtr mSearchStrategy;
 
+    // The searches may keep pointers to their last target and its ancestors between calls, so these are never spilled.
+    TraceSymbolicBranchPtr mLastTarget;
+
     FormRestrictions mFormFieldInitialRestrictions;
     FormRestrictions mergeDynamicSelectRestrictions(FormRestrictions base, QSet<SelectRestriction> replacements);
     FormRestrictions updateFormRestrictionsForFeatureFlags(FormRestrictions restrictions);
@@ -166,13 +192,18 @@ protected:
 
     ReorderingConstraintInfoPtr mReorderingInfo;
 
+    // Kept for the whole analysis, so the models of independent slices of the PC can be reused between targets.
+    SolverPtr mSolver;
+    uint mSolverCalls;
+
     // Logging
     uint mExplorationIndex;
     QString mPreviousConstraintID;
 
     // Helpers for addTrace
     void initSearchProcedure();
-    void mergeTraceIntoTree(TraceNodePtr trace, ExplorationHandle target);
+    void mergeTraceIntoTree(TraceNodePtr trace, ExplorationHandle target, const TracePath& path);
+    static uint countFrontier(TraceNodePtr trace);
     AbstractSelectorPtr buildSelector(ConcolicSearchSelector description);
 
     // Helpers for nextExploration
@@ -42,44 +42,31 @@ QList<EventHandlerDescriptorConstPtr> EntryPointDetector::detectAll(ExecutionRes
 
     QList<EventHandlerDescriptorConstPtr> entryEvents;
 
+    // Collect the elements with listeners, their type attribute and whether they are inside a form in one pass over
+    // the DOM, instead of looking up the element of each handler separately.
+    QHash<QString, QWebEventTarget> targets;
+    foreach (QWebEventTarget target, mPage->mainFrame()->documentElement().findEventTargets()) {
+        targets.insert(target.xPath, target);
+    }
+
     foreach (EventHandlerDescriptorConstPtr event , result->getEventHandlers()){
         qDebug() << "XPATH: " << event->xPathToElement();
-        if (event->getName().compare("click", Qt::CaseInsensitive) == 0 &&
-                event->getDomElement()->getTagName().compare("button", Qt::CaseInsensitive) == 0){
-            // Accept any click on a button
-            entryEvents.append(event);
 
-        } else if (event->getName().compare("click", Qt::CaseInsensitive) == 0 &&
-                 event->getDomElement()->getTagName().compare("a", Qt::CaseInsensitive) == 0){
-
-            // Accept a click on a link only if it is inside a form.
-            QWebElement element = event->getDomElement()->getElement(mPage);
-            // Search upwards until we find a form or reach the top of the hierarchy.
-            while (element.tagName().compare("form", Qt::CaseInsensitive) != 0 &&
-                  !element.isNull()){
-                element = element.parent();
-            }
-            // If we did find a form element then we know the original event was on an element we consider interesting.
-            if (element.tagName().compare("form", Qt::CaseInsensitive) == 0){
-                entryEvents.append(event);
-            }
-
-        }else if(event->getName().compare("click", Qt::CaseInsensitive) == 0 &&
-                 event->getDomElement()->getTagName().compare("input", Qt::CaseInsensitive) == 0 &&
-                 (event->getDomElement()->getElement(mPage).attribute("type").compare("button", Qt::CaseInsensitive) == 0 ||
-                  event->getDomElement()->getElement(mPage).attribute("type").compare("submit", Qt::CaseInsensitive) == 0 ||
-                  event->getDomElement()->getElement(mPage).attribute("type").compare("image", Qt::CaseInsensitive) == 0)){
-
-            // Accept a click on an input element of type button, submit, or image.
-            entryEvents.append(event);
+        QHash<QString, QWebEventTarget>::const_iterator target = targets.constFind(event->xPathToElement());
+        bool found = target != targets.constEnd();
 
-        }else if(event->getName().compare("submit", Qt::CaseInsensitive) == 0 &&
-                 event->getDomElement()->getTagName().compare("form", Qt::CaseInsensitive) == 0){
+        if (!found) {
+            // The handler was recorded on an element the DOM pass did not return, so its XPath is stale or computed
+            // differently. Links and inputs are then rejected, as the old lookup of a missing element did.
+            Log::debug(QString("CONCOLIC-INFO: No event target found for %1 on %2 at %3")
+                       .arg(event->getName()).arg(event->getDomElement()->getTagName())
+                       .arg(event->xPathToElement()).toStdString());
+            Statistics::statistics()->accumulate("FormCrawl::EntrypointTargetMisses", 1);
+        }
 
-            // Accept a submit event on a form element.
+        if (isEntryPoint(event->getName(), event->getDomElement()->getTagName(), found ? &target.value() : NULL)) {
             entryEvents.append(event);
         }
-
     }
 
     Statistics::statistics()->accumulate("FormCrawl::Entrypoints", entryEvents.size());
@@ -89,6 +76,40 @@ QList<EventHandlerDescriptorConstPtr> EntryPointDetector::detectAll(ExecutionRes
 
 
 
+bool EntryPointDetector::isEntryPoint(const QString& eventName, const QString& tagName, const QWebEventTarget* target)
+{
+    if (eventName.compare("click", Qt::CaseInsensitive) == 0 &&
+            tagName.compare("button", Qt::CaseInsensitive) == 0){
+        // Accept any click on a button
+        return true;
+
+    } else if (eventName.compare("click", Qt::CaseInsensitive) == 0 &&
+             tagName.compare("a", Qt::CaseInsensitive) == 0){
+
+        // Accept a click on a link only if it is inside a form.
+        return target != NULL && target->insideForm;
+
+    }else if(eventName.compare("click", Qt::CaseInsensitive) == 0 &&
+             tagName.compare("input", Qt::CaseInsensitive) == 0){
+
+        // Accept a click on an input element of type button, submit, or image.
+        return target != NULL &&
+                (target->type.compare("button", Qt::CaseInsensitive) == 0 ||
+                 target->type.compare("submit", Qt::CaseInsensitive) == 0 ||
+                 target->type.compare("image", Qt::CaseInsensitive) == 0);
+
+    }else if(eventName.compare("submit", Qt::CaseInsensitive) == 0 &&
+             tagName.compare("form", Qt::CaseInsensitive) == 0){
+
+        // Accept a submit event on a form element.
+        return true;
+    }
+
+    return false;
+}
+
+
+
 EventHandlerDescriptorConstPtr EntryPointDetector::choose(ExecutionResultPtr result)
 {
 
@@ -16,7 +16,9 @@
 
 #include <QString>
 #include <QList>
+#include <QHash>
 #include <QWebFrame>
+#include <QWebElement>
 
 #include "runtime/browser/executionresult.h"
 
@@ -44,6 +46,10 @@ public:
     // Chooses a single entry point on the page. Can return NULL if it does not find a suitable entry point.
     EventHandlerDescriptorConstPtr choose(ExecutionResultPtr result);
 
+    // Decides whether a handler for eventName on a tagName element is an entry point. target is the listener target
+    // found for the element of the handler, or NULL if its XPath matched no target.
+    static bool isEntryPoint(const QString& eventName, const QString& tagName, const QWebEventTarget* target);
+
 protected:
     ArtemisWebPagePtr mPage;
     void printResultInfo(ExecutionResultPtr result);
@@ -35,7 +35,7 @@ TraceClassificationResult FormSubmissionClassifier::classify(TraceNodePtr& trace
     // Scan the trace and classify according to the following rules:
     //     * Alert -> failure
     //     * New page load -> success
-    //     * DOM modification which introduces indicator words -> failure       // N.B. This is disabled currently because the DOM modification detector is expensive.
+    //     * DOM modification which introduces indicator words -> failure       // See TraceDomIndicatorDetector.
     //     * Otherwise unknown
 
     trace->accept(this);
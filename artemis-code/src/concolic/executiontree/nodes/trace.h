@@ -120,7 +120,7 @@ public:
      ~TraceDomModification() {}
 
     double amountModified;
-    QMap<int,int> words; // Mapping from index of TraceDomModDetector::indicators to the count of that word.
+    QMap<QString,int> words; // Mapping from each indicator word which was found to its count.
 };
 
 
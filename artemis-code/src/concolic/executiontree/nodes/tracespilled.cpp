@@ -0,0 +1,53 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "concolic/executiontree/tracespillstore.h"
+#include "concolic/reordering/reachablepathsconstraint.h"
+#include "concolic/tracestatistics.h"
+
+#include "tracespilled.h"
+
+namespace artemis {
+
+TraceSpilled::TraceSpilled(TraceSpillStorePtr store, qint64 offset)
+    : mStore(store)
+    , mOffset(offset)
+{
+}
+
+void TraceSpilled::accept(TraceVisitor* visitor)
+{
+    visitor->visit(this);
+}
+
+bool TraceSpilled::isEqualShallow(const QSharedPointer<const TraceNode>& other)
+{
+    QSharedPointer<const TraceSpilled> otherCasted = other.dynamicCast<const TraceSpilled>();
+
+    return !otherCasted.isNull() && otherCasted->mStore == mStore && otherCasted->mOffset == mOffset;
+}
+
+TraceNodePtr TraceSpilled::load()
+{
+    return mStore->read(mOffset);
+}
+
+// Out of line, as the summaries are only forward declared in the header.
+TraceSpilled::~TraceSpilled()
+{
+}
+
+}
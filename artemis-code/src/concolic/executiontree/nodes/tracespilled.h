@@ -0,0 +1,79 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRACESPILLED_H
+#define TRACESPILLED_H
+
+#include "trace.h"
+
+namespace artemis {
+
+class TraceSpillStore;
+typedef QSharedPointer<TraceSpillStore> TraceSpillStorePtr;
+
+class TraceStatistics;
+
+class ReachablePathsConstraint;
+typedef QSharedPointer<ReachablePathsConstraint> ReachablePathsConstraintPtr;
+
+/**
+ * A placeholder for a fully explored subtree which has been written out to a TraceSpillStore to save memory.
+ *
+ * The default TraceVisitor::visit(TraceSpilled*) loads the subtree and visits it instead, so visitors which need the
+ * whole tree (e.g. TraceDisplay, TraceStatistics) see it as if it had never been spilled. The searches override this,
+ * as there is nothing left to explore below a spilled node.
+ *
+ * Every load creates a new copy of the subtree, so the copies must not be modified. TraceMerger replaces the
+ * placeholder in the tree with a loaded copy before merging into it.
+ *
+ * As the subtree never changes while it is spilled, the visitors which run after every trace (TraceStatistics,
+ * ReachablePathsConstraintGenerator and the graph log of TraceDisplay) only load it once and keep what they need
+ * from it with the placeholder.
+ */
+class TraceSpilled : public TraceNode
+{
+public:
+    TraceSpilled(TraceSpillStorePtr store, qint64 offset);
+
+    void accept(TraceVisitor* visitor);
+    bool isEqualShallow(const QSharedPointer<const TraceNode>& other);
+
+    virtual void setChild(int position, TraceNodePtr node) {
+        assert(false); // A spilled subtree is loaded and put back into the tree before it is modified.
+    }
+
+    TraceNodePtr load();
+
+    inline qint64 getOffset() const {
+        return mOffset;
+    }
+
+    // Filled in by the visitors above the first time they load the subtree.
+    QSharedPointer<TraceStatistics> statistics;
+    ReachablePathsConstraintPtr reachablePaths;
+
+    ~TraceSpilled();
+
+private:
+    TraceSpillStorePtr mStore;
+    qint64 mOffset; // Position of the subtree in the store.
+};
+
+typedef QSharedPointer<TraceSpilled> TraceSpilledPtr;
+
+}
+
+#endif // TRACESPILLED_H
@@ -52,6 +52,7 @@ void TraceBuilder::beginRecording()
     // Reset the trace to be empty.
     mTrace = QSharedPointer<TraceNode>();
     mSuccessor = &mTrace;
+    mPath.clear();
     mCurrentSummary.clear();
 
 }
@@ -70,6 +71,7 @@ void TraceBuilder::endRecording()
 
     // Finish off the trace with an EndUnknown node.
     *mSuccessor = QSharedPointer<TraceNode>(new TraceEndUnknown());
+    mPath.append(*mSuccessor);
     mSuccessor = NULL;
 
 }
@@ -85,6 +87,7 @@ void TraceBuilder::newNode(QSharedPointer<TraceNode> node, QSharedPointer<TraceN
 
         // Add the new node to the current successor pointer.
         *mSuccessor = node;
+        mPath.append(node);
 
         // Update the new successor pointer
         mSuccessor = successor;
@@ -112,6 +115,7 @@ void TraceBuilder::flushSummary()
 
     // Add the new node to the current successor pointer and update the successor pointer.
     *mSuccessor = node;
+    mPath.append(node);
     mSuccessor = &(node->executions[0].second);
 
     mCurrentSummary.clear();
@@ -127,5 +131,15 @@ TraceNodePtr TraceBuilder::trace()
     return mTrace;
 }
 
+TracePath TraceBuilder::path()
+{
+    if(mRecording){
+        Log::fatal("TraceRecorder: Requested trace path during recording.");
+        exit(1);
+    }
+
+    return mPath;
+}
+
 
 } // namespace artemis
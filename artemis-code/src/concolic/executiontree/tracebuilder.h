@@ -21,6 +21,7 @@
 #include <QSharedPointer>
 
 #include "concolic/executiontree/tracenodes.h"
+#include "concolic/executiontree/tracepath.h"
 
 #include "concolic/traceeventdetectors.h"
 
@@ -49,6 +50,7 @@ public:
     void endRecording();
     bool isRecording() { return mRecording; }
     TraceNodePtr trace();
+    TracePath path(); // The nodes of trace() in order, see TracePath.
 
     // Called by the detectors to add a new node to the trace.
     // 'successor' must be a pointer to the 'next' 'branchTrue', 'branchFalse', etc. member of that node,
@@ -67,6 +69,7 @@ private:
     QSharedPointer<TraceNode>* mSuccessor; // Where in the trace to add the next node.
     // Can't be QSharedPointer<QSharedPointer<TraceNode>> otherwise it would delete the pointed-to values too early.
     // It should be valid whenever mRecording is true.
+    TracePath mPath;
 
     QList<QSharedPointer<TraceEventDetector> > mDetectors; // The interesting event detectors which add nodes to the traces.
 
@@ -38,7 +38,11 @@ TraceDisplay::TraceDisplay()
 }
 
 TraceDisplay::TraceDisplay(bool linkToCoverage)
-    : mLinkToCoverage(linkToCoverage)
+    : mNodeCounter(0)
+    , mEdgeSlot(0)
+    , mLinkToCoverage(linkToCoverage)
+    , mLogNodeCounter(0)
+    , mAppendingLog(false)
 {
     mExpressionPrinter = QSharedPointer<ExpressionPrinter>(new ExpressionValuePrinter());
 
@@ -73,7 +77,8 @@ QString TraceDisplay::makeGraph(TraceNodePtr tree, QString title)
 
     // Visitor populates mHeader* and mEdges.
     clearData();
-    tree->accept(this);
+    visitPassThrough(tree);
+    mVisiting.clear();
 
     // Begin the graph
     result += "digraph tree1 {\n" + indent + "graph [ordering = out];\n\n";
@@ -239,12 +244,163 @@ void TraceDisplay::writeGraphFile(TraceNodePtr tree, QString& pathToFile, bool a
 }
 
 
+/*
+ *  The graph log.
+ *
+ *  Each line is one tab-separated event, later events override earlier ones:
+ *    title     <title>
+ *    legend    <legend>
+ *    style     <subgraph> <style>           In the order the subgraphs appear in the graph.
+ *    iteration <n>                          The events which follow were added after iteration n.
+ *    node      <subgraph> <declaration>     Declares (or re-declares) the node named by the first word.
+ *    marker    <index> <declaration>        Declares a marker node, markers are grouped by index.
+ *    edge      <from> <slot> <to> <extras>  Sets the child in a given slot of a node.
+ *
+ *  Nodes which are no longer reachable from "start" (e.g. a replaced unexplored node) are dropped when the log is
+ *  turned back into a graph.
+ */
+
+bool TraceDisplay::openGraphLog(QString pathToLog, QString title)
+{
+    closeGraphLog();
+
+    mLogFile.setFileName(pathToLog);
+    if (!mLogFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        Log::error(QString("Could not open the tree log %1").arg(pathToLog).toStdString());
+        return false;
+    }
+    mLog.setDevice(&mLogFile);
+
+    mLoggedNodes.clear();
+    mLoggedEdges.clear();
+    mLoggedSpilled.clear();
+    mLogNodeCounter = 0;
+
+    if (!title.isNull() && !title.isEmpty()) {
+        title.replace("\"", "\\\"");
+        title.replace("\n", "\\n");
+        mLog << "title\t" << escapeLogField(title) << "\n";
+    }
+    if (!mLegend.isEmpty()) {
+        mLog << "legend\t" << escapeLogField(mLegend) << "\n";
+    }
+
+    for (int group = BRANCHES; group <= DIVERGENCES; group++) {
+        if (group == FUNCTIONS) {
+            mLog << "style\tmarkers\t" << escapeLogField(mStyleMarkers) << "\n";
+        }
+        mLog << "style\t" << groupName((NodeGroup)group) << "\t" << escapeLogField(groupStyle((NodeGroup)group)) << "\n";
+    }
+
+    mLog.flush();
+    return true;
+}
+
+// Appends the changes to the tree since the last call.
+void TraceDisplay::appendGraphLog(TraceNodePtr tree, uint iteration)
+{
+    if (!isGraphLogOpen()) {
+        return;
+    }
+
+    mLog << "iteration\t" << iteration << "\n";
+
+    clearData();
+    mAppendingLog = true;
+    visitPassThrough(tree);
+    mAppendingLog = false;
+    mVisiting.clear();
+
+    // Nodes which were removed from the tree are only forgotten once they make up most of the log state.
+    // mNodeCounter is the number of nodes in the tree.
+    if ((uint)mLoggedNodes.size() > 2 * (uint)mNodeCounter) {
+        pruneGraphLog();
+    }
+
+    // Flush after every update, so the log is usable after a crash.
+    mLog.flush();
+}
+
+void TraceDisplay::closeGraphLog()
+{
+    if (!isGraphLogOpen()) {
+        return;
+    }
+
+    mLog.flush();
+    mLog.setDevice(NULL);
+    mLogFile.close();
+
+    mLoggedNodes.clear();
+    mLoggedEdges.clear();
+    mLoggedSpilled.clear();
+}
+
+bool TraceDisplay::isGraphLogOpen() const
+{
+    return mLogFile.isOpen();
+}
+
+// Forgets the nodes which have been deleted, along with their outgoing edges and the slots below them.
+void TraceDisplay::pruneGraphLog()
+{
+    QHash<QPair<QString, uint>, LoggedNode>::iterator node = mLoggedNodes.begin();
+    while (node != mLoggedNodes.end()) {
+        if (node->node.isNull()) {
+            node = mLoggedNodes.erase(node);
+        } else {
+            ++node;
+        }
+    }
+
+    // A shared node below a deleted (or replaced) one is still alive, but its slot is gone.
+    QSet<QString> live;
+    bool changed = true;
+    while (changed) {
+        live.clear();
+        live.insert("start");
+        foreach (const LoggedNode& entry, mLoggedNodes) {
+            live.insert(entry.name);
+        }
+
+        changed = false;
+        node = mLoggedNodes.begin();
+        while (node != mLoggedNodes.end()) {
+            if (!live.contains(node.key().first)) {
+                node = mLoggedNodes.erase(node);
+                changed = true;
+            } else {
+                ++node;
+            }
+        }
+    }
+
+    QHash<QPair<QString, uint>, QString>::iterator edge = mLoggedEdges.begin();
+    while (edge != mLoggedEdges.end()) {
+        if (!live.contains(edge.key().first)) {
+            edge = mLoggedEdges.erase(edge);
+        } else {
+            ++edge;
+        }
+    }
+
+    QHash<TraceNode*, QWeakPointer<TraceNode> >::iterator spilled = mLoggedSpilled.begin();
+    while (spilled != mLoggedSpilled.end()) {
+        if (spilled->isNull()) {
+            spilled = mLoggedSpilled.erase(spilled);
+        } else {
+            ++spilled;
+        }
+    }
+}
+
+
 /*
  *  The node visitor methods.
  *
- *  Each of these must compute its name, add this to the corresponding header list,
- *  add the incoming edge to the edges list, and if there are any children then set
- *  mPreviousNode and mEdgeExtras and then process them.
+ *  Each of these must compute its name with declareNode(), add its declaration with addNode()
+ *  (unless declareNode() says it is already in the graph log), add the incoming edge with
+ *  addInEdge(), and if there are any children then process them with visitChild().
  */
 
 void TraceDisplay::visit(TraceNode *node)
@@ -258,401 +414,404 @@ void TraceDisplay::visit(TraceNode *node)
 void TraceDisplay::visit(TraceConcreteBranch *node)
 {
     mNodeCounter++;
+    QString name;
+    if (declareNode(node, "br", 0, &name)) {
+        std::stringstream sourceId;
+        sourceId << SourceInfo::getId(node->getSource()->getUrl(), node->getSource()->getStartLine());
+
+        std::stringstream sourceLine;
+        sourceLine << node->getLinenumber();
+
+        QString source = "#";
+        if (mLinkToCoverage) {
+            source = QString("coverage.html?code=ID%1&amp;line=%2").arg(
+                        QString::fromStdString(sourceId.str()),
+                        QString::fromStdString(sourceLine.str()));
+        }
 
-    std::stringstream sourceId;
-    sourceId << SourceInfo::getId(node->getSource()->getUrl(), node->getSource()->getStartLine());
-
-    std::stringstream sourceLine;
-    sourceLine << node->getLinenumber();
+        QString label = QString(" [URL = \"%1\"]").arg(source);
 
-    QString source = "#";
-    if (mLinkToCoverage) {
-        source = QString("coverage.html?code=ID%1&amp;line=%2").arg(
-                    QString::fromStdString(sourceId.str()),
-                    QString::fromStdString(sourceLine.str()));
+        addNode(BRANCHES, name + label);
     }
 
-    QString name = QString("br_%1").arg(mNodeCounter);
-    QString label = QString(" [URL = \"%1\"]").arg(source);
-
-    mHeaderBranches.append(name + label);
-
     addInEdge(name);
 
     // Childeren are displayed in the tree in the order they are specified in the edges list.
     // We want false branches on the left, so process those first.
 
-    mPreviousNode = name;
-    mEdgeExtras = "[color = red]";
-    node->getFalseBranch()->accept(this);
-
-    mPreviousNode = name;
-    mEdgeExtras = "[color = darkgreen]";
-    node->getTrueBranch()->accept(this);
+    visitChild(name, node->getFalseBranch(), "[color = red]", 0);
+    visitChild(name, node->getTrueBranch(), "[color = darkgreen]", 1);
 }
 
 
 void TraceDisplay::visit(TraceSymbolicBranch *node)
 {
     mNodeCounter++;
+    QString name;
+    if (declareNode(node, "sym", node->isDifficult(), &name)) {
+        node->getSymbolicCondition()->accept(mExpressionPrinter.data());
+        QString symbolicExpression(mExpressionPrinter->getResult().c_str());
+        mExpressionPrinter->clear();
+
+        symbolicExpression.replace("\\", "\\\\");
+        symbolicExpression.replace("\"", "\\\"");
+
+        std::stringstream sourceId;
+        sourceId << SourceInfo::getId(node->getSource()->getUrl(), node->getSource()->getStartLine());
+
+        std::stringstream sourceLine;
+        sourceLine << node->getLinenumber();
+
+        QString source = "#";
+        if (mLinkToCoverage) {
+            source = QString("coverage.html?code=ID%1&amp;line=%2").arg(
+                        QString::fromStdString(sourceId.str()),
+                        QString::fromStdString(sourceLine.str()));
+        }
 
-    node->getSymbolicCondition()->accept(mExpressionPrinter.data());
-    QString symbolicExpression(mExpressionPrinter->getResult().c_str());
-    mExpressionPrinter->clear();
-
-    symbolicExpression.replace("\\", "\\\\");
-    symbolicExpression.replace("\"", "\\\"");
-
-    std::stringstream sourceId;
-    sourceId << SourceInfo::getId(node->getSource()->getUrl(), node->getSource()->getStartLine());
-
-    std::stringstream sourceLine;
-    sourceLine << node->getLinenumber();
+        QString difficult = "";
+        if(node->isDifficult()) {
+            difficult = "fillcolor = blue, ";
+        }
 
-    QString source = "#";
-    if (mLinkToCoverage) {
-        source = QString("coverage.html?code=ID%1&amp;line=%2").arg(
-                    QString::fromStdString(sourceId.str()),
-                    QString::fromStdString(sourceLine.str()));
-    }
+        QString label = QString(" [%1label = \"Branch\\n%2\", URL = \"%3\"]").arg(difficult, symbolicExpression, source);
 
-    QString difficult = "";
-    if(node->isDifficult()) {
-        difficult = "fillcolor = blue, ";
+        addNode(SYM_BRANCHES, name + label);
     }
 
-    QString name = QString("sym_%1").arg(mNodeCounter);
-    QString label = QString(" [%1label = \"Branch\\n%2\", URL = \"%3\"]").arg(difficult, symbolicExpression, source);
-
-    mHeaderSymBranches.append(name + label);
-
     addInEdge(name);
 
     // Childeren are displayed in the tree in the order they are specified in the edges list.
     // We want false branches on the left, so process those first.
 
+    QString extras;
     if(mShowExplorationIndices && node->getExplorationIndex() > 0 && node->getExplorationDirection() == false) {
-        mEdgeExtras = QString("[color = red, xlabel = \"%1\"]").arg(node->getExplorationIndex());
+        extras = QString("[color = red, xlabel = \"%1\"]").arg(node->getExplorationIndex());
     } else {
-        mEdgeExtras = "[color = red]";
+        extras = "[color = red]";
     }
-    mPreviousNode = name;
-    node->getFalseBranch()->accept(this);
+    visitChild(name, node->getFalseBranch(), extras, 0);
 
     if(mShowExplorationIndices && node->getExplorationIndex() > 0 && node->getExplorationDirection() == true) {
-        mEdgeExtras = QString("[color = darkgreen, xlabel = \"%1\"]").arg(node->getExplorationIndex());
+        extras = QString("[color = darkgreen, xlabel = \"%1\"]").arg(node->getExplorationIndex());
     } else {
-        mEdgeExtras = "[color = darkgreen]";
+        extras = "[color = darkgreen]";
     }
-    mPreviousNode = name;
-    node->getTrueBranch()->accept(this);
+    visitChild(name, node->getTrueBranch(), extras, 1);
 }
 
 
 void TraceDisplay::visit(TraceUnexplored *node)
 {
-    QString name = QString("unexp_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
-    mHeaderUnexplored.append(name);
+    QString name;
+    if (declareNode(node, "unexp", 0, &name)) {
+        addNode(UNEXPLORED, name);
+    }
 
+    mNodeCounter++;
     addInEdge(name);
 }
 
 void TraceDisplay::visit(TraceUnexploredUnsat *node)
 {
-    QString name = QString("unexp_unsat_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
-    mHeaderUnexploredUnsat.append(name);
+    QString name;
+    if (declareNode(node, "unexp_unsat", 0, &name)) {
+        addNode(UNEXPLORED_UNSAT, name);
+    }
 
+    mNodeCounter++;
     addInEdge(name);
 }
 
 void TraceDisplay::visit(TraceUnexploredUnsolvable *node)
 {
-    QString name = QString("unexp_unsolvable_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
-    mHeaderUnexploredUnsolvable.append(name);
+    QString name;
+    if (declareNode(node, "unexp_unsolvable", 0, &name)) {
+        addNode(UNEXPLORED_UNSOLVABLE, name);
+    }
 
+    mNodeCounter++;
     addInEdge(name);
 }
 
 void TraceDisplay::visit(TraceUnexploredMissed *node)
 {
-    QString name = QString("unexp_missed_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
-    mHeaderUnexploredMissed.append(name);
+    QString name;
+    if (declareNode(node, "unexp_missed", 0, &name)) {
+        addNode(UNEXPLORED_MISSED, name);
+    }
 
+    mNodeCounter++;
     addInEdge(name);
 }
 
 void TraceDisplay::visit(TraceUnexploredQueued *node)
 {
-    QString name = QString("unexp_queued_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
-    mHeaderUnexploredQueued.append(name);
+    QString name;
+    if (declareNode(node, "unexp_queued", 0, &name)) {
+        addNode(UNEXPLORED_QUEUED, name);
+    }
 
+    mNodeCounter++;
     addInEdge(name);
 }
 
 
 void TraceDisplay::visit(TraceAlert *node)
 {
-    QString name = QString("alt_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
-    QString message = node->message;
-    message.replace('\"', "\\\"");
-    message.replace('\n', "\\n");
-    QString nodeDecl = QString("%1 [label = \"Alert\\n\\\"%2\\\"\"]").arg(name).arg(message);
-    mHeaderAlerts.append(nodeDecl);
+    QString name;
+    if (declareNode(node, "alt", 0, &name)) {
+        QString message = node->message;
+        message.replace('\"', "\\\"");
+        message.replace('\n', "\\n");
+        QString nodeDecl = QString("%1 [label = \"Alert\\n\\\"%2\\\"\"]").arg(name).arg(message);
+        addNode(ALERTS, nodeDecl);
+    }
 
+    mNodeCounter++;
     addInEdge(name);
 
-    mPreviousNode = name;
-    mEdgeExtras = "";
-    node->next->accept(this);
+    visitChild(name, node->next, "", 0);
 }
 
 void TraceDisplay::visit(TraceConsoleMessage *node)
 {
     // TODO: For simplicity I am treating these as alerts in the tree output.
 
-    QString name = QString("cm_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
-    QString message = node->message;
-    message.replace('\"', "\\\"");
-    message.replace('\n', "\\n");
-    QString nodeDecl = QString("%1 [label = \"Console message:\\n\\\"%2\\\"\"]").arg(name).arg(message);
-    mHeaderAlerts.append(nodeDecl);
+    QString name;
+    if (declareNode(node, "cm", 0, &name)) {
+        QString message = node->message;
+        message.replace('\"', "\\\"");
+        message.replace('\n', "\\n");
+        QString nodeDecl = QString("%1 [label = \"Console message:\\n\\\"%2\\\"\"]").arg(name).arg(message);
+        addNode(ALERTS, nodeDecl);
+    }
 
+    mNodeCounter++;
     addInEdge(name);
 
-    mPreviousNode = name;
-    mEdgeExtras = "";
-    node->next->accept(this);
+    visitChild(name, node->next, "", 0);
 }
 
 
 void TraceDisplay::visit(TraceDomModification *node)
 {
-    QString name = QString("dom_%1").arg(mNodeCounter);
-    mNodeCounter++;
+    QString name;
+    if (declareNode(node, "dom", 0, &name)) {
+        QString wordList = (node->words.size() > 0 ? "\\nIndicator words:" : "");
+        foreach(QString word, node->words.keys()){
+            wordList += QString("\\n%1: %2").arg(word).arg(node->words.value(word));
+        }
 
-    QString wordList = (node->words.size() > 0 ? "\\nIndicator words:" : "");
-    QString word;
-    int count;
-    foreach(int index, node->words.keys()){
-        word = TraceDomModDetector::indicators.at(index);
-        count = node->words.value(index);
-        wordList += QString("\\n%1: %2").arg(word).arg(count);
+        QString nodeDecl = QString("%1 [label = \"DOM Modified: %2% %3\"]").arg(name).arg(node->amountModified).arg(wordList);
+        addNode(DOM_MODS, nodeDecl);
     }
 
-    QString nodeDecl = QString("%1 [label = \"DOM Modified: %2% %3\"]").arg(name).arg(node->amountModified).arg(wordList);
-    mHeaderDomMods.append(nodeDecl);
-
+    mNodeCounter++;
     addInEdge(name);
 
-    mPreviousNode = name;
-    mEdgeExtras = "";
-
-    node->next->accept(this);
+    visitChild(name, node->next, "", 0);
 }
 
 
 void TraceDisplay::visit(TracePageLoad *node)
 {
-    QString name = QString("load_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
-    QString nodeDecl = QString("%1 [label = \"Page Load:\\n%2\"]").arg(name).arg(node->url.toString());
-    mHeaderLoads.append(nodeDecl);
+    QString name;
+    if (declareNode(node, "load", 0, &name)) {
+        QString nodeDecl = QString("%1 [label = \"Page Load:\\n%2\"]").arg(name).arg(node->url.toString());
+        addNode(LOADS, nodeDecl);
+    }
 
+    mNodeCounter++;
     addInEdge(name);
 
-    mPreviousNode = name;
-    mEdgeExtras = "";
-    node->next->accept(this);
+    visitChild(name, node->next, "", 0);
 }
 
 
 void TraceDisplay::visit(TraceMarker *node)
 {
-    QString name = QString("marker_%1").arg(mNodeCounter);
-    mNodeCounter++;
+    QString name;
+    if (declareNode(node, "marker", 0, &name)) {
+        QString nodeLabel;
+        if(node->index == "B") {
+            nodeLabel = node->label;
+        } else {
+            nodeLabel = node->index + ": " + node->label;
+        }
 
-    QString nodeLabel;
-    if(node->index == "B") {
-        nodeLabel = node->label;
-    } else {
-        nodeLabel = node->index + ": " + node->label;
+        QString nodeDecl = QString("%1 [label = \"%2\"]").arg(name, nodeLabel);
+        addMarkerNode(node->index, nodeDecl);
     }
 
-    QString nodeDecl = QString("%1 [label = \"%2\"]").arg(name, nodeLabel);
-    mHeaderMarkers.insert(node->index, nodeDecl);
-
+    mNodeCounter++;
     addInEdge(name);
 
-    mPreviousNode = name;
-    mEdgeExtras = "";
-    node->next->accept(this);
+    visitChild(name, node->next, "", 0);
 }
 
 
 void TraceDisplay::visit(TraceFunctionCall *node)
 {
-    QString name = QString("fun_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
-    QString funcName = node->name.isEmpty() ? "(anonymous)" : (node->name + "()");
-    QString nodeDecl = QString("%1 [label = \"%2\"]").arg(name).arg(funcName);
-    mHeaderFunctions.append(nodeDecl);
+    QString name;
+    if (declareNode(node, "fun", 0, &name)) {
+        QString funcName = node->name.isEmpty() ? "(anonymous)" : (node->name + "()");
+        QString nodeDecl = QString("%1 [label = \"%2\"]").arg(name).arg(funcName);
+        addNode(FUNCTIONS, nodeDecl);
+    }
 
+    mNodeCounter++;
     addInEdge(name);
 
-    mPreviousNode = name;
-    mEdgeExtras = "";
-
-    node->next->accept(this);
+    visitChild(name, node->next, "", 0);
 }
 
 
 void TraceDisplay::visit(TraceConcreteSummarisation *node)
 {
-    QString name = QString("aggr_%1").arg(mNodeCounter);
-    mNodeCounter++;
+    // The summary is extended with new executions, which changes the label.
+    QString name;
+    if (declareNode(node, "aggr", node->executions.length(), &name)) {
+        QStringList executionStats;
+        QList<int> functions = node->numFunctions();
+        QList<int> branches = node->numBranches();
+        for(int i = 0; i < node->executions.length(); i++) {
+            executionStats.append(QString("\\n Branches: %2  \\n Function Calls: %3  \\n").arg(branches[i]).arg(functions[i]));
+        }
 
-    QStringList executionStats;
-    QList<int> functions = node->numFunctions();
-    QList<int> branches = node->numBranches();
-    for(int i = 0; i < node->executions.length(); i++) {
-        executionStats.append(QString("\\n Branches: %2  \\n Function Calls: %3  \\n").arg(branches[i]).arg(functions[i]));
+        QString nodeDecl = QString("%1 [label = \"\\n Concrete Execution %2 \"]").arg(name).arg(executionStats.join("---"));
+        addNode(AGGREGATES, nodeDecl);
     }
 
-    QString nodeDecl = QString("%1 [label = \"\\n Concrete Execution %2 \"]").arg(name).arg(executionStats.join("---"));
-    mHeaderAggregates.append(nodeDecl);
-
+    mNodeCounter++;
     addInEdge(name);
 
-    foreach(TraceConcreteSummarisation::SingleExecution execution, node->executions) {
-        mPreviousNode = name;
-        mEdgeExtras = "";
-
-        execution.second->accept(this);
+    for(int i = 0; i < node->executions.length(); i++) {
+        visitChild(name, node->executions.at(i).second, "", i);
     }
 }
 
 
 void TraceDisplay::visit(TraceEndSuccess *node)
 {
-    QString name = QString("end_s_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
-    QStringList indices;
-    QList<uint> sorted = node->traceIndices.toList();
-    qSort(sorted);
-    foreach(uint idx, sorted) {
-        indices.append(QString::number(idx));
-    }
+    // The trace indices are extended when later traces end at the same node.
+    QString name;
+    if (declareNode(node, "end_s", node->traceIndices.size(), &name)) {
+        QStringList indices;
+        QList<uint> sorted = node->traceIndices.toList();
+        qSort(sorted);
+        foreach(uint idx, sorted) {
+            indices.append(QString::number(idx));
+        }
 
-    QString nodeDecl;
-    if(mShowExplorationIndices) {
-        nodeDecl = QString("%1 [xlabel = \"%2\"]").arg(name).arg(indices.join(", "));
-    } else {
-        nodeDecl = name;
+        QString nodeDecl;
+        if(mShowExplorationIndices) {
+            nodeDecl = QString("%1 [xlabel = \"%2\"]").arg(name).arg(indices.join(", "));
+        } else {
+            nodeDecl = name;
+        }
+        addNode(END_SUCC, nodeDecl);
     }
-    mHeaderEndSucc.append(nodeDecl);
 
+    mNodeCounter++;
     addInEdge(name);
 
     if(mPassThroughEndMarkers){
-        mPreviousNode = name;
-        mEdgeExtras = "";
-        node->next->accept(this);
+        visitChild(name, node->next, "", 0);
     }
 }
 
 
 void TraceDisplay::visit(TraceEndFailure *node)
 {
-    QString name = QString("end_f_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
-    QStringList indices;
-    QList<uint> sorted = node->traceIndices.toList();
-    qSort(sorted);
-    foreach(uint idx, sorted) {
-        indices.append(QString::number(idx));
-    }
+    QString name;
+    if (declareNode(node, "end_f", node->traceIndices.size(), &name)) {
+        QStringList indices;
+        QList<uint> sorted = node->traceIndices.toList();
+        qSort(sorted);
+        foreach(uint idx, sorted) {
+            indices.append(QString::number(idx));
+        }
 
-    QString nodeDecl;
-    if(mShowExplorationIndices) {
-        nodeDecl = QString("%1 [xlabel = \"%2\"]").arg(name).arg(indices.join(", "));
-    } else {
-        nodeDecl = name;
+        QString nodeDecl;
+        if(mShowExplorationIndices) {
+            nodeDecl = QString("%1 [xlabel = \"%2\"]").arg(name).arg(indices.join(", "));
+        } else {
+            nodeDecl = name;
+        }
+        addNode(END_FAIL, nodeDecl);
     }
-    mHeaderEndFail.append(nodeDecl);
 
+    mNodeCounter++;
     addInEdge(name);
 
     if(mPassThroughEndMarkers){
-        mPreviousNode = name;
-        mEdgeExtras = "";
-        node->next->accept(this);
+        visitChild(name, node->next, "", 0);
     }
 }
 
 
 void TraceDisplay::visit(TraceEndUnknown *node)
 {
-    QString name = QString("end_u_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
-    QStringList indices;
-    QList<uint> sorted = node->traceIndices.toList();
-    qSort(sorted);
-    foreach(uint idx, sorted) {
-        indices.append(QString::number(idx));
-    }
+    QString name;
+    if (declareNode(node, "end_u", node->traceIndices.size(), &name)) {
+        QStringList indices;
+        QList<uint> sorted = node->traceIndices.toList();
+        qSort(sorted);
+        foreach(uint idx, sorted) {
+            indices.append(QString::number(idx));
+        }
 
-    QString nodeDecl;
-    if(mShowExplorationIndices) {
-        nodeDecl = QString("%1 [xlabel = \"%2\"]").arg(name).arg(indices.join(", "));
-    } else {
-        nodeDecl = name;
+        QString nodeDecl;
+        if(mShowExplorationIndices) {
+            nodeDecl = QString("%1 [xlabel = \"%2\"]").arg(name).arg(indices.join(", "));
+        } else {
+            nodeDecl = name;
+        }
+        addNode(END_UNK, nodeDecl);
     }
-    mHeaderEndUnk.append(nodeDecl);
 
+    mNodeCounter++;
     addInEdge(name);
 }
 
 void TraceDisplay::visit(TraceDivergence* node)
 {
-    QString name = QString("diverge_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
-    mHeaderDivergences.append(name);
+    QString name;
+    if (declareNode(node, "diverge", 0, &name)) {
+        addNode(DIVERGENCES, name);
+    }
 
+    mNodeCounter++;
     addInEdge(name);
 
     // Main child
-    mPreviousNode = name;
-    mEdgeExtras = "";
-    node->next->accept(this);
+    visitChild(name, node->next, "", 0);
 
     // Divergent traces
-    foreach (TraceNodePtr child, node->divergedTraces) {
-        mPreviousNode = name;
-        mEdgeExtras = "[color = gray]";
-        child->accept(this);
+    for (int i = 0; i < node->divergedTraces.length(); i++) {
+        visitChild(name, node->divergedTraces.at(i), "[color = gray]", i + 1);
     }
 }
 
+// A spilled subtree never changes, so the graph log only loads it the first time the placeholder is seen.
+// The placeholder itself is not part of the graph, so it is tracked separately from the named nodes.
+void TraceDisplay::visit(TraceSpilled* node)
+{
+    if (mAppendingLog) {
+        QHash<TraceNode*, QWeakPointer<TraceNode> >::iterator logged = mLoggedSpilled.find(node);
+        if (logged != mLoggedSpilled.end() && logged->toStrongRef().data() == node) {
+            return;
+        }
+
+        if (mVisiting.data() == node) {
+            mLoggedSpilled.insert(node, mVisiting.toWeakRef());
+        }
+    }
+
+    visitPassThrough(node->load());
+}
+
 
 
 
@@ -682,14 +841,26 @@ void TraceDisplay::clearData()
 
     mPreviousNode = "start";
     mEdgeExtras = mShowExplorationIndices ? "[xlabel = \"1\"]" : "";
+    mEdgeSlot = 0;
     mNodeCounter = 0;
 
     mExpressionPrinter->clear();
 }
 
-// Adds a new edge to mEdges.
+// Adds a new edge to mEdges, or to the graph log if it has changed.
 void TraceDisplay::addInEdge(QString endpoint)
 {
+    if (mAppendingLog) {
+        QPair<QString, uint> slot(mPreviousNode, mEdgeSlot);
+        QString edge = endpoint + "\t" + mEdgeExtras;
+        QHash<QPair<QString, uint>, QString>::iterator logged = mLoggedEdges.find(slot);
+        if (logged == mLoggedEdges.end() || *logged != edge) {
+            mLog << "edge\t" << mPreviousNode << "\t" << mEdgeSlot << "\t" << endpoint << "\t" << escapeLogField(mEdgeExtras) << "\n";
+            mLoggedEdges.insert(slot, edge);
+        }
+        return;
+    }
+
     QString edge = QString("%1 -> %2").arg(mPreviousNode).arg(endpoint);
     if(!mEdgeExtras.isEmpty()){
         edge += " " + mEdgeExtras;
@@ -697,6 +868,212 @@ void TraceDisplay::addInEdge(QString endpoint)
     mEdges.append(edge);
 }
 
+bool TraceDisplay::declareNode(TraceNode* node, QString prefix, uint state, QString* name)
+{
+    if (!mAppendingLog) {
+        *name = QString("%1_%2").arg(prefix).arg(mNodeCounter);
+        return true;
+    }
+
+    // Nodes keep their name for as long as they stay in the same slot, so later updates can refer to them.
+    QPair<QString, uint> slot(mPreviousNode, mEdgeSlot);
+    QHash<QPair<QString, uint>, LoggedNode>::iterator logged = mLoggedNodes.find(slot);
+    if (logged != mLoggedNodes.end() && logged->node.toStrongRef().data() == node) {
+        *name = logged->name;
+        if (logged->state == state) {
+            return false;
+        }
+        logged->state = state;
+        return true;
+    }
+
+    LoggedNode entry;
+    entry.node = mVisiting.data() == node ? mVisiting.toWeakRef() : QWeakPointer<TraceNode>();
+    entry.name = QString("%1_%2").arg(prefix).arg(mLogNodeCounter);
+    entry.state = state;
+    mLogNodeCounter++;
+
+    // Without a pointer to check against, the node is declared again on every update rather than risk a stale name.
+    if (!entry.node.isNull()) {
+        mLoggedNodes.insert(slot, entry);
+    }
+
+    *name = entry.name;
+    return true;
+}
+
+void TraceDisplay::addNode(NodeGroup group, QString declaration)
+{
+    if (mAppendingLog) {
+        mLog << "node\t" << groupName(group) << "\t" << escapeLogField(declaration) << "\n";
+        return;
+    }
+
+    switch (group) {
+    case BRANCHES:
+        mHeaderBranches.append(declaration);
+        break;
+    case SYM_BRANCHES:
+        mHeaderSymBranches.append(declaration);
+        break;
+    case UNEXPLORED:
+        mHeaderUnexplored.append(declaration);
+        break;
+    case UNEXPLORED_UNSAT:
+        mHeaderUnexploredUnsat.append(declaration);
+        break;
+    case UNEXPLORED_UNSOLVABLE:
+        mHeaderUnexploredUnsolvable.append(declaration);
+        break;
+    case UNEXPLORED_MISSED:
+        mHeaderUnexploredMissed.append(declaration);
+        break;
+    case UNEXPLORED_QUEUED:
+        mHeaderUnexploredQueued.append(declaration);
+        break;
+    case ALERTS:
+        mHeaderAlerts.append(declaration);
+        break;
+    case DOM_MODS:
+        mHeaderDomMods.append(declaration);
+        break;
+    case LOADS:
+        mHeaderLoads.append(declaration);
+        break;
+    case FUNCTIONS:
+        mHeaderFunctions.append(declaration);
+        break;
+    case END_SUCC:
+        mHeaderEndSucc.append(declaration);
+        break;
+    case END_FAIL:
+        mHeaderEndFail.append(declaration);
+        break;
+    case END_UNK:
+        mHeaderEndUnk.append(declaration);
+        break;
+    case AGGREGATES:
+        mHeaderAggregates.append(declaration);
+        break;
+    case DIVERGENCES:
+        mHeaderDivergences.append(declaration);
+        break;
+    }
+}
+
+void TraceDisplay::addMarkerNode(QString index, QString declaration)
+{
+    if (mAppendingLog) {
+        mLog << "marker\t" << escapeLogField(index) << "\t" << escapeLogField(declaration) << "\n";
+        return;
+    }
+
+    mHeaderMarkers.insert(index, declaration);
+}
+
+void TraceDisplay::visitChild(QString parent, TraceNodePtr child, QString edgeExtras, uint slot)
+{
+    mPreviousNode = parent;
+    mEdgeExtras = edgeExtras;
+    mEdgeSlot = slot;
+    visitPassThrough(child);
+}
+
+// The incoming edge is still the one for the skipped node, so the child takes its place in the graph.
+void TraceDisplay::visitPassThrough(TraceNodePtr child)
+{
+    mVisiting = child;
+    child->accept(this);
+}
+
+// The subgraph names, as used in makeGraph().
+QString TraceDisplay::groupName(NodeGroup group)
+{
+    switch (group) {
+    case BRANCHES:
+        return "branches";
+    case SYM_BRANCHES:
+        return "branches_sym";
+    case UNEXPLORED:
+        return "unexplored";
+    case UNEXPLORED_UNSAT:
+        return "unexplored_unsat";
+    case UNEXPLORED_UNSOLVABLE:
+        return "unexplored_unsolvable";
+    case UNEXPLORED_MISSED:
+        return "unexplored_missed";
+    case UNEXPLORED_QUEUED:
+        return "unexplored_queued";
+    case ALERTS:
+        return "alerts";
+    case DOM_MODS:
+        return "dom_mods";
+    case LOADS:
+        return "loads";
+    case FUNCTIONS:
+        return "functions";
+    case END_SUCC:
+        return "end_succ";
+    case END_FAIL:
+        return "end_fail";
+    case END_UNK:
+        return "end_unk";
+    case AGGREGATES:
+        return "aggregates";
+    case DIVERGENCES:
+        return "diverged";
+    }
+    return "";
+}
+
+QString TraceDisplay::groupStyle(NodeGroup group) const
+{
+    switch (group) {
+    case BRANCHES:
+        return mStyleBranches;
+    case SYM_BRANCHES:
+        return mStyleSymBranches;
+    case UNEXPLORED:
+        return mStyleUnexplored;
+    case UNEXPLORED_UNSAT:
+        return mStyleUnexploredUnsat;
+    case UNEXPLORED_UNSOLVABLE:
+        return mStyleUnexploredUnsolvable;
+    case UNEXPLORED_MISSED:
+        return mStyleUnexploredMissed;
+    case UNEXPLORED_QUEUED:
+        return mStyleUnexploredQueued;
+    case ALERTS:
+        return mStyleAlerts;
+    case DOM_MODS:
+        return mStyleDomMods;
+    case LOADS:
+        return mStyleLoads;
+    case FUNCTIONS:
+        return mStyleFunctions;
+    case END_SUCC:
+        return mStyleEndSucc;
+    case END_FAIL:
+        return mStyleEndFail;
+    case END_UNK:
+        return mStyleEndUnk;
+    case AGGREGATES:
+        return mStyleAggregates;
+    case DIVERGENCES:
+        return mStyleDivergences;
+    }
+    return "";
+}
+
+// Fields are tab-separated and events newline-separated, so those (and the escape character) are escaped.
+QString TraceDisplay::escapeLogField(QString field)
+{
+    field.replace("\\", "\\\\");
+    field.replace("\t", "\\t");
+    field.replace("\n", "\\n");
+    return field;
+}
+
 
 
 } //namespace artemis
@@ -22,6 +22,12 @@
 
 #include <QString>
 #include <QList>
+#include <QHash>
+#include <QSet>
+#include <QPair>
+#include <QFile>
+#include <QTextStream>
+#include <QWeakPointer>
 #include <QDateTime>
 
 
@@ -47,6 +53,14 @@ public:
     void writeGraphFile(TraceNodePtr tree, QString &pathToFile, QString title = QString());
     void writeGraphFile(TraceNodePtr tree, QString &pathToFile, bool autoName, QString title = QString());
 
+    // Incremental output.
+    // Instead of the whole graph, appendGraphLog() only writes the nodes and edges which were added or changed since
+    // the previous call to an append-only log. scripts/gvlog2gv.py turns the log into a .gv file for any iteration.
+    bool openGraphLog(QString pathToLog, QString title = QString());
+    void appendGraphLog(TraceNodePtr tree, uint iteration);
+    void closeGraphLog();
+    bool isGraphLogOpen() const;
+
     // The visitor methods over traces.
     // TODO: we could clean up this interface by putting these into an inner class.
     void visit(TraceNode* node); // Never called unless node types change.
@@ -68,8 +82,15 @@ public:
     void visit(TraceEndFailure* node);
     void visit(TraceEndUnknown* node);
     void visit(TraceDivergence* node);
+    void visit(TraceSpilled* node);
 
 protected:
+    // The node types, each of which becomes a separately styled subgraph. Markers are grouped by their index instead.
+    enum NodeGroup {
+        BRANCHES, SYM_BRANCHES, UNEXPLORED, UNEXPLORED_UNSAT, UNEXPLORED_UNSOLVABLE, UNEXPLORED_MISSED, UNEXPLORED_QUEUED,
+        ALERTS, DOM_MODS, LOADS, FUNCTIONS, END_SUCC, END_FAIL, END_UNK, AGGREGATES, DIVERGENCES
+    };
+
     // These lists contain the declarations of nodes which are to be put at the beginning of the file.
     // They include the node labels and any node-specific formatting.
     // Each type (e.g. branches) becomes a subgraph in the result which are styled separately.
@@ -94,10 +115,26 @@ protected:
     // The indent used when generating the output file.
     static QString indent;
 
+    // The slot of the edge being generated among the children of mPreviousNode (e.g. 0 for false, 1 for true).
+    uint mEdgeSlot;
+
     // Helpers
     void clearData();
     void addInEdge(QString endpoint);
 
+    // Names the node being visited. Returns false if its declaration is already in the graph log for the same slot and
+    // the node's state has not changed since, in which case the visitor does not need to build the declaration again.
+    bool declareNode(TraceNode* node, QString prefix, uint state, QString* name);
+    void addNode(NodeGroup group, QString declaration);
+    void addMarkerNode(QString index, QString declaration);
+
+    // Visit a child of the node 'parent', or continue with a child without showing the current node.
+    void visitChild(QString parent, TraceNodePtr child, QString edgeExtras, uint slot);
+    void visitPassThrough(TraceNodePtr child);
+
+    static QString groupName(NodeGroup group);
+    QString groupStyle(NodeGroup group) const;
+
     // Used to print any symbolic constraints.
     QSharedPointer<ExpressionPrinter> mExpressionPrinter;
 
@@ -116,6 +153,30 @@ protected:
 
     // Enable links to a coverage.html file
     bool mLinkToCoverage;
+
+    // State of the graph log, only used between openGraphLog() and closeGraphLog().
+    struct LoggedNode {
+        QWeakPointer<TraceNode> node; // Guards against a deleted node's address being reused.
+        QString name;
+        uint state;
+    };
+
+    QFile mLogFile;
+    QTextStream mLog;
+    // The nodes are keyed by the slot they are shown in, i.e. their parent's name and the edge slot. Shared nodes (e.g.
+    // the unexplored node singletons) appear in several slots, and makeGraph() shows each of them separately.
+    QHash<QPair<QString, uint>, LoggedNode> mLoggedNodes;
+    QHash<QPair<QString, uint>, QString> mLoggedEdges;
+    QHash<TraceNode*, QWeakPointer<TraceNode> > mLoggedSpilled;
+    uint mLogNodeCounter;
+    bool mAppendingLog;
+
+    void pruneGraphLog();
+
+    // The child currently being visited, so nodes can be identified across calls to appendGraphLog().
+    TraceNodePtr mVisiting;
+
+    static QString escapeLogField(QString field);
 };
 
 
@@ -134,9 +134,9 @@ TraceDisplayOverview::TraceDisplayOverview(bool linkToCoverage)
 /*
  *  The node visitor methods.
  *
- *  Each of these must compute its name, add this to the corresponding header list,
- *  add the incoming edge to the edges list, and if there are any children then set
- *  mPreviousNode and mEdgeExtras and then process them.
+ *  Each of these must compute its name with declareNode(), add its declaration with addNode()
+ *  (unless declareNode() says it is already in the graph log), add the incoming edge with
+ *  addInEdge(), and if there are any children then process them with visitChild().
  *
  *  However, note that in overview mode we will be "skipping" certain nodes.
  */
@@ -145,31 +145,27 @@ TraceDisplayOverview::TraceDisplayOverview(bool linkToCoverage)
 
 void TraceDisplayOverview::visit(TraceConcreteBranch *node)
 {
-    QString name = QString("br_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
     // If both branches are explored, we want to show them. Otherwise they are skipped.
     if(!isImmediatelyUnexplored(node->getFalseBranch()) && !isImmediatelyUnexplored(node->getTrueBranch())){
         // Show the branch.
-        mHeaderBranches.append(name);
+        QString name;
+        if (declareNode(node, "br", 0, &name)) {
+            addNode(BRANCHES, name);
+        }
+        mNodeCounter++;
         addInEdge(name);
 
         // Process the children (false/left first).
-        mPreviousNode = name;
-        mEdgeExtras = "[color = red]";
-        node->getFalseBranch()->accept(this);
-
-        mPreviousNode = name;
-        mEdgeExtras = "[color = darkgreen]";
-        node->getTrueBranch()->accept(this);
+        visitChild(name, node->getFalseBranch(), "[color = red]", 0);
+        visitChild(name, node->getTrueBranch(), "[color = darkgreen]", 1);
 
     }else if(isImmediatelyUnexplored(node->getFalseBranch()) && !isImmediatelyUnexplored(node->getTrueBranch())){
         // Skip this node and continue on true branch.
-        node->getTrueBranch()->accept(this);
+        visitPassThrough(node->getTrueBranch());
 
     }else if(!isImmediatelyUnexplored(node->getFalseBranch()) && isImmediatelyUnexplored(node->getTrueBranch())){
         // Skip this node and continue on false branch.
-        node->getFalseBranch()->accept(this);
+        visitPassThrough(node->getFalseBranch());
 
     }else{
         // No children explored... this is an error.
@@ -181,52 +177,52 @@ void TraceDisplayOverview::visit(TraceConcreteBranch *node)
 
 void TraceDisplayOverview::visit(TraceSymbolicBranch *node)
 {
-    QString name = QString("sym_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
     // We always show symbolic brnaches, but we no longer need to find their conditions, etc.
 
-    std::stringstream sourceId;
-    sourceId << SourceInfo::getId(node->getSource()->getUrl(), node->getSource()->getStartLine());
+    QString name;
+    if (declareNode(node, "sym", node->isDifficult(), &name)) {
+        std::stringstream sourceId;
+        sourceId << SourceInfo::getId(node->getSource()->getUrl(), node->getSource()->getStartLine());
 
-    std::stringstream sourceLine;
-    sourceLine << node->getLinenumber();
+        std::stringstream sourceLine;
+        sourceLine << node->getLinenumber();
 
-    QString source = "#";
-    if (mLinkToCoverage) {
-        source = QString("coverage.html?code=ID%1&amp;line=%2").arg(
-                    QString::fromStdString(sourceId.str()),
-                    QString::fromStdString(sourceLine.str()));
-    }
+        QString source = "#";
+        if (mLinkToCoverage) {
+            source = QString("coverage.html?code=ID%1&amp;line=%2").arg(
+                        QString::fromStdString(sourceId.str()),
+                        QString::fromStdString(sourceLine.str()));
+        }
 
-    QString difficult = "";
-    if(node->isDifficult()) {
-        difficult = "fillcolor = blue, ";
-    }
+        QString difficult = "";
+        if(node->isDifficult()) {
+            difficult = "fillcolor = blue, ";
+        }
 
-    QString label = QString(" [%1URL = \"%2\"]").arg(difficult, source);
+        QString label = QString(" [%1URL = \"%2\"]").arg(difficult, source);
 
-    mHeaderSymBranches.append(name + label);
+        addNode(SYM_BRANCHES, name + label);
+    }
+    mNodeCounter++;
     addInEdge(name);
 
     // Childeren are displayed in the tree in the order they are specified in the edges list.
     // We want false branches on the left, so process those first.
 
+    QString extras;
     if(mShowExplorationIndices && node->getExplorationIndex() > 0 && node->getExplorationDirection() == false) {
-        mEdgeExtras = QString("[color = red, xlabel = \"%1\"]").arg(node->getExplorationIndex());
+        extras = QString("[color = red, xlabel = \"%1\"]").arg(node->getExplorationIndex());
     } else {
-        mEdgeExtras = "[color = red]";
+        extras = "[color = red]";
     }
-    mPreviousNode = name;
-    node->getFalseBranch()->accept(this);
+    visitChild(name, node->getFalseBranch(), extras, 0);
 
     if(mShowExplorationIndices && node->getExplorationIndex() > 0 && node->getExplorationDirection() == true) {
-        mEdgeExtras = QString("[color = darkgreen, xlabel = \"%1\"]").arg(node->getExplorationIndex());
+        extras = QString("[color = darkgreen, xlabel = \"%1\"]").arg(node->getExplorationIndex());
     } else {
-        mEdgeExtras = "[color = darkgreen]";
+        extras = "[color = darkgreen]";
     }
-    mPreviousNode = name;
-    node->getTrueBranch()->accept(this);
+    visitChild(name, node->getTrueBranch(), extras, 1);
 }
 
 
@@ -234,87 +230,83 @@ void TraceDisplayOverview::visit(TraceSymbolicBranch *node)
 
 void TraceDisplayOverview::visit(TraceAlert *node)
 {
-    QString name = QString("alt_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
     // Always show alerts, but no longer include messages.
-    mHeaderAlerts.append(name);
+    QString name;
+    if (declareNode(node, "alt", 0, &name)) {
+        addNode(ALERTS, name);
+    }
+    mNodeCounter++;
     addInEdge(name);
 
-    mPreviousNode = name;
-    mEdgeExtras = "";
-    node->next->accept(this);
+    visitChild(name, node->next, "", 0);
 }
 
 void TraceDisplayOverview::visit(TraceConsoleMessage *node)
 {
     // TODO: For simplicity I am treating these as alerts in the tree output.
 
-    QString name = QString("cm_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
     // Always show console messages, but no longer include messages.
-    mHeaderAlerts.append(name);
+    QString name;
+    if (declareNode(node, "cm", 0, &name)) {
+        addNode(ALERTS, name);
+    }
+    mNodeCounter++;
     addInEdge(name);
 
-    mPreviousNode = name;
-    mEdgeExtras = "";
-    node->next->accept(this);
+    visitChild(name, node->next, "", 0);
 }
 
 
 void TraceDisplayOverview::visit(TraceDomModification *node)
 {
     if(node->words.size() > 0){
-        QString name = QString("dom_%1").arg(mNodeCounter);
+        QString name;
+        if (declareNode(node, "dom", 0, &name)) {
+            addNode(DOM_MODS, name);
+        }
         mNodeCounter++;
-
-        mHeaderDomMods.append(name);
         addInEdge(name);
 
-        mPreviousNode = name;
-        mEdgeExtras = "";
+        visitChild(name, node->next, "", 0);
+    } else {
+        visitPassThrough(node->next);
     }
-
-    node->next->accept(this);
 }
 
 
 void TraceDisplayOverview::visit(TracePageLoad *node)
 {
-    QString name = QString("load_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
     // Always show loads, but no longer show messages.
-    mHeaderLoads.append(name);
+    QString name;
+    if (declareNode(node, "load", 0, &name)) {
+        addNode(LOADS, name);
+    }
+    mNodeCounter++;
     addInEdge(name);
 
-    mPreviousNode = name;
-    mEdgeExtras = "";
-    node->next->accept(this);
+    visitChild(name, node->next, "", 0);
 }
 
 
 void TraceDisplayOverview::visit(TraceMarker *node)
 {
-    QString name = QString("marker_%1").arg(mNodeCounter);
-    mNodeCounter++;
-
     // Always show markers, but only show the index as the label.
-    mHeaderMarkers.insert(node->index, name);
+    QString name;
+    if (declareNode(node, "marker", 0, &name)) {
+        addMarkerNode(node->index, name);
+    }
 
+    mNodeCounter++;
     addInEdge(name);
 
-    mPreviousNode = name;
-    mEdgeExtras = "";
-    node->next->accept(this);
+    visitChild(name, node->next, "", 0);
 }
 
 
 void TraceDisplayOverview::visit(TraceFunctionCall *node)
 {
     // Skip these nodes.
-    node->next->accept(this);
+    visitPassThrough(node->next);
 }
 
 
@@ -322,21 +314,19 @@ void TraceDisplayOverview::visit(TraceConcreteSummarisation *node)
 {
     // If there are multiple children then branch, but otherwise ignore.
     if(node->executions.length() == 1) {
-        node->executions[0].second->accept(this);
+        visitPassThrough(node->executions[0].second);
     } else if(node->executions.length() > 1) {
 
-        QString name = QString("aggr_%1").arg(mNodeCounter);
-        mNodeCounter++;
-
-        mHeaderAggregates.append(name);
+        QString name;
+        if (declareNode(node, "aggr", 0, &name)) {
+            addNode(AGGREGATES, name);
+        }
 
+        mNodeCounter++;
         addInEdge(name);
 
-        foreach(TraceConcreteSummarisation::SingleExecution execution, node->executions) {
-            mPreviousNode = name;
-            mEdgeExtras = "";
-
-            execution.second->accept(this);
+        for(int i = 0; i < node->executions.length(); i++) {
+            visitChild(name, node->executions.at(i).second, "", i);
         }
     }
 }
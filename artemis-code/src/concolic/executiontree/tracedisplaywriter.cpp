@@ -0,0 +1,119 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <QFile>
+
+#include "util/loggingutil.h"
+#include "statistics/statsstorage.h"
+
+#include "tracedisplaywriter.h"
+
+namespace artemis
+{
+
+TraceDisplayWriter::TraceDisplayWriter(Options options)
+    : mOptions(options)
+    , mDisplay(options.outputCoverage != NONE)
+    , mDisplayOverview(options.outputCoverage != NONE)
+    , mUpdated(false)
+    , mLastIteration(0)
+{
+}
+
+void TraceDisplayWriter::open(QString logName, QString overviewLogName, QString title)
+{
+    if (mOptions.concolicTreeOutput == TREE_NONE) {
+        return;
+    }
+
+    mLogName = logName;
+    mDisplay.openGraphLog(mLogName, title);
+
+    if (mOptions.concolicTreeOutputOverview) {
+        mOverviewLogName = overviewLogName;
+        mDisplayOverview.openGraphLog(mOverviewLogName, title);
+    }
+
+    mUpdated = false;
+}
+
+// Appends the latest changes to the logs, unless the last update was less than one interval ago.
+void TraceDisplayWriter::update(TraceNodePtr tree, uint iteration)
+{
+    if (mOptions.concolicTreeOutput == TREE_NONE) {
+        return;
+    }
+
+    if (mUpdated) {
+        bool iterationBudget = mOptions.concolicTreeOutputIterations > 0 &&
+                iteration - mLastIteration < mOptions.concolicTreeOutputIterations;
+        bool timeBudget = mOptions.concolicTreeOutputSeconds > 0 &&
+                mLastUpdate.elapsed() < (qint64)mOptions.concolicTreeOutputSeconds * 1000;
+        if (iterationBudget || timeBudget) {
+            Statistics::statistics()->accumulate("Concolic::TreeOutput::SkippedUpdates", 1);
+            return;
+        }
+    }
+
+    append(tree, iteration);
+}
+
+void TraceDisplayWriter::finish(TraceNodePtr tree, uint iteration, QString graphName, QString overviewGraphName, QString title)
+{
+    if (mOptions.concolicTreeOutput == TREE_NONE) {
+        return;
+    }
+
+    // Complete the logs, so they also contain the final tree.
+    append(tree, iteration);
+    mDisplay.closeGraphLog();
+    mDisplayOverview.closeGraphLog();
+
+    if (!tree.isNull()) {
+        Log::debug(QString("CONCOLIC-INFO: Writing tree to file %1").arg(graphName).toStdString());
+        mDisplay.writeGraphFile(tree, graphName, false, title);
+        if (mOptions.concolicTreeOutputOverview) {
+            mDisplayOverview.writeGraphFile(tree, overviewGraphName, false, title);
+        }
+    }
+
+    // The logs are only needed to rebuild the intermediate trees.
+    if (mOptions.concolicTreeOutput == TREE_FINAL) {
+        QFile::remove(mLogName);
+        if (!mOverviewLogName.isEmpty()) {
+            QFile::remove(mOverviewLogName);
+        }
+    }
+}
+
+void TraceDisplayWriter::append(TraceNodePtr tree, uint iteration)
+{
+    if (tree.isNull()) {
+        return;
+    }
+
+    mDisplay.appendGraphLog(tree, iteration);
+    mDisplayOverview.appendGraphLog(tree, iteration);
+
+    mUpdated = true;
+    mLastIteration = iteration;
+    mLastUpdate.start();
+
+    Statistics::statistics()->accumulate("Concolic::TreeOutput::Updates", 1);
+}
+
+} // namespace artemis
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef TRACEDISPLAYWRITER_H
+#define TRACEDISPLAYWRITER_H
+
+#include <QString>
+#include <QElapsedTimer>
+
+#include "runtime/options.h"
+
+#include "tracedisplay.h"
+#include "tracedisplayoverview.h"
+
+namespace artemis
+{
+
+/**
+ * Writes the execution tree graphs of a concolic run, following the --concolic-tree-output options.
+ *
+ * While the analysis runs, only the changes to the tree are appended to a graph log (see TraceDisplay), at most once
+ * per --concolic-tree-output-interval. The log is flushed on every update, so there is always an up-to-date tree on
+ * disk. When the run is done the final tree is written as a .gv file, and the logs are removed unless the graphs of
+ * all iterations were requested (they can be rebuilt with scripts/gvlog2gv.py).
+ */
+class TraceDisplayWriter
+{
+public:
+    TraceDisplayWriter(Options options);
+
+    void open(QString logName, QString overviewLogName, QString title = QString());
+    void update(TraceNodePtr tree, uint iteration);
+    void finish(TraceNodePtr tree, uint iteration, QString graphName, QString overviewGraphName, QString title = QString());
+
+protected:
+    Options mOptions;
+
+    TraceDisplay mDisplay;
+    TraceDisplayOverview mDisplayOverview;
+    QString mLogName;
+    QString mOverviewLogName;
+
+    // Throttling of the updates.
+    bool mUpdated;
+    uint mLastIteration;
+    QElapsedTimer mLastUpdate;
+
+    void append(TraceNodePtr tree, uint iteration);
+};
+
+} // namespace artemis
+
+#endif // TRACEDISPLAYWRITER_H
@@ -26,22 +26,43 @@
 namespace artemis
 {
 
-TraceNodePtr TraceMerger::merge(TraceNodePtr trace, TraceNodePtr executiontree, TraceNodePtr* executionTreeRootPtr)
+// The index is pruned of nodes which are no longer in the tree once it has grown past this size (and then twice the
+// size after the last pruning).
+static const int PRUNE_INDEX_MIN_SIZE = 4096;
+
+TraceMerger::TraceMerger()
+    : QObject()
+    , mStartingTreeRootPtr(NULL)
+    , mPreviousDirection(0)
+    , mImmediateParentDirection(0)
+    , mMergingDivergence(false)
+    , mMergedIntoDivergence(false)
+    , mChangedTree(false)
+    , mPruneIndexAt(PRUNE_INDEX_MIN_SIZE)
+    , mDepth(0)
+    , mPrefixFingerprint(TracePath::EMPTY_PREFIX)
+{
+}
+
+TraceNodePtr TraceMerger::merge(TraceNodePtr trace, TraceNodePtr executiontree, TraceNodePtr* executionTreeRootPtr, TraceSymbolicBranchPtr target,
+                                const TracePath& path)
 {
     if (trace.isNull()) {
         return executiontree;
     }
 
     if (executiontree.isNull()) {
+        // A new tree, so any existing entries in the index belong to an old one.
+        mPrefixIndex.clear();
+        mChangedTree = true;
+        indexSuffix(trace, 0, TracePath::EMPTY_PREFIX);
         return trace; // replace the entire execution tree with the trace
         Statistics::statistics()->accumulate("Concolic::ExecutionTree::DistinctTracesExplored", 1);
     }
 
     mStartingTrace = trace;
     mStartingTreeRootPtr = executionTreeRootPtr;
-
-    mCurrentTrace = trace;
-    mCurrentTree = executiontree;
+    mRootResult = executiontree;
 
     mPreviousParent = TraceNodePtr();
     mPreviousDirection = 0;
@@ -50,10 +71,42 @@ TraceNodePtr TraceMerger::merge(TraceNodePtr trace, TraceNodePtr executiontree,
     mImmediateParentDirection = 0;
 
     mMergingDivergence = false;
+    mMergedIntoDivergence = false;
+    mChangedTree = false;
+
+    if (target.isNull() || !jumpToTarget(trace, target, path)) {
+        mCurrentTrace = trace;
+        mCurrentTree = executiontree;
+        mDepth = 0;
+        mPrefixFingerprint = TracePath::EMPTY_PREFIX;
+    }
+
+    // Each visit merges a single trace node and sets mNextTrace if the merge continues further down the trace.
+    while (!mCurrentTrace.isNull()) {
+        mNextTrace = TraceNodePtr();
+        mCurrentTrace->accept(this);
+        mCurrentTrace = mNextTrace;
+    }
+
+    mMergingDivergence = false;
+    if (mMergedIntoDivergence) {
+        mAlreadyMismatched.clear();
+    }
+
+    mCurrentTree = TraceNodePtr();
+    mPreviousParent = TraceNodePtr();
+    mImmediateParent = TraceNodePtr();
+
+    if (mPrefixIndex.size() > mPruneIndexAt) {
+        pruneIndex();
+    }
 
-    trace->accept(this);
+    return mRootResult;
+}
 
-    return mCurrentTree;
+bool TraceMerger::changedTree() const
+{
+    return mChangedTree;
 }
 
 void TraceMerger::visit(TraceUnexplored* node)
@@ -64,16 +117,11 @@ void TraceMerger::visit(TraceUnexplored* node)
 
 void TraceMerger::visit(TraceEnd* node)
 {
-    TraceDivergencePtr skipped = skipDivergenceNodesInTree();
+    skipDivergenceNodesInTree();
 
     // case: unexplored branch in the tree
     if (TraceVisitor::isImmediatelyUnexplored(mCurrentTree)) {
-
-        // Insert this trace directly into the tree and return
-        mCurrentTree = mCurrentTrace;
-        unSkipDivergenceNodesInTree(skipped);
-        Statistics::statistics()->accumulate("Concolic::ExecutionTree::DistinctTracesExplored", 1);
-        reportMerge(mCurrentTrace);
+        insertTrace();
         return;
     }
 
@@ -82,7 +130,6 @@ void TraceMerger::visit(TraceEnd* node)
         // Merge the exploration indices.
         TraceEndPtr treeEnd =  mCurrentTree.dynamicCast<TraceEnd>();
         treeEnd->traceIndices.unite(node->traceIndices);
-        unSkipDivergenceNodesInTree(skipped);
 
     } else {
         handleDivergence();
@@ -91,16 +138,11 @@ void TraceMerger::visit(TraceEnd* node)
 
 void TraceMerger::visit(TraceBranch* node)
 {
-    TraceDivergencePtr skipped = skipDivergenceNodesInTree();
+    skipDivergenceNodesInTree();
 
     // case: unexplored branch in the tree
     if (TraceVisitor::isImmediatelyUnexplored(mCurrentTree)) {
-
-        // Insert this trace directly into the tree and return
-        mCurrentTree = mCurrentTrace;
-        unSkipDivergenceNodesInTree(skipped);
-        Statistics::statistics()->accumulate("Concolic::ExecutionTree::DistinctTracesExplored", 1);
-        reportMerge(mCurrentTrace);
+        insertTrace();
         return;
     }
 
@@ -108,31 +150,28 @@ void TraceMerger::visit(TraceBranch* node)
     if (node->isEqualShallow(mCurrentTree)) {
 
         TraceBranchPtr treeBranch = mCurrentTree.dynamicCast<TraceBranch>();
+        indexTreeNode(treeBranch);
+
+        // A recorded trace only takes one direction at each branch, the other is unexplored and adds nothing.
+        bool traceTrue = !TraceVisitor::isImmediatelyUnexplored(node->getTrueBranch());
+        bool traceFalse = !TraceVisitor::isImmediatelyUnexplored(node->getFalseBranch());
+        assert(!(traceTrue && traceFalse));
+
+        if (traceTrue) {
+            mPreviousParent = treeBranch;
+            mPreviousDirection = 1;
+            mImmediateParent = treeBranch;
+            mImmediateParentDirection = 1;
+            descend(treeBranch->getTrueBranch(), node->getTrueBranch(), 1);
+
+        } else if (traceFalse) {
+            mPreviousParent = treeBranch;
+            mPreviousDirection = 0;
+            mImmediateParent = treeBranch;
+            mImmediateParentDirection = 0;
+            descend(treeBranch->getFalseBranch(), node->getFalseBranch(), 0);
+        }
 
-        // Merge the traces for each branch
-
-        mCurrentTree = treeBranch->getTrueBranch();
-        mCurrentTrace = node->getTrueBranch();
-        mPreviousParent = treeBranch;
-        mPreviousDirection = 1;
-        mImmediateParent = treeBranch;
-        mImmediateParentDirection = 1;
-        mCurrentTrace->accept(this);
-
-        treeBranch->setTrueBranch(mCurrentTree);
-
-        mCurrentTree = treeBranch->getFalseBranch();
-        mCurrentTrace = node->getFalseBranch();
-        mPreviousParent = treeBranch;
-        mPreviousDirection = 0;
-        mImmediateParent = treeBranch;
-        mImmediateParentDirection = 0;
-        mCurrentTrace->accept(this);
-
-        treeBranch->setFalseBranch(mCurrentTree);
-
-        mCurrentTree = treeBranch;
-        unSkipDivergenceNodesInTree(skipped);
         return;
     }
 
@@ -141,32 +180,20 @@ void TraceMerger::visit(TraceBranch* node)
 
 void TraceMerger::visit(TraceAnnotation* node)
 {
-    TraceDivergencePtr skipped = skipDivergenceNodesInTree();
+    skipDivergenceNodesInTree();
 
     // case: unexplored branch in the tree
     if (TraceVisitor::isImmediatelyUnexplored(mCurrentTree)) {
-
-        // Insert this trace directly into the tree and return
-        mCurrentTree = mCurrentTrace;
-        unSkipDivergenceNodesInTree(skipped);
-        Statistics::statistics()->accumulate("Concolic::ExecutionTree::DistinctTracesExplored", 1);
-        reportMerge(mCurrentTrace);
+        insertTrace();
         return;
     }
 
     if (node->isEqualShallow(mCurrentTree)) {
         TraceAnnotationPtr treeAnnotation = mCurrentTree.dynamicCast<TraceAnnotation>();
 
-        mCurrentTree = treeAnnotation->next;
-        mCurrentTrace = node->next;
         mImmediateParent = treeAnnotation;
         mImmediateParentDirection = 0;
-        mCurrentTrace->accept(this);
-
-        treeAnnotation->next = mCurrentTree;
-
-        mCurrentTree = treeAnnotation;
-        unSkipDivergenceNodesInTree(skipped);
+        descend(treeAnnotation->next, node->next, 0);
         return;
     }
 
@@ -176,16 +203,11 @@ void TraceMerger::visit(TraceAnnotation* node)
 
 void TraceMerger::visit(TraceConcreteSummarisation *node)
 {
-    TraceDivergencePtr skipped = skipDivergenceNodesInTree();
+    skipDivergenceNodesInTree();
 
     // case: unexplored branch in the tree
     if (TraceVisitor::isImmediatelyUnexplored(mCurrentTree)) {
-
-        // Insert this trace directly into the tree and return
-        mCurrentTree = mCurrentTrace;
-        unSkipDivergenceNodesInTree(skipped);
-        Statistics::statistics()->accumulate("Concolic::ExecutionTree::DistinctTracesExplored", 1);
-        reportMerge(mCurrentTrace);
+        insertTrace();
         return;
     }
 
@@ -217,18 +239,11 @@ void TraceMerger::visit(TraceConcreteSummarisation *node)
 
             // If the executions match exactly then merge the successor nodes and end.
             if(treeExec.first == traceExec.first) {
-                mCurrentTree = treeExec.second;
-                mCurrentTrace = traceExec.second;
                 mPreviousParent = treeSummary;
                 mPreviousDirection = idx;
                 mImmediateParent = treeSummary;
                 mImmediateParentDirection = idx;
-                mCurrentTrace->accept(this);
-
-                treeExec.second = mCurrentTree;
-
-                mCurrentTree = treeSummary;
-                unSkipDivergenceNodesInTree(skipped);
+                descend(treeExec.second, traceExec.second, 0);
                 return;
             }
 
@@ -270,8 +285,11 @@ void TraceMerger::visit(TraceConcreteSummarisation *node)
         // If we have checked each execution without finding a match or a divergence, then this is a valid new path.
         // Insert the new path into the tree and return.
         treeSummary->executions.append(traceExec);
+        mChangedTree = true;
         // mCurrentTree is not changed.
-        unSkipDivergenceNodesInTree(skipped);
+        if (!mMergingDivergence) {
+            indexSuffix(traceExec.second, mDepth + 1, TracePath::combine(TracePath::combine(mPrefixFingerprint, TracePath::shallowKey(mCurrentTrace)), 0));
+        }
         Statistics::statistics()->accumulate("Concolic::ExecutionTree::DistinctTracesExplored", 1);
         mPreviousParent = treeSummary;
         mPreviousDirection = treeSummary->executions.length()-1;
@@ -297,12 +315,44 @@ void TraceMerger::visit(TraceDivergence* node)
 }
 
 
+// Continue merging with the given child of the current trace node, against the given child of the current tree node.
+// The callers set mImmediateParent (and mPreviousParent for branch points) to the current tree node beforehand.
+void TraceMerger::descend(TraceNodePtr treeChild, TraceNodePtr traceChild, int traceDirection)
+{
+    mPrefixFingerprint = TracePath::combine(TracePath::combine(mPrefixFingerprint, TracePath::shallowKey(mCurrentTrace)), traceDirection);
+    mDepth++;
+
+    mCurrentTree = treeChild;
+    mNextTrace = traceChild;
+}
+
+// The tree is unexplored at this point, so the rest of the trace is inserted directly into the tree.
+void TraceMerger::insertTrace()
+{
+    if (mImmediateParent.isNull()) {
+        mRootResult = mCurrentTrace;
+    } else {
+        mImmediateParent->setChild(mImmediateParentDirection, mCurrentTrace);
+    }
+    mCurrentTree = mCurrentTrace;
+    mChangedTree = true;
+
+    if (!mMergingDivergence) {
+        indexSuffix(mCurrentTrace, mDepth, mPrefixFingerprint);
+    }
+
+    Statistics::statistics()->accumulate("Concolic::ExecutionTree::DistinctTracesExplored", 1);
+    reportMerge(mCurrentTrace);
+}
+
+
 // When we find a divergent merge, this function inserts the divergence node into the tree to record it.
 void TraceMerger::handleDivergence()
 {
     qWarning() << "Warning, divergance discovered while merging a trace!";
     Statistics::statistics()->accumulate("Concolic::ExecutionTree::DivergentMerges", 1);
     Log::info("  Trace merge diverged from the tree.");
+    mChangedTree = true;
 
     // Use mImmediateParent[Direction] and mCurrentTree to insert a new TraceDivergence into the tree.
 
@@ -320,43 +370,35 @@ void TraceMerger::handleDivergence()
         addDivergentTraceToNode(divergence, mCurrentTrace);
 
         mImmediateParent->setChild(mImmediateParentDirection, divergence); // Replaces the pointer to mCurrentTree with divercence in the immediate parent node.
-        mCurrentTree = divergence;
 
     } else {
         addDivergentTraceToNode(parentDivergence, mCurrentTrace);
-        mCurrentTree = parentDivergence;
     }
 }
 
 void TraceMerger::addDivergentTraceToNode(TraceDivergencePtr node, TraceNodePtr trace)
 {
     // Try to merge this trace with one of the existing divergent traces, if possible.
-    // If there is an existing divergence with a matching head node, then just recursively merge the traces as normal.
+    // If there is an existing divergence with a matching head node, then merge the traces as normal from there on
+    // (the main loop in merge() continues with the same trace node against the head).
     // Otherwise just append the new trace to the list of divergences.
 
-    bool matched = false;
     foreach (TraceNodePtr head, node->divergedTraces) {
         if (!mAlreadyMismatched.contains(head) && trace->isEqualShallow(head)) {
             mMergingDivergence = true;
+            mMergedIntoDivergence = true;
 
             mCurrentTree = head;
-            mCurrentTrace = trace;
+            mNextTrace = trace;
             // mPreviousParent, mPreviousDirection as before.
             mImmediateParent = node;
-            mImmediateParentDirection = node->divergedTraces.indexOf(head);
+            mImmediateParentDirection = node->divergedTraces.indexOf(head) + 1; // See TraceDivergence::setChild.
 
-            mCurrentTrace->accept(this);
-
-            mMergingDivergence = false;
-
-            matched = true;
-            mAlreadyMismatched.clear();
-            break;
+            return;
         }
     }
-    if (!matched) {
-        node->divergedTraces.append(trace);
-    }
+
+    node->divergedTraces.append(trace);
 }
 
 void TraceMerger::handleDivergenceAtRoot()
@@ -370,14 +412,16 @@ void TraceMerger::handleDivergenceAtRoot()
     addDivergentTraceToNode(divergence, mCurrentTrace); // Same as mStartingTrace here.
 
     *mStartingTreeRootPtr = divergence;
-    mCurrentTree = divergence;
+    mRootResult = divergence;
 }
 
-TraceDivergencePtr TraceMerger::skipDivergenceNodesInTree()
+void TraceMerger::skipDivergenceNodesInTree()
 {
+    loadSpilledTree();
+
     TraceDivergencePtr head = mCurrentTree.dynamicCast<TraceDivergence>();
     if (head.isNull()) {
-        return TraceDivergencePtr();
+        return;
     }
 
     // Sanity check for more than one divergence in a row.
@@ -392,14 +436,26 @@ TraceDivergencePtr TraceMerger::skipDivergenceNodesInTree()
     mImmediateParentDirection = 0;
     mCurrentTree = head->next;
 
-    return head;
+    loadSpilledTree();
 }
 
-void TraceMerger::unSkipDivergenceNodesInTree(TraceDivergencePtr node)
+// If the tree continues in a spilled subtree, it is loaded and put back in place of the placeholder before merging.
+void TraceMerger::loadSpilledTree()
 {
-    if (!node.isNull()) {
-        mCurrentTree = node;
+    TraceSpilledPtr spilled = mCurrentTree.dynamicCast<TraceSpilled>();
+    if (spilled.isNull()) {
+        return;
+    }
+
+    mCurrentTree = spilled->load();
+
+    if (mImmediateParent.isNull()) {
+        mRootResult = mCurrentTree;
+    } else {
+        mImmediateParent->setChild(mImmediateParentDirection, mCurrentTree);
     }
+
+    Statistics::statistics()->accumulate("Concolic::ExecutionTree::SpilledSubtreesRestored", 1);
 }
 
 // When we merge a trace, trigger the signals.
@@ -411,7 +467,92 @@ void TraceMerger::reportMerge(TraceNodePtr newPart)
     }
 }
 
+// Skips the part of the merge above the target branch if the trace is known to match the tree there.
+// Returns false (and leaves the merge state untouched) if the merge must start from the root.
+bool TraceMerger::jumpToTarget(TraceNodePtr trace, TraceSymbolicBranchPtr target, const TracePath& path)
+{
+    QHash<TraceNode*, PrefixEntry>::const_iterator entry = mPrefixIndex.constFind(target.data());
+    if (entry == mPrefixIndex.constEnd() || entry->node.toStrongRef().data() != target.data() ||
+            entry->depth >= path.length() || path.nodeAt(0) != trace) {
+        Statistics::statistics()->accumulate("Concolic::ExecutionTree::MergeFromRoot", 1);
+        return false;
+    }
 
+    // The recorded path gives the trace node at the depth of the target and the fingerprint of the trace above it,
+    // so neither the trace nor the tree above the target is walked.
+    TraceNodePtr current = path.nodeAt(entry->depth);
+    quint64 prefix = path.prefixFingerprintAt(entry->depth);
+
+    // As the tree above the target is unknown here, the merge must not diverge at the target itself, so a fingerprint
+    // collision with a node of another type falls back to merging from the root.
+    if (TracePath::combine(prefix, TracePath::shallowKey(current)) != entry->fingerprint ||
+            !current->isEqualShallow(target)) {
+        Statistics::statistics()->accumulate("Concolic::ExecutionTree::MergeFromRoot", 1);
+        return false;
+    }
+
+    // The target is a branch and matches the trace node, so it can never cause an insertion or divergence itself and
+    // its parents are not needed.
+    mCurrentTrace = current;
+    mCurrentTree = target;
+    mDepth = entry->depth;
+    mPrefixFingerprint = prefix;
+
+    Statistics::statistics()->accumulate("Concolic::ExecutionTree::MergeFromTarget", 1);
+    return true;
+}
+
+// Adds a symbolic branch which the current trace node matched to the index.
+void TraceMerger::indexTreeNode(TraceNodePtr node)
+{
+    if (mMergingDivergence || node.dynamicCast<TraceSymbolicBranch>().isNull()) {
+        return;
+    }
+
+    PrefixEntry entry;
+    entry.depth = mDepth;
+    entry.fingerprint = TracePath::combine(mPrefixFingerprint, TracePath::shallowKey(mCurrentTrace));
+    entry.node = node.toWeakRef();
+    mPrefixIndex.insert(node.data(), entry);
+}
 
+// Removes the entries for nodes which have been deleted, e.g. when their subtree was spilled to disk.
+void TraceMerger::pruneIndex()
+{
+    QHash<TraceNode*, PrefixEntry>::iterator entry = mPrefixIndex.begin();
+    while (entry != mPrefixIndex.end()) {
+        if (entry->node.isNull()) {
+            entry = mPrefixIndex.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+
+    mPruneIndexAt = qMax(PRUNE_INDEX_MIN_SIZE, 2 * mPrefixIndex.size());
+    Statistics::statistics()->accumulate("Concolic::ExecutionTree::PrefixIndexPrunes", 1);
+}
+
+// Adds the symbolic branches of a part of a trace which was inserted into the tree to the index.
+void TraceMerger::indexSuffix(TraceNodePtr suffix, uint depth, quint64 prefixFingerprint)
+{
+    TraceNodePtr current = suffix;
+
+    while (!current.isNull() && !TraceVisitor::isImmediatelyUnexplored(current)) {
+        quint64 fingerprint = TracePath::combine(prefixFingerprint, TracePath::shallowKey(current));
+
+        if (!current.dynamicCast<TraceSymbolicBranch>().isNull()) {
+            PrefixEntry entry;
+            entry.depth = depth;
+            entry.fingerprint = fingerprint;
+            entry.node = current.toWeakRef();
+            mPrefixIndex.insert(current.data(), entry);
+        }
+
+        int direction;
+        current = TracePath::nextOnTrace(current, &direction);
+        prefixFingerprint = TracePath::combine(fingerprint, direction);
+        depth++;
+    }
+}
 
 }
@@ -14,7 +14,11 @@
  * limitations under the License.
  */
 
+#include <QHash>
+#include <QWeakPointer>
+
 #include "concolic/executiontree/tracenodes.h"
+#include "concolic/executiontree/tracepath.h"
 #include "concolic/executiontree/tracevisitor.h"
 
 #include "statistics/statsstorage.h"
@@ -34,13 +38,30 @@ namespace artemis
  * Please observe that this function mutates the executiontree, and if it is null it inserts new nodes.
  * Thus, the usage of a pointer to the executiontree pointer.
  *
+ * A recorded trace is a single path, so the merge walks the trace and the tree together in a loop (one visit per
+ * trace node) instead of recursing, and uses constant stack space however long the trace is.
+ *
+ * If the run was aimed at a target branch (the ExplorationDescriptor chosen by the search) and the TracePath recorded
+ * with the trace is given, the merge starts at that branch instead of at the root. Each symbolic branch in the tree is
+ * indexed by its depth and a fingerprint of the shallow contents (the parts compared by isEqualShallow) and directions
+ * of the nodes above it. If the trace node at the same depth has the same fingerprint, a node-by-node merge would have
+ * matched the whole prefix, so it is skipped and only the trace below the target is merged, at a cost proportional to
+ * that suffix. Otherwise the merge falls back to walking from the root, so divergences are detected exactly as before.
+ *
  */
 class TraceMerger : public QObject, public TraceVisitor
 {
     Q_OBJECT
 
 public:
-    TraceNodePtr merge(TraceNodePtr trace, TraceNodePtr executiontree, TraceNodePtr* executionTreeRootPtr);
+    TraceMerger();
+
+    TraceNodePtr merge(TraceNodePtr trace, TraceNodePtr executiontree, TraceNodePtr* executionTreeRootPtr,
+                       TraceSymbolicBranchPtr target = TraceSymbolicBranchPtr(), const TracePath& path = TracePath());
+
+    // Whether the last merge added anything to the tree (a new path or a divergence). A trace which followed a path
+    // already in the tree only updates the trace indices of its end node.
+    bool changedTree() const;
 
     void visit(TraceNode* node);
 
@@ -60,8 +81,13 @@ private:
     TraceNodePtr mCurrentTree;
     TraceNodePtr mCurrentTrace;
 
+    // Set by the visitors to the trace node to continue merging with (against the new mCurrentTree), if any.
+    TraceNodePtr mNextTrace;
+    void descend(TraceNodePtr treeChild, TraceNodePtr traceChild, int traceDirection);
+
     TraceNodePtr mStartingTrace;
     TraceNodePtr* mStartingTreeRootPtr; // This is a hack to allow us to replace the root node in handleDivergenceAtRoot(). A better solution might be to introduce a header node for trees.
+    TraceNodePtr mRootResult; // The root of the tree after merging, returned by merge().
 
     // Used to report where a new trace was added to the tree.
     // These refer to the nearest ancestor which is a branch node.
@@ -74,16 +100,40 @@ private:
     TraceNodePtr mImmediateParent;
     int mImmediateParentDirection;
 
+    void insertTrace();
+
     void handleDivergence();
     void addDivergentTraceToNode(TraceDivergencePtr node, TraceNodePtr trace);
     void handleDivergenceAtRoot();
     bool mMergingDivergence;
+    bool mMergedIntoDivergence;
+    bool mChangedTree;
     QSet<TraceNodePtr> mAlreadyMismatched;
 
     // Used in the visitors to "fast-foraward" through any divergence nodes in the tree before trying to match.
     // These nodes are added by TraceMerger so they will not match anyhting in the new trace and shouold be skipped over.
-    TraceDivergencePtr skipDivergenceNodesInTree();
-    void unSkipDivergenceNodesInTree(TraceDivergencePtr node);
+    void skipDivergenceNodesInTree();
+
+    // Used in the same place to put spilled parts of the tree (see TraceSpiller) back before merging into them.
+    void loadSpilledTree();
+
+    // Prefix index used to start merging at the target branch.
+    struct PrefixEntry {
+        uint depth;
+        quint64 fingerprint;
+        QWeakPointer<TraceNode> node; // Guards against a deleted node's address being reused.
+    };
+    QHash<TraceNode*, PrefixEntry> mPrefixIndex;
+    int mPruneIndexAt;
+    void pruneIndex();
+
+    // Depth of mCurrentTrace in the trace and the fingerprint of the nodes above it.
+    uint mDepth;
+    quint64 mPrefixFingerprint;
+
+    bool jumpToTarget(TraceNodePtr trace, TraceSymbolicBranchPtr target, const TracePath& path);
+    void indexTreeNode(TraceNodePtr node);
+    void indexSuffix(TraceNodePtr suffix, uint depth, quint64 prefixFingerprint);
 };
 
 }
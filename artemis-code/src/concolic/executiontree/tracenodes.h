@@ -49,6 +49,7 @@
 #include "nodes/traceunexploredmissed.h"
 #include "nodes/traceunexploredqueued.h"
 #include "nodes/tracedivergence.h"
+#include "nodes/tracespilled.h"
 
 #ifndef TRACENODES_H
 #define TRACENODES_H
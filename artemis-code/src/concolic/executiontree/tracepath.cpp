@@ -0,0 +1,128 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <typeinfo>
+
+#include "concolic/executiontree/tracevisitor.h"
+
+#include "tracepath.h"
+
+namespace artemis
+{
+
+const quint64 TracePath::EMPTY_PREFIX = 0xcbf29ce484222325ULL;
+
+TracePath::TracePath()
+{
+}
+
+void TracePath::append(TraceNodePtr node)
+{
+    if (mNodes.isEmpty()) {
+        mPrefixFingerprints.append(EMPTY_PREFIX);
+    } else {
+        int direction;
+        nextOnTrace(mNodes.last(), &direction);
+        mPrefixFingerprints.append(combine(combine(mPrefixFingerprints.last(), shallowKey(mNodes.last())), direction));
+    }
+
+    mNodes.append(node);
+}
+
+void TracePath::clear()
+{
+    mNodes.clear();
+    mPrefixFingerprints.clear();
+}
+
+uint TracePath::length() const
+{
+    return mNodes.length();
+}
+
+TraceNodePtr TracePath::nodeAt(uint depth) const
+{
+    return mNodes.at(depth);
+}
+
+quint64 TracePath::prefixFingerprintAt(uint depth) const
+{
+    return mPrefixFingerprints.at(depth);
+}
+
+// Everything isEqualShallow compares for a trace node, so nodes with different keys can never match each other.
+quint64 TracePath::shallowKey(TraceNodePtr node)
+{
+    quint64 key = typeid(*node).hash_code();
+
+    TraceMarkerPtr marker = node.dynamicCast<TraceMarker>();
+    if (!marker.isNull()) {
+        return combine(combine(key, qHash(marker->label)), qHash(marker->index));
+    }
+
+    QSharedPointer<TraceFunctionCall> call = node.dynamicCast<TraceFunctionCall>();
+    if (!call.isNull()) {
+        return combine(key, qHash(call->name));
+    }
+
+    // A summary in the tree matches the trace through the execution with exactly the same events.
+    TraceConcreteSummarisationPtr summary = node.dynamicCast<TraceConcreteSummarisation>();
+    if (!summary.isNull() && !summary->executions.isEmpty()) {
+        foreach (TraceConcreteSummarisation::EventType event, summary->executions[0].first) {
+            key = combine(key, event);
+        }
+        return combine(key, summary->executions[0].first.length());
+    }
+
+    return key;
+}
+
+quint64 TracePath::combine(quint64 fingerprint, quint64 value)
+{
+    // 64 bit version of boost::hash_combine.
+    return fingerprint ^ (value + 0x9e3779b97f4a7c15ULL + (fingerprint << 6) + (fingerprint >> 2));
+}
+
+TraceNodePtr TracePath::nextOnTrace(TraceNodePtr node, int* direction)
+{
+    *direction = 0;
+
+    TraceBranchPtr branch = node.dynamicCast<TraceBranch>();
+    if (!branch.isNull()) {
+        if (!TraceVisitor::isImmediatelyUnexplored(branch->getTrueBranch())) {
+            *direction = 1;
+            return branch->getTrueBranch();
+        }
+        if (!TraceVisitor::isImmediatelyUnexplored(branch->getFalseBranch())) {
+            return branch->getFalseBranch();
+        }
+        return TraceNodePtr();
+    }
+
+    TraceAnnotationPtr annotation = node.dynamicCast<TraceAnnotation>();
+    if (!annotation.isNull()) {
+        return annotation->next;
+    }
+
+    TraceConcreteSummarisationPtr summary = node.dynamicCast<TraceConcreteSummarisation>();
+    if (!summary.isNull() && summary->executions.length() == 1) {
+        return summary->executions[0].second;
+    }
+
+    return TraceNodePtr(); // TraceEnd
+}
+
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRACEPATH_H
+#define TRACEPATH_H
+
+#include <QList>
+
+#include "concolic/executiontree/tracenodes.h"
+
+namespace artemis
+{
+
+/**
+ * The nodes along a single recorded trace, in order, each with a fingerprint of the nodes above it and the directions
+ * taken from them.
+ *
+ * It is built by TraceBuilder as the trace is recorded, so TraceMerger can find the trace node at a given depth and
+ * compare its prefix with the execution tree without walking the trace.
+ *
+ * The fingerprints only cover the parts of each node compared by isEqualShallow, so two prefixes which a merge would
+ * match node-by-node have the same fingerprint.
+ */
+class TracePath
+{
+public:
+    TracePath();
+
+    // Adds the next node of the trace. It must already be attached to the previous node.
+    void append(TraceNodePtr node);
+    void clear();
+
+    uint length() const;
+    TraceNodePtr nodeAt(uint depth) const;
+    quint64 prefixFingerprintAt(uint depth) const;
+
+    // The fingerprint of the (empty) prefix above the root.
+    static const quint64 EMPTY_PREFIX;
+
+    static quint64 shallowKey(TraceNodePtr node);
+    static quint64 combine(quint64 fingerprint, quint64 value);
+
+    // The next node along a recorded trace, and the direction taken to reach it.
+    static TraceNodePtr nextOnTrace(TraceNodePtr node, int* direction);
+
+private:
+    QList<TraceNodePtr> mNodes;
+    QList<quint64> mPrefixFingerprints;
+};
+
+}
+
+#endif // TRACEPATH_H
@@ -0,0 +1,278 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "util/loggingutil.h"
+#include "statistics/statsstorage.h"
+
+#include "tracespiller.h"
+
+namespace artemis
+{
+
+// The reference count and allocation overhead of each node, on top of the node itself.
+const quint64 TraceSpiller::NODE_OVERHEAD = 32;
+
+// Smaller subtrees would hardly save anything over their placeholder.
+const quint64 TraceSpiller::SPILL_MIN_SIZE = 4096;
+
+TraceSpiller::TraceSpiller(uint memoryLimit)
+    : QObject()
+    , TraceVisitor()
+    , mMemoryLimit((quint64)memoryLimit * 1024 * 1024)
+    , mEstimatedSize(0)
+    , mNextPassAt(mMemoryLimit)
+    , mStore(TraceSpillStorePtr())
+    , mNumSpilled(0)
+    , mNodeSize(0)
+    , mNodeHot(false)
+{
+}
+
+void TraceSpiller::addedToTree(TraceNodePtr suffix)
+{
+    if (mMemoryLimit == 0) {
+        return;
+    }
+
+    mEstimatedSize += walk(suffix, NULL, false);
+}
+
+void TraceSpiller::slNewTraceAdded(TraceNodePtr parent, int direction, TraceNodePtr suffix, TraceNodePtr fullTrace)
+{
+    addedToTree(suffix);
+}
+
+bool TraceSpiller::spillIfNeeded(TraceNodePtr tree, TraceNodePtr pinned)
+{
+    if (mMemoryLimit == 0 || tree.isNull() || mEstimatedSize < mNextPassAt) {
+        return false;
+    }
+
+    if (mStore.isNull()) {
+        mStore = TraceSpillStore::create();
+    }
+
+    uint numSpilledBefore = mNumSpilled;
+    quint64 sizeBefore = mEstimatedSize;
+
+    mEstimatedSize = walk(tree, pinned.data(), true);
+    mNextPassAt = qMax(mMemoryLimit, mEstimatedSize + mMemoryLimit / 8);
+
+    Log::debug(QString("Spilled %1 subtrees of the execution tree, estimated size %2kB -> %3kB.")
+               .arg(mNumSpilled - numSpilledBefore).arg(sizeBefore / 1024).arg(mEstimatedSize / 1024).toStdString());
+    Statistics::statistics()->accumulate("Concolic::ExecutionTree::SpillPasses", 1);
+
+    return mNumSpilled != numSpilledBefore;
+}
+
+// Walks the subtree in post-order, with an explicit stack as the tree can be very deep.
+// A hot node (one with something left to explore below it) spills its cold children once they have all been walked,
+// so only the largest fully explored subtrees are spilled. The root can not be replaced, so it is treated as hot.
+quint64 TraceSpiller::walk(TraceNodePtr tree, TraceNode* pinned, bool spill)
+{
+    QStack<Frame> stack;
+    stack.push(enter(tree, pinned));
+
+    while (true) {
+        if (stack.top().childSizes.size() < stack.top().children.size()) {
+            TraceNodePtr child = stack.top().children.at(stack.top().childSizes.size());
+            stack.push(enter(child, pinned));
+            continue;
+        }
+
+        Frame frame = stack.pop();
+
+        if (spill && (frame.hot || stack.isEmpty())) {
+            frame.size -= spillChildren(frame);
+        }
+
+        if (stack.isEmpty()) {
+            return frame.size;
+        }
+
+        Frame& parent = stack.top();
+        parent.size += frame.size;
+        parent.hot = parent.hot || frame.hot;
+        parent.childSizes.append(frame.size);
+        parent.childrenHot.append(frame.hot);
+    }
+}
+
+TraceSpiller::Frame TraceSpiller::enter(TraceNodePtr node, TraceNode* pinned)
+{
+    Frame frame;
+    frame.node = node;
+
+    if (node.isNull()) {
+        return frame;
+    }
+
+    mNodeSize = 0;
+    mNodeHot = false;
+    mNodeChildren.clear();
+
+    node->accept(this);
+
+    frame.size = mNodeSize;
+    frame.hot = mNodeHot || node.data() == pinned;
+    frame.children = mNodeChildren;
+    return frame;
+}
+
+// Returns the estimated memory saved.
+quint64 TraceSpiller::spillChildren(const Frame& frame)
+{
+    quint64 saved = 0;
+
+    for (int i = 0; i < frame.children.size(); i++) {
+        if (frame.childrenHot.at(i) || frame.childSizes.at(i) < SPILL_MIN_SIZE) {
+            continue;
+        }
+
+        qint64 offset = mStore->write(frame.children.at(i));
+        if (offset < 0) {
+            break;
+        }
+
+        frame.node->setChild(i, TraceSpilledPtr(new TraceSpilled(mStore, offset)));
+
+        saved += frame.childSizes.at(i) - (sizeof(TraceSpilled) + NODE_OVERHEAD);
+        mNumSpilled++;
+        Statistics::statistics()->accumulate("Concolic::ExecutionTree::SpilledSubtrees", 1);
+    }
+
+    return saved;
+}
+
+quint64 TraceSpiller::stringSize(const QString& string)
+{
+    return string.capacity() * sizeof(QChar);
+}
+
+
+
+// The visitor part, which sets the size, state and children of a single node.
+// The children are listed in the order of the positions passed to setChild().
+// The sizes are rough estimates, only the node itself and the strings and containers it holds are counted.
+
+void TraceSpiller::visit(TraceNode* node)
+{
+    Log::fatal("Error: Reached a node of unknown type while spilling the execution tree (TraceSpiller).");
+    exit(1);
+}
+
+void TraceSpiller::visit(TraceConcreteBranch* node)
+{
+    mNodeSize = sizeof(TraceConcreteBranch) + NODE_OVERHEAD;
+    mNodeChildren << node->getFalseBranch() << node->getTrueBranch();
+}
+
+void TraceSpiller::visit(TraceSymbolicBranch* node)
+{
+    mNodeSize = sizeof(TraceSymbolicBranch) + NODE_OVERHEAD;
+    mNodeChildren << node->getFalseBranch() << node->getTrueBranch();
+}
+
+// The unexplored nodes are singletons, so they take no memory of their own.
+
+void TraceSpiller::visit(TraceUnexplored* node)
+{
+    mNodeHot = true;
+}
+
+void TraceSpiller::visit(TraceUnexploredUnsat* node)
+{
+}
+
+void TraceSpiller::visit(TraceUnexploredUnsolvable* node)
+{
+}
+
+void TraceSpiller::visit(TraceUnexploredMissed* node)
+{
+}
+
+void TraceSpiller::visit(TraceUnexploredQueued* node)
+{
+    // Must stay in the tree until the trace exploring it has been merged.
+    mNodeHot = true;
+}
+
+void TraceSpiller::visit(TraceAlert* node)
+{
+    mNodeSize = sizeof(TraceAlert) + NODE_OVERHEAD + stringSize(node->message);
+    mNodeChildren << node->next;
+}
+
+void TraceSpiller::visit(TraceConsoleMessage* node)
+{
+    mNodeSize = sizeof(TraceConsoleMessage) + NODE_OVERHEAD + stringSize(node->message);
+    mNodeChildren << node->next;
+}
+
+void TraceSpiller::visit(TraceDomModification* node)
+{
+    mNodeSize = sizeof(TraceDomModification) + NODE_OVERHEAD + node->words.size() * 4 * sizeof(void*);
+    mNodeChildren << node->next;
+}
+
+void TraceSpiller::visit(TracePageLoad* node)
+{
+    mNodeSize = sizeof(TracePageLoad) + NODE_OVERHEAD + node->url.toEncoded().size();
+    mNodeChildren << node->next;
+}
+
+void TraceSpiller::visit(TraceMarker* node)
+{
+    mNodeSize = sizeof(TraceMarker) + NODE_OVERHEAD + stringSize(node->label) + stringSize(node->index);
+    foreach (QString value, node->selectRestriction.values) {
+        mNodeSize += stringSize(value);
+    }
+    mNodeChildren << node->next;
+}
+
+void TraceSpiller::visit(TraceFunctionCall* node)
+{
+    mNodeSize = sizeof(TraceFunctionCall) + NODE_OVERHEAD + stringSize(node->name);
+    mNodeChildren << node->next;
+}
+
+void TraceSpiller::visit(TraceDivergence* node)
+{
+    mNodeSize = sizeof(TraceDivergence) + NODE_OVERHEAD;
+    mNodeChildren << node->next;
+}
+
+void TraceSpiller::visit(TraceConcreteSummarisation* node)
+{
+    mNodeSize = sizeof(TraceConcreteSummarisation) + NODE_OVERHEAD;
+    foreach (TraceConcreteSummarisation::SingleExecution execution, node->executions) {
+        mNodeSize += sizeof(TraceConcreteSummarisation::SingleExecution) + execution.first.size() * sizeof(void*);
+        mNodeChildren << execution.second;
+    }
+}
+
+void TraceSpiller::visit(TraceEnd* node)
+{
+    mNodeSize = sizeof(TraceEndSuccess) + NODE_OVERHEAD + node->traceIndices.size() * 4 * sizeof(void*);
+}
+
+void TraceSpiller::visit(TraceSpilled* node)
+{
+    mNodeSize = sizeof(TraceSpilled) + NODE_OVERHEAD;
+}
+
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRACESPILLER_H
+#define TRACESPILLER_H
+
+#include <QObject>
+#include <QList>
+#include <QStack>
+
+#include "concolic/executiontree/tracenodes.h"
+#include "concolic/executiontree/tracevisitor.h"
+#include "concolic/executiontree/tracespillstore.h"
+
+namespace artemis
+{
+
+/**
+ * Keeps the execution tree under a memory limit by moving fully explored subtrees to a TraceSpillStore on disk.
+ *
+ * The size of the tree is estimated as traces are added. Once the estimate is over the limit, the tree is walked and
+ * every subtree without unexplored or queued leaves is replaced by a TraceSpilled placeholder. The searches do not
+ * look below these, and other visitors load them back as needed (see TraceSpilled).
+ *
+ * The walk follows the tree as the searches do, so the parts below end markers and the diverged traces of divergence
+ * nodes are never spilled on their own. Subtrees smaller than SPILL_MIN_SIZE are left in memory, as are the pinned
+ * node and its ancestors; the searches may keep pointers to their last target between calls.
+ *
+ * If the tree is still over the limit after spilling, the next walk waits until the estimate has grown by an eighth
+ * of the limit, so a tree with a large unexplored frontier is not walked after every trace.
+ */
+class TraceSpiller : public QObject, public TraceVisitor
+{
+    Q_OBJECT
+
+public:
+    TraceSpiller(uint memoryLimit); // In MB, 0 for no limit.
+
+    // Adds the size of a new part of the tree to the estimate.
+    void addedToTree(TraceNodePtr suffix);
+
+    // Spills the fully explored parts of the tree if it is over the limit. Returns true if anything was spilled.
+    bool spillIfNeeded(TraceNodePtr tree, TraceNodePtr pinned);
+
+public slots:
+    void slNewTraceAdded(TraceNodePtr parent, int direction, TraceNodePtr suffix, TraceNodePtr fullTrace);
+
+private:
+    quint64 mMemoryLimit; // In bytes, 0 for no limit.
+    quint64 mEstimatedSize;
+    quint64 mNextPassAt;
+
+    TraceSpillStorePtr mStore;
+    uint mNumSpilled;
+
+    static const quint64 NODE_OVERHEAD;
+    static const quint64 SPILL_MIN_SIZE;
+
+    // A node whose subtree is being walked, with the estimated size and whether there is anything left to explore in
+    // the children which have been walked so far.
+    struct Frame {
+        Frame() : size(0), hot(false) {}
+
+        TraceNodePtr node;
+        quint64 size;
+        bool hot;
+
+        QList<TraceNodePtr> children;
+        QList<quint64> childSizes;
+        QList<bool> childrenHot;
+    };
+
+    // Returns the estimated size of the subtree, after spilling if spill is set.
+    quint64 walk(TraceNodePtr tree, TraceNode* pinned, bool spill);
+    Frame enter(TraceNodePtr node, TraceNode* pinned);
+    quint64 spillChildren(const Frame& frame);
+
+    static quint64 stringSize(const QString& string);
+
+    // Set by the visitor for a single node, read by enter().
+    quint64 mNodeSize;
+    bool mNodeHot;
+    QList<TraceNodePtr> mNodeChildren;
+
+    // The visitor part, which looks at a single node.
+    // Should only be called by enter().
+    void visit(TraceNode* node);
+    void visit(TraceConcreteBranch* node);
+    void visit(TraceSymbolicBranch* node);
+    void visit(TraceUnexplored* node);
+    void visit(TraceUnexploredUnsat* node);
+    void visit(TraceUnexploredUnsolvable* node);
+    void visit(TraceUnexploredMissed* node);
+    void visit(TraceUnexploredQueued* node);
+    void visit(TraceAlert* node);
+    void visit(TraceConsoleMessage* node);
+    void visit(TraceDomModification* node);
+    void visit(TracePageLoad* node);
+    void visit(TraceMarker* node);
+    void visit(TraceFunctionCall* node);
+    void visit(TraceDivergence* node);
+    void visit(TraceConcreteSummarisation* node);
+    void visit(TraceEnd* node);
+    void visit(TraceSpilled* node);
+};
+
+}
+
+#endif // TRACESPILLER_H
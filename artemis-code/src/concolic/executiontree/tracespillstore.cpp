@@ -0,0 +1,455 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <QDir>
+
+#include "util/loggingutil.h"
+#include "statistics/statsstorage.h"
+
+#include "tracespillstore.h"
+
+namespace artemis
+{
+
+TraceSpillStorePtr TraceSpillStore::create()
+{
+    TraceSpillStorePtr store = TraceSpillStorePtr(new TraceSpillStore());
+    store->mSelf = store.toWeakRef();
+    return store;
+}
+
+TraceSpillStore::TraceSpillStore()
+    : TraceVisitor()
+    , mFile(QDir::tempPath() + "/artemis-tree-XXXXXX")
+    , mFailed(false)
+{
+    if (!mFile.open()) {
+        Log::error(QString("Could not create %1, the execution tree will be kept in memory.").arg(mFile.fileTemplate()).toStdString());
+        mFailed = true;
+        return;
+    }
+
+    mStream.setDevice(&mFile);
+    mStream.setVersion(QDataStream::Qt_4_8);
+}
+
+qint64 TraceSpillStore::write(TraceNodePtr subtree)
+{
+    if (mFailed) {
+        return -1;
+    }
+
+    qint64 offset = mFile.size();
+    mFile.seek(offset);
+
+    mPending.clear();
+    mPending.push(subtree);
+
+    while (!mPending.isEmpty()) {
+        TraceNodePtr node = mPending.pop();
+        if (node.isNull()) {
+            writeTag(NODE_NULL);
+        } else {
+            node->accept(this);
+        }
+    }
+
+    if (!mFile.flush()) {
+        Log::error(QString("Could not write to %1, the execution tree will be kept in memory.").arg(mFile.fileName()).toStdString());
+        mFailed = true;
+        return -1;
+    }
+
+    Statistics::statistics()->accumulate("Concolic::ExecutionTree::SpilledBytes", (int)(mFile.size() - offset));
+    return offset;
+}
+
+TraceNodePtr TraceSpillStore::read(qint64 offset)
+{
+    if (mFailed || !mFile.seek(offset)) {
+        Log::fatal("Could not read back a spilled part of the execution tree.");
+        exit(1);
+    }
+
+    // Each node is read into its position (parent and child index) from the top of the stack.
+    TraceNodePtr root;
+    QStack<QPair<TraceNodePtr, int> > positions;
+    positions.push(QPair<TraceNodePtr, int>(TraceNodePtr(), 0));
+
+    while (!positions.isEmpty()) {
+        QPair<TraceNodePtr, int> position = positions.pop();
+
+        int numChildren = 0;
+        TraceNodePtr node = readNode(&numChildren);
+
+        if (position.first.isNull()) {
+            root = node;
+        } else {
+            attach(position.first, position.second, node);
+        }
+
+        for (int i = numChildren - 1; i >= 0; i--) {
+            positions.push(QPair<TraceNodePtr, int>(node, i));
+        }
+    }
+
+    if (mStream.status() != QDataStream::Ok) {
+        Log::fatal("Could not read back a spilled part of the execution tree.");
+        exit(1);
+    }
+
+    Statistics::statistics()->accumulate("Concolic::ExecutionTree::SpilledSubtreesLoaded", 1);
+    return root;
+}
+
+TraceNodePtr TraceSpillStore::readNode(int* numChildren)
+{
+    quint8 tag;
+    mStream >> tag;
+
+    *numChildren = 0;
+
+    switch (tag) {
+    case NODE_NULL:
+        return TraceNodePtr();
+
+    case CONCRETE_BRANCH:
+    case SYMBOLIC_BRANCH: {
+        uint sourceOffset;
+        quint64 source;
+        uint linenumber;
+        mStream >> sourceOffset >> source >> linenumber;
+
+        *numChildren = 2;
+
+        if (tag == CONCRETE_BRANCH) {
+            return TraceNodePtr(new TraceConcreteBranch(sourceOffset, reinterpret_cast<QSource*>((quintptr)source), linenumber));
+        }
+
+        quint64 condition;
+        bool difficult;
+        uint explorationIndex;
+        bool explorationDirection;
+        mStream >> condition >> difficult >> explorationIndex >> explorationDirection;
+
+        TraceSymbolicBranchPtr branch = TraceSymbolicBranchPtr(new TraceSymbolicBranch(reinterpret_cast<Symbolic::Expression*>((quintptr)condition),
+                                                                                       sourceOffset, reinterpret_cast<QSource*>((quintptr)source), linenumber));
+        if (difficult) {
+            branch->markDifficult();
+        }
+        if (explorationIndex != 0) {
+            branch->markExploration(explorationIndex, explorationDirection);
+        }
+        return branch;
+    }
+
+    case UNEXPLORED:
+        return TraceUnexplored::getInstance();
+    case UNEXPLORED_UNSAT:
+        return TraceUnexploredUnsat::getInstance();
+    case UNEXPLORED_UNSOLVABLE:
+        return TraceUnexploredUnsolvable::getInstance();
+    case UNEXPLORED_MISSED:
+        return TraceUnexploredMissed::getInstance();
+    case UNEXPLORED_QUEUED:
+        return TraceUnexploredQueued::getInstance();
+
+    case ALERT: {
+        QSharedPointer<TraceAlert> alert = QSharedPointer<TraceAlert>(new TraceAlert());
+        mStream >> alert->message;
+        *numChildren = 1;
+        return alert;
+    }
+
+    case CONSOLE_MESSAGE: {
+        QSharedPointer<TraceConsoleMessage> message = QSharedPointer<TraceConsoleMessage>(new TraceConsoleMessage());
+        mStream >> message->message;
+        *numChildren = 1;
+        return message;
+    }
+
+    case DOM_MODIFICATION: {
+        QSharedPointer<TraceDomModification> modification = QSharedPointer<TraceDomModification>(new TraceDomModification());
+        mStream >> modification->amountModified >> modification->words;
+        *numChildren = 1;
+        return modification;
+    }
+
+    case PAGE_LOAD: {
+        QSharedPointer<TracePageLoad> load = QSharedPointer<TracePageLoad>(new TracePageLoad());
+        mStream >> load->url;
+        *numChildren = 1;
+        return load;
+    }
+
+    case MARKER: {
+        TraceMarkerPtr marker = TraceMarkerPtr(new TraceMarker());
+        mStream >> marker->label >> marker->index >> marker->isSelectRestriction
+                >> marker->selectRestriction.variable >> marker->selectRestriction.values;
+        *numChildren = 1;
+        return marker;
+    }
+
+    case FUNCTION_CALL: {
+        QSharedPointer<TraceFunctionCall> call = QSharedPointer<TraceFunctionCall>(new TraceFunctionCall());
+        mStream >> call->name;
+        *numChildren = 1;
+        return call;
+    }
+
+    case DIVERGENCE: {
+        TraceDivergencePtr divergence = TraceDivergencePtr(new TraceDivergence());
+        quint32 numDiverged;
+        mStream >> numDiverged;
+        for (quint32 i = 0; i < numDiverged && mStream.status() == QDataStream::Ok; i++) {
+            divergence->divergedTraces.append(TraceNodePtr());
+        }
+        *numChildren = 1 + divergence->divergedTraces.size();
+        return divergence;
+    }
+
+    case CONCRETE_SUMMARISATION: {
+        TraceConcreteSummarisationPtr summary = TraceConcreteSummarisationPtr(new TraceConcreteSummarisation());
+        quint32 numExecutions;
+        mStream >> numExecutions;
+        for (quint32 i = 0; i < numExecutions && mStream.status() == QDataStream::Ok; i++) {
+            QList<quint8> events;
+            mStream >> events;
+
+            QList<TraceConcreteSummarisation::EventType> execution;
+            foreach (quint8 event, events) {
+                execution.append((TraceConcreteSummarisation::EventType)event);
+            }
+            summary->executions.append(TraceConcreteSummarisation::SingleExecution(execution, TraceNodePtr()));
+        }
+        *numChildren = summary->executions.size();
+        return summary;
+    }
+
+    case END_SUCCESS: {
+        QSharedPointer<TraceEndSuccess> end = QSharedPointer<TraceEndSuccess>(new TraceEndSuccess());
+        mStream >> end->traceIndices;
+        *numChildren = 1;
+        return end;
+    }
+
+    case END_FAILURE: {
+        QSharedPointer<TraceEndFailure> end = QSharedPointer<TraceEndFailure>(new TraceEndFailure());
+        mStream >> end->traceIndices;
+        *numChildren = 1;
+        return end;
+    }
+
+    case END_UNKNOWN: {
+        QSharedPointer<TraceEndUnknown> end = QSharedPointer<TraceEndUnknown>(new TraceEndUnknown());
+        mStream >> end->traceIndices;
+        return end;
+    }
+
+    case SPILLED: {
+        qint64 offset;
+        mStream >> offset;
+        return TraceNodePtr(new TraceSpilled(mSelf.toStrongRef(), offset));
+    }
+
+    default:
+        Log::fatal("Found a node of unknown type while reading back a spilled part of the execution tree.");
+        exit(1);
+    }
+}
+
+void TraceSpillStore::attach(TraceNodePtr parent, int position, TraceNodePtr child)
+{
+    // End markers keep the part of the tree they cut off in next, which setChild() does not allow.
+    QSharedPointer<TraceEndSuccess> success = parent.dynamicCast<TraceEndSuccess>();
+    if (!success.isNull()) {
+        success->next = child;
+        return;
+    }
+
+    QSharedPointer<TraceEndFailure> failure = parent.dynamicCast<TraceEndFailure>();
+    if (!failure.isNull()) {
+        failure->next = child;
+        return;
+    }
+
+    parent->setChild(position, child);
+}
+
+void TraceSpillStore::writeTag(NodeTag tag)
+{
+    mStream << (quint8)tag;
+}
+
+void TraceSpillStore::writeBranch(TraceBranch* node)
+{
+    mStream << node->getSourceOffset() << (quint64)(quintptr)node->getSource() << node->getLinenumber();
+}
+
+// The children are written after their parent, in the order of the positions passed to setChild().
+void TraceSpillStore::writeChildren(QList<TraceNodePtr> children)
+{
+    for (int i = children.size() - 1; i >= 0; i--) {
+        mPending.push(children.at(i));
+    }
+}
+
+
+
+// The visitor part, which writes a single node.
+
+void TraceSpillStore::visit(TraceNode* node)
+{
+    Log::fatal("Error: Reached a node of unknown type while spilling the execution tree (TraceSpillStore).");
+    exit(1);
+}
+
+void TraceSpillStore::visit(TraceConcreteBranch* node)
+{
+    writeTag(CONCRETE_BRANCH);
+    writeBranch(node);
+    writeChildren(QList<TraceNodePtr>() << node->getFalseBranch() << node->getTrueBranch());
+}
+
+void TraceSpillStore::visit(TraceSymbolicBranch* node)
+{
+    writeTag(SYMBOLIC_BRANCH);
+    writeBranch(node);
+    mStream << (quint64)(quintptr)node->getSymbolicCondition() << node->isDifficult()
+            << node->getExplorationIndex() << node->getExplorationDirection();
+    writeChildren(QList<TraceNodePtr>() << node->getFalseBranch() << node->getTrueBranch());
+}
+
+void TraceSpillStore::visit(TraceUnexplored* node)
+{
+    writeTag(UNEXPLORED);
+}
+
+void TraceSpillStore::visit(TraceUnexploredUnsat* node)
+{
+    writeTag(UNEXPLORED_UNSAT);
+}
+
+void TraceSpillStore::visit(TraceUnexploredUnsolvable* node)
+{
+    writeTag(UNEXPLORED_UNSOLVABLE);
+}
+
+void TraceSpillStore::visit(TraceUnexploredMissed* node)
+{
+    writeTag(UNEXPLORED_MISSED);
+}
+
+void TraceSpillStore::visit(TraceUnexploredQueued* node)
+{
+    writeTag(UNEXPLORED_QUEUED);
+}
+
+void TraceSpillStore::visit(TraceAlert* node)
+{
+    writeTag(ALERT);
+    mStream << node->message;
+    writeChildren(QList<TraceNodePtr>() << node->next);
+}
+
+void TraceSpillStore::visit(TraceConsoleMessage* node)
+{
+    writeTag(CONSOLE_MESSAGE);
+    mStream << node->message;
+    writeChildren(QList<TraceNodePtr>() << node->next);
+}
+
+void TraceSpillStore::visit(TraceDomModification* node)
+{
+    writeTag(DOM_MODIFICATION);
+    mStream << node->amountModified << node->words;
+    writeChildren(QList<TraceNodePtr>() << node->next);
+}
+
+void TraceSpillStore::visit(TracePageLoad* node)
+{
+    writeTag(PAGE_LOAD);
+    mStream << node->url;
+    writeChildren(QList<TraceNodePtr>() << node->next);
+}
+
+void TraceSpillStore::visit(TraceMarker* node)
+{
+    writeTag(MARKER);
+    mStream << node->label << node->index << node->isSelectRestriction
+            << node->selectRestriction.variable << node->selectRestriction.values;
+    writeChildren(QList<TraceNodePtr>() << node->next);
+}
+
+void TraceSpillStore::visit(TraceFunctionCall* node)
+{
+    writeTag(FUNCTION_CALL);
+    mStream << node->name;
+    writeChildren(QList<TraceNodePtr>() << node->next);
+}
+
+void TraceSpillStore::visit(TraceDivergence* node)
+{
+    writeTag(DIVERGENCE);
+    mStream << (quint32)node->divergedTraces.size();
+    writeChildren(QList<TraceNodePtr>() << node->next << node->divergedTraces);
+}
+
+void TraceSpillStore::visit(TraceConcreteSummarisation* node)
+{
+    writeTag(CONCRETE_SUMMARISATION);
+    mStream << (quint32)node->executions.size();
+
+    QList<TraceNodePtr> children;
+    foreach (TraceConcreteSummarisation::SingleExecution execution, node->executions) {
+        QList<quint8> events;
+        foreach (TraceConcreteSummarisation::EventType event, execution.first) {
+            events.append((quint8)event);
+        }
+        mStream << events;
+        children.append(execution.second);
+    }
+    writeChildren(children);
+}
+
+void TraceSpillStore::visit(TraceEndSuccess* node)
+{
+    writeTag(END_SUCCESS);
+    mStream << node->traceIndices;
+    writeChildren(QList<TraceNodePtr>() << node->next);
+}
+
+void TraceSpillStore::visit(TraceEndFailure* node)
+{
+    writeTag(END_FAILURE);
+    mStream << node->traceIndices;
+    writeChildren(QList<TraceNodePtr>() << node->next);
+}
+
+void TraceSpillStore::visit(TraceEndUnknown* node)
+{
+    writeTag(END_UNKNOWN);
+    mStream << node->traceIndices;
+}
+
+void TraceSpillStore::visit(TraceSpilled* node)
+{
+    // Already in the store, so only the reference is written.
+    writeTag(SPILLED);
+    mStream << node->getOffset();
+}
+
+}
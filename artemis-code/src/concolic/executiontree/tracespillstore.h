@@ -0,0 +1,107 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRACESPILLSTORE_H
+#define TRACESPILLSTORE_H
+
+#include <QDataStream>
+#include <QSharedPointer>
+#include <QStack>
+#include <QTemporaryFile>
+#include <QWeakPointer>
+
+#include "concolic/executiontree/tracenodes.h"
+#include "concolic/executiontree/tracevisitor.h"
+
+namespace artemis
+{
+
+/**
+ * A disk-backed store for fully explored parts of the execution tree, used by TraceSpiller.
+ *
+ * Subtrees are appended to a temporary file (removed at exit) and read back by their offset, always as a new copy.
+ * A subtree which is put back into the tree and spilled again later is written anew, so the file only grows.
+ *
+ * The symbolic conditions and sources of the branches are never freed during a run, so they are written by address.
+ * A store can only be read by the process which wrote it.
+ *
+ * Subtrees are written and read using an explicit stack, as the tree can be deeper than the call stack allows.
+ */
+class TraceSpillStore : public TraceVisitor
+{
+public:
+    static TraceSpillStorePtr create();
+
+    // Writes a subtree to the store and returns its offset, or -1 if it could not be written.
+    qint64 write(TraceNodePtr subtree);
+
+    // Reads a copy of the subtree written at the given offset.
+    TraceNodePtr read(qint64 offset);
+
+    ~TraceSpillStore() {}
+
+private:
+    TraceSpillStore();
+
+    enum NodeTag {
+        NODE_NULL, CONCRETE_BRANCH, SYMBOLIC_BRANCH,
+        UNEXPLORED, UNEXPLORED_UNSAT, UNEXPLORED_UNSOLVABLE, UNEXPLORED_MISSED, UNEXPLORED_QUEUED,
+        ALERT, CONSOLE_MESSAGE, DOM_MODIFICATION, PAGE_LOAD, MARKER, FUNCTION_CALL, DIVERGENCE,
+        CONCRETE_SUMMARISATION, END_SUCCESS, END_FAILURE, END_UNKNOWN, SPILLED
+    };
+
+    QWeakPointer<TraceSpillStore> mSelf; // Given to the placeholders for already spilled subtrees which are read.
+
+    QTemporaryFile mFile;
+    QDataStream mStream;
+    bool mFailed;
+
+    // The nodes which write() still has to write, in reverse order.
+    QStack<TraceNodePtr> mPending;
+    void writeTag(NodeTag tag);
+    void writeBranch(TraceBranch* node);
+    void writeChildren(QList<TraceNodePtr> children);
+
+    TraceNodePtr readNode(int* numChildren);
+    static void attach(TraceNodePtr parent, int position, TraceNodePtr child);
+
+    // The visitor part, which writes a single node.
+    // Should only be called by write().
+    void visit(TraceNode* node);
+    void visit(TraceConcreteBranch* node);
+    void visit(TraceSymbolicBranch* node);
+    void visit(TraceUnexplored* node);
+    void visit(TraceUnexploredUnsat* node);
+    void visit(TraceUnexploredUnsolvable* node);
+    void visit(TraceUnexploredMissed* node);
+    void visit(TraceUnexploredQueued* node);
+    void visit(TraceAlert* node);
+    void visit(TraceConsoleMessage* node);
+    void visit(TraceDomModification* node);
+    void visit(TracePageLoad* node);
+    void visit(TraceMarker* node);
+    void visit(TraceFunctionCall* node);
+    void visit(TraceDivergence* node);
+    void visit(TraceConcreteSummarisation* node);
+    void visit(TraceEndSuccess* node);
+    void visit(TraceEndFailure* node);
+    void visit(TraceEndUnknown* node);
+    void visit(TraceSpilled* node);
+};
+
+}
+
+#endif // TRACESPILLSTORE_H
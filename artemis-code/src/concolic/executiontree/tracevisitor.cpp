@@ -49,6 +49,10 @@ void TraceVisitor::visit(TraceEndUnknown* node)         { visit(static_cast<Trac
 
 void TraceVisitor::visit(TraceDivergence* node)         { visit(static_cast<TraceAnnotation*>(node)); }
 
+// A spilled subtree is loaded and visited in its place, so it is only seen by visitors which override this.
+// The loaded copy is freed again once the call returns.
+void TraceVisitor::visit(TraceSpilled* node)            { node->load()->accept(this); }
+
 
 
 // These helper methods can be useful for concrete visitors.
@@ -47,6 +47,7 @@ class TraceEndSuccess;
 class TraceEndFailure;
 class TraceEndUnknown;
 class TraceDivergence;
+class TraceSpilled;
 
 
 /*
@@ -95,6 +96,7 @@ public:
     virtual void visit(TraceEndFailure* node);
     virtual void visit(TraceEndUnknown* node);
     virtual void visit(TraceDivergence* node);
+    virtual void visit(TraceSpilled* node);
 
     // Helper methods for concrete visitors.
     static bool isImmediatelyUnexplored(QSharedPointer<TraceNode> trace);
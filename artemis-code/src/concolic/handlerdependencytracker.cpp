@@ -16,12 +16,11 @@
 
 #include "handlerdependencytracker.h"
 
-#include "util/fileutil.h"
+#include "util/loggingutil.h"
 #include "statistics/statsstorage.h"
 
-#include <assert.h>
 #include <QDebug>
-#include <QRegExp>
+#include <QFile>
 
 namespace artemis
 {
@@ -30,79 +29,251 @@ HandlerDependencyTracker::HandlerDependencyTracker(bool enabled)
     : mEnabled(enabled)
     , mNoEventLabel("[none]")
 {
-    mCurrentEvent = mNoEventLabel;
+    mCurrentEvent = internLabel(mNoEventLabel);
 }
 
-void HandlerDependencyTracker::writeGraph(QList<int> indexPermutation)
+uint HandlerDependencyTracker::internLabel(const QString& label)
 {
-    if(!mEnabled) {
-        return;
+    QHash<QString, uint>::const_iterator it = mLabelIds.constFind(label);
+    if (it != mLabelIds.constEnd()) {
+        return it.value();
     }
 
-    QString filename = "handlers.gv";
+    uint id = mLabels.size();
+    mLabels.append(label);
+    mLabelIds.insert(label, id);
+    return id;
+}
 
-    QString graph = "digraph {\n  node [shape = \"rectangle\", style = \"filled\", fillcolor = \"forestgreen\"];\n\n";
+quint64 HandlerDependencyTracker::edgeKey(uint source, uint target, bool isSymbolic)
+{
+    return ((quint64)source << 32) | ((quint64)target << 1) | (isSymbolic ? 1 : 0);
+}
 
-    QMap<QString, QString> names;
+uint HandlerDependencyTracker::edgeSource(quint64 key)
+{
+    return (uint)(key >> 32);
+}
 
-    // Declare each node.
+uint HandlerDependencyTracker::edgeTarget(quint64 key)
+{
+    return (uint)((key & 0xFFFFFFFFu) >> 1);
+}
+
+bool HandlerDependencyTracker::edgeIsSymbolic(quint64 key)
+{
+    return (key & 1) != 0;
+}
+
+QList<quint64> HandlerDependencyTracker::sortedEdges()
+{
+    // Sorted, so the output does not depend on the hash order.
+    QList<quint64> edges = mEdgeCounts.keys();
+    qSort(edges);
+    return edges;
+}
+
+QList<HandlerDependencyTracker::GraphNode> HandlerDependencyTracker::buildGraphNodes(const QList<int>& indexPermutation, QHash<uint, QString>* names)
+{
+    QList<GraphNode> nodes;
+
+    // Reads which did not come from a known handler are shown first, as if from an extra event.
+    bool hasNoSource = false;
+    foreach (quint64 edge, mEdgeCounts.keys()) {
+        if (edgeSource(edge) == 0) {
+            hasNoSource = true;
+            break;
+        }
+    }
+
+    // The events in the order they were triggered.
     int idx = 1;
-    QString idxStr;
-    foreach(QString label, mEvents) {
-        names.insert(label, QString("event_%1").arg(idx));
-        idxStr = (idx-1) < indexPermutation.length() ? QString::number(indexPermutation.at(idx-1)) : "";
-        idxStr = idx == mEvents.length() ? "B" : idxStr;
-        graph += QString("  %1 [label = \"%2\", xlabel = \"%3\"];\n").arg(names[label], label, idxStr);
+    foreach (uint label, mEvents) {
+        GraphNode node;
+        node.label = label;
+        node.name = QString("event_%1").arg(idx);
+        node.position = (idx-1) < indexPermutation.length() ? QString::number(indexPermutation.at(idx-1)) : "";
+        node.position = idx == mEvents.length() ? "B" : node.position;
+        node.kind = "event";
+        nodes.append(node);
+        names->insert(label, node.name);
         idx++;
     }
-    // Check for any which were not listed in the event sequence...
-    QSet<QString> extras;
-    foreach(EdgeDescriptor edge, mEdgeCounts.keys()) {
-        assert(mEvents.contains(edge.first.first) || edge.first.first == mNoEventLabel);
-        if(!mEvents.contains(edge.first.second)) {
-            names.insert(edge.first.second, QString("unknown_%1").arg(idx));
-            graph += QString("  %1 [label = \"%2\", fillcolor = \"red\"];\n").arg(names[edge.first.second], edge.first.second);
-            idx++;
-            extras.insert(edge.first.second);
+
+    if (hasNoSource) {
+        GraphNode node;
+        node.label = 0;
+        node.name = "no_source";
+        node.kind = "none";
+        nodes.prepend(node);
+        names->insert(0, node.name);
+    }
+
+    // Any which were not listed in the event sequence.
+    foreach (quint64 edge, sortedEdges()) {
+        uint ends[] = {edgeSource(edge), edgeTarget(edge)};
+        for (int i = 0; i < 2; i++) {
+            if (!names->contains(ends[i])) {
+                GraphNode node;
+                node.label = ends[i];
+                node.name = QString("unknown_%1").arg(idx);
+                node.kind = "unknown";
+                nodes.append(node);
+                names->insert(ends[i], node.name);
+                idx++;
+            }
+        }
+    }
+
+    return nodes;
+}
+
+// Escapes a string for use as a double-quoted graphviz or JSON string.
+static QString quoted(const QString& string)
+{
+    QString result = "\"";
+    result.reserve(string.length() + 2);
+    foreach (QChar c, string) {
+        switch (c.unicode()) {
+        case '"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\r':
+            result += "\\r";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        default:
+            if (c.unicode() < 0x20) {
+                result += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+            } else {
+                result += c;
+            }
         }
     }
-    // Sanity check for any variable reads not coming from a known handler.
-    QSet<QString> observed;
-    foreach(EdgeDescriptor edge, mEdgeCounts.keys()) {
-        observed.insert(edge.first.first);
+    result += "\"";
+    return result;
+}
+
+void HandlerDependencyTracker::writeGraph(QList<int> indexPermutation)
+{
+    if(!mEnabled) {
+        return;
+    }
+
+    QFile graphFile("handlers.gv");
+    if (graphFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        QTextStream out(&graphFile);
+        writeGraphviz(out, indexPermutation);
+    } else {
+        Log::error("Could not write the handler dependency graph to handlers.gv");
     }
-    if(observed.contains(mNoEventLabel)) {
-        names.insert(mNoEventLabel, QString("no_source"));
-        graph += QString("  no_source [label = \"%1\", fillcolor = \"lightgray\"];\n").arg(mNoEventLabel);
-        mEvents.prepend(mNoEventLabel);
+
+    QFile jsonFile("handlers.json");
+    if (jsonFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        QTextStream out(&jsonFile);
+        writeJson(out, indexPermutation);
+    } else {
+        Log::error("Could not write the handler dependency graph to handlers.json");
     }
-    observed.subtract(extras);
-    assert(mEvents.toSet().contains(observed));
+}
+
+void HandlerDependencyTracker::writeGraphviz(QTextStream& out, QList<int> indexPermutation)
+{
+    QHash<uint, QString> names;
+    QList<GraphNode> nodes = buildGraphNodes(indexPermutation, &names);
 
-    graph += "\n";
+    out << "digraph {\n  node [shape = \"rectangle\", style = \"filled\", fillcolor = \"forestgreen\"];\n\n";
+
+    // Declare each node.
+    foreach (const GraphNode& node, nodes) {
+        out << "  " << node.name << " [label = " << quoted(mLabels.at(node.label));
+        if (node.kind == "event") {
+            out << ", xlabel = " << quoted(node.position);
+        } else if (node.kind == "none") {
+            out << ", fillcolor = \"lightgray\"";
+        } else {
+            out << ", fillcolor = \"red\"";
+        }
+        out << "];\n";
+    }
+
+    out << "\n";
 
     // Add invisible edges which keep the main sequence in line.
-    for(int i = 0; i < mEvents.length() - 1; i++) {
-        graph += QString("  %1 -> %2 [style = \"invis\", weight = \"100\"];\n").arg(names[mEvents.at(i)], names[mEvents.at(i+1)]);
+    QString previous;
+    foreach (const GraphNode& node, nodes) {
+        if (node.kind == "unknown") {
+            continue;
+        }
+        if (!previous.isNull()) {
+            out << "  " << previous << " -> " << node.name << " [style = \"invis\", weight = \"100\"];\n";
+        }
+        previous = node.name;
     }
 
-    graph += "\n";
+    out << "\n";
 
     // Add the edges.
-    QString edgeColour;
-    foreach(EdgeDescriptor edge, mEdgeCounts.keys()) {
-        edgeColour = (edge.second ? "blue" : "red");
-        edgeColour = edge.first.first == mNoEventLabel ? "gray" : edgeColour;
-        graph += QString("  %1 -> %2 [label = \" %3\" color = \"%4\"];\n").arg(names[edge.first.first],
-                                                                            names[edge.first.second],
-                                                                            QString::number(mEdgeCounts[edge]),
-                                                                            edgeColour);
+    foreach (quint64 edge, sortedEdges()) {
+        QString edgeColour = edgeIsSymbolic(edge) ? "blue" : "red";
+        edgeColour = edgeSource(edge) == 0 ? "gray" : edgeColour;
+        out << "  " << names.value(edgeSource(edge)) << " -> " << names.value(edgeTarget(edge))
+            << " [label = \" " << mEdgeCounts.value(edge) << "\" color = \"" << edgeColour << "\"];\n";
     }
 
     // Finish
-    graph += "\n}\n";
+    out << "\n}\n";
+}
+
+void HandlerDependencyTracker::writeJson(QTextStream& out, QList<int> indexPermutation)
+{
+    QHash<uint, QString> names;
+    QList<GraphNode> nodes = buildGraphNodes(indexPermutation, &names);
+
+    // The nodes, followed by an adjacency list from each node name to the fields read in it.
+    out << "{\n  \"nodes\": [";
+    bool first = true;
+    foreach (const GraphNode& node, nodes) {
+        out << (first ? "\n" : ",\n");
+        out << "    {\"name\": " << quoted(node.name) << ", \"label\": " << quoted(mLabels.at(node.label))
+            << ", \"kind\": " << quoted(node.kind) << ", \"position\": " << quoted(node.position) << "}";
+        first = false;
+    }
+    out << "\n  ],\n  \"edges\": {";
 
-    writeStringToFile(filename, graph);
+    // sortedEdges() keeps the edges from one source together.
+    bool firstSource = true;
+    bool inSource = false;
+    uint source = 0;
+    foreach (quint64 edge, sortedEdges()) {
+        if (!inSource || edgeSource(edge) != source) {
+            if (inSource) {
+                out << "\n    ]";
+            }
+            source = edgeSource(edge);
+            out << (firstSource ? "\n" : ",\n") << "    " << quoted(names.value(source)) << ": [";
+            firstSource = false;
+            inSource = true;
+            first = true;
+        }
+        out << (first ? "\n" : ",\n");
+        out << "      {\"target\": " << quoted(names.value(edgeTarget(edge)))
+            << ", \"symbolic\": " << (edgeIsSymbolic(edge) ? "true" : "false")
+            << ", \"count\": " << mEdgeCounts.value(edge) << "}";
+        first = false;
+    }
+    if (inSource) {
+        out << "\n    ]";
+    }
+    out << "\n  }\n}\n";
 }
 
 void HandlerDependencyTracker::beginHandler(QString variable)
@@ -111,9 +282,10 @@ void HandlerDependencyTracker::beginHandler(QString variable)
         return;
     }
 
-    mCurrentEvent = variable;
-    if(!mEvents.contains(variable)) {
-        mEvents.append(variable);
+    mCurrentEvent = internLabel(variable);
+    if(!mEventSet.contains(mCurrentEvent)) {
+        mEvents.append(mCurrentEvent);
+        mEventSet.insert(mCurrentEvent);
     } else {
         qDebug() << "Warning: Duplicate event name" << variable << "seen in HandlerDependencyTracker.";
     }
@@ -124,7 +296,8 @@ void HandlerDependencyTracker::newIteration()
     // Reset mEvents, so we only keep the version from the latest run.
     // In fact it should be the same on every iteration (except the initial load...).
     mEvents.clear();
-    mCurrentEvent = mNoEventLabel;
+    mEventSet.clear();
+    mCurrentEvent = 0;
 }
 
 void HandlerDependencyTracker::slJavascriptSymbolicFieldRead(QString variable, bool isSymbolic)
@@ -133,14 +306,25 @@ void HandlerDependencyTracker::slJavascriptSymbolicFieldRead(QString variable, b
         return;
     }
 
-    variable.remove(QRegExp("^SYM_IN_(INT_|BOOL_)?"));
-
-    EdgeDescriptor edge;
-    edge.first.first = mCurrentEvent;
-    edge.first.second = variable;
-    edge.second = isSymbolic;
+    // The prefix is only stripped the first time each variable is read.
+    QHash<QString, uint>::const_iterator it = mVariableIds.constFind(variable);
+    uint target;
+    if (it != mVariableIds.constEnd()) {
+        target = it.value();
+    } else {
+        QString label = variable;
+        if (label.startsWith("SYM_IN_INT_")) {
+            label.remove(0, 11);
+        } else if (label.startsWith("SYM_IN_BOOL_")) {
+            label.remove(0, 12);
+        } else if (label.startsWith("SYM_IN_")) {
+            label.remove(0, 7);
+        }
+        target = internLabel(label);
+        mVariableIds.insert(variable, target);
+    }
 
-    mEdgeCounts[edge] += 1;
+    mEdgeCounts[edgeKey(mCurrentEvent, target, isSymbolic)] += 1;
 }
 
 
@@ -151,18 +335,18 @@ void HandlerDependencyTracker::reportGraphStatistics()
     }
 
     // Read mEdgeCounts and log some statistics about the handlers graph.
-    foreach(EdgeDescriptor edge, mEdgeCounts.keys()) {
+    foreach(quint64 edge, mEdgeCounts.keys()) {
         Statistics::statistics()->accumulate("Concolic::HandlersGraph::TotalEdges", 1);
 
-        if (edge.first.first == mNoEventLabel) {
+        if (edgeSource(edge) == 0) {
             Statistics::statistics()->accumulate("Concolic::HandlersGraph::UnknownEdges", 1);
-        } else if (edge.second) {
+        } else if (edgeIsSymbolic(edge)) {
             Statistics::statistics()->accumulate("Concolic::HandlersGraph::SymbolicEdges", 1);
         } else {
             Statistics::statistics()->accumulate("Concolic::HandlersGraph::ConcreteEdges", 1);
         }
 
-        if (edge.first.first == edge.first.second) {
+        if (edgeSource(edge) == edgeTarget(edge)) {
             Statistics::statistics()->accumulate("Concolic::HandlersGraph::SelfLoops", 1);
         }
     }
@@ -16,8 +16,9 @@
 
 #include <QString>
 #include <QList>
-#include <QMap>
-#include <QPair>
+#include <QHash>
+#include <QSet>
+#include <QTextStream>
 
 #ifndef HANDLERDEPENDENCYTRACKER_H
 #define HANDLERDEPENDENCYTRACKER_H
@@ -31,6 +32,9 @@ namespace artemis
  *
  *  Note that this does not give a full picture of which handlers depend on each other (they may do so concretely,
  *  which this class ignores currently).
+ *
+ *  Handler and field labels are interned, so recording a read is a couple of hash lookups on small integer keys.
+ *  The graph is streamed out as graphviz (handlers.gv) and as a JSON adjacency list (handlers.json).
  */
 class HandlerDependencyTracker : public QObject
 {
@@ -40,6 +44,8 @@ public:
     HandlerDependencyTracker(bool enabled);
 
     void writeGraph(QList<int> indexPermutation);
+    void writeGraphviz(QTextStream& out, QList<int> indexPermutation);
+    void writeJson(QTextStream& out, QList<int> indexPermutation);
 
     void beginHandler(QString variable);
 
@@ -53,13 +59,36 @@ public slots:
 private:
     bool mEnabled;
 
-    QString mCurrentEvent;
-    QList<QString> mEvents;
+    // Label ids index into mLabels, the id of mNoEventLabel is always 0.
+    uint internLabel(const QString& label);
+
+    // The nodes of the graph, in the order they are declared in both output formats.
+    struct GraphNode {
+        uint label;
+        QString name;
+        QString position; // Position in the event sequence, empty for nodes which are not in it.
+        QString kind; // "event", "unknown" or "none".
+    };
+    QList<GraphNode> buildGraphNodes(const QList<int>& indexPermutation, QHash<uint, QString>* names);
+
+    // An edge is packed as (source << 32) | (target << 1) | isSymbolic, so the edges sort by source and then target.
+    static quint64 edgeKey(uint source, uint target, bool isSymbolic);
+    static uint edgeSource(quint64 key);
+    static uint edgeTarget(quint64 key);
+    static bool edgeIsSymbolic(quint64 key);
+    QList<quint64> sortedEdges();
 
     const QString mNoEventLabel;
 
-    typedef QPair<QPair<QString, QString>, bool> EdgeDescriptor;
-    QMap<EdgeDescriptor, uint> mEdgeCounts;
+    QList<QString> mLabels;
+    QHash<QString, uint> mLabelIds;
+    QHash<QString, uint> mVariableIds; // Raw variable names (with the SYM_IN_ prefix) to label ids.
+
+    uint mCurrentEvent;
+    QList<uint> mEvents;
+    QSet<uint> mEventSet;
+
+    QHash<quint64, uint> mEdgeCounts;
 };
 
 } // namespace artemis
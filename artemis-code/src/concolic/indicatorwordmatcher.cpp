@@ -0,0 +1,92 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "indicatorwordmatcher.h"
+
+namespace artemis
+{
+
+IndicatorWordMatcher::IndicatorWordMatcher(const QList<QString>& words)
+{
+    mWords.append(-1); // The root.
+
+    for (int index = 0; index < words.length(); index++) {
+        int state = 0;
+
+        foreach (QChar c, words.at(index)) {
+            int nextState = next(state, c);
+            if (nextState == NO_STATE) {
+                nextState = mWords.size();
+                mWords.append(-1);
+                mTransitions.insert(((quint64)state << 16) | c.toLower().unicode(), nextState);
+            }
+            state = nextState;
+        }
+
+        // An empty word can never match a token, and the first of any duplicate words is reported.
+        if (state != 0 && mWords[state] == -1) {
+            mWords[state] = index;
+        }
+    }
+}
+
+int IndicatorWordMatcher::next(int state, QChar c) const
+{
+    return mTransitions.value(((quint64)state << 16) | c.toLower().unicode(), NO_STATE);
+}
+
+// The same delimiters as TraceDomModDetector::tokenise().
+bool IndicatorWordMatcher::isDelimiter(QChar c)
+{
+    if (c.isSpace()) {
+        return true;
+    }
+
+    switch (c.unicode()) {
+    case '<': case '>': case '"': case '\'': case ':': case '.': case ',': case '!': case '?': case '/': case ';': case '-':
+        return true;
+    default:
+        return false;
+    }
+}
+
+int IndicatorWordMatcher::match(const QString& text, QMap<int, int>* counts) const
+{
+    int matches = 0;
+    int state = 0;
+
+    const QChar* c = text.constData();
+    const QChar* end = c + text.length();
+
+    for (; c <= end; c++) {
+        if (c == end || isDelimiter(*c)) {
+            // End of a token (or of a run of delimiters, where state is still the root).
+            if (state != NO_STATE && mWords[state] != -1) {
+                counts->insert(mWords[state], 1 + counts->value(mWords[state], 0));
+                matches++;
+            }
+            state = 0;
+
+        } else if (state != NO_STATE) {
+            // Stays at NO_STATE until the end of the token once it is not a prefix of any word.
+            state = next(state, *c);
+        }
+    }
+
+    return matches;
+}
+
+}
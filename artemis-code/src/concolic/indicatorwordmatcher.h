@@ -0,0 +1,60 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INDICATORWORDMATCHER_H
+#define INDICATORWORDMATCHER_H
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QHash>
+#include <QVector>
+
+namespace artemis
+{
+
+/*
+ * Finds a fixed list of words in text, in a single pass and without allocating.
+ *
+ * The text is split into tokens as TraceDomModDetector::tokenise() does, and a token matches a word if they are equal
+ * ignoring case. The words are compiled into a trie when the matcher is built, and each token is looked up by walking
+ * the trie as it is read.
+ */
+class IndicatorWordMatcher
+{
+public:
+    IndicatorWordMatcher(const QList<QString>& words);
+
+    // Adds the number of times each word occurs in text to counts, keyed by the index of the word in the list.
+    // Returns the total number of matches.
+    int match(const QString& text, QMap<int, int>* counts) const;
+
+    static bool isDelimiter(QChar c);
+
+private:
+    static const int NO_STATE = -1;
+
+    int next(int state, QChar c) const;
+
+    // (state << 16 | character) -> state, where state 0 is the root.
+    QHash<quint64, int> mTransitions;
+    // state -> index of the word ending there, or -1.
+    QVector<int> mWords;
+};
+
+}
+
+#endif // INDICATORWORDMATCHER_H
@@ -24,39 +24,59 @@ QSharedPointer<ReachablePathsAbort> ReachablePathsAbort::instance;
 
 QSet<QString> ReachablePathsITE::freeVariableNames()
 {
-    ExpressionFreeVariableLister lister;
-    condition->accept(&lister);
-    QSet<QString> result = lister.getResult().keys().toSet();
-    result.unite(thenConstraint->freeVariableNames());
-    result.unite(elseConstraint->freeVariableNames());
-    return result;
+    cache();
+    return mFreeVariableNames;
 }
 
 QSet<Symbolic::Expression*> ReachablePathsITE::getAllConditions()
 {
-    QSet<Symbolic::Expression*> result;
-    result.insert(condition);
-    result.unite(thenConstraint->getAllConditions());
-    result.unite(elseConstraint->getAllConditions());
-    return result;
+    cache();
+    return mAllConditions;
 }
 
-QSet<QString> ReachablePathsDisjunction::freeVariableNames()
+void ReachablePathsITE::cache()
 {
-    QSet<QString> result;
-    foreach (ReachablePathsConstraintPtr c, children) {
-        result.unite(c->freeVariableNames());
+    if (mCached) {
+        return;
     }
-    return result;
+
+    ExpressionFreeVariableLister lister;
+    condition->accept(&lister);
+    mFreeVariableNames = lister.getResult().keys().toSet();
+    mFreeVariableNames.unite(thenConstraint->freeVariableNames());
+    mFreeVariableNames.unite(elseConstraint->freeVariableNames());
+
+    mAllConditions.insert(condition);
+    mAllConditions.unite(thenConstraint->getAllConditions());
+    mAllConditions.unite(elseConstraint->getAllConditions());
+
+    mCached = true;
+}
+
+QSet<QString> ReachablePathsDisjunction::freeVariableNames()
+{
+    cache();
+    return mFreeVariableNames;
 }
 
 QSet<Symbolic::Expression*> ReachablePathsDisjunction::getAllConditions()
 {
-    QSet<Symbolic::Expression*> result;
+    cache();
+    return mAllConditions;
+}
+
+void ReachablePathsDisjunction::cache()
+{
+    if (mCached) {
+        return;
+    }
+
     foreach (ReachablePathsConstraintPtr c, children) {
-        result.unite(c->getAllConditions());
+        mFreeVariableNames.unite(c->freeVariableNames());
+        mAllConditions.unite(c->getAllConditions());
     }
-    return result;
+
+    mCached = true;
 }
 
 QSharedPointer<ReachablePathsOk> ReachablePathsOk::getInstance()
@@ -43,10 +43,15 @@ public:
 typedef QSharedPointer<ReachablePathsConstraint> ReachablePathsConstraintPtr;
 
 
+/*
+ * The ITE and disjunction nodes are hash-consed by ReachablePathsConstraintGenerator, so a constraint is a DAG in which
+ * each distinct sub-constraint appears once. They must not be modified once they have been built: the results of
+ * freeVariableNames() and getAllConditions() are cached, so they are only computed once for each shared node.
+ */
 class ReachablePathsITE : public ReachablePathsConstraint
 {
 public:
-    ReachablePathsITE() {}
+    ReachablePathsITE() : mCached(false) {}
 
     Symbolic::Expression* condition;
     ReachablePathsConstraintPtr thenConstraint;
@@ -56,12 +61,19 @@ public:
     virtual bool isAlwaysAborting() { return false; }
     virtual QSet<QString> freeVariableNames();
     virtual QSet<Symbolic::Expression*> getAllConditions();
+
+protected:
+    void cache();
+
+    bool mCached;
+    QSet<QString> mFreeVariableNames;
+    QSet<Symbolic::Expression*> mAllConditions;
 };
 
 class ReachablePathsDisjunction : public ReachablePathsConstraint
 {
 public:
-    ReachablePathsDisjunction() {}
+    ReachablePathsDisjunction() : mCached(false) {}
 
     QList<ReachablePathsConstraintPtr> children;
 
@@ -69,6 +81,13 @@ public:
     virtual bool isAlwaysAborting() { return false; }
     virtual QSet<QString> freeVariableNames();
     virtual QSet<Symbolic::Expression*> getAllConditions();
+
+protected:
+    void cache();
+
+    bool mCached;
+    QSet<QString> mFreeVariableNames;
+    QSet<Symbolic::Expression*> mAllConditions;
 };
 
 class ReachablePathsOk : public ReachablePathsConstraint
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include "statistics/statsstorage.h"
+
 #include "reachablepathsconstraintgenerator.h"
 
 namespace artemis
@@ -24,11 +26,78 @@ ReachablePathsConstraintPtr ReachablePathsConstraintGenerator::generateConstrain
     // Call the visitor part to process the tree.
     ReachablePathsConstraintGenerator generator;
     tree->accept(&generator);
+
+    Statistics::statistics()->accumulate("Concolic::Reordering::ReachablePathsNodes", generator.mInterned.size());
+    Statistics::statistics()->accumulate("Concolic::Reordering::ReachablePathsSharedNodes", generator.mInternedHits);
+
     return generator.mSubtreeExpression;
 }
 
 ReachablePathsConstraintGenerator::ReachablePathsConstraintGenerator()
+    : mInternedHits(0)
+{
+}
+
+template <typename T>
+static void appendAddress(QByteArray& key, T* pointer)
+{
+    key.append(reinterpret_cast<const char*>(&pointer), sizeof(pointer));
+}
+
+ReachablePathsConstraintPtr ReachablePathsConstraintGenerator::makeITE(Symbolic::Expression* condition, ReachablePathsConstraintPtr thenConstraint, ReachablePathsConstraintPtr elseConstraint)
 {
+    // The condition is irrelevant if both sides are the same sub-constraint.
+    if (thenConstraint == elseConstraint) {
+        return thenConstraint;
+    }
+
+    QByteArray key("I");
+    appendAddress(key, condition);
+    appendAddress(key, thenConstraint.data());
+    appendAddress(key, elseConstraint.data());
+
+    ReachablePathsConstraintPtr& interned = mInterned[key];
+    if (!interned.isNull()) {
+        mInternedHits++;
+        return interned;
+    }
+
+    QSharedPointer<ReachablePathsITE> newExpr = QSharedPointer<ReachablePathsITE>(new ReachablePathsITE());
+    newExpr->condition = condition;
+    newExpr->thenConstraint = thenConstraint;
+    newExpr->elseConstraint = elseConstraint;
+    interned = newExpr;
+    return interned;
+}
+
+ReachablePathsConstraintPtr ReachablePathsConstraintGenerator::makeDisjunction(QList<ReachablePathsConstraintPtr> children)
+{
+    // Drop repeated children, (or A A) is just A.
+    QList<ReachablePathsConstraintPtr> distinct;
+    foreach (ReachablePathsConstraintPtr child, children) {
+        if (!distinct.contains(child)) {
+            distinct.append(child);
+        }
+    }
+    if (distinct.length() == 1) {
+        return distinct.first();
+    }
+
+    QByteArray key("D");
+    foreach (ReachablePathsConstraintPtr child, distinct) {
+        appendAddress(key, child.data());
+    }
+
+    ReachablePathsConstraintPtr& interned = mInterned[key];
+    if (!interned.isNull()) {
+        mInternedHits++;
+        return interned;
+    }
+
+    QSharedPointer<ReachablePathsDisjunction> newExpr = QSharedPointer<ReachablePathsDisjunction>(new ReachablePathsDisjunction());
+    newExpr->children = distinct;
+    interned = newExpr;
+    return interned;
 }
 
 // We cover all the other cases below so this should never be called.
@@ -68,10 +137,7 @@ void ReachablePathsConstraintGenerator::visit(TraceConcreteBranch* node)
     } else {
         // Otherwise, generate a Disjunction constraint.
         // This is because we want to generate the overapproximation, so we assume either branch is reachable.
-        QSharedPointer<ReachablePathsDisjunction> newExpr = QSharedPointer<ReachablePathsDisjunction>(new ReachablePathsDisjunction());
-        newExpr->children.append(trueConstraint);
-        newExpr->children.append(falseConstraint);
-        mSubtreeExpression = newExpr;
+        mSubtreeExpression = makeDisjunction(QList<ReachablePathsConstraintPtr>() << trueConstraint << falseConstraint);
     }
 }
 
@@ -105,11 +171,7 @@ void ReachablePathsConstraintGenerator::visit(TraceSymbolicBranch* node)
         mSubtreeExpression = ReachablePathsAbort::getInstance();
     } else {
         // Otherwise, generate an ITE constraint.
-        QSharedPointer<ReachablePathsITE> newExpr = QSharedPointer<ReachablePathsITE>(new ReachablePathsITE());
-        newExpr->condition = node->getSymbolicCondition();
-        newExpr->thenConstraint = trueConstraint;
-        newExpr->elseConstraint = falseConstraint;
-        mSubtreeExpression = newExpr;
+        mSubtreeExpression = makeITE(node->getSymbolicCondition(), trueConstraint, falseConstraint);
     }
 }
 
@@ -147,9 +209,7 @@ void ReachablePathsConstraintGenerator::visit(TraceConcreteSummarisation* node)
     } else {
         // Otherwise, generate a Disjunction constraint.
         // This is because we want to generate the overapproximation, so we assume any branch is reachable.
-        QSharedPointer<ReachablePathsDisjunction> newExpr = QSharedPointer<ReachablePathsDisjunction>(new ReachablePathsDisjunction());
-        newExpr->children = constraints;
-        mSubtreeExpression = newExpr;
+        mSubtreeExpression = makeDisjunction(constraints);
     }
 
 }
@@ -212,4 +272,17 @@ void ReachablePathsConstraintGenerator::visit(TraceDivergence* node)
     node->next->accept(this);
 }
 
+// A spilled subtree never changes, so its constraint is kept with the placeholder after it has been loaded once.
+// The constraint only refers to the symbolic conditions, which are shared by every copy of the subtree.
+void ReachablePathsConstraintGenerator::visit(TraceSpilled* node)
+{
+    if (node->reachablePaths.isNull()) {
+        node->load()->accept(this);
+        node->reachablePaths = mSubtreeExpression;
+        return;
+    }
+
+    mSubtreeExpression = node->reachablePaths;
+}
+
 } // namespace artemis
@@ -17,6 +17,8 @@
 #ifndef REACHABLEPATHSCONSTRAINTGENERATOR_H
 #define REACHABLEPATHSCONSTRAINTGENERATOR_H
 
+#include <QByteArray>
+#include <QHash>
 #include <QList>
 #include <QPair>
 
@@ -38,6 +40,10 @@ namespace artemis
  * Ignored branches: UNSAT, CNS, Missed, unexplored children of concrete branches [all treated as "don't care"]
  * The returned constraint will exactly charaterise the "good" traces.
  *
+ * The constraint nodes are hash-consed: a sub-constraint with the same condition and the same (already shared)
+ * children is only built once, so the result is a DAG whose size follows the number of distinct subtrees rather than
+ * the number of paths. The constraint writers emit each shared node once, as a named definition.
+ *
  */
 class ReachablePathsConstraintGenerator : public TraceVisitor
 {
@@ -50,8 +56,16 @@ protected:
 
     // The visitor works from the bottom up, setting mSubtreeExpression to represent the set of all terminating traces.
     // If both sides of a branch are known to have the same value, then the branch can be dropped.
-    // TODO: Currently this is only done for constants True and False, not for sub-expressions.
-    // TODO: It would be better to have a check for constraint equality and merge all equal (even equivalent) branches.
+    // As the children are interned, this is a pointer comparison and also covers equal sub-expressions.
+    // TODO: Equal conditions are only detected if they are the same expression; equivalent branches are not merged.
+
+    // Interned constructors for the non-constant nodes.
+    ReachablePathsConstraintPtr makeITE(Symbolic::Expression* condition, ReachablePathsConstraintPtr thenConstraint, ReachablePathsConstraintPtr elseConstraint);
+    ReachablePathsConstraintPtr makeDisjunction(QList<ReachablePathsConstraintPtr> children);
+
+    // Keyed on the node type and the addresses of the condition and children.
+    QHash<QByteArray, ReachablePathsConstraintPtr> mInterned;
+    uint mInternedHits;
 
     // Catch-all (error)
     virtual void visit(TraceNode* node);
@@ -74,6 +88,9 @@ protected:
     // Ignore
     virtual void visit(TraceAnnotation* node);
     virtual void visit(TraceDivergence* node);
+
+    // Loaded once, then the constraint is kept with the placeholder.
+    virtual void visit(TraceSpilled* node);
 };
 
 
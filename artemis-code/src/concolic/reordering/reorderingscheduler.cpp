@@ -0,0 +1,136 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "reorderingscheduler.h"
+
+#include <assert.h>
+#include <QtAlgorithms>
+
+#include "util/loggingutil.h"
+
+namespace artemis
+{
+
+// Tuning of the ranked scheduler, see actionScore().
+// How much of the previous success rate and new paths estimates is kept after each exploration.
+static const double SCHEDULE_HISTORY_WEIGHT = 0.5;
+// Keeps actions whose recent explorations failed from being starved completely.
+static const double SCHEDULE_MIN_SUCCESS_RATE = 0.1;
+// How quickly an action which is not chosen gains priority.
+static const double SCHEDULE_AGING = 0.1;
+
+ReorderingScheduler::ReorderingScheduler(ConcolicReorderingScheduler type)
+    : mType(type)
+    , mPreviousAction(0)
+{
+}
+
+uint ReorderingScheduler::chooseNextAction(QList<uint> actionsToExplore, const QMap<uint, uint>& frontiers)
+{
+    assert(!actionsToExplore.isEmpty());
+
+    qSort(actionsToExplore);
+
+    uint chosen;
+    switch (mType) {
+    case SCHEDULE_RANKED:
+        chosen = chooseNextActionRanked(actionsToExplore, frontiers);
+        break;
+    case SCHEDULE_ROUND_ROBIN:
+    default:
+        chosen = chooseNextActionRoundRobin(actionsToExplore);
+        break;
+    }
+
+    foreach (uint actionIdx, actionsToExplore) {
+        mSchedule[actionIdx].waiting++;
+    }
+    mSchedule[chosen].waiting = 0;
+
+    mPreviousAction = chosen;
+    return chosen;
+}
+
+// Takes the actions in index order. actionsToExplore must be sorted.
+uint ReorderingScheduler::chooseNextActionRoundRobin(const QList<uint>& actionsToExplore) const
+{
+    // On the first run, choose the first action.
+    if (mPreviousAction == 0) {
+        return actionsToExplore[0];
+    }
+    // If we are in the middle of the action sequence, choose the next action.
+    // N.B. This also covers the submit button, as it has a higher index than all the other actions.
+    foreach (uint actionIdx, actionsToExplore) {
+        if (actionIdx > mPreviousAction) {
+            return actionIdx;
+        }
+    }
+    // Otherwise we have wrapped around to the start again.
+    return actionsToExplore[0];
+}
+
+// Chooses the action with the best score, see actionScore(). Ties are broken in round-robin order, which is also the
+// order used on the first run, before anything is known about the actions. actionsToExplore must be sorted.
+uint ReorderingScheduler::chooseNextActionRanked(const QList<uint>& actionsToExplore, const QMap<uint, uint>& frontiers) const
+{
+    uint first = chooseNextActionRoundRobin(actionsToExplore);
+    int start = actionsToExplore.indexOf(first);
+
+    uint best = first;
+    double bestScore = -1;
+
+    for (int i = 0; i < actionsToExplore.size(); i++) {
+        uint actionIdx = actionsToExplore[(start + i) % actionsToExplore.size()];
+        double score = actionScore(actionIdx, frontiers.value(actionIdx, 0));
+        if (score > bestScore) {
+            best = actionIdx;
+            bestScore = score;
+        }
+    }
+
+    Log::debug(QString("ReorderingScheduler: Scheduled action %1 with score %2").arg(best).arg(bestScore).toStdString());
+    return best;
+}
+
+// An action is worth exploring if its tree has many unexplored branches, if its recent explorations were solved
+// with few solver calls, and if they added new paths to the trees. Actions which have been waiting slowly gain
+// priority, so every action is explored eventually.
+double ReorderingScheduler::actionScore(uint actionIdx, uint frontier) const
+{
+    ActionSchedule schedule = mSchedule.value(actionIdx);
+
+    return (1.0 + frontier) *
+           (SCHEDULE_MIN_SUCCESS_RATE + schedule.successRate) *
+           (1.0 + schedule.newPaths) *
+           (1.0 + SCHEDULE_AGING * schedule.waiting);
+}
+
+void ReorderingScheduler::recordExplorationAttempt(uint actionIdx, bool solved, uint solverCalls)
+{
+    // A solved exploration counts as 1 / (number of solver calls it took), a failed one as 0.
+    double success = (solved && solverCalls > 0) ? 1.0 / solverCalls : 0.0;
+    ActionSchedule& schedule = mSchedule[actionIdx];
+    schedule.successRate = SCHEDULE_HISTORY_WEIGHT * schedule.successRate + (1 - SCHEDULE_HISTORY_WEIGHT) * success;
+}
+
+void ReorderingScheduler::recordNewPaths(uint actionIdx, uint newPaths)
+{
+    ActionSchedule& schedule = mSchedule[actionIdx];
+    schedule.newPaths = SCHEDULE_HISTORY_WEIGHT * schedule.newPaths + (1 - SCHEDULE_HISTORY_WEIGHT) * newPaths;
+}
+
+} // namespace artemis
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef REORDERINGSCHEDULER_H
+#define REORDERINGSCHEDULER_H
+
+#include <QList>
+#include <QMap>
+
+#include "runtime/options.h"
+
+namespace artemis
+{
+
+/*
+ * Chooses which action the ConcolicReorderingRuntime explores next.
+ *
+ * SCHEDULE_ROUND_ROBIN takes the actions in index order.
+ * SCHEDULE_RANKED scores each action by the unexplored branches in its tree, its recent solver success rate and the new
+ * paths its recent explorations added to the trees, see actionScore().
+ */
+
+class ReorderingScheduler
+{
+public:
+    ReorderingScheduler(ConcolicReorderingScheduler type);
+
+    // actionsToExplore must not be empty. frontiers gives the unexplored symbolic branches in the tree of each action
+    // (see ConcolicAnalysis::getFrontierSize()), it is only used by SCHEDULE_RANKED.
+    uint chooseNextAction(QList<uint> actionsToExplore, const QMap<uint, uint>& frontiers);
+
+    // The result of an exploration of the action which was chosen, and how many solver calls it took.
+    void recordExplorationAttempt(uint actionIdx, bool solved, uint solverCalls);
+    // The number of new paths added to the trees by the run of an exploration of this action.
+    void recordNewPaths(uint actionIdx, uint newPaths);
+
+    double actionScore(uint actionIdx, uint frontier) const;
+
+protected:
+    ConcolicReorderingScheduler mType;
+    uint mPreviousAction; // 0 before the first action is chosen; action indices start at 1.
+
+    struct ActionSchedule {
+        double successRate; // Recent solver success rate, see recordExplorationAttempt().
+        double newPaths; // Recent number of new paths added to the trees per exploration of this action.
+        uint waiting; // Explorations since this action was last chosen.
+
+        // Unknown actions are assumed to be good, so each action is tried before it can be ranked down.
+        ActionSchedule()
+            : successRate(1)
+            , newPaths(1)
+            , waiting(0)
+        {}
+    };
+    QMap<uint, ActionSchedule> mSchedule;
+
+    uint chooseNextActionRoundRobin(const QList<uint>& actionsToExplore) const;
+    uint chooseNextActionRanked(const QList<uint>& actionsToExplore, const QMap<uint, uint>& frontiers) const;
+};
+
+} // namespace artemis
+#endif // REORDERINGSCHEDULER_H
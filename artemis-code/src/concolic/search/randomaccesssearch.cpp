@@ -307,6 +307,11 @@ void RandomAccessSearch::visit(TraceEnd *node)
     // Ignore.
 }
 
+void RandomAccessSearch::visit(TraceSpilled *node)
+{
+    // Ignore, there are no possible explorations in a spilled subtree.
+}
+
 
 
 
@@ -113,6 +113,7 @@ private:
     void visit(TraceUnexplored* node);
     void visit(TraceAnnotation* node);
     void visit(TraceEnd* node);
+    void visit(TraceSpilled* node);
 
 };
 
@@ -349,6 +349,12 @@ void DepthFirstSearch::visit(TraceEnd *node)
     continueFromLeaf();
 }
 
+void DepthFirstSearch::visit(TraceSpilled *node)
+{
+    // There is nothing left to explore in a spilled subtree, so it is not loaded.
+    continueFromLeaf();
+}
+
 void DepthFirstSearch::slNewTraceAdded(TraceNodePtr parent, int direction, TraceNodePtr suffix, TraceNodePtr fullTrace)
 {
     mTreeHasNewTrace = true;
@@ -81,6 +81,7 @@ public:
     void visit(TraceUnexploredQueued* node);
     void visit(TraceAnnotation* node);      // Ignore all other annotations.
     void visit(TraceEnd* node);             // Stop searching at *any* end node.
+    void visit(TraceSpilled* node);         // Fully explored, so also treated as a leaf.
 
 public slots:
     void slNewTraceAdded(TraceNodePtr parent, int direction, TraceNodePtr suffix, TraceNodePtr fullTrace);
@@ -38,6 +38,7 @@ SMTConstraintWriter::SMTConstraintWriter(ConcolicBenchmarkFeatures disabledFeatu
     , mError(false)
     , mErrorClause(-1)
     , mNextTemporarySequence(0)
+    , mReachablePathsSharedDefinitions(0)
     , mDisabledFeatures(disabledFeatures)
 {
 }
@@ -65,6 +66,18 @@ bool SMTConstraintWriter::encodeUnderscore()
 }
 
 bool SMTConstraintWriter::write(PathConditionPtr pathCondition, FormRestrictions formRestrictions, DomSnapshotStoragePtr domSnapshots, ReachablePathsConstraintSet reachablePaths, ReorderingConstraintInfoPtr reorderingInfo, std::string outputFile)
+{
+    std::ofstream constraintFile;
+    constraintFile.open(outputFile.data());
+
+    bool result = writeToStream(pathCondition, formRestrictions, domSnapshots, reachablePaths, reorderingInfo, constraintFile);
+
+    constraintFile.close();
+
+    return result;
+}
+
+bool SMTConstraintWriter::writeToStream(PathConditionPtr pathCondition, FormRestrictions formRestrictions, DomSnapshotStoragePtr domSnapshots, ReachablePathsConstraintSet reachablePaths, ReorderingConstraintInfoPtr reorderingInfo, std::ostream& output)
 {
     std::string preVisitHookOutput;
     std::string visitorOutput;
@@ -121,17 +134,12 @@ bool SMTConstraintWriter::write(PathConditionPtr pathCondition, FormRestrictions
     postVisitHookOutput = mOutput.str();
     mOutput.str("");
 
-    std::ofstream constraintFile;
-    constraintFile.open(outputFile.data());
-
-    constraintFile << preVisitHookOutput;
-    constraintFile << mPreambleDefinitions.join("\n").toStdString();
-    constraintFile << visitorOutput;
-    constraintFile << reachablePathsOutput;
-    constraintFile << linearOrderingOutput;
-    constraintFile << postVisitHookOutput;
-
-    constraintFile.close();
+    output << preVisitHookOutput;
+    output << mPreambleDefinitions.join("\n").toStdString();
+    output << visitorOutput;
+    output << reachablePathsOutput;
+    output << linearOrderingOutput;
+    output << postVisitHookOutput;
 
     if (mError) {
         return false;
@@ -164,33 +172,55 @@ void SMTConstraintWriter::emitReachablePathsConstraints()
     // mReachablePaths is a set of extra constraints. Each member is a pair: a name for that constraint and a
     // ReachablePathsConstraintPtr to be written. Each constraint takes the form of a tree of ITE decisions with
     // symbolic conditions and either "true" or "false" at each leaf of the tree.
+    //
+    // Every ITE or disjunction node is written once as a named definition (RP_<n>) which its parents refer to, so
+    // the output grows with the number of distinct sub-constraints rather than with the number of paths.
+    // Definitions are shared whenever their bodies are equal. The bodies use the variable names as renamed for each
+    // action, so this is exact and also shares sub-constraints between the constraints for different actions.
+
+    mReachablePathsDefinitions.clear();
+    mReachablePathsSharedDefinitions = 0;
 
     foreach (NamedReachablePathsConstraint constraint, mReachablePaths) {
         if (!mReorderingInfo.isNull()) {
             mReorderingInfo->setIndex(constraint.first.second);
         }
 
+        // The nodes must be rewritten for each constraint, as the renaming above changes their bodies.
+        mReachablePathsNodeNames.clear();
+
         mOutput << std::endl;
         mOutput << "; Reachable-paths constraint for " << constraint.first.first.toStdString() << std::endl;
-        std::string exprString = reachablePathsConstraintExpression(constraint.second, 2);
-        mOutput << "(assert \n" << exprString << "\n)" << std::endl;
+        std::string exprString = reachablePathsConstraintExpression(constraint.second);
+        mOutput << "(assert " << exprString << ")" << std::endl;
+    }
+
+    if (!mReachablePaths.isEmpty()) {
+        Statistics::statistics()->accumulate("Concolic::Solver::ReachablePathsDefinitions", (int)mReachablePathsDefinitions.size());
+        Statistics::statistics()->accumulate("Concolic::Solver::ReachablePathsSharedDefinitions", mReachablePathsSharedDefinitions);
     }
 }
 
-std::string SMTConstraintWriter::reachablePathsConstraintExpression(ReachablePathsConstraintPtr expr, int indent)
+std::string SMTConstraintWriter::reachablePathsConstraintExpression(ReachablePathsConstraintPtr expr)
 {
-    std::string indentStr = std::string(indent, ' ');
-
     // If the expression is just true or false, we have reached a leaf.
     if (expr->isAlwaysTerminating()) {
-        return indentStr + "true";
+        return "true";
     }
     if (expr->isAlwaysAborting()) {
-        return indentStr + "false";
+        return "false";
+    }
+
+    // The constraint is a DAG, shared nodes are only written once.
+    QHash<ReachablePathsConstraint*, std::string>::const_iterator visited = mReachablePathsNodeNames.find(expr.data());
+    if (visited != mReachablePathsNodeNames.end()) {
+        return visited.value();
     }
 
     // Otherwise, we must be at a ReachablePathsITE or ReachablePathsDisjunction node.
+    // The children are written (as definitions) before the body of this node is built.
     // TODO: Really we should use a visitor or something and avoid this constant casting...
+    std::string body;
     QSharedPointer<ReachablePathsITE> ite = expr.dynamicCast<ReachablePathsITE>();
     if (!ite.isNull()) {
 
@@ -200,23 +230,35 @@ std::string SMTConstraintWriter::reachablePathsConstraintExpression(ReachablePat
             error("Writing the reachable-paths constraint did not result in a boolean constraint");
         }
         std::string conditionString = mExpressionBuffer;
-        std::string thenBranch = reachablePathsConstraintExpression(ite->thenConstraint, indent+2);
-        std::string elseBranch = reachablePathsConstraintExpression(ite->elseConstraint, indent+2);
+        std::string thenBranch = reachablePathsConstraintExpression(ite->thenConstraint);
+        std::string elseBranch = reachablePathsConstraintExpression(ite->elseConstraint);
 
-        return indentStr + "(" + ifLabel() + "\n" + indentStr + "  " + conditionString + "\n" + thenBranch + "\n" + elseBranch + "\n" + indentStr + ")";
+        body = "(" + ifLabel() + " " + conditionString + " " + thenBranch + " " + elseBranch + ")";
 
     } else {
         QSharedPointer<ReachablePathsDisjunction> disjunct = expr.dynamicCast<ReachablePathsDisjunction>();
         assert(!disjunct.isNull());
 
-        std::string childStrings;
+        body = "(or";
         foreach (ReachablePathsConstraintPtr childConstraint, disjunct->children) {
-            childStrings.append(reachablePathsConstraintExpression(childConstraint, indent+2));
-            childStrings.append("\n");
+            body += " " + reachablePathsConstraintExpression(childConstraint);
         }
+        body += ")";
+    }
 
-        return indentStr + "(or\n" + childStrings + "\n" + indentStr + ")";
+    std::string& name = mReachablePathsDefinitions[body];
+    if (name.empty()) {
+        std::ostringstream definition;
+        definition << "RP_" << mReachablePathsDefinitions.size();
+        name = definition.str();
+
+        mOutput << "(define-fun " << name << " () Bool " << body << ")" << std::endl;
+    } else {
+        mReachablePathsSharedDefinitions++;
     }
+
+    mReachablePathsNodeNames.insert(expr.data(), name);
+    return name;
 }
 
 void SMTConstraintWriter::emitLinearOrderingConstraints(QSet<QString> varsUsed)
@@ -21,6 +21,7 @@
 #include <map>
 
 #include <QSharedPointer>
+#include <QHash>
 
 #include "JavaScriptCore/symbolic/expr.h"
 #include "JavaScriptCore/symbolic/expression/visitor.h"
@@ -77,6 +78,9 @@ public:
 
     virtual bool write(PathConditionPtr pathCondition, FormRestrictions formRestrictions, DomSnapshotStoragePtr domSnapshots, ReachablePathsConstraintSet reachablePaths, ReorderingConstraintInfoPtr reorderingInfo, std::string outputFile);
 
+    // As write(), but to a stream, e.g. for solvers which run in-process.
+    bool writeToStream(PathConditionPtr pathCondition, FormRestrictions formRestrictions, DomSnapshotStoragePtr domSnapshots, ReachablePathsConstraintSet reachablePaths, ReorderingConstraintInfoPtr reorderingInfo, std::ostream& output);
+
     std::string getErrorReason() {
         return mErrorReason;
     }
@@ -167,7 +171,7 @@ protected:
     QSet<QString> getFreeVariables(PathConditionPtr pc);
 
     virtual void emitReachablePathsConstraints();
-    std::string reachablePathsConstraintExpression(ReachablePathsConstraintPtr expr, int indent);
+    std::string reachablePathsConstraintExpression(ReachablePathsConstraintPtr expr);
     virtual void emitLinearOrderingConstraints(QSet<QString> varsUsed);
     virtual Symbolic::Type getTypeUsedInPC(std::string variable, Symbolic::Type initialValueType);
 
@@ -233,8 +237,15 @@ protected:
     DomSnapshotStoragePtr mDomSnapshots;
     ReachablePathsConstraintSet mReachablePaths;
     ReorderingConstraintInfoPtr mReorderingInfo;
+
     QStringList mPreambleDefinitions;
 
+    // The named definitions emitted for the reachable-paths constraints, keyed on their body, and the definition used
+    // for each node of the constraint currently being written.
+    std::map<std::string, std::string> mReachablePathsDefinitions;
+    QHash<ReachablePathsConstraint*, std::string> mReachablePathsNodeNames;
+    uint mReachablePathsSharedDefinitions;
+
     // Benchmarking
     ConcolicBenchmarkFeatures mDisabledFeatures;
 };
@@ -192,26 +192,24 @@ SolutionPtr CVC4Solver::solve(PathConditionPtr pc, FormRestrictions formRestrict
 
     clog << "Solved as:\n";
 
-    while (fp.good()) {
+    // Reused for every line, so reading the model does not allocate per value.
+    SolverModelEntry entry;
 
-        // split each line
-        std::getline(fp, line);
+    while (std::getline(fp, line)) {
 
         // check for end-of-solutions
         if (line.compare(")") == 0) {
             break;
         }
 
-        std::string symbol;
-        std::string type;
-        std::string value;
+        if (line.empty()) {
+            continue;
+        }
 
-        std::stringstream ss(line);
-        std::getline(ss, symbol, ' '); // skip a static prefix
-        std::getline(ss, symbol, ' ');
-        std::getline(ss, type, ' '); // skip a static prefix
-        std::getline(ss, type, ' ');
-        std::getline(ss, value, ')');
+        if (!SolverModelParser::parseDefineFun(line, &entry)) {
+            Statistics::statistics()->accumulate("Concolic::Solver::ErrorsReadingSolution", 1);
+            return emitError(clog, "Could not parse the model in the solver's result: " + line);
+        }
 
         // decode type of value
         Symbolvalue symbolvalue;
@@ -225,10 +223,10 @@ SolutionPtr CVC4Solver::solve(PathConditionPtr pc, FormRestrictions formRestrict
 
         // Variables not prefixed with SYM_ are ignored
 
-        std::string identifier = cw->decodeIdentifier(symbol);
+        std::string identifier = cw->decodeIdentifier(entry.symbol);
 
         if (identifier.compare(0, 7, "SYM_IN_") == 0) {
-            SolutionPtr ret = decodeDOMInputResult(clog, identifier, type, value, &symbolvalue, formRestrictions);
+            SolutionPtr ret = decodeDOMInputResult(clog, identifier, entry, &symbolvalue, formRestrictions);
             if (!ret.isNull()) return ret;
 
         } else if (identifier.compare(0, 11, "SYM_TARGET_") == 0 && identifier.find("_SOLUTIONXPATH") != std::string::npos) {
@@ -236,21 +234,15 @@ SolutionPtr CVC4Solver::solve(PathConditionPtr pc, FormRestrictions formRestrict
             identifier = identifier.substr(0, identifier.length()-14); // remove _solutionxpath
 
             symbolvalue.kind = Symbolic::OBJECT;
-            value = value.substr(1, value.length() - 2); // Strip quotes from strings
-            symbolvalue.string = value;
+            symbolvalue.string = entry.text;
         } else if (identifier.compare(0, 13, "SYM_ORDERING_") == 0) {
-            if (type.compare("Int") != 0) {
+            if (entry.sort.compare("Int") != 0 || entry.kind != SolverModelEntry::INTEGER) {
                 Statistics::statistics()->accumulate("Concolic::Solver::ErrorsReadingSolution", 1);
                 return emitError(clog, "Type mismatch for ordering variable in solver's result.");
             }
+            // N.B. We never expect to see negative values in the ordering constraints, but that is not checked here.
             symbolvalue.kind = Symbolic::INT;
-            // Handle negative values. N.B. We never expect to see negative values in the ordering constraints, but that is not checked here.
-            if (value.find("(- ") == std::string::npos) {
-                std::stringstream(value) >> symbolvalue.u.integer;
-            } else {
-                std::stringstream(value.substr(3, value.length() - 3)) >> symbolvalue.u.integer;
-                symbolvalue.u.integer *= -1;
-            }
+            symbolvalue.u.integer = entry.integer;
         } else {
             continue;
         }
@@ -260,16 +252,16 @@ SolutionPtr CVC4Solver::solve(PathConditionPtr pc, FormRestrictions formRestrict
 
         switch(symbolvalue.kind) {
         case Symbolic::STRING:
-            clog << symbol << " = \"" << symbolvalue.string << "\"" << std::endl;
+            clog << entry.symbol << " = \"" << symbolvalue.string << "\"" << std::endl;
             break;
         case Symbolic::INT:
-            clog << symbol << " = " << symbolvalue.u.integer << std::endl;
+            clog << entry.symbol << " = " << symbolvalue.u.integer << std::endl;
             break;
         case Symbolic::BOOL:
-            clog << symbol << " = " << symbolvalue.u.boolean << std::endl;
+            clog << entry.symbol << " = " << symbolvalue.u.boolean << std::endl;
             break;
         case Symbolic::OBJECT:
-            clog << symbol << " is xpath[" << symbolvalue.string << "]" << std::endl;
+            clog << entry.symbol << " is xpath[" << symbolvalue.string << "]" << std::endl;
         default:
             break;
         }
@@ -285,9 +277,8 @@ SolutionPtr CVC4Solver::solve(PathConditionPtr pc, FormRestrictions formRestrict
 }
 
 SolutionPtr CVC4Solver::decodeDOMInputResult(std::ofstream& clog,
-                                             std::string identifier,
-                                             std::string type,
-                                             std::string value,
+                                             const std::string& identifier,
+                                             const SolverModelEntry& entry,
                                              Symbolvalue* symbolvalue,
                                              const FormRestrictions& formRestrictions)
 {
@@ -304,7 +295,7 @@ SolutionPtr CVC4Solver::decodeDOMInputResult(std::ofstream& clog,
         exit(1);
     }
 
-    if (type.compare("String") == 0) {
+    if (entry.sort.compare("String") == 0) {
         // Double-check we have a string-typed variable name.
         if (symbol_name_type != Symbolic::STRING){
             Statistics::statistics()->accumulate("Concolic::Solver::ErrorsReadingSolution", 1);
@@ -313,18 +304,10 @@ SolutionPtr CVC4Solver::decodeDOMInputResult(std::ofstream& clog,
 
         symbolvalue->kind = Symbolic::STRING;
 
-        // Strip quotes from strings
-        // TODO: Does this even need to be conditional, can strings be returned without quotes?
-        if (value.find("\"") != std::string::npos && value.length() > 1) {
-            value = value.substr(1, value.length() - 2);
-        }
-
-        // Replace escaped special chars in strings.
-        value = stringResultReplacements(value);
-
-        symbolvalue->string = value;
+        // The parser has already removed the quotes and escapes.
+        symbolvalue->string = entry.text;
 
-    } else if (type.compare("Bool") == 0) {
+    } else if (entry.sort.compare("Bool") == 0) {
         // Double-check we have a bool-typed variable name.
         if (symbol_name_type != Symbolic::BOOL){
             Statistics::statistics()->accumulate("Concolic::Solver::ErrorsReadingSolution", 1);
@@ -333,42 +316,32 @@ SolutionPtr CVC4Solver::decodeDOMInputResult(std::ofstream& clog,
 
         symbolvalue->kind = Symbolic::BOOL;
 
-        if (value.compare("false") == 0) {
-            symbolvalue->u.boolean = false;
-        } else if (value.compare("true") == 0) {
-            symbolvalue->u.boolean = true;
+        if (entry.kind == SolverModelEntry::BOOLEAN) {
+            symbolvalue->u.boolean = entry.boolean;
         } else {
             Statistics::statistics()->accumulate("Concolic::Solver::ErrorsReadingSolution", 1);
             return emitError(clog, "Value of boolean returned is not true/false.");
         }
 
-    } else if (type.compare("Int") == 0) {
+    } else if (entry.sort.compare("Int") == 0) {
+        if (entry.kind != SolverModelEntry::INTEGER) {
+            Statistics::statistics()->accumulate("Concolic::Solver::ErrorsReadingSolution", 1);
+            return emitError(clog, "Value of integer returned is not a numeral.");
+        }
+
         // Check the type according to the variable name.
         if (symbol_name_type == Symbolic::INT) {
             // This really is an int-typed variable.
 
             symbolvalue->kind = Symbolic::INT;
-
-            // Handle negative values.
-            if (value.find("(- ") == std::string::npos) {
-                std::stringstream(value) >> symbolvalue->u.integer;
-            } else {
-                std::stringstream(value.substr(3, value.length() - 3)) >> symbolvalue->u.integer;
-                symbolvalue->u.integer *= -1;
-            }
+            symbolvalue->u.integer = entry.integer;
 
         } else if (symbol_name_type == Symbolic::STRING) {
             // This variable was optimised string->int by the constraint writer to help CVC4.
             // We want to undo this here.
 
             symbolvalue->kind = Symbolic::STRING;
-
-            // Handle negative values.
-            if (value.find("(- ") == std::string::npos) {
-                symbolvalue->string = value;
-            } else {
-                symbolvalue->string = "-" + value.substr(3, value.length() - 3);
-            }
+            symbolvalue->string = entry.text; // Negative values are already written as "-5".
 
             // If the symbol references a select element, then we must ensure that
             // the solved value matches a valid value for the select.
@@ -399,26 +372,13 @@ SolutionPtr CVC4Solver::decodeDOMInputResult(std::ofstream& clog,
     } else {
         Statistics::statistics()->accumulate("Concolic::Solver::ErrorsReadingSolution", 1);
         std::ostringstream err;
-        err << "Unknown type " << type << " encountered in result.";
+        err << "Unknown type " << entry.sort << " encountered in result.";
         return emitError(clog, err.str());
     }
 
     return SolutionPtr(NULL);
 }
 
-std::string CVC4Solver::stringResultReplacements(std::string value)
-{
-    // If there are escaped characters in the solver's result, un-escape them here.
-    QString v = QString::fromStdString(value);
-
-    v.replace("\\'", "'");
-    v.replace("\\\"", "\"");
-    v.replace("\\\\", "\\");
-
-    std::cerr << v.toStdString() << std::endl;
-    return v.toStdString();
-}
-
 SolutionPtr CVC4Solver::emitError(std::ofstream& clog, const std::string& reason, int clause)
 {
     clog << "ERROR: " << reason << std::endl << std::endl;
@@ -18,6 +18,7 @@
 #define CVC4SOLVER_H
 
 #include "solver.h"
+#include "solvermodelparser.h"
 
 #include <QString>
 
@@ -42,8 +43,7 @@ public:
 private:
     SolutionPtr emitError(std::ofstream& clog, const std::string& reason, int clause = -1);
     void emitConstraints(std::ofstream& constraintIndex, const QString& identifier, bool sat);
-    SolutionPtr decodeDOMInputResult(std::ofstream& clog, std::string identifier, std::string type, std::string value, Symbolvalue* result, const FormRestrictions& formRestrictions);
-    std::string stringResultReplacements(std::string value);
+    SolutionPtr decodeDOMInputResult(std::ofstream& clog, const std::string& identifier, const SolverModelEntry& entry, Symbolvalue* result, const FormRestrictions& formRestrictions);
 
     QString mLastConstraintID;
 };
@@ -26,6 +26,7 @@
 #include "statistics/statsstorage.h"
 
 #include "concolic/solver/constraintwriter/kaluza.h"
+#include "concolic/solver/solvermodelparser.h"
 
 #include "kaluzasolver.h"
 
@@ -89,19 +90,12 @@ SolutionPtr KaluzaSolver::solve(PathConditionPtr pc, FormRestrictions formRestri
     std::ifstream fp("/tmp/kaluza-result");
 
     if (fp.is_open()) {
-        while (fp.good()) {
+        // Reused for every line, so reading the model does not allocate per value.
+        SolverModelEntry entry;
 
-            // split each line
-            std::getline(fp, line);
+        while (std::getline(fp, line)) {
 
-            std::string symbol;
-            std::string value;
-
-            std::stringstream lines(line);
-            std::getline(lines, symbol, ' ');
-            std::getline(lines, value, ' ');
-
-            if (symbol.compare("") == 0) {
+            if (!SolverModelParser::parseKaluzaAssignment(line, &entry)) {
                 continue; // ignore blank lines
             }
 
@@ -109,23 +103,19 @@ SolutionPtr KaluzaSolver::solve(PathConditionPtr pc, FormRestrictions formRestri
             Symbolvalue symbolvalue;
             symbolvalue.found = true;
 
-            if (value.compare("false") == 0) {
-                symbolvalue.kind = Symbolic::BOOL;
-                symbolvalue.u.boolean = false;
-
-            } else if (value.compare("true") == 0) {
+            if (entry.kind == SolverModelEntry::BOOLEAN) {
                 symbolvalue.kind = Symbolic::BOOL;
-                symbolvalue.u.boolean = true;
+                symbolvalue.u.boolean = entry.boolean;
 
             } else {
                 symbolvalue.kind = Symbolic::INT;
-                symbolvalue.u.integer = std::atoi(value.c_str());
+                symbolvalue.u.integer = entry.kind == SolverModelEntry::INTEGER ? entry.integer : std::atoi(entry.text.c_str());
             }
 
             // TODO add string support
 
             // save result
-            solution->insertSymbol(symbol.c_str(), symbolvalue);
+            solution->insertSymbol(entry.symbol.c_str(), symbolvalue);
         }
     }
 
@@ -0,0 +1,231 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <QStringList>
+
+#include "statistics/statsstorage.h"
+#include "util/loggingutil.h"
+
+#include "expressionfreevariablelister.h"
+#include "expressionvalueprinter.h"
+
+#include "slicingsolver.h"
+
+namespace artemis
+{
+
+// The cache is dropped when it grows past this many slices.
+static const int MAX_CACHED_SLICES = 4096;
+
+SlicingSolver::SlicingSolver(ConcolicBenchmarkFeatures disabledFeatures, SolverPtr solver)
+    : Solver(disabledFeatures)
+    , mSolver(solver)
+{
+}
+
+QString SlicingSolver::getLastConstraintID()
+{
+    return mSolver->getLastConstraintID();
+}
+
+QList<SlicingSolver::Slice> SlicingSolver::slicePC(PathConditionPtr pc, FormRestrictions formRestrictions)
+{
+    // All the variables in a radio group are linked through the group.
+    QHash<QString, QString> radioGroups;
+    QHash<QString, QSet<QString> > radioVariables;
+    foreach (RadioRestriction rr, formRestrictions.second) {
+        foreach (QString variable, rr.variables) {
+            radioGroups.insert(variable, rr.groupName);
+        }
+        radioVariables[rr.groupName].unite(rr.variables);
+    }
+
+    // Union-find over the conditions, joining two conditions when they share a variable.
+    QList<uint> parent;
+    QList<QSet<QString> > variables;
+    QHash<QString, uint> firstUse;
+    ExpressionFreeVariableLister lister;
+
+    for (uint i = 0; i < pc->size(); i++) {
+        parent.append(i);
+
+        lister.clear();
+        pc->get(i).first->accept(&lister);
+
+        QSet<QString> conditionVariables;
+        foreach (QString variable, lister.getResult().keys()) {
+            conditionVariables.insert(variable);
+            if (radioGroups.contains(variable)) {
+                conditionVariables.unite(radioVariables.value(radioGroups.value(variable)));
+            }
+        }
+        variables.append(conditionVariables);
+
+        foreach (QString variable, conditionVariables) {
+            QHash<QString, uint>::const_iterator use = firstUse.constFind(variable);
+            if (use == firstUse.constEnd()) {
+                firstUse.insert(variable, i);
+                continue;
+            }
+
+            uint a = use.value();
+            while (parent.at(a) != a) {
+                a = parent.at(a);
+            }
+            uint b = i;
+            while (parent.at(b) != b) {
+                b = parent.at(b);
+            }
+            // The lower index is kept as the root, so the slices come out ordered by their first condition.
+            if (a < b) {
+                parent[b] = a;
+            } else if (b < a) {
+                parent[a] = b;
+            }
+        }
+    }
+
+    QList<Slice> slices;
+    QHash<uint, int> sliceIndex;
+    for (uint i = 0; i < pc->size(); i++) {
+        uint root = i;
+        while (parent.at(root) != root) {
+            root = parent.at(root);
+        }
+
+        if (!sliceIndex.contains(root)) {
+            sliceIndex.insert(root, slices.size());
+            slices.append(Slice());
+        }
+
+        Slice& slice = slices[sliceIndex.value(root)];
+        slice.conditions.append(i);
+        slice.variables.unite(variables.at(i));
+    }
+
+    return slices;
+}
+
+// Identifies a slice by its conditions and the restrictions on its variables, which are all that its model depends on.
+QString SlicingSolver::sliceKey(PathConditionPtr pc, const Slice& slice, FormRestrictions formRestrictions)
+{
+    QString key;
+
+    foreach (uint i, slice.conditions) {
+        ExpressionValuePrinter printer;
+        pc->get(i).first->accept(&printer);
+        key += QString::fromStdString(printer.getResult());
+        key += pc->get(i).second ? "\n== true\n" : "\n== false\n";
+    }
+
+    foreach (SelectRestriction sr, formRestrictions.first) {
+        if (slice.variables.contains(sr.variable)) {
+            key += QString("select %1: %2\n").arg(sr.variable, sr.values.join("\n"));
+        }
+    }
+
+    foreach (RadioRestriction rr, formRestrictions.second) {
+        if (slice.variables.contains(rr.variables)) {
+            key += QString("radio %1 %2\n").arg(rr.groupName).arg((int)rr.alwaysSet);
+        }
+    }
+
+    return key;
+}
+
+void SlicingSolver::cacheModel(const QString& key, const Slice& slice, SolutionPtr solution)
+{
+    if (mModels.size() >= MAX_CACHED_SLICES) {
+        mModels.clear();
+    }
+
+    SliceModel model;
+    foreach (QString variable, slice.variables) {
+        Symbolvalue value = solution->findSymbol(variable);
+        if (value.found) {
+            model.insert(variable, value);
+        }
+    }
+    mModels.insert(key, model);
+}
+
+SolutionPtr SlicingSolver::solve(PathConditionPtr pc, FormRestrictions formRestrictions, DomSnapshotStoragePtr domSnapshots, ReachablePathsConstraintSet reachablePaths, ReorderingConstraintInfoPtr reorderingInfo)
+{
+    if (mDisabledFeatures.testFlag(CONSTRAINT_SLICING) || !reachablePaths.isEmpty() || !reorderingInfo.isNull() || pc->size() < 2) {
+        return mSolver->solve(pc, formRestrictions, domSnapshots, reachablePaths, reorderingInfo);
+    }
+
+    QList<Slice> slices = slicePC(pc, formRestrictions);
+
+    // Drop the slices with a cached model, except for the one containing the target branch.
+    QList<QString> keys;
+    QList<int> reused;
+    QList<uint> kept;
+    for (int s = 0; s < slices.size(); s++) {
+        keys.append(sliceKey(pc, slices.at(s), formRestrictions));
+
+        bool isTarget = slices.at(s).conditions.contains(pc->size() - 1);
+        if (!isTarget && mModels.contains(keys.last())) {
+            reused.append(s);
+        } else {
+            kept.append(slices.at(s).conditions);
+        }
+    }
+
+    Statistics::statistics()->accumulate("Concolic::Solver::Slicing::Slices", slices.size());
+    Statistics::statistics()->accumulate("Concolic::Solver::Slicing::ReusedSlices", reused.size());
+    Statistics::statistics()->accumulate("Concolic::Solver::Slicing::DroppedConditions", (int)(pc->size() - kept.size()));
+
+    PathConditionPtr slicedPC = pc;
+    if (!reused.isEmpty()) {
+        qSort(kept);
+        slicedPC = PathConditionPtr(new PathCondition());
+        foreach (uint i, kept) {
+            slicedPC->addCondition(pc->get(i).first, pc->get(i).second, pc->getBranch(i));
+        }
+        Log::debug(QString("  Solving %1 of %2 conditions, reusing the models of %3 independent slices.")
+                   .arg(slicedPC->size()).arg(pc->size()).arg(reused.size()).toStdString());
+    }
+
+    SolutionPtr solution = mSolver->solve(slicedPC, formRestrictions, domSnapshots, reachablePaths, reorderingInfo);
+
+    if (!solution->isSolved()) {
+        // An UNSAT subset means the whole PC is UNSAT. An unsolvable clause is reported as an index into the full PC.
+        if (!solution->isUnsat() && slicedPC != pc &&
+            solution->getUnsolvableClause() >= 0 && solution->getUnsolvableClause() < kept.size()) {
+            return SolutionPtr(new Solution(false, false, solution->getUnsolvableReason(), kept.at(solution->getUnsolvableClause())));
+        }
+        return solution;
+    }
+
+    for (int s = 0; s < slices.size(); s++) {
+        if (!reused.contains(s)) {
+            cacheModel(keys.at(s), slices.at(s), solution);
+        }
+    }
+
+    // The cached models replace any values the solver chose for the variables of the dropped slices.
+    foreach (int s, reused) {
+        SliceModel model = mModels.value(keys.at(s));
+        for (SliceModel::const_iterator it = model.constBegin(); it != model.constEnd(); ++it) {
+            solution->insertSymbol(it.key(), it.value());
+        }
+    }
+
+    return solution;
+}
+
+} // namespace artemis
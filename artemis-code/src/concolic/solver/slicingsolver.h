@@ -0,0 +1,73 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SLICINGSOLVER_H
+#define SLICINGSOLVER_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+
+#include "solver.h"
+
+namespace artemis
+{
+
+/*
+ * Wraps another solver and only sends it the part of the PC which is not already known to be solvable.
+ *
+ * The PC is split into slices of conditions which share no free variables (radio buttons in the same group count as
+ * one variable, as they are constrained together). Each time a PC is solved, the model of every slice is cached.
+ * When a later PC contains a slice which was solved before (e.g. the constraints on the fields which are not touched
+ * by the negated branch), that slice is dropped and its cached model is used instead. The slice containing the
+ * target branch (the last condition) is always solved.
+ *
+ * Slicing is skipped in the modes which add constraints across the whole PC (reachable paths and reordering).
+ */
+class SlicingSolver : public Solver
+{
+public:
+
+    SlicingSolver(ConcolicBenchmarkFeatures disabledFeatures, SolverPtr solver);
+
+    SolutionPtr solve(PathConditionPtr pc, FormRestrictions formRestrictions, DomSnapshotStoragePtr domSnapshots, ReachablePathsConstraintSet reachablePaths, ReorderingConstraintInfoPtr reorderingInfo);
+
+    QString getLastConstraintID();
+
+    struct Slice {
+        QList<uint> conditions; // Indices into the PC, in order.
+        QSet<QString> variables;
+    };
+
+    // The slices of the PC, ordered by their first condition.
+    static QList<Slice> slicePC(PathConditionPtr pc, FormRestrictions formRestrictions);
+
+protected:
+    QString sliceKey(PathConditionPtr pc, const Slice& slice, FormRestrictions formRestrictions);
+    void cacheModel(const QString& key, const Slice& slice, SolutionPtr solution);
+
+    SolverPtr mSolver;
+
+    typedef QHash<QString, Symbolvalue> SliceModel;
+    QHash<QString, SliceModel> mModels;
+};
+
+typedef QSharedPointer<SlicingSolver> SlicingSolverPtr;
+
+}
+
+#endif // SLICINGSOLVER_H
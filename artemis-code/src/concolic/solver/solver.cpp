@@ -17,6 +17,9 @@
 #include "solver.h"
 
 #include "z3solver.h"
+#ifdef ARTEMIS_Z3_INPROCESS
+#include "z3inprocesssolver.h"
+#endif
 #include "kaluzasolver.h"
 #include "cvc4solver.h"
 
@@ -34,6 +37,13 @@ QSharedPointer<Solver> Solver::getSolver(const Options& options)
     switch(options.solver) {
     case Z3STR:
         return Z3SolverPtr(new Z3Solver(options.concolicDisabledFeatures));
+    case Z3STR_INPROCESS:
+#ifdef ARTEMIS_Z3_INPROCESS
+        return Z3InProcessSolverPtr(new Z3InProcessSolver(options.concolicDisabledFeatures));
+#else
+        std::cerr << "The in-process Z3-str solver is not available, Artemis must be built with qmake CONFIG+=z3inprocess" << std::endl;
+        exit(1);
+#endif
     case KALUZA:
         return KaluzaSolverPtr(new KaluzaSolver(options.concolicDisabledFeatures));
     case CVC4:
@@ -0,0 +1,393 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <climits>
+
+#include "solvermodelparser.h"
+
+namespace artemis
+{
+
+static inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static inline bool isDelimiter(char c)
+{
+    return isSpace(c) || c == '(' || c == ')';
+}
+
+static inline int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+size_t SolverModelParser::skipSpace(const std::string& input, size_t pos)
+{
+    while (pos < input.size() && isSpace(input[pos])) {
+        pos++;
+    }
+    return pos;
+}
+
+// Skips a string literal, |quoted symbol|, atom or balanced s-expression starting at pos.
+size_t SolverModelParser::skipExpression(const std::string& input, size_t pos)
+{
+    if (pos >= input.size()) {
+        return std::string::npos;
+    }
+
+    if (input[pos] == '"') {
+        for (size_t i = pos + 1; i < input.size(); i++) {
+            if (input[i] == '\\') {
+                i++;
+            } else if (input[i] == '"') {
+                if (i + 1 < input.size() && input[i + 1] == '"') {
+                    i++;
+                } else {
+                    return i + 1;
+                }
+            }
+        }
+        return std::string::npos;
+    }
+
+    if (input[pos] == '|') {
+        size_t end = input.find('|', pos + 1);
+        return end == std::string::npos ? end : end + 1;
+    }
+
+    if (input[pos] == '(') {
+        pos++;
+        while (true) {
+            pos = skipSpace(input, pos);
+            if (pos >= input.size()) {
+                return std::string::npos;
+            }
+            if (input[pos] == ')') {
+                return pos + 1;
+            }
+            pos = skipExpression(input, pos);
+            if (pos == std::string::npos) {
+                return pos;
+            }
+        }
+    }
+
+    if (input[pos] == ')') {
+        return std::string::npos;
+    }
+
+    while (pos < input.size() && !isDelimiter(input[pos])) {
+        pos++;
+    }
+    return pos;
+}
+
+size_t SolverModelParser::parseStringLiteral(const std::string& input, size_t pos, std::string* result)
+{
+    result->clear();
+    pos++; // The opening quote.
+
+    while (pos < input.size()) {
+        // Copy the plain characters up to the next quote or escape in one go.
+        size_t special = input.find_first_of("\"\\", pos);
+        if (special == std::string::npos) {
+            return std::string::npos;
+        }
+        result->append(input, pos, special - pos);
+        pos = special;
+
+        if (input[pos] == '"') {
+            // A doubled quote is an escaped quote (SMT-LIB 2.5), otherwise it ends the string.
+            if (pos + 1 < input.size() && input[pos + 1] == '"') {
+                result->push_back('"');
+                pos += 2;
+                continue;
+            }
+            return pos + 1;
+        }
+
+        if (pos + 1 >= input.size()) {
+            return std::string::npos;
+        }
+
+        char escaped = input[pos + 1];
+        pos += 2;
+        switch (escaped) {
+        case '\\': result->push_back('\\'); break;
+        case '"': result->push_back('"'); break;
+        case '\'': result->push_back('\''); break;
+        case 'n': result->push_back('\n'); break;
+        case 't': result->push_back('\t'); break;
+        case 'r': result->push_back('\r'); break;
+        case 'a': result->push_back('\a'); break;
+        case 'b': result->push_back('\b'); break;
+        case 'v': result->push_back('\v'); break;
+        case 'f': result->push_back('\f'); break;
+        case 'e': result->push_back('\x1B'); break;
+        case 'x':
+            if (pos + 1 < input.size() && hexValue(input[pos]) >= 0 && hexValue(input[pos + 1]) >= 0) {
+                result->push_back((char)(hexValue(input[pos]) * 16 + hexValue(input[pos + 1])));
+                pos += 2;
+            } else {
+                result->append("\\x");
+            }
+            break;
+        case 'u': {
+            // Either \uXXXX or \u{X...}.
+            unsigned int codepoint = 0;
+            size_t end = pos;
+            bool braced = pos < input.size() && input[pos] == '{';
+            if (braced) {
+                end++;
+            }
+            size_t digits = 0;
+            while (end < input.size() && hexValue(input[end]) >= 0 && digits < (braced ? 5u : 4u)) {
+                codepoint = codepoint * 16 + hexValue(input[end]);
+                end++;
+                digits++;
+            }
+            if ((braced ? (digits > 0 && end < input.size() && input[end] == '}') : digits == 4) && codepoint <= 0xFF) {
+                // The values are read back with QString::fromStdString, which takes Latin-1 in Qt 4, so the code
+                // point is stored as a single byte. Larger code points cannot be stored and keep their escape.
+                result->push_back((char)codepoint);
+                pos = braced ? end + 1 : end;
+            } else {
+                result->append("\\u");
+            }
+            break;
+        }
+        default:
+            // Not an escape we know, so it is kept as it is.
+            result->push_back('\\');
+            result->push_back(escaped);
+        }
+    }
+
+    return std::string::npos;
+}
+
+bool SolverModelParser::parseInteger(const char* begin, const char* end, int* result)
+{
+    const char* digits = begin;
+    bool negative = false;
+    if (digits < end && *digits == '-') {
+        negative = true;
+        digits++;
+    }
+    if (digits == end) {
+        return false;
+    }
+
+    long long value = 0;
+    for (const char* c = digits; c < end; c++) {
+        if (*c < '0' || *c > '9') {
+            return false;
+        }
+        if (value <= (long long)INT_MAX + 1) {
+            value = value * 10 + (*c - '0');
+        }
+    }
+    value = negative ? -value : value;
+
+    *result = value > INT_MAX ? INT_MAX : (value < INT_MIN ? INT_MIN : (int)value);
+    return true;
+}
+
+void SolverModelParser::setAtom(const char* begin, const char* end, SolverModelEntry* result)
+{
+    size_t length = end - begin;
+    if (length == 4 && std::char_traits<char>::compare(begin, "true", 4) == 0) {
+        result->kind = SolverModelEntry::BOOLEAN;
+        result->boolean = true;
+        result->text.assign(begin, end);
+    } else if (length == 5 && std::char_traits<char>::compare(begin, "false", 5) == 0) {
+        result->kind = SolverModelEntry::BOOLEAN;
+        result->boolean = false;
+        result->text.assign(begin, end);
+    } else if (parseInteger(begin, end, &result->integer)) {
+        result->kind = SolverModelEntry::INTEGER;
+        result->text.assign(begin, end);
+    } else {
+        result->kind = SolverModelEntry::OTHER;
+        result->text.assign(begin, end);
+    }
+}
+
+size_t SolverModelParser::parseValue(const std::string& input, size_t pos, SolverModelEntry* result)
+{
+    pos = skipSpace(input, pos);
+    if (pos >= input.size()) {
+        return std::string::npos;
+    }
+
+    const char* data = input.data();
+
+    if (input[pos] == '"') {
+        result->kind = SolverModelEntry::STRING;
+        return parseStringLiteral(input, pos, &result->text);
+    }
+
+    size_t end = skipExpression(input, pos);
+    if (end == std::string::npos) {
+        return end;
+    }
+
+    if (input[pos] == '(') {
+        // Negative integers are written as (- 5).
+        size_t minus = skipSpace(input, pos + 1);
+        if (minus < end && input[minus] == '-' && minus + 1 < end && isSpace(input[minus + 1])) {
+            size_t digits = skipSpace(input, minus + 1);
+            size_t digitsEnd = digits;
+            while (digitsEnd < end && input[digitsEnd] >= '0' && input[digitsEnd] <= '9') {
+                digitsEnd++;
+            }
+            if (digitsEnd > digits && skipSpace(input, digitsEnd) == end - 1) {
+                result->kind = SolverModelEntry::INTEGER;
+                result->text.assign("-");
+                result->text.append(data + digits, digitsEnd - digits);
+                parseInteger(result->text.data(), result->text.data() + result->text.size(), &result->integer);
+                return end;
+            }
+        }
+
+        result->kind = SolverModelEntry::OTHER;
+        result->text.assign(data + pos, end - pos);
+        return end;
+    }
+
+    setAtom(data + pos, data + end, result);
+    return end;
+}
+
+bool SolverModelParser::parseDefineFun(const std::string& line, SolverModelEntry* result)
+{
+    size_t pos = skipSpace(line, 0);
+    if (pos >= line.size() || line[pos] != '(') {
+        return false;
+    }
+
+    pos = skipSpace(line, pos + 1);
+    if (line.compare(pos, 10, "define-fun") != 0 || pos + 10 >= line.size() || !isSpace(line[pos + 10])) {
+        return false;
+    }
+
+    // The symbol, which may be quoted as |symbol|.
+    pos = skipSpace(line, pos + 10);
+    size_t end = skipExpression(line, pos);
+    if (end == std::string::npos || end == pos || line[pos] == '(' || line[pos] == '"') {
+        return false;
+    }
+    if (line[pos] == '|') {
+        result->symbol.assign(line, pos + 1, end - pos - 2);
+    } else {
+        result->symbol.assign(line, pos, end - pos);
+    }
+
+    // The arguments, which are always () for constants.
+    pos = skipSpace(line, end);
+    end = skipExpression(line, pos);
+    if (end == std::string::npos || line[pos] != '(') {
+        return false;
+    }
+
+    pos = skipSpace(line, end);
+    end = skipExpression(line, pos);
+    if (end == std::string::npos || end == pos) {
+        return false;
+    }
+    result->sort.assign(line, pos, end - pos);
+
+    pos = parseValue(line, end, result);
+    if (pos == std::string::npos) {
+        return false;
+    }
+
+    pos = skipSpace(line, pos);
+    if (pos >= line.size() || line[pos] != ')') {
+        return false;
+    }
+    return skipSpace(line, pos + 1) == line.size();
+}
+
+bool SolverModelParser::parseZ3StrAssignment(const std::string& line, SolverModelEntry* result)
+{
+    size_t symbolEnd = line.find(' ');
+    if (symbolEnd == 0 || symbolEnd == std::string::npos) {
+        return false;
+    }
+    size_t delimEnd = line.find(' ', symbolEnd + 1);
+    if (line.compare(symbolEnd + 1, delimEnd == std::string::npos ? std::string::npos : delimEnd - symbolEnd - 1, ":") != 0) {
+        return false;
+    }
+
+    result->symbol.assign(line, 0, symbolEnd);
+    result->sort.clear();
+
+    const char* data = line.data();
+    size_t value = delimEnd == std::string::npos ? line.size() : delimEnd + 1;
+    size_t valueEnd = line.size();
+
+    // Empty strings are printed as "", otherwise strings are not quoted.
+    if (valueEnd - value == 2 && line.compare(value, 2, "\"\"") == 0) {
+        result->kind = SolverModelEntry::STRING;
+        result->text.clear();
+        return true;
+    }
+
+    // Negative integers are printed as (- 5), which is only read as such if it is the whole value.
+    if (line.compare(value, 3, "(- ") == 0 && valueEnd - value > 4 && line[valueEnd - 1] == ')' && line[value + 3] != '-' &&
+            parseInteger(data + value + 3, data + valueEnd - 1, &result->integer)) {
+        result->kind = SolverModelEntry::INTEGER;
+        result->text.assign("-");
+        result->text.append(data + value + 3, valueEnd - value - 4);
+        parseInteger(result->text.data(), result->text.data() + result->text.size(), &result->integer);
+        return true;
+    }
+
+    result->kind = SolverModelEntry::STRING;
+    result->text.assign(data + value, valueEnd - value);
+    return true;
+}
+
+bool SolverModelParser::parseKaluzaAssignment(const std::string& line, SolverModelEntry* result)
+{
+    size_t symbolEnd = line.find(' ');
+    if (symbolEnd == 0 || line.empty()) {
+        return false;
+    }
+    symbolEnd = symbolEnd == std::string::npos ? line.size() : symbolEnd;
+
+    size_t value = symbolEnd == line.size() ? symbolEnd : symbolEnd + 1;
+    size_t valueEnd = line.find(' ', value);
+    valueEnd = valueEnd == std::string::npos ? line.size() : valueEnd;
+
+    result->symbol.assign(line, 0, symbolEnd);
+    result->sort.clear();
+    setAtom(line.data() + value, line.data() + valueEnd, result);
+    return true;
+}
+
+} // namespace artemis
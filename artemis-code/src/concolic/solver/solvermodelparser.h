@@ -0,0 +1,78 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SOLVERMODELPARSER_H
+#define SOLVERMODELPARSER_H
+
+#include <string>
+
+namespace artemis
+{
+
+/*
+ * One assignment read from a solver's model.
+ *
+ * The strings keep their capacity between lines, so a single entry can be reused for a whole model without
+ * allocating again for each line.
+ */
+struct SolverModelEntry {
+    enum Kind {
+        STRING, INTEGER, BOOLEAN, OTHER
+    };
+
+    Kind kind;
+    std::string symbol;
+    std::string sort; // Empty if the solver does not give the sort of each value.
+    std::string text; // The unescaped string in Latin-1, the integer in decimal (e.g. "-5"), "true"/"false" or the raw value.
+    int integer; // Saturated at INT_MIN/INT_MAX.
+    bool boolean;
+};
+
+/*
+ * Single-pass parsers for the model lines written by each solver backend.
+ *
+ * These replace the stringstream/getline splitting in the solvers, which cut values at the first ')' or ' ' and
+ * un-escaped strings with several passes of QString::replace.
+ */
+class SolverModelParser
+{
+public:
+    // CVC4: (define-fun SYM_IN_x () String "value")
+    // The sort and the value may be s-expressions, e.g. (- 5). Strings may contain escapes and parentheses.
+    static bool parseDefineFun(const std::string& line, SolverModelEntry* result);
+
+    // Z3-str.py: SYM_IN_x : value
+    // The value is the rest of the line, which is unquoted. "" is the empty string and (- 5) is a negative integer.
+    static bool parseZ3StrAssignment(const std::string& line, SolverModelEntry* result);
+
+    // Kaluza: SYM_IN_x value
+    static bool parseKaluzaAssignment(const std::string& line, SolverModelEntry* result);
+
+    // Reads one SMT-LIB value (a string literal, numeral, boolean or s-expression) starting at pos.
+    // Returns the position after the value, or std::string::npos if it is malformed.
+    static size_t parseValue(const std::string& input, size_t pos, SolverModelEntry* result);
+
+private:
+    static size_t skipSpace(const std::string& input, size_t pos);
+    static size_t skipExpression(const std::string& input, size_t pos);
+    static size_t parseStringLiteral(const std::string& input, size_t pos, std::string* result);
+    static bool parseInteger(const char* begin, const char* end, int* result);
+    static void setAtom(const char* begin, const char* end, SolverModelEntry* result);
+};
+
+}
+
+#endif // SOLVERMODELPARSER_H
@@ -0,0 +1,250 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <set>
+#include <sstream>
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include "strTheory.h"
+
+#include "util/loggingutil.h"
+#include "statistics/statsstorage.h"
+
+#include "concolic/solver/constraintwriter/z3str.h"
+
+#include "z3inprocesssolver.h"
+
+namespace artemis
+{
+
+// The string theory keeps its state in globals, so there can only be one context. It is created on first use and
+// kept for the rest of the run.
+static Z3_context gContext = NULL;
+
+static Z3_context getContext()
+{
+    if (gContext == NULL) {
+        gContext = mk_my_context();
+        Z3_theory theory = mk_pa_theory(gContext);
+        gContext = Z3_theory_get_context(theory);
+    }
+    return gContext;
+}
+
+// Reads a value from the model in the same format as Z3-str prints it.
+static std::string modelValue(Z3_context context, Z3_ast value)
+{
+    if (Z3_get_ast_kind(context, value) == Z3_NUMERAL_AST) {
+        return Z3_get_numeral_string(context, value);
+    }
+
+    switch (Z3_get_bool_value(context, value)) {
+    case Z3_L_TRUE:
+        return "true";
+    case Z3_L_FALSE:
+        return "false";
+    default:
+        break;
+    }
+
+    // String constants are theory values, named by their content.
+    if (Z3_is_app(context, value) && Z3_get_app_num_args(context, Z3_to_app(context, value)) == 0) {
+        Z3_func_decl decl = Z3_get_app_decl(context, Z3_to_app(context, value));
+        std::string name = Z3_get_symbol_string(context, Z3_get_decl_name(context, decl));
+        return name.compare("\"\"") == 0 ? "" : name;
+    }
+
+    return Z3_ast_to_string(context, value);
+}
+
+Z3InProcessSolver::Z3InProcessSolver(ConcolicBenchmarkFeatures disabledFeatures)
+    : Solver(disabledFeatures)
+{
+}
+
+SolutionPtr Z3InProcessSolver::solve(PathConditionPtr pc, FormRestrictions formRestrictions, DomSnapshotStoragePtr domSnapshots, ReachablePathsConstraintSet reachablePaths, ReorderingConstraintInfoPtr reorderingInfo)
+{
+    // 1. translate pc to something solvable using the translator
+
+    Z3STRConstraintWriterPtr cw = Z3STRConstraintWriterPtr(new Z3STRConstraintWriter(mDisabledFeatures));
+    std::ostringstream constraints;
+
+    if (!cw->writeToStream(pc, formRestrictions, domSnapshots, reachablePaths, reorderingInfo, constraints)) {
+        Statistics::statistics()->accumulate("Concolic::Solver::ConstraintsNotWritten", 1);
+        QString reason = QString("Could not translate the PC into solver input: %1").arg(QString::fromStdString(cw->getErrorReason()));
+        return SolutionPtr(new Solution(false, false, reason, cw->getErrorClause()));
+    }
+
+    std::string input;
+    if (!convertConstraints(constraints.str(), &input)) {
+        Statistics::statistics()->accumulate("Concolic::Solver::ConstraintsNotWritten", 1);
+        return SolutionPtr(new Solution(false, false, "Could not convert the string constants in the solver input."));
+    }
+
+    Statistics::statistics()->accumulate("Concolic::Solver::ConstraintsWritten", 1);
+
+    // 2. solve it in a fresh scope of the shared context
+
+    Z3_context context = getContext();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    Z3_push(context);
+
+    Z3_ast formula = Z3_parse_smtlib2_string(context, input.c_str(), 0, 0, 0, 0, 0, 0);
+    Z3_error_code error = Z3_get_error_code(context);
+
+    SolutionPtr solution;
+
+    if (error != Z3_OK) {
+        Statistics::statistics()->accumulate("Concolic::Solver::ConstraintsNotSolved", 1);
+        solution = SolutionPtr(new Solution(false, false, QString("Z3 could not parse the solver input: %1").arg(Z3_get_error_msg_ex(context, error))));
+
+    } else {
+        Z3_assert_cnstr(context, formula);
+
+        Z3_model model = 0;
+        Z3_lbool result = Z3_check_and_get_model(context, &model);
+
+        Statistics::statistics()->accumulate("Concolic::Solver::ConstraintsSolved", 1);
+
+        // 3. interpret the result
+
+        if (result != Z3_L_TRUE) {
+            // Like the Z3-str.py path, an unknown result is treated as UNSAT.
+            Statistics::statistics()->accumulate("Concolic::Solver::ConstraintsSolvedAsUNSAT", 1);
+            solution = SolutionPtr(new Solution(false, true));
+
+        } else {
+            solution = SolutionPtr(new Solution(true, false));
+
+            for (unsigned i = 0; i < Z3_get_model_num_constants(context, model); i++) {
+                Z3_func_decl decl = Z3_get_model_constant(context, model, i);
+                std::string symbol = Z3_get_symbol_string(context, Z3_get_decl_name(context, decl));
+
+                // Skip the temporaries introduced by the string theory and the string constants.
+                if (symbol.compare(0, 3, "_t_") == 0 || symbol.compare(0, 11, "__cOnStStR_") == 0) {
+                    continue;
+                }
+
+                Z3_ast value;
+                if (!Z3_eval_func_decl(context, model, decl, &value)) {
+                    continue;
+                }
+
+                // As for Z3Solver, all values are returned as strings since the inputs are strings.
+                Symbolvalue symbolvalue;
+                symbolvalue.found = true;
+                symbolvalue.kind = Symbolic::STRING;
+                symbolvalue.string = modelValue(context, value);
+
+                solution->insertSymbol(cw->decodeIdentifier(symbol).c_str(), symbolvalue);
+            }
+        }
+
+        if (model) {
+            Z3_del_model(context, model);
+        }
+    }
+
+    Z3_pop(context, 1);
+    reset_str_theory();
+
+    double time = (double)timer.elapsed() / 1000;
+    Log::debug(QString("  Took %1s").arg(time).toStdString());
+    Statistics::statistics()->accumulate("Concolic::Solver::TotalSolverTime", time);
+
+    return solution;
+}
+
+bool Z3InProcessSolver::convertConstraints(const std::string& constraints, std::string* result)
+{
+    // The same encoding as encodeConstStr() in Z3-str.py, which the string theory decodes again.
+    static const char* encodings[][2] = {
+        {" ", "_aScIi_040"}, {"\\\"", "_aScIi_042"}, {"#", "_aScIi_043"}, {"$", "_aScIi_044"},
+        {"'", "_aScIi_047"}, {"(", "_aScIi_050"}, {")", "_aScIi_051"}, {",", "_aScIi_054"},
+        {":", "_aScIi_072"}, {";", "_aScIi_073"}, {"[", "_aScIi_133"}, {"]", "_aScIi_135"},
+        {"\\\\", "_aScIi_134"}, {"{", "_aScIi_173"}, {"}", "_aScIi_175"}, {"|", "_aScIi_174"},
+        {"`", "_aScIi_140"}
+    };
+
+    std::ostringstream declarations;
+    std::ostringstream body;
+    std::set<std::string> declared;
+
+    std::istringstream input(constraints);
+    std::string line;
+
+    while (std::getline(input, line)) {
+        size_t first = line.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos) {
+            continue;
+        }
+        line = line.substr(first, line.find_last_not_of(" \t\r\n") - first + 1);
+
+        if (line[0] == ';' || line[0] == '%' ||
+            line.find("get-model") != std::string::npos || line.find("set-option") != std::string::npos) {
+            continue;
+        }
+
+        size_t start = line.find('"');
+        while (start != std::string::npos) {
+            // A quote after an odd number of backslashes is escaped and does not end the constant.
+            size_t end = line.find('"', start + 1);
+            while (end != std::string::npos) {
+                size_t backslashes = 0;
+                while (end - backslashes > start + 1 && line[end - backslashes - 1] == '\\') {
+                    backslashes++;
+                }
+                if (backslashes % 2 == 0) {
+                    break;
+                }
+                end = line.find('"', end + 1);
+            }
+
+            if (end == std::string::npos) {
+                return false;
+            }
+
+            std::string constant = line.substr(start + 1, end - start - 1);
+            for (size_t i = 0; i < sizeof(encodings) / sizeof(encodings[0]); i++) {
+                std::string from = encodings[i][0];
+                std::string to = encodings[i][1];
+                for (size_t pos = constant.find(from); pos != std::string::npos; pos = constant.find(from, pos + to.length())) {
+                    constant.replace(pos, from.length(), to);
+                }
+            }
+
+            std::string name = "__cOnStStR_" + constant;
+            if (declared.insert(name).second) {
+                declarations << "(declare-const " << name << " String)\n";
+            }
+
+            line.replace(start, end - start + 1, name);
+            start = line.find('"', start + name.length());
+        }
+
+        body << line << "\n";
+    }
+
+    *result = declarations.str() + "\n" + body.str();
+    return true;
+}
+
+} // namespace artemis
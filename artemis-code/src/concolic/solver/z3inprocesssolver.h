@@ -0,0 +1,54 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef Z3INPROCESSSOLVER_H
+#define Z3INPROCESSSOLVER_H
+
+#include <string>
+
+#include "solver.h"
+
+namespace artemis
+{
+
+/*
+ * The Z3-str solver, linked into Artemis (contrib/Z3 and the string theory from contrib/Z3-str) instead of run
+ * through Z3-str.py.
+ *
+ * The constraints are written by the same Z3STRConstraintWriter as for Z3Solver, but kept in memory and parsed with
+ * the Z3 API into a single context which lives for the whole run. Each constraint is solved in its own scope
+ * (Z3_push/Z3_pop) and the model is read back through the API.
+ */
+class Z3InProcessSolver : public Solver
+{
+public:
+
+    Z3InProcessSolver(ConcolicBenchmarkFeatures disabledFeatures);
+
+    SolutionPtr solve(PathConditionPtr pc, FormRestrictions formRestrictions, DomSnapshotStoragePtr domSnapshots, ReachablePathsConstraintSet reachablePaths, ReorderingConstraintInfoPtr reorderingInfo);
+
+    // The Z3 parser does not understand string constants, so they are replaced by specially named string variables
+    // which the string theory turns back into constants, as done by Z3-str.py. Returns false if a constant is not
+    // terminated.
+    static bool convertConstraints(const std::string& constraints, std::string* result);
+
+};
+
+typedef QSharedPointer<Z3InProcessSolver> Z3InProcessSolverPtr;
+
+}
+
+#endif // Z3INPROCESSSOLVER_H
@@ -27,6 +27,7 @@
 #include "statistics/statsstorage.h"
 
 #include "concolic/solver/constraintwriter/z3str.h"
+#include "concolic/solver/solvermodelparser.h"
 
 #include "z3solver.h"
 
@@ -119,63 +120,34 @@ SolutionPtr Z3Solver::solve(PathConditionPtr pc, FormRestrictions formRestrictio
 
         constraintLog << "Solved as:\n";
 
-        while (fp.good()) {
+        // Reused for every line, so reading the model does not allocate per value.
+        SolverModelEntry entry;
 
-            // split each line
-            std::getline(fp, line);
+        while (std::getline(fp, line)) {
 
             // check for end-of-solutions
             if (line.compare("************************") == 0) {
                 break;
             }
 
-            std::string symbol;
-            std::string delim;
-            std::string value;
-
-            std::stringstream lines(line);
-            std::getline(lines, symbol, ' ');
-            std::getline(lines, delim, ' ');
-            std::getline(lines, value, '\n');
-
-            // decode type of value
-            Symbolvalue symbolvalue;
-            symbolvalue.found = true;
-
-            // Empty string is signalled by the solver script as the literal ""
-            // This means we cannot inject the literal "" (i.e. two double quotes) now.
-            if(value.compare("\"\"") == 0){
-                value.clear();
+            if (!SolverModelParser::parseZ3StrAssignment(line, &entry)) {
+                continue;
             }
 
-            /*if (value.compare("false") == 0) {
-                symbolvalue.kind = Symbolic::BOOL;
-                symbolvalue.u.boolean = false;
-
-            } else if (value.compare("true") == 0) {
-                symbolvalue.kind = Symbolic::BOOL;
-                symbolvalue.u.boolean = true;
-
-            } else {
-                symbolvalue.kind = Symbolic::INT;
-                symbolvalue.u.integer = std::atoi(value.c_str());
-            }*/
-
             // TODO, add support for the other types,
             // right now not needed as we only have symbolic strings as input
 
+            // Empty string is signalled by the solver script as the literal ""
+            // This means we cannot inject the literal "" (i.e. two double quotes) now.
+            Symbolvalue symbolvalue;
+            symbolvalue.found = true;
             symbolvalue.kind = Symbolic::STRING;
-
-            if (value.find("(- ") == std::string::npos) { // not a negative value
-                symbolvalue.string = value;
-            } else {
-                symbolvalue.string = "-" + value.substr(3, value.length() - 4);
-            }
+            symbolvalue.string = entry.text;
 
             // save result
-            solution->insertSymbol(cw->decodeIdentifier(symbol).c_str(), symbolvalue);
+            solution->insertSymbol(cw->decodeIdentifier(entry.symbol).c_str(), symbolvalue);
 
-            constraintLog << symbol << " = " << symbolvalue.string << "\n";
+            constraintLog << entry.symbol << " = " << symbolvalue.string << "\n";
         }
     }else{
         Statistics::statistics()->accumulate("Concolic::Solver::ConstraintsNotSolved", 1);
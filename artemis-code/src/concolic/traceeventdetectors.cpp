@@ -53,6 +53,16 @@ void TraceEventDetector::newSummaryInfo(TraceConcreteSummarisation::EventType in
     }
 }
 
+bool TraceEventDetector::isRecording()
+{
+    if(mTraceBuilder){
+        return mTraceBuilder->isRecording();
+    }else{
+        Log::fatal("Trace Event Detector being used with no associated Trace Builder.");
+        exit(1);
+    }
+}
+
 bool TraceEventDetector::shouldSummarise()
 {
     if(mTraceBuilder){
@@ -175,7 +185,7 @@ void TraceDomModDetector::slDomModified(QString start, QString end)
     // Create the node.
     QSharedPointer<TraceDomModification> node = QSharedPointer<TraceDomModification>(new TraceDomModification());
 
-    QPair<double, QMap<int, int> > metrics = computeMetrics(start, end);
+    QPair<double, QMap<QString, int> > metrics = computeMetrics(start, end);
     node->amountModified = metrics.first;
     node->words = metrics.second;
 
@@ -186,7 +196,7 @@ void TraceDomModDetector::slDomModified(QString start, QString end)
 
 // Takes the two DOM strings and computes the modification metrics.
 // Returns a pair or the amount of modification and the list of indicator words which were added.
-QPair<double, QMap<int, int> > TraceDomModDetector::computeMetrics(QString start, QString end)
+QPair<double, QMap<QString, int> > TraceDomModDetector::computeMetrics(QString start, QString end)
 {
     QStringList startTokens = tokenise(start);
     QStringList endTokens = tokenise(end);
@@ -204,18 +214,18 @@ QPair<double, QMap<int, int> > TraceDomModDetector::computeMetrics(QString start
     Log::debug(QString("Amount modified: %2/%3 = %1%").arg(modified).arg((double)result.first).arg((double)startTokens.length()).toStdString());
 
     // Check whether any of the inserted words are in our "indicators" list.
-    QMap<int,int> matches;
+    QMap<QString,int> matches;
     int j;
     foreach(QString inserted, result.second) {
         for(j = 0; j < indicators.length(); j++) {
             if(inserted.compare(indicators.at(j), Qt::CaseInsensitive) == 0) {
-                matches.insert(j, 1 + matches.value(j, 0));
+                matches.insert(indicators.at(j), 1 + matches.value(indicators.at(j), 0));
                 Log::debug(QString("On list: %1").arg(inserted).toStdString());
             }
         }
     }
 
-    return QPair<double,QMap<int,int> >(modified, matches);
+    return QPair<double,QMap<QString,int> >(modified, matches);
 }
 
 // Splits a DOM string into tokens.
@@ -318,6 +328,38 @@ const QList<QString> TraceDomModDetector::indicators = TraceDomModDetector::getI
 
 
 
+// DOM Indicator Word Detector
+
+TraceDomIndicatorDetector::TraceDomIndicatorDetector(const QList<QString>& words)
+    : mWords(words)
+    , mMatcher(words)
+{
+}
+
+void TraceDomIndicatorDetector::slDomTextInserted(QString text)
+{
+    // Text is inserted all the time while a page loads, so do not even match it unless it can be used.
+    if(!isRecording()) {
+        return;
+    }
+
+    QMap<int, int> counts;
+    if(mMatcher.match(text, &counts) == 0) {
+        return;
+    }
+
+    QSharedPointer<TraceDomModification> node = QSharedPointer<TraceDomModification>(new TraceDomModification());
+    node->amountModified = 0; // Not measured by this detector.
+    foreach(int index, counts.keys()) {
+        node->words.insert(mWords.at(index), counts.value(index));
+    }
+
+    // Pass the new node to the trace builder.
+    newNode(node.staticCast<TraceNode>(), &(node->next));
+}
+
+
+
 
 // Trace Marker Detector
 
@@ -22,6 +22,7 @@
 #include <QPair>
 
 #include "concolic/executiontree/tracenodes.h"
+#include "concolic/indicatorwordmatcher.h"
 #include "runtime/input/forms/formfieldrestrictedvalues.h"
 
 #ifndef TRACEEVENTDETECTORS_H
@@ -63,6 +64,7 @@ protected:
     void newNode(QSharedPointer<TraceNode> node, QSharedPointer<TraceNode>* successor);
     void newSummaryInfo(TraceConcreteSummarisation::EventType info);
     bool shouldSummarise();
+    bool isRecording();
 };
 
 
@@ -148,14 +150,37 @@ public slots:
     void slDomModified(QString start, QString end);
 
 private:
-    static QPair<double, QMap<int, int> > computeMetrics(QString start, QString end);
-    static QStringList tokenise(QString dom);
+    static QPair<double, QMap<QString, int> > computeMetrics(QString start, QString end);
     static QPair<int, QStringList> findInsertions(QStringList start, QStringList end);
 
+public:
+    // The default words which indicate an error message.
+    static const QList<QString> indicators;
     static QList<QString> getIndicators();
 
+    static QStringList tokenise(QString dom);
+};
+
+
+/*
+ *  Detector for indicator words (e.g. TraceDomModDetector::indicators) in text added to the DOM.
+ *  WebKit reports each text node as it is inserted into the page, and the part of its text which changed afterwards,
+ *  so no DOM snapshots are needed.
+ *  A DOM modification node is added to the trace for every such text which contains any indicator words.
+ */
+class TraceDomIndicatorDetector : public TraceEventDetector
+{
+    Q_OBJECT
+
 public:
-    static const QList<QString> indicators;
+    TraceDomIndicatorDetector(const QList<QString>& words);
+
+public slots:
+    void slDomTextInserted(QString text);
+
+private:
+    QList<QString> mWords;
+    IndicatorWordMatcher mMatcher;
 };
 
 
@@ -270,9 +270,68 @@ void TraceStatistics::visit(TraceUnexploredQueued *node)
     mNumUnexploredQueued++;
 }
 
+// A spilled subtree never changes, so its counts are kept with the placeholder after it has been loaded once.
+void TraceStatistics::visit(TraceSpilled *node)
+{
+    if (node->statistics.isNull()) {
+        node->statistics = QSharedPointer<TraceStatistics>(new TraceStatistics());
+        node->statistics->processTrace(node->load());
+    }
+
+    add(*node->statistics);
+}
+
 
 
 
+// Adds the counts of a subtree which was processed on its own to the counts so far.
+void TraceStatistics::add(const TraceStatistics& subtree)
+{
+    mNumNodes += subtree.mNumNodes;
+
+    mNumBranches += subtree.mNumBranches;
+    mNumSymBranches += subtree.mNumSymBranches;
+    mNumConcreteBranches += subtree.mNumConcreteBranches;
+    mNumBranchesFullyExplored += subtree.mNumBranchesFullyExplored;
+    mNumSymBranchesFullyExplored += subtree.mNumSymBranchesFullyExplored;
+    mNumConcreteBranchesFullyExplored += subtree.mNumConcreteBranchesFullyExplored;
+
+    mNumDivergenceNodes += subtree.mNumDivergenceNodes;
+    mNumDivergentTraces += subtree.mNumDivergentTraces;
+
+    // The branches counted since the last marker above the subtree belong to the first marker in it, if any.
+    mNumEventSequenceSymBranches += subtree.mNumEventSequenceSymBranches;
+    mNumEventSequenceSymBranchesFullyExplored += subtree.mNumEventSequenceSymBranchesFullyExplored;
+    if (subtree.mNumEventMarkers > 0) {
+        mNumEventSequenceSymBranches += mNumSymBranchesSinceLastMarker;
+        mNumEventSequenceSymBranchesFullyExplored += mNumSymBranchesFullyExploredSinceLastMarker;
+        mNumSymBranchesSinceLastMarker = subtree.mNumSymBranchesSinceLastMarker;
+        mNumSymBranchesFullyExploredSinceLastMarker = subtree.mNumSymBranchesFullyExploredSinceLastMarker;
+    } else {
+        mNumSymBranchesSinceLastMarker += subtree.mNumSymBranchesSinceLastMarker;
+        mNumSymBranchesFullyExploredSinceLastMarker += subtree.mNumSymBranchesFullyExploredSinceLastMarker;
+    }
+
+    mNumAlerts += subtree.mNumAlerts;
+    mNumConsoleMessages += subtree.mNumConsoleMessages;
+    mNumFunctionCalls += subtree.mNumFunctionCalls;
+    mNumDomModifications += subtree.mNumDomModifications;
+    mNumInterestingDomModifications += subtree.mNumInterestingDomModifications;
+    mNumPageLoads += subtree.mNumPageLoads;
+    mNumEventMarkers += subtree.mNumEventMarkers;
+
+    mNumEndSuccess += subtree.mNumEndSuccess;
+    mNumEndFailure += subtree.mNumEndFailure;
+    mNumEndUnknown += subtree.mNumEndUnknown;
+
+    mNumUnexplored += subtree.mNumUnexplored;
+    mNumUnexploredSymbolicChild += subtree.mNumUnexploredSymbolicChild;
+    mNumUnexploredUnsat += subtree.mNumUnexploredUnsat;
+    mNumUnexploredMissed += subtree.mNumUnexploredMissed;
+    mNumUnexploredUnsolvable += subtree.mNumUnexploredUnsolvable;
+    mNumUnexploredQueued += subtree.mNumUnexploredQueued;
+}
+
 // Checks if a branch is fully explored.
 bool TraceStatistics::isFullyExplored(TraceBranch *node)
 {
@@ -99,8 +99,11 @@ public:
     virtual void visit(TraceUnexploredUnsolvable* node);
     virtual void visit(TraceUnexploredQueued* node);
 
+    virtual void visit(TraceSpilled* node);
+
 protected:
     bool isFullyExplored(TraceBranch* node);
+    void add(const TraceStatistics& subtree);
     int mNumSymBranchesSinceLastMarker;
     int mNumSymBranchesFullyExploredSinceLastMarker;
 };
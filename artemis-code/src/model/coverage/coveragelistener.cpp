@@ -30,7 +30,8 @@ namespace artemis
 CoverageListener::CoverageListener(const QSet<QUrl>& ignoredUrls) :
     QObject(NULL),
     mIgnoredUrls(ignoredUrls),
-    mInputBeingExecuted(-1)
+    mInputBeingExecuted(-1),
+    mChangeCount(0)
 {
     mIgnoredUrls.insert(DONT_MEASURE_COVERAGE);
 }
@@ -85,11 +86,39 @@ float CoverageListener::getBytecodeCoverage(QSharedPointer<const BaseInput> inpu
 
 }
 
+uint CoverageListener::getChangeCount() const
+{
+    return mChangeCount;
+}
+
+QSet<int> CoverageListener::getInputsChangedSince(uint changeCount) const
+{
+    QSet<int> changed;
+
+    QMap<int, QSet<codeblockid_t>* >::const_iterator it;
+    for (it = mInputToCodeBlockMap.begin(); it != mInputToCodeBlockMap.end(); it++) {
+        if (mInputChangedAt.value(it.key()) > changeCount) {
+            changed.insert(it.key());
+            continue;
+        }
+
+        foreach (codeblockid_t codeBlockID, *it.value()) {
+            if (mCodeBlockChangedAt.value(codeBlockID) > changeCount) {
+                changed.insert(it.key());
+                break;
+            }
+        }
+    }
+
+    return changed;
+}
+
 void CoverageListener::notifyStartingEvent(QSharedPointer<const BaseInput> inputEvent)
 {
     mInputBeingExecuted = inputEvent->hashCode();
     if (!mInputToCodeBlockMap.contains(mInputBeingExecuted)) {
         mInputToCodeBlockMap.insert(mInputBeingExecuted, new QSet<codeblockid_t>());
+        mInputChangedAt.insert(mInputBeingExecuted, ++mChangeCount);
     }
 }
 
@@ -98,6 +127,11 @@ void CoverageListener::notifyStartingLoad()
     mInputBeingExecuted = -1;
 }
 
+void CoverageListener::setPrettifyCache(PrettifyCachePtr prettifier)
+{
+    mPrettifier = prettifier;
+}
+
 void CoverageListener::slJavascriptScriptParsed(QString sourceCode, QSource* source)
 {   
 
@@ -112,6 +146,15 @@ void CoverageListener::slJavascriptScriptParsed(QString sourceCode, QSource* sou
         qDebug() << "Loaded script: " << source->getUrl() << " (line " << QString::number(source->getStartLine()) << ")";
 
         SourceInfoPtr sourceInfo = SourceInfoPtr(new SourceInfo(sourceCode, source->getUrl(), source->getStartLine()));
+
+        // Inline scripts are not prettified, so only attach a mapping if it really describes this source.
+        if (!mPrettifier.isNull()) {
+            PrettifyMappingConstPtr mapping = mPrettifier->getMapping(source->getUrl());
+            if (!mapping.isNull() && mapping->getPrettySource() == sourceCode) {
+                sourceInfo->setPrettifyMapping(mapping);
+            }
+        }
+
         mSources.insert(sourceID, sourceInfo);
     }
 }
@@ -142,7 +185,11 @@ void CoverageListener::slJavascriptFunctionCalled(QString functionName, size_t b
     }
 
     if (mInputBeingExecuted != -1) {
-        mInputToCodeBlockMap.value(mInputBeingExecuted)->insert(codeBlockID);
+        QSet<codeblockid_t>* codeBlocks = mInputToCodeBlockMap.value(mInputBeingExecuted);
+        if (!codeBlocks->contains(codeBlockID)) {
+            codeBlocks->insert(codeBlockID);
+            mInputChangedAt.insert(mInputBeingExecuted, ++mChangeCount);
+        }
     }
 
 }
@@ -154,7 +201,12 @@ void CoverageListener::slJavascriptBytecodeExecuted(const ByteCodeInfoStruct& bi
     QSharedPointer<CodeBlockInfo> codeBlockInfo = mCodeBlocks.value(codeBlockID, QSharedPointer<CodeBlockInfo>(NULL));
 
     if (!codeBlockInfo.isNull()) {
+        size_t covered = codeBlockInfo->numCoveredBytecodes();
         codeBlockInfo->setBytecodeCovered(binfo.bytecodeOffset);
+
+        if (codeBlockInfo->numCoveredBytecodes() != covered) {
+            mCodeBlockChangedAt.insert(codeBlockID, ++mChangeCount);
+        }
     }
 
     sourceid_t sourceID = SourceInfo::getId(source->getUrl(), source->getStartLine());
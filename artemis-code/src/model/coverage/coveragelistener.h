@@ -23,11 +23,13 @@
 #include <QUrl>
 #include <QMap>
 #include <QSet>
+#include <QHash>
 #include <QSharedPointer>
 #include <QWebExecutionListener>
 #include <QSource>
 
 #include "runtime/input/baseinput.h"
+#include "runtime/browser/ajax/prettifycache.h"
 
 #include "sourceinfo.h"
 #include "codeblockinfo.h"
@@ -51,9 +53,16 @@ public:
 
     float getBytecodeCoverage(QSharedPointer<const BaseInput> inputEvent) const;
 
+    // Every change to the coverage of an input is counted. The inputs (by hash code) whose coverage changed after
+    // getChangeCount() returned changeCount.
+    uint getChangeCount() const;
+    QSet<int> getInputsChangedSince(uint changeCount) const;
+
     void notifyStartingEvent(QSharedPointer<const BaseInput> inputEvent);
     void notifyStartingLoad();
 
+    void setPrettifyCache(PrettifyCachePtr prettifier);
+
     QString toString() const;
 
 private:
@@ -64,12 +73,19 @@ private:
     QMap<int, QSet<codeblockid_t>* > mInputToCodeBlockMap;
     int mInputBeingExecuted;
 
+    // The change count at the last change of the code blocks of an input, or of the bytecodes covered in a code block.
+    uint mChangeCount;
+    QHash<int, uint> mInputChangedAt;
+    QHash<codeblockid_t, uint> mCodeBlockChangedAt;
+
     // (sourceID -> SourceInfo)
     QMap<sourceid_t, SourceInfoPtr> mSources;
 
     // (codeBlockID -> CodeBlockInfo)
     QMap<codeblockid_t, QSharedPointer<CodeBlockInfo> > mCodeBlocks;
 
+    PrettifyCachePtr mPrettifier;
+
 
 public slots:
 
@@ -48,8 +48,16 @@ void writeCoverageStdout(CoverageListenerPtr cov)
         QSet<uint> lineCoverage = sourceInfo->getLineCoverage();
         int lineNumber = sourceInfo->getStartLine();
 
+        bool prettified = !sourceInfo->getPrettifyMapping().isNull();
+        if (prettified) {
+            Log::info("(Prettified source, original line numbers are shown in brackets)");
+        }
+
         while (!read.atEnd()) {
             QString prefix = lineCoverage.contains(lineNumber) ? ">>>" : "   ";
+            if (prettified) {
+                prefix += QString("[%1] ").arg(sourceInfo->getOriginalLine(lineNumber), 5);
+            }
             QString line = prefix + read.readLine();
             Log::info(line.toStdString());
             lineNumber++;
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <assert.h>
+#include <algorithm>
+
+#include "prettifymapping.h"
+
+namespace artemis
+{
+
+PrettifyMapping::PrettifyMapping(const QString& originalSource, const QString& prettySource,
+                                 const QVector<int>& segmentPrettyOffsets, const QVector<int>& segmentOriginalOffsets)
+    : mOriginalSource(originalSource)
+    , mPrettySource(prettySource)
+    , mSegmentPrettyOffsets(segmentPrettyOffsets)
+    , mSegmentOriginalOffsets(segmentOriginalOffsets)
+    , mOriginalLineStarts(lineStarts(originalSource))
+    , mPrettyLineStarts(lineStarts(prettySource))
+{
+    assert(mSegmentPrettyOffsets.size() == mSegmentOriginalOffsets.size());
+}
+
+QString PrettifyMapping::getOriginalSource() const
+{
+    return mOriginalSource;
+}
+
+QString PrettifyMapping::getPrettySource() const
+{
+    return mPrettySource;
+}
+
+const QVector<int>& PrettifyMapping::getSegmentPrettyOffsets() const
+{
+    return mSegmentPrettyOffsets;
+}
+
+const QVector<int>& PrettifyMapping::getSegmentOriginalOffsets() const
+{
+    return mSegmentOriginalOffsets;
+}
+
+int PrettifyMapping::originalOffset(int prettyOffset) const
+{
+    if (mSegmentPrettyOffsets.isEmpty() || prettyOffset < mSegmentPrettyOffsets.first()) {
+        return qMax(0, qMin(prettyOffset, mOriginalSource.length()));
+    }
+
+    // Last segment starting at or before prettyOffset.
+    int segment = (std::upper_bound(mSegmentPrettyOffsets.constBegin(), mSegmentPrettyOffsets.constEnd(), prettyOffset)
+                   - mSegmentPrettyOffsets.constBegin()) - 1;
+
+    int offset = mSegmentOriginalOffsets.at(segment) + (prettyOffset - mSegmentPrettyOffsets.at(segment));
+
+    // Inserted whitespace runs past the copied text, clamp it to where the next segment starts.
+    int limit = segment + 1 < mSegmentOriginalOffsets.size() ? mSegmentOriginalOffsets.at(segment + 1) : mOriginalSource.length();
+    return qMin(offset, limit);
+}
+
+uint PrettifyMapping::originalLine(uint prettyLine) const
+{
+    if (prettyLine < 1 || (int)prettyLine > mPrettyLineStarts.size()) {
+        return prettyLine;
+    }
+
+    int offset = originalOffset(mPrettyLineStarts.at(prettyLine - 1));
+
+    return std::upper_bound(mOriginalLineStarts.constBegin(), mOriginalLineStarts.constEnd(), offset)
+            - mOriginalLineStarts.constBegin();
+}
+
+QVector<int> PrettifyMapping::lineStarts(const QString& source)
+{
+    QVector<int> starts;
+    starts.append(0);
+    for (int i = 0; i < source.length(); i++) {
+        if (source.at(i) == QChar('\n')) {
+            starts.append(i + 1);
+        }
+    }
+    return starts;
+}
+
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PRETTIFYMAPPING_H
+#define PRETTIFYMAPPING_H
+
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+namespace artemis
+{
+
+/**
+ * Relates a prettified script back to the original source it was generated from.
+ *
+ * Prettification only ever replaces or inserts whitespace between tokens, so the mapping is stored as a list of
+ * segments. Each segment starts at a (pretty offset, original offset) pair and offsets advance together until the
+ * next segment starts.
+ *
+ * Line numbers are 1-based and relative to the start of the script.
+ */
+class PrettifyMapping
+{
+public:
+    PrettifyMapping(const QString& originalSource, const QString& prettySource,
+                    const QVector<int>& segmentPrettyOffsets, const QVector<int>& segmentOriginalOffsets);
+
+    QString getOriginalSource() const;
+    QString getPrettySource() const;
+
+    const QVector<int>& getSegmentPrettyOffsets() const;
+    const QVector<int>& getSegmentOriginalOffsets() const;
+
+    int originalOffset(int prettyOffset) const;
+    uint originalLine(uint prettyLine) const;
+
+protected:
+    static QVector<int> lineStarts(const QString& source);
+
+    QString mOriginalSource;
+    QString mPrettySource;
+
+    QVector<int> mSegmentPrettyOffsets;
+    QVector<int> mSegmentOriginalOffsets;
+
+    QVector<int> mOriginalLineStarts;
+    QVector<int> mPrettyLineStarts;
+};
+
+typedef QSharedPointer<PrettifyMapping> PrettifyMappingPtr;
+typedef QSharedPointer<const PrettifyMapping> PrettifyMappingConstPtr;
+
+}
+
+#endif // PRETTIFYMAPPING_H
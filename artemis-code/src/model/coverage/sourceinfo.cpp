@@ -118,6 +118,31 @@ QMap<int,int> SourceInfo::getSymbolicRangeCoverage() const
 }
 
 
+void SourceInfo::setPrettifyMapping(PrettifyMappingConstPtr mapping)
+{
+    mPrettifyMapping = mapping;
+}
+
+PrettifyMappingConstPtr SourceInfo::getPrettifyMapping() const
+{
+    return mPrettifyMapping;
+}
+
+int SourceInfo::getOriginalOffset(int offset) const
+{
+    if (mPrettifyMapping.isNull()) {
+        return offset;
+    }
+    return mPrettifyMapping->originalOffset(offset);
+}
+
+uint SourceInfo::getOriginalLine(uint lineNumber) const
+{
+    if (mPrettifyMapping.isNull() || lineNumber < (uint)mStartLine) {
+        return lineNumber;
+    }
+    return mPrettifyMapping->originalLine(lineNumber - mStartLine + 1) + mStartLine - 1;
+}
 
 QString SourceInfo::toString() const
 {
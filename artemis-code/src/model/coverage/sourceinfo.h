@@ -22,6 +22,8 @@
 #include <QDebug>
 #include <QSharedPointer>
 
+#include "prettifymapping.h"
+
 namespace artemis
 {
 
@@ -47,6 +49,12 @@ public:
     QMap<int,int> getRangeCoverage() const;
     QMap<int,int> getSymbolicRangeCoverage() const;
 
+    // For prettified scripts, relates offsets and line numbers in getSource() back to the original source.
+    void setPrettifyMapping(PrettifyMappingConstPtr mapping);
+    PrettifyMappingConstPtr getPrettifyMapping() const;
+    int getOriginalOffset(int offset) const;
+    uint getOriginalLine(uint lineNumber) const;
+
     QString toString() const;
     QDebug friend operator<<(QDebug dbg, const SourceInfo& e);
 
@@ -62,6 +70,7 @@ private:
     QMap<int,int> mSymbolicEndRangeCoverage;
     QMap<int,int> mStartRangeCoverage;
     QMap<int,int> mEndRangeCoverage;
+    PrettifyMappingConstPtr mPrettifyMapping;
 };
 
 typedef QSharedPointer<SourceInfo> SourceInfoPtr;
@@ -23,29 +23,36 @@
 
 namespace artemis {
 
+uint JavascriptStatistics::sWriteVersions = 0;
+
 JavascriptStatistics::JavascriptStatistics() :
     QObject(NULL),
-    mInputBeingExecuted(0)
+    mWriteVersion(++sWriteVersions),
+    mInputBeingExecuted(-1),
+    mInputHashBeingExecuted(0),
+    mChangeCount(0)
 {
 }
 
 void JavascriptStatistics::notifyStartingEvent(QSharedPointer<const BaseInput> inputEvent)
 {
-    mInputBeingExecuted = inputEvent->hashCode();
+    QString identity = inputEvent->identity();
+    mInputHashBeingExecuted = inputEvent->hashCode();
 
-    if (!mPropertyReadSet.contains(mInputBeingExecuted)) {
-        mPropertyReadSet.insert(mInputBeingExecuted, new QSet<QString>());
-    }
+    mInputBeingExecuted = mInputIds.value(identity, -1);
 
-    if (!mPropertyWriteSet.contains(mInputBeingExecuted)) {
-        mPropertyWriteSet.insert(mInputBeingExecuted, new QSet<QString>());
+    if (mInputBeingExecuted == -1) {
+        mInputBeingExecuted = mPropertyReadSet.size();
+        mInputIds.insert(identity, mInputBeingExecuted);
+        mPropertyReadSet.append(QBitArray());
+        mPropertyWriteSet.append(QBitArray());
     }
 }
 
 void JavascriptStatistics::notifyStartingLoad()
 {
     // Ignore stuff before we call our first event
-    mInputBeingExecuted = 0;
+    mInputBeingExecuted = -1;
 }
 
 void JavascriptStatistics::slJavascriptPropertyRead(QString propertyName, intptr_t codeBlockID, intptr_t sourceID, QSource* source)
@@ -56,8 +63,10 @@ void JavascriptStatistics::slJavascriptPropertyRead(QString propertyName, intptr
 
     Statistics::statistics()->accumulate("WebKit::readproperties", 1);
 
-    if (mInputBeingExecuted != 0) {
-        mPropertyReadSet.value(mInputBeingExecuted)->insert(propertyName);
+    if (mInputBeingExecuted != -1) {
+        if (insertProperty(mPropertyReadSet[mInputBeingExecuted], propertyName)) {
+            mInputChangedAt.insert(mInputHashBeingExecuted, ++mChangeCount);
+        }
     }
 }
 
@@ -69,31 +78,136 @@ void JavascriptStatistics::slJavascriptPropertyWritten(QString propertyName, int
 
     Statistics::statistics()->accumulate("WebKit::writtenproperties", 1);
 
-    if (mInputBeingExecuted != 0) {
-        mPropertyWriteSet.value(mInputBeingExecuted)->insert(propertyName);
+    if (mInputBeingExecuted != -1) {
+        if (insertProperty(mPropertyWriteSet[mInputBeingExecuted], propertyName)) {
+            mWriteVersion = ++sWriteVersions;
+            mInputChangedAt.insert(mInputHashBeingExecuted, ++mChangeCount);
+        }
     }
 }
 
-QSet<QString> JavascriptStatistics::getPropertiesWritten(const QSharedPointer<const BaseInput>& input) const
+int JavascriptStatistics::internProperty(const QString& propertyName)
 {
-    uint hashcode = input->hashCode();
+    QHash<QString, int>::const_iterator it = mPropertyIds.find(propertyName);
+    if (it != mPropertyIds.end()) {
+        return it.value();
+    }
+
+    int id = mPropertyNames.size();
+    mPropertyIds.insert(propertyName, id);
+    mPropertyNames.append(propertyName);
+    return id;
+}
 
-    if (mPropertyWriteSet.contains(hashcode)) {
-        return *mPropertyWriteSet.value(hashcode);
+// Returns true if the property was not in the set before.
+bool JavascriptStatistics::insertProperty(QBitArray& set, const QString& propertyName)
+{
+    int id = internProperty(propertyName);
+
+    if (id >= set.size()) {
+        // Grow geometrically, as new properties keep being found during a run.
+        set.resize(qMax(id + 1, 2 * set.size()));
+    } else if (set.testBit(id)) {
+        return false;
     }
 
-    return QSet<QString>();
+    set.setBit(id);
+    return true;
 }
 
-QSet<QString> JavascriptStatistics::getPropertiesRead(const QSharedPointer<const BaseInput>& input) const
+int JavascriptStatistics::inputId(const QSharedPointer<const BaseInput>& input) const
+{
+    return mInputIds.value(input->identity(), -1);
+}
+
+QBitArray JavascriptStatistics::getPropertyIdsRead(const QSharedPointer<const BaseInput>& input) const
+{
+    int id = inputId(input);
+    return id == -1 ? QBitArray() : mPropertyReadSet.at(id);
+}
+
+QBitArray JavascriptStatistics::getPropertyIdsWritten(const InputSequenceConstPtr& sequence)
+{
+    // The write set of each prefix is cached on the node of its last input, which is shared by every sequence built
+    // from that prefix. Only the inputs after the last valid cached prefix are added, and a cached set is freed
+    // along with the sequences using it.
+    QList<const InputSequence::Node*> uncached;
+    QBitArray written;
+
+    for (const InputSequence::Node* node = sequence->mLast.data(); node != NULL; node = node->previous.data()) {
+        if (node->writtenVersion == mWriteVersion) {
+            written = node->written;
+            break;
+        }
+        uncached.append(node);
+    }
+
+    for (int i = uncached.size() - 1; i >= 0; i--) {
+        const InputSequence::Node* node = uncached.at(i);
+
+        int id = inputId(node->input);
+        if (id != -1) {
+            const QBitArray& inputWritten = mPropertyWriteSet.at(id);
+            if (written.size() < inputWritten.size()) {
+                written.resize(inputWritten.size());
+            }
+            written |= inputWritten;
+        }
+
+        node->written = written;
+        node->writtenVersion = mWriteVersion;
+    }
+
+    return written;
+}
+
+QString JavascriptStatistics::getPropertyName(int propertyId) const
+{
+    return mPropertyNames.at(propertyId);
+}
+
+uint JavascriptStatistics::getChangeCount() const
+{
+    return mChangeCount;
+}
+
+QSet<int> JavascriptStatistics::getInputsChangedSince(uint changeCount) const
+{
+    QSet<int> changed;
+
+    QHash<int, uint>::const_iterator it;
+    for (it = mInputChangedAt.begin(); it != mInputChangedAt.end(); it++) {
+        if (it.value() > changeCount) {
+            changed.insert(it.key());
+        }
+    }
+
+    return changed;
+}
+
+static QSet<QString> propertyNames(const QBitArray& set, const QList<QString>& names)
 {
-    uint hashcode = input->hashCode();
+    QSet<QString> result;
 
-    if (mPropertyReadSet.contains(hashcode)) {
-        return *mPropertyReadSet.value(hashcode);
+    for (int id = 0; id < set.size(); id++) {
+        if (set.testBit(id)) {
+            result.insert(names.at(id));
+        }
     }
 
-    return QSet<QString>();
+    return result;
+}
+
+QSet<QString> JavascriptStatistics::getPropertiesWritten(const QSharedPointer<const BaseInput>& input) const
+{
+    int id = inputId(input);
+    return id == -1 ? QSet<QString>() : propertyNames(mPropertyWriteSet.at(id), mPropertyNames);
+}
+
+QSet<QString> JavascriptStatistics::getPropertiesRead(const QSharedPointer<const BaseInput>& input) const
+{
+    int id = inputId(input);
+    return id == -1 ? QSet<QString>() : propertyNames(mPropertyReadSet.at(id), mPropertyNames);
 }
 
 }
@@ -21,12 +21,21 @@
 #include <QSharedPointer>
 #include <QSet>
 #include <QHash>
+#include <QVector>
+#include <QBitArray>
 #include <QSource>
 
 #include "runtime/input/baseinput.h"
+#include "runtime/input/inputsequence.h"
 
 namespace artemis {
 
+/*
+ * Records which JavaScript properties are read and written by each input.
+ *
+ * Inputs are told apart by BaseInput::identity(), so the same event executed in several configurations shares its
+ * sets. Property names are interned to small integer ids, and the sets are bitsets indexed by these ids.
+ */
 class JavascriptStatistics : public QObject
 {
 
@@ -41,15 +50,47 @@ public:
     QSet<QString> getPropertiesWritten(const QSharedPointer<const BaseInput>& input) const;
     QSet<QString> getPropertiesRead(const QSharedPointer<const BaseInput>& input) const;
 
+    // The ids of the properties read by input. The bitset may be shorter than the number of properties.
+    QBitArray getPropertyIdsRead(const QSharedPointer<const BaseInput>& input) const;
+    // The ids of the properties written by any of the inputs in sequence.
+    QBitArray getPropertyIdsWritten(const InputSequenceConstPtr& sequence);
+
+    QString getPropertyName(int propertyId) const;
+
+    // Every change to the properties read or written by an input is counted. The inputs (by hash code) whose
+    // properties changed after getChangeCount() returned changeCount.
+    uint getChangeCount() const;
+    QSet<int> getInputsChangedSince(uint changeCount) const;
+
 private:
+    int inputId(const QSharedPointer<const BaseInput>& input) const;
+    int internProperty(const QString& propertyName);
+    bool insertProperty(QBitArray& set, const QString& propertyName);
+
+    // PropertyString -> PropertyId
+    QHash<QString, int> mPropertyIds;
+    QList<QString> mPropertyNames;
+
+    // Input identity -> InputId
+    QHash<QString, int> mInputIds;
+
+    // InputId -> set<PropertyId>
+    QVector<QBitArray> mPropertyReadSet;
+
+    // InputId -> set<PropertyId>
+    QVector<QBitArray> mPropertyWriteSet;
 
-    // InputHash -> set<PropertyString>
-    QHash<uint, QSet<QString>* > mPropertyReadSet;
+    // Changed whenever any write set changes, to invalidate the write sets cached on InputSequence nodes.
+    // Unique across instances, so a node cached by another instance is never taken as valid.
+    uint mWriteVersion;
+    static uint sWriteVersions;
 
-    // InputHash -> set<PropertyString>
-    QHash<uint, QSet<QString>* > mPropertyWriteSet;
+    int mInputBeingExecuted;
+    int mInputHashBeingExecuted;
 
-    uint mInputBeingExecuted;
+    // InputHash -> change count at the last change of its sets
+    uint mChangeCount;
+    QHash<int, uint> mInputChangedAt;
 
 public slots:
     void slJavascriptPropertyRead(QString propertyName, intptr_t codeBlockID, intptr_t sourceID, QSource* source);
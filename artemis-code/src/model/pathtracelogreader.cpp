@@ -0,0 +1,292 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <QFile>
+#include <QTextStream>
+
+#include "util/loggingutil.h"
+
+#include "pathtracelogreader.h"
+
+namespace artemis
+{
+
+PathTraceLogReader::PathTraceLogReader(QString pathToLog)
+    : mPathToLog(pathToLog)
+{
+}
+
+void PathTraceLogReader::writeText(PathTraceReport level)
+{
+    QFile file(mPathToLog);
+    if (mPathToLog.isEmpty() || !file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        Log::info("No traces were recorded.");
+        return;
+    }
+
+    QTextStream log(&file);
+    log.setCodec("UTF-8");
+
+    mSources.clear();
+
+    bool anyTraces = false;
+    bool inTrace = false;
+    bool printing = false;
+    uint stackLevel = 1;
+
+    while (!log.atEnd()) {
+        QStringList fields = splitLogLine(log.readLine());
+        QString event = fields.first();
+
+        if (event == "source" && fields.size() >= 3) {
+            mSources.insert(fields[1].toUInt(), fields[2]);
+
+        } else if (event == "trace" && fields.size() >= 3) {
+            if (inTrace && printing) {
+                Log::info("\n");
+            }
+
+            anyTraces = true;
+            inTrace = true;
+            printing = level == ALL_TRACES || (level == CLICK_TRACES && fields[1] == "click");
+            stackLevel = 1;
+
+            if (printing) {
+                Log::info("    Trace Start | " + fields[2].toStdString());
+            }
+
+        } else if (!printing) {
+            continue;
+
+        } else if (event == "call" && fields.size() >= 4) {
+            QString message = QString("File: %1, Line: %2.").arg(displayedUrl(mSources.value(fields[3].toUInt()))).arg(fields[2]);
+            QString itemStr = fields[1].leftJustified(35 - stackLevel*2) + ' ' + message;
+            Log::info("  Function Call | " + std::string(stackLevel*2, ' ') + itemStr.toStdString());
+            stackLevel++;
+
+        } else if (event == "return") {
+            if (stackLevel > 1) {
+                stackLevel--;
+            }
+
+        } else if (event == "alert" && fields.size() >= 2) {
+            fields[1].replace("\n", "\\n");
+            QString itemStr = fields[1].isEmpty() ? "alert()" : (QString("alert()").leftJustified(35 - stackLevel*2) + ' ' + fields[1]);
+            Log::info("     Alert Call | " + std::string(stackLevel*2, ' ') + itemStr.toStdString());
+
+        } else if (event == "limit" && fields.size() >= 2) {
+            Log::info("          Limit | Only the first " + fields[1].toStdString() + " trace items were recorded.");
+        }
+    }
+
+    if (inTrace && printing) {
+        Log::info("\n");
+    }
+
+    if (!anyTraces) {
+        Log::info("No traces were recorded.");
+    }
+}
+
+bool PathTraceLogReader::writeHTML(QString pathToFile, bool linkWithCoverage, QString coveragePath)
+{
+    QFile output(pathToFile);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        Log::error("Error: Could not write the path trace report " + pathToFile.toStdString());
+        return false;
+    }
+
+    QTextStream res(&output);
+    res.setCodec("UTF-8");
+
+    QString defaultClasses = "hidebytecode";
+
+    QString style = ".controls a{text-decoration:underline;cursor:pointer;}ol{list-style:none;}ol#tracelist{margin-left:170px;}ol#tracelist>li{margin-bottom:30px;}ol#tracelist>li>span.label{font-weight:bold;}ol.functionbody{border-left:1px solid lightgray;}span.label{position:absolute;left:0;display:block;width:150px;text-align:right;}span.extrainfo{position:absolute;left:700px;white-space:nowrap;}span.itemname{font-family:monospace;}li.funcall>span.itemname,li.trace>span.description{cursor:pointer;margin-left:-1.2em;}li.funcall>span.itemname:before{content:'\\25BD\\00A0';}li.trace>span.description:before{content:'\\25BF\\00A0';}li.funcall.collapsed>span.itemname:before{content:'\\25B7\\00A0';}li.trace.collapsed>span.description:before{content:'\\25B9\\00A0';}li.funcall.collapsed>ol,li.trace.collapsed>ol{display:none;}";
+    style += " ol#tracelist.hidebytecode ol.singletrace li.bytecode{display:none;} ol#tracelist.showclicktracesonly li.trace:not(.click){display:none;} ol#tracelist.hideloadtraces li.trace.load{display:none;} ol#tracelist.hidemousetraces li.trace.mouse{display:none;}";
+
+    QString script = "window.onload = function(){elems = document.querySelectorAll('li.funcall>span.itemname, li.trace>span.description'); for(var i=0; i<elems.length; i++){elems[i].onclick = function(){this.parentNode.classList.toggle('collapsed');}}};";
+    script += " function toggleSetting(setting){tl=document.getElementById('tracelist').classList.toggle(setting);return false;}";
+
+    res << "<html>\n<head>\n\t<meta charset=\"utf-8\"/>\n\t<title>Path Trace</title>\n\t<style type=\"text/css\">" << style << "</style>\n\t<script type=\"text/javascript\">" << script << "</script>\n</head>\n<body>\n";
+
+    res << "<h1>Path Tracer Results</h1>\n";
+
+    res << "<hr>\n<h3>Display Options:</h3>\n<ul class=\"controls\">\n";
+    res << "\t<li><a onclick=\"toggleSetting('showclicktracesonly')\">Toggle displaying click traces only</a></li>\n";
+    res << "\t<li><a onclick=\"toggleSetting('hidemousetraces')\">Toggle mouse-related traces</a></li>\n";
+    res << "\t<li><a onclick=\"toggleSetting('hideloadtraces')\">Toggle loading-related traces</a></li>\n";
+    res << "</ul>\n<hr>\n\n";
+
+    QFile file(mPathToLog);
+    bool haveLog = !mPathToLog.isEmpty() && file.open(QIODevice::ReadOnly | QIODevice::Text);
+
+    QTextStream log(&file);
+    log.setCodec("UTF-8");
+
+    mSources.clear();
+
+    bool inList = false;
+    bool inTrace = false;
+    uint indentLevel = 3;
+    QString limit;
+
+    while (haveLog && !log.atEnd()) {
+        QStringList fields = splitLogLine(log.readLine());
+        QString event = fields.first();
+
+        if (event == "source" && fields.size() >= 3) {
+            mSources.insert(fields[1].toUInt(), fields[2]);
+            continue;
+        }
+
+        if (event == "limit" && fields.size() >= 2) {
+            limit = fields[1];
+            continue;
+        }
+
+        if (event == "trace" && fields.size() >= 3) {
+            if (!inList) {
+                res << "<ol id=\"tracelist\" class=\"" << defaultClasses << "\">\n";
+                inList = true;
+            }
+
+            // Close the calls which did not return before the trace ended.
+            for (; inTrace && indentLevel > 3; indentLevel--) {
+                res << QString(indentLevel - 1, '\t') << "</ol>\n" << QString(indentLevel - 1, '\t') << "</li>\n";
+            }
+            if (inTrace) {
+                res << "\t\t</ol>\n\t</li>\n";
+            }
+
+            res << "\t<li class=\"trace " << fields[1] << " collapsed\">\n\t\t<span class=\"label\">Trace Start:</span> <span class=\"description\">" << fields[2] << "</span>\n\t\t<ol class=\"singletrace\">\n";
+            inTrace = true;
+            indentLevel = 3;
+            continue;
+        }
+
+        if (!inTrace) {
+            continue;
+        }
+
+        QString indent = QString(indentLevel, '\t');
+
+        if (event == "call" && fields.size() >= 4) {
+            sourceid_t sourceID = fields[3].toUInt();
+            QString url = mSources.value(sourceID);
+            QString itemStr = "<span class=\"itemname\">" + escapeHTML(fields[1]) + "</span>";
+
+            QString functionLink;
+            if (linkWithCoverage) {
+                QString codeID = "ID" + QString::number(sourceID); // Matches the definition in coverageoutputstream.cpp
+                functionLink = QString("<a href=\"%1?code=%2&line=%3\" target=\"coverageReport\" >View Code</a>").arg(coveragePath).arg(codeID).arg(fields[2]);
+            }
+            QString extraStr = QString("<span class=\"extrainfo\">File: <a href=\"%1\">%2</a>, Line: %3, %4</span>").arg(url).arg(displayedUrl(url, true)).arg(fields[2]).arg(functionLink);
+
+            res << indent << "<li class=\"funcall\">\n" << indent << "\t<span class=\"label\">Function Call:</span> " << itemStr << extraStr << "\n" << indent << "\t<ol class=\"functionbody\">\n";
+            indentLevel++;
+
+        } else if (event == "return") {
+            if (indentLevel > 3) {
+                res << indent << "</ol>\n" << QString(indentLevel - 1, '\t') << "</li>\n";
+                indentLevel--;
+            }
+
+        } else if (event == "alert" && fields.size() >= 2) {
+            fields[1].replace("\n", "\\n");
+            QString extraStr = fields[1].isEmpty() ? "" : (" <span class=\"extrainfo\">" + fields[1] + "</span>");
+            res << indent << "<li class=\"alert\"><span class=\"label\">Alert Call:</span> <span class=\"itemname\">alert()</span>" << extraStr << "</li>\n";
+        }
+    }
+
+    if (inList) {
+        for (; indentLevel > 3; indentLevel--) {
+            res << QString(indentLevel - 1, '\t') << "</ol>\n" << QString(indentLevel - 1, '\t') << "</li>\n";
+        }
+        res << "\t\t</ol>\n\t</li>\n";
+        res << "</ol>\n";
+    } else {
+        res << "<p>No traces were recorded.</p>\n";
+    }
+
+    if (!limit.isEmpty()) {
+        res << "<p>The trace item limit was reached, only the first " << limit << " trace items were recorded.</p>\n";
+    }
+
+    res << "</body>\n</html>\n";
+
+    return true;
+}
+
+QString PathTraceLogReader::displayedUrl(QString url, bool fileNameOnly)
+{
+    bool hasQuery = url.indexOf('?') != -1;
+    QString name = url.split("?").first();
+
+    if(fileNameOnly){
+        name = name.split("/").last();
+    }
+    if(hasQuery){
+        name += "?...";
+    }
+
+    return name;
+    // TODO: sometimes returns empty
+}
+
+QStringList PathTraceLogReader::splitLogLine(const QString& line)
+{
+    // Tabs inside the fields are escaped, so the raw tabs are the separators.
+    QStringList fields = line.split('\t');
+    for (int i = 0; i < fields.size(); i++) {
+        fields[i] = unescapeLogField(fields[i]);
+    }
+    return fields;
+}
+
+QString PathTraceLogReader::unescapeLogField(const QString& field)
+{
+    if (!field.contains('\\')) {
+        return field;
+    }
+
+    QString result;
+    result.reserve(field.size());
+
+    for (int i = 0; i < field.size(); i++) {
+        if (field[i] != '\\' || i + 1 == field.size()) {
+            result.append(field[i]);
+            continue;
+        }
+
+        i++;
+        if (field[i] == 't') {
+            result.append('\t');
+        } else if (field[i] == 'n') {
+            result.append('\n');
+        } else {
+            result.append(field[i]);
+        }
+    }
+
+    return result;
+}
+
+QString PathTraceLogReader::escapeHTML(QString text)
+{
+    return text.replace('&', "&amp;").replace('>', "&gt;").replace('<', "&lt;");
+}
+
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PATHTRACELOGREADER_H
+#define PATHTRACELOGREADER_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+
+#include "runtime/options.h"
+#include "model/coverage/sourceinfo.h"
+
+namespace artemis
+{
+
+/**
+ * Builds the path trace reports from the log written by PathTracer.
+ *
+ * The log is read one line at a time and the reports are written as they are read, so only the URLs of the sources
+ * are kept in memory.
+ */
+class PathTraceLogReader
+{
+public:
+    explicit PathTraceLogReader(QString pathToLog);
+
+    // Prints the traces selected by level to the log (as the console report).
+    void writeText(PathTraceReport level);
+
+    // Writes the collapsible HTML report, returns false if it could not be written.
+    bool writeHTML(QString pathToFile, bool linkWithCoverage, QString coveragePath);
+
+    static QString displayedUrl(QString url, bool fileNameOnly = false);
+
+private:
+    QString mPathToLog;
+    QHash<sourceid_t, QString> mSources;
+
+    static QStringList splitLogLine(const QString& line);
+    static QString unescapeLogField(const QString& field);
+    static QString escapeHTML(QString text);
+};
+
+}
+
+#endif // PATHTRACELOGREADER_H
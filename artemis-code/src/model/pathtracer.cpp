@@ -14,23 +14,78 @@
  * limitations under the License.
  */
 
-#include <sstream>
+#include <QDir>
 
 #include "util/loggingutil.h"
-#include "util/fileutil.h"
-#include "model/coverage/codeblockinfo.h"
 #include "statistics/statsstorage.h"
 
+#include "pathtracelogreader.h"
+
 #include "pathtracer.h"
 
 namespace artemis
 {
 
-PathTracer::PathTracer(PathTraceReport reportLevel, CoverageListenerPtr coverage)
-    : mCoverage(coverage)
-    , mTraceItemPoolUncompressedSize(0)
-    , mReportLevel(reportLevel)
+PathTracer::PathTracer(PathTraceReport reportLevel, uint maxItems, uint sampling)
+    : mReportLevel(reportLevel)
+    , mMaxItems(maxItems)
+    , mSampling(sampling == 0 ? 1 : sampling)
+    , mLogFile(QDir::tempPath() + "/artemis-traces-XXXXXX.log")
+    , mRecording(false)
+    , mTraces(0)
+    , mRecordedTraces(0)
+    , mItems(0)
+    , mRecordedItems(0)
+{
+}
+
+PathTracer::~PathTracer()
+{
+    if (mLogFile.isOpen()) {
+        mLog.flush();
+        mLogFile.close();
+    }
+}
+
+QString PathTracer::getLogPath() const
+{
+    return mLogPath;
+}
+
+/**
+ * The log is a temporary file, which is opened on the first trace and removed with the tracer. It contains one event per line, with tab separated fields (tabs, newlines
+ * and backslashes in the fields are escaped):
+ *
+ *   trace   <class> <description>       Starts a new trace, class is one of TraceClass().
+ *   source  <source id> <url>           Logged once per source, before the first call into it.
+ *   call    <name> <line> <source id>
+ *   return  <name>
+ *   alert   <message>
+ *   limit   <max items>                 Logged once when the item limit is reached, nothing is recorded after it.
+ */
+bool PathTracer::openLog()
+{
+    if (mLogFile.isOpen()) {
+        return true;
+    }
+
+    if (!mLogFile.open()) {
+        Log::error("Error: Could not create the path trace log " + mLogFile.fileTemplate().toStdString());
+        exit(1);
+    }
+    mLogPath = mLogFile.fileName();
+
+    mLog.setDevice(&mLogFile);
+    mLog.setCodec("UTF-8");
+    return true;
+}
+
+QString PathTracer::escapeLogField(QString field)
 {
+    field.replace("\\", "\\\\");
+    field.replace("\t", "\\t");
+    field.replace("\n", "\\n");
+    return field;
 }
 
 void PathTracer::notifyStartingLoad()
@@ -78,126 +133,93 @@ void PathTracer::slEventListenerTriggered(QWebElement* elem, QString eventName)
 
 void PathTracer::slJavascriptFunctionCalled(QString functionName, size_t bytecodeSize, uint functionStartLine, uint sourceOffset, QSource* source)
 {
-    if(mReportLevel == NO_TRACES){
+    if(mReportLevel == NO_TRACES || !startItem()){
         return;
     }
 
-    TraceItem item;
-    item.type = FUNCALL;
-    item.string = displayedFunctionName(functionName);
-    item.lineInFile = functionStartLine;
-    item.sourceID = SourceInfo::getId(source->getUrl(), source->getStartLine());
-    appendItem(item);
+    sourceid_t sourceID = SourceInfo::getId(source->getUrl(), source->getStartLine());
+    if (!mLoggedSources.contains(sourceID)) {
+        mLoggedSources.insert(sourceID);
+        mLog << "source\t" << sourceID << "\t" << escapeLogField(source->getUrl()) << "\n";
+    }
+
+    mLog << "call\t" << escapeLogField(displayedFunctionName(functionName)) << "\t" << functionStartLine << "\t" << sourceID << "\n";
 }
 
 void PathTracer::slJavascriptFunctionReturned(QString functionName)
 {
-    if(mReportLevel == NO_TRACES){
+    if(mReportLevel == NO_TRACES || !startItem()){
         return;
     }
 
-    appendItem(FUNRET, displayedFunctionName(functionName));
+    mLog << "return\t" << escapeLogField(displayedFunctionName(functionName)) << "\n";
 }
 
 void PathTracer::slJavascriptAlert(QWebFrame* frame, QString msg)
 {
-    if(mReportLevel == NO_TRACES){
+    if(mReportLevel == NO_TRACES || !startItem()){
         return;
     }
 
-    msg = msg.replace("\n", "\\n");
-    appendItem(ALERT, msg);
+    mLog << "alert\t" << escapeLogField(msg) << "\n";
 }
 
 void PathTracer::newPathTrace(QString description, TraceType type)
 {
-    PathTrace newTrace;
-    newTrace.type = type;
-    newTrace.description = description;
-    mTraces.append(newTrace);
+    mTraces++;
+
+    // Once the limit is reached nothing more is recorded, not even the (then empty) traces.
+    if (mMaxItems != 0 && mRecordedItems >= mMaxItems) {
+        mRecording = false;
+        return;
+    }
+
+    mRecording = (mTraces - 1) % mSampling == 0;
+    if (!mRecording) {
+        return;
+    }
+
+    openLog();
+    mRecordedTraces++;
+    mLog << "trace\t" << TraceClass(type) << "\t" << escapeLogField(description) << "\n";
 }
 
-void PathTracer::appendItem(TraceItem item)
+// Returns true if the item should be written to the log.
+bool PathTracer::startItem()
 {
-    if(mTraces.isEmpty()){
+    if(mTraces == 0){
         Log::error("Error: Trace item was added before any trace was started.");
-        Log::error("       Name: " + item.getName().toStdString());
         exit(1);
     }
 
-    TraceItemReference reference = item.hashcode();
+    mItems++;
 
-    if (!mTraceItemPool.contains(reference)) {
-        mTraceItemPool.insert(reference, item);
+    if (!mRecording) {
+        return false;
     }
 
-    mTraces.last().items.append(reference);
-    mTraceItemPoolUncompressedSize++;
-}
+    if (mMaxItems != 0 && mRecordedItems >= mMaxItems) {
+        mLog << "limit\t" << mMaxItems << "\n";
+        mRecording = false;
+        return false;
+    }
 
-void PathTracer::appendItem(ItemType type, QString name)
-{
-    TraceItem item;
-    item.type = type;
-    item.string = name;
-    appendItem(item);
+    mRecordedItems++;
+    return true;
 }
 
 void PathTracer::write()
 {
-    TraceItemReference itemReference;
-    TraceItem item;
-    PathTrace trace;
-    uint stackLevel;
-    string itemStr;
-
     if(mReportLevel == NO_TRACES){
         return;
     }
     if(mReportLevel == HTML_TRACES){
         Log::info("Trace report will be output as an HTML file in the working directory.");
-    }
-
-    //Log::info("===== Path Tracer =====");
-    if(mTraces.isEmpty()){
-        Log::info("No traces were recorded.");
         return;
     }
-    foreach(trace, mTraces){
-        if(mReportLevel == ALL_TRACES || (mReportLevel == CLICK_TRACES && trace.type == CLICK)){
-
-            Log::info("    Trace Start | " + trace.description.toStdString());
-            stackLevel = 1;
-
-            foreach(itemReference, trace.items){
-                item = mTraceItemPool[itemReference];
-                QString message = item.getMessage(mCoverage);
-                if(message == ""){
-                    itemStr = item.getName().toStdString();
-                }else{
-                    itemStr = (item.getName().leftJustified(35 - stackLevel*2) + ' ' + message).toStdString();
-                }
-                switch(item.type){
-                case FUNCALL:
-                    Log::info("  Function Call | " + std::string(stackLevel*2, ' ') + itemStr);
-                    stackLevel++;
-                    break;
-                case FUNRET:
-                    stackLevel--;
-                    //Log::info("   Function End | " + std::string(stackLevel*2, ' ') + itemStr);
-                    break;
-                case ALERT:
-                    Log::info("     Alert Call | " + std::string(stackLevel*2, ' ') + itemStr);
-                    break;
-                default:
-                    Log::info("        Unknown | " + std::string(stackLevel*2, ' ') + itemStr);
-                    break;
-                }
-            }
-
-            Log::info("\n");
-        }
-    }
+
+    mLog.flush();
+    PathTraceLogReader(mLogPath).writeText(mReportLevel);
 }
 
 void PathTracer::writePathTraceHTML(bool linkWithCoverage, QString coveragePath, QString& pathToFile){
@@ -205,105 +227,9 @@ void PathTracer::writePathTraceHTML(bool linkWithCoverage, QString coveragePath,
         return;
     }
 
-    TraceItem item;
-    PathTrace trace;
-    QString itemStr;
-    QString extraStr, functionLink;
-    uint indentLevel;
-    QString indent;
-    QString defaultClasses = "hidebytecode";
-    QString codeID;
-
-    QString style = ".controls a{text-decoration:underline;cursor:pointer;}ol{list-style:none;}ol#tracelist{margin-left:170px;}ol#tracelist>li{margin-bottom:30px;}ol#tracelist>li>span.label{font-weight:bold;}ol.functionbody{border-left:1px solid lightgray;}span.label{position:absolute;left:0;display:block;width:150px;text-align:right;}span.extrainfo{position:absolute;left:700px;white-space:nowrap;}span.itemname{font-family:monospace;}li.funcall>span.itemname,li.trace>span.description{cursor:pointer;margin-left:-1.2em;}li.funcall>span.itemname:before{content:'\\25BD\\00A0';}li.trace>span.description:before{content:'\\25BF\\00A0';}li.funcall.collapsed>span.itemname:before{content:'\\25B7\\00A0';}li.trace.collapsed>span.description:before{content:'\\25B9\\00A0';}li.funcall.collapsed>ol,li.trace.collapsed>ol{display:none;}";
-    style += " ol#tracelist.hidebytecode ol.singletrace li.bytecode{display:none;} ol#tracelist.showclicktracesonly li.trace:not(.click){display:none;} ol#tracelist.hideloadtraces li.trace.load{display:none;} ol#tracelist.hidemousetraces li.trace.mouse{display:none;}";
-
-    QString script = "window.onload = function(){elems = document.querySelectorAll('li.funcall>span.itemname, li.trace>span.description'); for(var i=0; i<elems.length; i++){elems[i].onclick = function(){this.parentNode.classList.toggle('collapsed');}}};";
-    script += " function toggleSetting(setting){tl=document.getElementById('tracelist').classList.toggle(setting);return false;}";
-
-    QString res = "<html>\n<head>\n\t<meta charset=\"utf-8\"/>\n\t<title>Path Trace</title>\n\t<style type=\"text/css\">" + style + "</style>\n\t<script type=\"text/javascript\">" + script + "</script>\n</head>\n<body>\n";
-
-    res += "<h1>Path Tracer Results</h1>\n";
-
-    res += "<hr>\n<h3>Display Options:</h3>\n<ul class=\"controls\">\n";
-    res += "\t<li><a onclick=\"toggleSetting('showclicktracesonly')\">Toggle displaying click traces only</a></li>\n";
-    res += "\t<li><a onclick=\"toggleSetting('hidemousetraces')\">Toggle mouse-related traces</a></li>\n";
-    res += "\t<li><a onclick=\"toggleSetting('hideloadtraces')\">Toggle loading-related traces</a></li>\n";
-    res += "</ul>\n<hr>\n\n";
-
-    if(mTraces.isEmpty()){
-        res += "<p>No traces were recorded.</p>\n";
-    }else{
-        res += "<ol id=\"tracelist\" class=\""+defaultClasses+"\">\n";
-        foreach(trace, mTraces){
-
-            res += "\t<li class=\"trace "+TraceClass(trace.type)+" collapsed\">\n\t\t<span class=\"label\">Trace Start:</span> <span class=\"description\">" + trace.description + "</span>\n\t\t<ol class=\"singletrace\">\n";
-            indentLevel = 3;
-
-            QListIterator<TraceItemReference> itemIt(trace.items);
-
-            while(itemIt.hasNext()){
-
-                item = mTraceItemPool[itemIt.next()];
-
-                QString message = item.getMessage(mCoverage);
-
-                itemStr = item.getName();
-                itemStr.replace('&',"&amp;").replace('>',"&gt;").replace('<',"&lt;");
-                itemStr = "<span class=\"itemname\">" + itemStr + "</span>";
-                extraStr = message.isEmpty() ? "" : (" <span class=\"extrainfo\">" + message + "</span>");
-                indent = QString(indentLevel, '\t');
-                res += indent;
-
-                switch(item.type){
-                case FUNCALL:
-                    if(linkWithCoverage){
-                        codeID = "ID"+QString::number(item.sourceID); // Matches the definition in coverageoutputstream.cpp
-                        functionLink = QString("<a href=\"%1?code=%2&line=%3\" target=\"coverageReport\" >View Code</a>").arg(coveragePath).arg(codeID).arg(item.lineInFile);
-                    }else{
-                        functionLink = "";
-                    }
-                    extraStr = QString("<span class=\"extrainfo\">File: <a href=\"%1\">%2</a>, Line: %3, %4</span>").arg(item.getUrl(mCoverage)).arg(displayedUrl(item.getUrl(mCoverage), true)).arg(item.lineInFile).arg(functionLink);
-                    res += "<li class=\"funcall\">\n"+indent+"\t<span class=\"label\">Function Call:</span> " + itemStr + extraStr + "\n"+indent+"\t<ol class=\"functionbody\">\n";
-                    indentLevel++;
-                    break;
-                case FUNRET:
-                    res += "</ol>\n" + QString(indentLevel-1, '\t') + "</li>\n";
-                    indentLevel--;
-                    break;
-                case ALERT:
-                    res += "<li class=\"alert\"><span class=\"label\">Alert Call:</span> " + itemStr + extraStr + "</li>\n";
-                    break;
-                default:
-                    res += "<li class=\"unknown\"><span class=\"label\">Unknown:</span> " + itemStr + extraStr + "</li>\n";
-                    break;
-                }
-            }
-
-            res += "\t\t</ol>\n\t</li>\n";
-        }
-    res += "</ol>\n";
-    }
-
-    res += "</body>\n</html>\n";
-
+    mLog.flush();
     pathToFile = QString("traces-") + QDateTime::currentDateTime().toString("dd-MM-yy-hh-mm-ss") + ".html";
-    writeStringToFile(pathToFile, res);
-}
-
-QString PathTracer::displayedUrl(QString url, bool fileNameOnly)
-{
-    bool hasQuery = url.indexOf('?') != -1;
-    QString name = url.split("?").first();
-
-    if(fileNameOnly){
-        name = name.split("/").last();
-    }
-    if(hasQuery){
-        name += "?...";
-    }
-
-    return name;
-    // TODO: sometimes returns empty
+    PathTraceLogReader(mLogPath).writeHTML(pathToFile, linkWithCoverage, coveragePath);
 }
 
 QString PathTracer::displayedFunctionName(QString name)
@@ -329,10 +255,10 @@ QString PathTracer::TraceClass(TraceType type)
 
 void PathTracer::writeStatistics()
 {
-    std::stringstream out;
-    out << mTraceItemPool.size() << "/" << mTraceItemPoolUncompressedSize;
-
-    Statistics::statistics()->set("WebKit::pathtracer::traceitempool-compression", out.str());
+    Statistics::statistics()->set("WebKit::pathtracer::traces", (int)mTraces);
+    Statistics::statistics()->set("WebKit::pathtracer::traces-recorded", (int)mRecordedTraces);
+    Statistics::statistics()->set("WebKit::pathtracer::items", (int)mItems);
+    Statistics::statistics()->set("WebKit::pathtracer::items-recorded", (int)mRecordedItems);
 }
 
 }
@@ -26,99 +26,68 @@
 #include <QWebElement>
 #include <QWebExecutionListener>
 #include <QDateTime>
-#include <QListIterator>
 #include <QSource>
-#include <QHash>
+#include <QSet>
+#include <QTemporaryFile>
+#include <QTextStream>
 
 #include "runtime/options.h"
 #include "runtime/input/baseinput.h"
 #include "model/coverage/sourceinfo.h"
-#include "model/coverage/coveragelistener.h"
 
 namespace artemis
 {
 
+/**
+ * Records the path through the JavaScript (function calls and alerts) for each page load and event.
+ *
+ * The traces are not kept in memory, they are streamed to a log (see openLog() for the format) as they are recorded,
+ * and the reports are generated from that log by PathTraceLogReader. At most maxItems items are recorded (0 for no
+ * limit) and only one in every sampling traces.
+ */
 class PathTracer : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit PathTracer(PathTraceReport reportLevel, CoverageListenerPtr coverage);
+    explicit PathTracer(PathTraceReport reportLevel, uint maxItems = 0, uint sampling = 1);
+    ~PathTracer();
+
     void notifyStartingLoad();
     void notifyStartingEvent(QSharedPointer<const BaseInput> inputEvent);
     void write();
     void writePathTraceHTML(bool linkWithCoverage, QString coveragePath, QString& pathToFile);
     void writeStatistics();
 
-private:
-
-    CoverageListenerPtr mCoverage; // used for printing urls without storing the entire URL
-
-    enum ItemType {FUNCALL, FUNRET, ALERT};
-    struct TraceItem {
-        ItemType type;
-        QString string;
-
-        // The following are not present in all item types.
-        uint lineInFile;
-        sourceid_t sourceID;
-
-        QString getUrl(CoverageListenerPtr coverage) {
-            return coverage->getSourceInfo(sourceID)->getURL();
-        }
-
-        QString getName() {
-            switch (type) {
-            case ALERT:
-                return "alert()";
-            default:
-                return string;
-            }
-        }
-
-        QString getMessage(CoverageListenerPtr coverage) {
-            switch (type) {
-            case FUNCALL:
-                return QString("File: %1, Line: %2.").arg(PathTracer::displayedUrl(getUrl(coverage))).arg(lineInFile);
-            case ALERT:
-                return string;
-            default:
-                return "";
-            }
-        }
-
-        uint hashcode() {
-            return (uint)type + qHash(string) * 7 + lineInFile * 31 + sourceID * 79;
-        }
-    };
-
-    /**
-     * We place all trace items in the trace item pool, such that items with identical contents are merged together.
-     *
-     * This is to reduce the high memory consumption resulting from a large number of very similar traces.
-     */
-    typedef uint TraceItemReference;
-    QHash<TraceItemReference, TraceItem> mTraceItemPool;
-
-    unsigned int mTraceItemPoolUncompressedSize;
+    QString getLogPath() const;
 
     enum TraceType {OTHER, CLICK, LOAD, MOUSE};
-    struct PathTrace {
-        TraceType type;
-        QString description;
-        QList<TraceItemReference> items;
-    };
+    static QString TraceClass(TraceType type);
 
-    QList<PathTrace> mTraces;
+private:
     const PathTraceReport mReportLevel;
+    const uint mMaxItems;
+    const uint mSampling;
+
+    QString mLogPath;
+    QTemporaryFile mLogFile;
+    QTextStream mLog;
+    QSet<sourceid_t> mLoggedSources;
+
+    // Whether items are recorded into the current trace (i.e. it was sampled and the limit is not reached yet).
+    bool mRecording;
+
+    uint mTraces;
+    uint mRecordedTraces;
+    uint mItems;
+    uint mRecordedItems;
 
+    bool openLog();
     void newPathTrace(QString description, TraceType type);
-    void appendItem(TraceItem item);
-    void appendItem(ItemType type, QString name);
+    bool startItem();
 
-    static QString displayedUrl(QString url, bool fileNameOnly = false);
     QString displayedFunctionName(QString name);
-    QString TraceClass(TraceType type);
+    static QString escapeLogField(QString field);
 
 public slots:
     void slJavascriptFunctionCalled(QString functionName, size_t bytecodeSize, uint functionStartLine, uint sourceOffset, QSource* source);
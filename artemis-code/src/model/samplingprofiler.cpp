@@ -0,0 +1,401 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <assert.h>
+
+#include <QFile>
+#include <QMutexLocker>
+#include <QSet>
+#include <QWebExecutionListener>
+
+#include <qjson/serializer.h>
+
+#include "util/loggingutil.h"
+
+#include "samplingprofiler.h"
+
+namespace artemis {
+
+// The number of hotspots included in the report, the flat profile is always complete.
+static const int MAX_HOTSPOTS = 100;
+
+SamplerThread::SamplerThread(SamplingProfiler* profiler, uint intervalMicroseconds)
+    : mProfiler(profiler)
+    , mInterval(intervalMicroseconds)
+    , mStopped(0)
+{
+}
+
+void SamplerThread::stop()
+{
+    mStopped.fetchAndStoreOrdered(1);
+}
+
+void SamplerThread::run()
+{
+    while (!mStopped) {
+        usleep(mInterval);
+        mProfiler->tick();
+    }
+}
+
+
+QAtomicInt SamplingProfiler::mPhase(SamplingProfiler::ARTEMIS);
+SamplingProfiler* SamplingProfiler::mRunning = NULL;
+
+SamplingProfiler::Phase SamplingProfiler::setPhase(Phase phase)
+{
+    Phase previous = (Phase)mPhase.fetchAndStoreOrdered(phase);
+
+    // The shadow stack only describes the JavaScript running in the current phase (e.g. the handlers of one event).
+    // Clearing it here keeps a return which was never seen (exceptions, aborted loads) from leaking into later phases.
+    if (previous != phase && mRunning != NULL) {
+        mRunning->mCallStack.clear();
+    }
+
+    return previous;
+}
+
+SamplingProfiler::Phase SamplingProfiler::currentPhase()
+{
+    return (Phase)(int)mPhase;
+}
+
+SamplingProfiler::PhaseScope::PhaseScope(Phase phase)
+    : mPrevious(SamplingProfiler::setPhase(phase))
+{
+}
+
+SamplingProfiler::PhaseScope::~PhaseScope()
+{
+    SamplingProfiler::setPhase(mPrevious);
+}
+
+SamplingProfiler::SamplingProfiler()
+    : QObject()
+    , mListener(NULL)
+    , mSampler(NULL)
+    , mInterval(0)
+    , mSamples(0)
+{
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+    stop();
+}
+
+void SamplingProfiler::start(QWebExecutionListener* listener, uint intervalMicroseconds)
+{
+    assert(listener);
+    assert(intervalMicroseconds > 0);
+
+    if (isRunning()) {
+        stop();
+    }
+
+    mListener = listener;
+    mInterval = intervalMicroseconds;
+    mCallStack.clear();
+    mRunning = this;
+
+    QObject::connect(mListener, SIGNAL(sigJavascriptSampled(uint, uint, uint, QSource*, bool)),
+                     this, SLOT(slJavascriptSampled(uint, uint, uint, QSource*, bool)));
+    QObject::connect(mListener, SIGNAL(sigJavascriptFunctionCalled(QString, size_t, uint, uint, QSource*)),
+                     this, SLOT(slJavascriptFunctionCalled(QString, size_t, uint, uint, QSource*)));
+    QObject::connect(mListener, SIGNAL(sigJavascriptFunctionReturned(QString)),
+                     this, SLOT(slJavascriptFunctionReturned(QString)));
+
+    mSampler = new SamplerThread(this, mInterval);
+    mSampler->start();
+
+    Log::debug(QString("Sampling profiler: started with an interval of %1us").arg(mInterval).toStdString());
+}
+
+void SamplingProfiler::stop()
+{
+    if (!isRunning()) {
+        return;
+    }
+
+    mSampler->stop();
+    mSampler->wait();
+    delete mSampler;
+    mSampler = NULL;
+
+    mListener->disconnect(this);
+    mListener = NULL;
+    mCallStack.clear();
+
+    if (mRunning == this) {
+        mRunning = NULL;
+    }
+
+    Log::debug(QString("Sampling profiler: stopped after %1 samples").arg(mSamples).toStdString());
+}
+
+void SamplingProfiler::reset()
+{
+    QMutexLocker locker(&mMutex);
+
+    mSamples = 0;
+    mSelf.clear();
+    mTotal.clear();
+    mHotspots.clear();
+    mCallTree = CallTreeNode();
+}
+
+bool SamplingProfiler::isRunning() const
+{
+    return mSampler != NULL;
+}
+
+uint SamplingProfiler::getInterval() const
+{
+    return mInterval;
+}
+
+void SamplingProfiler::tick()
+{
+    // If the previous request is still pending then no bytecode has been executed since the last tick, so the main
+    // thread is in WebKit or in Artemis itself. There is no JavaScript stack to record in that case.
+    if (!mListener->requestSample()) {
+        record(currentPhase(), NATIVE, QStringList(), QString());
+    }
+}
+
+void SamplingProfiler::slJavascriptSampled(uint bytecodeOffset, uint linenumber, uint sourceOffset, QSource* source, bool instrumented)
+{
+    QStringList frames;
+    foreach (Frame frame, mCallStack) {
+        frames.append(frameLabel(frame.name, frame.line, frame.source));
+    }
+
+    // The sampled code block is not on the shadow stack if it is top-level (program or eval) code.
+    if (mCallStack.isEmpty() || mCallStack.last().source != source || mCallStack.last().sourceOffset != sourceOffset) {
+        frames.append(frameLabel(QString("(program)"), linenumber, source));
+    }
+
+    QString location = QString("%1:%2 [bytecode %3]")
+            .arg(source == NULL ? QString("(unknown)") : source->getUrl())
+            .arg(linenumber)
+            .arg(bytecodeOffset);
+
+    record(currentPhase(), instrumented ? PAGE_JS : ARTEMIS_JS, frames, location);
+}
+
+void SamplingProfiler::slJavascriptFunctionCalled(QString functionName, size_t bytecodeSize, uint functionStartLine, uint sourceOffset, QSource* source)
+{
+    Frame frame;
+    frame.name = functionName.isEmpty() ? QString("(anonymous)") : functionName;
+    frame.line = functionStartLine;
+    frame.sourceOffset = sourceOffset;
+    frame.source = source;
+
+    mCallStack.append(frame);
+}
+
+void SamplingProfiler::slJavascriptFunctionReturned(QString functionName)
+{
+    QString name = functionName.isEmpty() ? QString("(anonymous)") : functionName;
+
+    // Unwind to the matching call, frames above it were left by exceptions.
+    for (int i = mCallStack.size() - 1; i >= 0; i--) {
+        if (mCallStack.at(i).name == name) {
+            mCallStack.erase(mCallStack.begin() + i, mCallStack.end());
+            return;
+        }
+    }
+}
+
+void SamplingProfiler::record(Phase phase, Category category, const QStringList& frames, const QString& location)
+{
+    QMutexLocker locker(&mMutex);
+
+    mSamples++;
+
+    QStringList path;
+    path << phaseToString(phase) << categoryToString(category) << frames;
+
+    CallTreeNode* node = &mCallTree;
+    node->total++;
+    foreach (QString label, path) {
+        QSharedPointer<CallTreeNode>& child = node->children[label];
+        if (child.isNull()) {
+            child = QSharedPointer<CallTreeNode>(new CallTreeNode());
+        }
+        node = child.data();
+        node->total++;
+    }
+    node->self++;
+
+    // Recursive functions appear several times on a stack, but only count once towards their total.
+    QString leaf = frames.isEmpty() ? QString("(native) %1").arg(phaseToString(phase)) : frames.last();
+    QSet<QString> seen;
+    foreach (QString label, frames) {
+        if (!seen.contains(label)) {
+            seen.insert(label);
+            mTotal[label]++;
+        }
+    }
+    if (frames.isEmpty()) {
+        mTotal[leaf]++;
+    }
+    mSelf[leaf]++;
+
+    if (!location.isEmpty()) {
+        mHotspots[location]++;
+    }
+}
+
+QString SamplingProfiler::frameLabel(QString name, uint line, QSource* source)
+{
+    return QString("%1 (%2:%3)").arg(name).arg(source == NULL ? QString("(unknown)") : source->getUrl()).arg(line);
+}
+
+QVariantMap SamplingProfiler::callTreeToVariant(const QString& name, const CallTreeNode& node)
+{
+    QVariantList children;
+    foreach (QString childName, node.children.keys()) {
+        children.append(callTreeToVariant(childName, *node.children.value(childName)));
+    }
+
+    QVariantMap result;
+    result.insert("name", name);
+    result.insert("self", node.self);
+    result.insert("total", node.total);
+    result.insert("children", children);
+    return result;
+}
+
+QVariantMap SamplingProfiler::toVariant()
+{
+    QMutexLocker locker(&mMutex);
+
+    // Flat profile, by decreasing self time.
+    QMultiMap<quint64, QString> bySelf;
+    foreach (QString label, mTotal.keys()) {
+        bySelf.insert(mSelf.value(label, 0), label);
+    }
+
+    QVariantList flat;
+    QMapIterator<quint64, QString> flatIter(bySelf);
+    flatIter.toBack();
+    while (flatIter.hasPrevious()) {
+        flatIter.previous();
+        QVariantMap entry;
+        entry.insert("function", flatIter.value());
+        entry.insert("self", flatIter.key());
+        entry.insert("total", mTotal.value(flatIter.value()));
+        flat.append(entry);
+    }
+
+    // Hottest bytecode locations.
+    QMultiMap<quint64, QString> byCount;
+    foreach (QString location, mHotspots.keys()) {
+        byCount.insert(mHotspots.value(location), location);
+    }
+
+    QVariantList hotspots;
+    QMapIterator<quint64, QString> hotspotIter(byCount);
+    hotspotIter.toBack();
+    while (hotspotIter.hasPrevious() && hotspots.size() < MAX_HOTSPOTS) {
+        hotspotIter.previous();
+        QVariantMap entry;
+        entry.insert("location", hotspotIter.value());
+        entry.insert("samples", hotspotIter.key());
+        hotspots.append(entry);
+    }
+
+    // Samples per phase and category, from the top two levels of the call tree.
+    QVariantMap phases;
+    foreach (QString phaseName, mCallTree.children.keys()) {
+        QSharedPointer<CallTreeNode> phaseNode = mCallTree.children.value(phaseName);
+        QVariantMap categories;
+        categories.insert("total", phaseNode->total);
+        foreach (QString categoryName, phaseNode->children.keys()) {
+            categories.insert(categoryName, phaseNode->children.value(categoryName)->total);
+        }
+        phases.insert(phaseName, categories);
+    }
+
+    QVariantMap result;
+    result.insert("interval", mInterval);
+    result.insert("samples", mSamples);
+    result.insert("running", isRunning());
+    result.insert("phases", phases);
+    result.insert("flat", flat);
+    result.insert("hotspots", hotspots);
+    result.insert("calltree", callTreeToVariant(QString("(root)"), mCallTree));
+    return result;
+}
+
+bool SamplingProfiler::writeToFile(QString path)
+{
+    QJson::Serializer serializer;
+    bool ok;
+    QByteArray json = serializer.serialize(toVariant(), &ok);
+
+    QFile file(path);
+    if (!ok || !file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        Log::error(QString("Sampling profiler: could not write the profile to %1").arg(path).toStdString());
+        return false;
+    }
+
+    file.write(json);
+    file.close();
+
+    Log::info(QString("Sampling profiler: wrote %1 samples to %2").arg(mSamples).arg(path).toStdString());
+    return true;
+}
+
+QString SamplingProfiler::phaseToString(Phase phase)
+{
+    switch (phase) {
+    case ARTEMIS:
+        return "artemis";
+    case PAGE_LOAD:
+        return "page-load";
+    case INJECTION:
+        return "injection";
+    case EVENT:
+        return "event";
+    case SOLVER:
+        return "solver";
+    case MERGE:
+        return "merge";
+    default:
+        assert(false);
+        return "";
+    }
+}
+
+QString SamplingProfiler::categoryToString(Category category)
+{
+    switch (category) {
+    case PAGE_JS:
+        return "page-js";
+    case ARTEMIS_JS:
+        return "artemis-js";
+    case NATIVE:
+        return "native";
+    default:
+        assert(false);
+        return "";
+    }
+}
+
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SAMPLINGPROFILER_H
+#define SAMPLINGPROFILER_H
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QThread>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QMap>
+#include <QVariantMap>
+#include <QSource>
+
+class QWebExecutionListener;
+
+namespace artemis {
+
+class SamplingProfiler;
+
+// Wakes up every interval and asks the profiler to take a sample.
+class SamplerThread : public QThread
+{
+public:
+    SamplerThread(SamplingProfiler* profiler, uint intervalMicroseconds);
+
+    void stop();
+
+protected:
+    void run();
+
+    SamplingProfiler* mProfiler;
+    uint mInterval;
+    QAtomicInt mStopped;
+};
+
+/**
+ * A low-overhead sampling profiler for a whole Artemis run.
+ *
+ * A sampler thread periodically asks the QWebExecutionListener for a sample. The next bytecode executed by the
+ * interpreter answers the request (with its CodeBlock, bytecode offset and line) on the main thread, where it is
+ * combined with a shadow call stack built from the function call/return signals. If no bytecode picks up the
+ * request before the next tick, the main thread was busy outside of JavaScript and the sample is attributed to
+ * Artemis itself ("native").
+ *
+ * Every sample is also tagged with the current Artemis phase (set with setPhase() or a PhaseScope), so time can be
+ * attributed to page JavaScript, to JavaScript injected by Artemis (which the interpreter does not instrument), or
+ * to Artemis in each of page load, injection, event, solver and merge.
+ */
+class SamplingProfiler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Phase {
+        ARTEMIS, PAGE_LOAD, INJECTION, EVENT, SOLVER, MERGE
+    };
+
+    enum Category {
+        PAGE_JS, ARTEMIS_JS, NATIVE
+    };
+
+    // Sets the phase for the samples which follow, and returns the previous one. Cheap enough to call when no
+    // profiler is running.
+    static Phase setPhase(Phase phase);
+    static Phase currentPhase();
+
+    // Sets a phase for the lifetime of the scope and restores the previous phase afterwards.
+    class PhaseScope
+    {
+    public:
+        PhaseScope(Phase phase);
+        ~PhaseScope();
+
+    private:
+        Phase mPrevious;
+    };
+
+    SamplingProfiler();
+    ~SamplingProfiler();
+
+    void start(QWebExecutionListener* listener, uint intervalMicroseconds);
+    void stop();
+    void reset();
+
+    bool isRunning() const;
+    uint getInterval() const;
+
+    // Flat profile, hotspots and call tree (phase -> category -> JavaScript frames).
+    QVariantMap toVariant();
+    bool writeToFile(QString path);
+
+    static QString phaseToString(Phase phase);
+    static QString categoryToString(Category category);
+
+public slots:
+    void slJavascriptSampled(uint bytecodeOffset, uint linenumber, uint sourceOffset, QSource* source, bool instrumented);
+    void slJavascriptFunctionCalled(QString functionName, size_t bytecodeSize, uint functionStartLine, uint sourceOffset, QSource* source);
+    void slJavascriptFunctionReturned(QString functionName);
+
+protected:
+    friend class SamplerThread;
+
+    // Called from the sampler thread.
+    void tick();
+
+    void record(Phase phase, Category category, const QStringList& frames, const QString& location);
+
+    struct Frame {
+        QString name;
+        uint line;
+        uint sourceOffset;
+        QSource* source;
+    };
+
+    static QString frameLabel(QString name, uint line, QSource* source);
+
+    struct CallTreeNode {
+        CallTreeNode() : self(0), total(0) {}
+
+        quint64 self;
+        quint64 total;
+        QMap<QString, QSharedPointer<CallTreeNode> > children;
+    };
+
+    static QVariantMap callTreeToVariant(const QString& name, const CallTreeNode& node);
+
+    QWebExecutionListener* mListener;
+    SamplerThread* mSampler;
+    uint mInterval;
+
+    // The shadow call stack, only used from the main thread.
+    QList<Frame> mCallStack;
+
+    // Aggregated samples, written from both the main thread and the sampler thread.
+    QMutex mMutex;
+    quint64 mSamples;
+    QHash<QString, quint64> mSelf;
+    QHash<QString, quint64> mTotal;
+    QHash<QString, quint64> mHotspots;
+    CallTreeNode mCallTree;
+
+    static QAtomicInt mPhase;
+    static SamplingProfiler* mRunning;
+};
+
+typedef QSharedPointer<SamplingProfiler> SamplingProfilerPtr;
+
+}
+
+#endif // SAMPLINGPROFILER_H
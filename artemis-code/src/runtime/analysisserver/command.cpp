@@ -109,6 +109,11 @@ void CoverageCommand::accept(AnalysisServerRuntime *server)
     server->execute(this);
 }
 
+void ProfileCommand::accept(AnalysisServerRuntime *server)
+{
+    server->execute(this);
+}
+
 
 
 } // namespace artemis
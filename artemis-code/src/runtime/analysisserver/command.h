@@ -323,6 +323,26 @@ public:
 
 typedef QSharedPointer<CoverageCommand> CoverageCommandPtr;
 
+// Command to control the sampling profiler and fetch its results.
+class ProfileCommand : public Command
+{
+public:
+    enum ProfileAction { Start, Stop, Report, Reset };
+
+    ProfileCommand(ProfileAction action, uint interval, QString file)
+        : action(action)
+        , interval(interval)
+        , file(file)
+    {}
+    virtual void accept(AnalysisServerRuntime* server);
+
+    ProfileAction action;
+    uint interval;
+    QString file;
+};
+
+typedef QSharedPointer<ProfileCommand> ProfileCommandPtr;
+
 
 
 
@@ -189,6 +189,10 @@ CommandPtr RequestHandler::createCommand(QVariant data)
         expectedFields = QStringList();
         cmdObject = coverageCommand(mainObject);
 
+    } else if (command == "profile") {
+        expectedFields = QStringList() << "action" << "interval" << "file";
+        cmdObject = profileCommand(mainObject);
+
     } else {
         return parseError("Command was not recognised.");
     }
@@ -704,5 +708,56 @@ CommandPtr RequestHandler::coverageCommand(QVariantMap mainObject)
     return CoverageCommandPtr(new CoverageCommand);
 }
 
+CommandPtr RequestHandler::profileCommand(QVariantMap mainObject)
+{
+    Log::debug("  Request handler: Building profile command.");
+
+    ProfileCommand::ProfileAction action;
+
+    if (!mainObject.contains("action")) {
+        return parseError("Could not find the 'action' property for a profile command.");
+    }
+
+    if (mainObject["action"].type() != QVariant::String) {
+        return parseError("The 'action' property for a profile command must be a string.");
+    }
+
+    QString actionString = mainObject["action"].toString();
+    if (actionString == "start") {
+        action = ProfileCommand::Start;
+    } else if (actionString == "stop") {
+        action = ProfileCommand::Stop;
+    } else if (actionString == "report") {
+        action = ProfileCommand::Report;
+    } else if (actionString == "reset") {
+        action = ProfileCommand::Reset;
+    } else {
+        return parseError("The 'action' property for a profile command was not recognised.");
+    }
+
+    // 'interval' is an optional sampling interval in microseconds (default 1000).
+    uint interval = 1000;
+    if (mainObject.contains("interval")) {
+        bool ok;
+        interval = mainObject["interval"].toUInt(&ok);
+
+        if (!ok || interval == 0) {
+            return parseError("The 'interval' property for a profile command must be a positive integer.");
+        }
+    }
+
+    // 'file' is an optional path the report is also written to.
+    QString file;
+    if (mainObject.contains("file")) {
+        if (mainObject["file"].type() != QVariant::String) {
+            return parseError("The 'file' property for a profile command must be a string.");
+        }
+
+        file = mainObject["file"].toString();
+    }
+
+    return ProfileCommandPtr(new ProfileCommand(action, interval, file));
+}
+
 
 }
@@ -70,6 +70,7 @@ protected:
     CommandPtr evaluateJsCommand(QVariantMap mainObject);
     CommandPtr setSymbolicValuesCommand(QVariantMap mainObject);
     CommandPtr coverageCommand(QVariantMap mainObject);
+    CommandPtr profileCommand(QVariantMap mainObject);
 
 protected slots:
     void slRequestFullyLoaded();
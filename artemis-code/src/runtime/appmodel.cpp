@@ -24,12 +24,13 @@ AppModel::AppModel(Options options)
 {
     mCoverageListener = CoverageListenerPtr(new CoverageListener(options.coverageIgnoreUrls ));
     mJavascriptStatistics = JavascriptStatisticsPtr(new JavascriptStatistics());
+    mSamplingProfiler = SamplingProfilerPtr(new SamplingProfiler());
 
     // If we are in concolic mode then enable the path tracer by default (but without overriding any user-specified setting).
     if(options.majorMode == artemis::CONCOLIC && options.reportPathTrace == artemis::NO_TRACES){
-        mPathTracer = PathTracerPtr(new PathTracer(artemis::HTML_TRACES, mCoverageListener));
+        mPathTracer = PathTracerPtr(new PathTracer(artemis::HTML_TRACES, options.pathTraceMaxItems, options.pathTraceSampling));
     }else{
-        mPathTracer = PathTracerPtr(new PathTracer(options.reportPathTrace, mCoverageListener));
+        mPathTracer = PathTracerPtr(new PathTracer(options.reportPathTrace, options.pathTraceMaxItems, options.pathTraceSampling));
     }
 }
 
@@ -48,4 +49,9 @@ PathTracerPtr AppModel::getPathTracer() const
     return mPathTracer;
 }
 
+SamplingProfilerPtr AppModel::getSamplingProfiler() const
+{
+    return mSamplingProfiler;
+}
+
 }
@@ -23,6 +23,7 @@
 #include "model/coverage/coveragelistener.h"
 #include "model/javascriptstatistics.h"
 #include "model/pathtracer.h"
+#include "model/samplingprofiler.h"
 
 namespace artemis {
 
@@ -35,11 +36,13 @@ public:
     CoverageListenerPtr getCoverageListener() const;
     JavascriptStatisticsPtr getJavascriptStatistics() const;
     PathTracerPtr getPathTracer() const;
+    SamplingProfilerPtr getSamplingProfiler() const;
 
 private:
     CoverageListenerPtr mCoverageListener;
     JavascriptStatisticsPtr mJavascriptStatistics;
     PathTracerPtr mPathTracer;
+    SamplingProfilerPtr mSamplingProfiler;
 
 };
 
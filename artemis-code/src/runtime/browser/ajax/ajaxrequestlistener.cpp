@@ -16,16 +16,37 @@
 
 #include "ajaxrequestlistener.h"
 #include <QNetworkAccessManager>
+#include <QNetworkCookieJar>
 #include <QNetworkRequest>
+#include <QBuffer>
 #include <QDebug>
 
+#include "statistics/statsstorage.h"
+#include "util/loggingutil.h"
+
+#include "cachednetworkreply.h"
+#include "recordingnetworkreply.h"
+#include "prettifyingnetworkreply.h"
+
 
 namespace artemis
 {
 
 AjaxRequestListener::AjaxRequestListener(QObject* parent) :
-    QNetworkAccessManager(parent)
+    QNetworkAccessManager(parent),
+    mNetworkCacheMode(NETWORK_CACHE_OFF)
+{
+}
+
+void AjaxRequestListener::setNetworkCache(NetworkCachePtr cache, NetworkCacheMode mode)
 {
+    mNetworkCache = cache;
+    mNetworkCacheMode = mode;
+}
+
+void AjaxRequestListener::setPrettifyCache(PrettifyCachePtr prettifier)
+{
+    mPrettifier = prettifier;
 }
 
 QNetworkReply* AjaxRequestListener::createRequest(Operation op, const QNetworkRequest& req, QIODevice* outgoingData)
@@ -68,8 +89,13 @@ QNetworkReply* AjaxRequestListener::createRequest(Operation op, const QNetworkRe
     }
 
 
-    //super call
-    QNetworkReply* reply = QNetworkAccessManager::createRequest(op, req, outgoingData);
+    //super call, unless the network cache is enabled
+    QNetworkReply* reply = mNetworkCache.isNull() ? QNetworkAccessManager::createRequest(op, req, outgoingData)
+                                                  : createCachedRequest(op, req, outgoingData);
+
+    if (!mPrettifier.isNull() && op == GetOperation) {
+        reply = new PrettifyingNetworkReply(this, reply, mPrettifier);
+    }
 
     if (op == GetOperation)
         { emit this->pageGet(req.url()); }
@@ -79,4 +105,89 @@ QNetworkReply* AjaxRequestListener::createRequest(Operation op, const QNetworkRe
     return reply;
 }
 
+QNetworkReply* AjaxRequestListener::createCachedRequest(Operation op, const QNetworkRequest& req, QIODevice* outgoingData)
+{
+    if (!NetworkCache::isCacheable(op, req)) {
+        QString scheme = req.url().scheme();
+        if (mNetworkCacheMode == NETWORK_CACHE_OFFLINE && (scheme == "http" || scheme == "https")) {
+            Log::warning("NetworkCache: Blocked uncacheable request in offline mode: " + req.url().toString().toStdString());
+            Statistics::statistics()->accumulate("AjaxRequestListener::NetworkCache::Misses", 1);
+            return new CachedNetworkReply(this, op, req, CachedResponseConstPtr());
+        }
+        return QNetworkAccessManager::createRequest(op, req, outgoingData);
+    }
+
+    // The request body is part of the key, so it must be read here and handed on to the real request as a fresh device.
+    QByteArray body;
+    if (outgoingData != NULL) {
+        body = outgoingData->readAll();
+    }
+
+    QList<QNetworkCookie> cookies;
+    if (cookieJar() != NULL) {
+        cookies = cookieJar()->cookiesForUrl(req.url());
+    }
+
+    QByteArray key = NetworkCache::requestKey(op, req, body, cookies);
+
+    // While recording, every request still goes to the network, so e.g. a form which is posted twice reaches the server
+    // twice, and the latest response is recorded. Replay mode serves the GET and HEAD requests it has an HTTP response
+    // for, and records the rest like record mode.
+    if (mNetworkCacheMode == NETWORK_CACHE_REPLAY) {
+        CachedResponseConstPtr response = mNetworkCache->lookup(key);
+
+        if (NetworkCache::isReplayable(op, response)) {
+            Statistics::statistics()->accumulate("AjaxRequestListener::NetworkCache::Hits", 1);
+            storeCookies(req.url(), response);
+            return new CachedNetworkReply(this, op, req, response);
+        }
+
+        Statistics::statistics()->accumulate("AjaxRequestListener::NetworkCache::Misses", 1);
+    }
+
+    if (mNetworkCacheMode == NETWORK_CACHE_OFFLINE) {
+        CachedResponseConstPtr response = mNetworkCache->lookup(key);
+
+        if (response.isNull()) {
+            Log::warning("NetworkCache: No recorded response in offline mode for " + req.url().toString().toStdString());
+            Statistics::statistics()->accumulate("AjaxRequestListener::NetworkCache::Misses", 1);
+        } else {
+            Statistics::statistics()->accumulate("AjaxRequestListener::NetworkCache::Hits", 1);
+            storeCookies(req.url(), response);
+        }
+
+        return new CachedNetworkReply(this, op, req, response);
+    }
+
+    QBuffer* bodyBuffer = NULL;
+    if (outgoingData != NULL) {
+        bodyBuffer = new QBuffer();
+        bodyBuffer->setData(body);
+        bodyBuffer->open(QIODevice::ReadOnly);
+    }
+
+    QNetworkReply* networkReply = QNetworkAccessManager::createRequest(op, req, bodyBuffer);
+
+    if (bodyBuffer != NULL) {
+        bodyBuffer->setParent(networkReply);
+    }
+
+    return new RecordingNetworkReply(this, networkReply, mNetworkCache, key);
+}
+
+// The cached reply does not come from QNetworkAccessManager, which would otherwise store the cookies it sets.
+void AjaxRequestListener::storeCookies(const QUrl& url, CachedResponseConstPtr response)
+{
+    if (cookieJar() == NULL) {
+        return;
+    }
+
+    typedef QPair<QByteArray, QByteArray> RawHeader;
+    foreach (RawHeader header, response->headers) {
+        if (header.first.toLower() == "set-cookie") {
+            cookieJar()->setCookiesFromUrl(QNetworkCookie::parseCookies(header.second), url);
+        }
+    }
+}
+
 }
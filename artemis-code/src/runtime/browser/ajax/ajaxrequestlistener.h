@@ -18,6 +18,12 @@
 #define AJAXREQUESTLISTENER_H
 #include <QNetworkAccessManager>
 #include <QUrl>
+
+#include "runtime/options.h"
+
+#include "networkcache.h"
+#include "prettifycache.h"
+
 namespace artemis
 {
 
@@ -30,6 +36,23 @@ public:
     explicit AjaxRequestListener(QObject* parent = 0);
     QNetworkReply* createRequest(Operation op, const QNetworkRequest& req, QIODevice* outgoingData = 0);
 
+    // Record the responses into the given cache and, in replay and offline mode, serve them from it. In replay mode only
+    // replayable responses are served and the other requests are recorded. In offline mode a cache miss fails the request
+    // instead of going to the network.
+    void setNetworkCache(NetworkCachePtr cache, NetworkCacheMode mode);
+
+    // Prettify JavaScript responses before they reach WebKit.
+    void setPrettifyCache(PrettifyCachePtr prettifier);
+
+protected:
+    QNetworkReply* createCachedRequest(Operation op, const QNetworkRequest& req, QIODevice* outgoingData);
+    void storeCookies(const QUrl& url, CachedResponseConstPtr response);
+
+    NetworkCachePtr mNetworkCache;
+    NetworkCacheMode mNetworkCacheMode;
+
+    PrettifyCachePtr mPrettifier;
+
 signals:
     void pageGet(QUrl url);
     void pagePost(QUrl url);
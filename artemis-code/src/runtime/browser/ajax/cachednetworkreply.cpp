@@ -0,0 +1,109 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include <QTimer>
+#include <QUrl>
+
+#include "cachednetworkreply.h"
+
+namespace artemis
+{
+
+CachedNetworkReply::CachedNetworkReply(QObject* parent, QNetworkAccessManager::Operation op, const QNetworkRequest& request, CachedResponseConstPtr response)
+    : QNetworkReply(parent)
+    , mResponse(response)
+    , mOffset(0)
+{
+    setRequest(request);
+    setUrl(request.url());
+    setOperation(op);
+
+    if (!mResponse.isNull() && mResponse->statusCode != 0) {
+        setAttribute(QNetworkRequest::HttpStatusCodeAttribute, mResponse->statusCode);
+        setAttribute(QNetworkRequest::HttpReasonPhraseAttribute, mResponse->reasonPhrase);
+        if (!mResponse->redirectTarget.isEmpty()) {
+            setAttribute(QNetworkRequest::RedirectionTargetAttribute, QUrl::fromEncoded(mResponse->redirectTarget));
+        }
+
+        typedef QPair<QByteArray, QByteArray> RawHeader;
+        foreach (RawHeader header, mResponse->headers) {
+            setRawHeader(header.first, header.second);
+        }
+    }
+
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+    // WebKit connects to our signals after createRequest returns, so delivery must be deferred to the event loop.
+    QTimer::singleShot(0, this, SLOT(slDeliver()));
+}
+
+void CachedNetworkReply::slDeliver()
+{
+    if (mResponse.isNull()) {
+        setError(QNetworkReply::ContentNotFoundError, "Artemis network cache: no recorded response for " + url().toString());
+        emit error(QNetworkReply::ContentNotFoundError);
+        setFinished(true);
+        emit finished();
+        return;
+    }
+
+    // In the same order as a real reply: an HTTP error response still has headers and usually a body.
+    if (mResponse->statusCode != 0) {
+        emit metaDataChanged();
+    }
+    if (!mResponse->body.isEmpty()) {
+        emit downloadProgress(mResponse->body.size(), mResponse->body.size());
+        emit readyRead();
+    }
+    if (mResponse->error != QNetworkReply::NoError) {
+        setError(mResponse->error, mResponse->errorString);
+        emit error(mResponse->error);
+    }
+    setFinished(true);
+    emit finished();
+}
+
+void CachedNetworkReply::abort()
+{
+    // Nothing is in flight, there is nothing to cancel.
+}
+
+qint64 CachedNetworkReply::bytesAvailable() const
+{
+    qint64 remaining = mResponse.isNull() ? 0 : mResponse->body.size() - mOffset;
+    return remaining + QIODevice::bytesAvailable();
+}
+
+bool CachedNetworkReply::isSequential() const
+{
+    return true;
+}
+
+qint64 CachedNetworkReply::readData(char* data, qint64 maxSize)
+{
+    if (mResponse.isNull() || mOffset >= mResponse->body.size()) {
+        return -1;
+    }
+
+    qint64 count = qMin(maxSize, mResponse->body.size() - mOffset);
+    memcpy(data, mResponse->body.constData() + mOffset, count);
+    mOffset += count;
+    return count;
+}
+
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CACHEDNETWORKREPLY_H
+#define CACHEDNETWORKREPLY_H
+
+#include <QNetworkReply>
+#include <QNetworkAccessManager>
+
+#include "networkcache.h"
+
+namespace artemis
+{
+
+/**
+ * A network reply which is served entirely from a NetworkCache entry, without any network access.
+ *
+ * Recorded errors are replayed as well. If the response is null (a miss in offline mode) the reply fails with
+ * ContentNotFoundError instead.
+ */
+class CachedNetworkReply : public QNetworkReply
+{
+    Q_OBJECT
+
+public:
+    CachedNetworkReply(QObject* parent, QNetworkAccessManager::Operation op, const QNetworkRequest& request, CachedResponseConstPtr response);
+
+    void abort();
+    qint64 bytesAvailable() const;
+    bool isSequential() const;
+
+protected:
+    qint64 readData(char* data, qint64 maxSize);
+
+    CachedResponseConstPtr mResponse;
+    qint64 mOffset;
+
+private slots:
+    void slDeliver();
+};
+
+}
+
+#endif // CACHEDNETWORKREPLY_H
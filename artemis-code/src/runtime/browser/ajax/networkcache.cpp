@@ -0,0 +1,220 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QUrl>
+
+#include "util/loggingutil.h"
+
+#include "networkcache.h"
+
+namespace artemis
+{
+
+// Bumped whenever the entry format changes, so stale stores are ignored rather than misread.
+static const quint32 ENTRY_FORMAT_VERSION = 2;
+
+NetworkCache::NetworkCache(QString directory)
+    : mDirectory(directory)
+{
+    QDir().mkpath(mDirectory + "/entries");
+    QDir().mkpath(mDirectory + "/objects");
+}
+
+QByteArray NetworkCache::requestKey(QNetworkAccessManager::Operation op, const QNetworkRequest& request, const QByteArray& body,
+                                    const QList<QNetworkCookie>& cookies)
+{
+    QByteArray method;
+    switch (op) {
+    case QNetworkAccessManager::HeadOperation:
+        method = "HEAD";
+        break;
+    case QNetworkAccessManager::GetOperation:
+        method = "GET";
+        break;
+    case QNetworkAccessManager::PutOperation:
+        method = "PUT";
+        break;
+    case QNetworkAccessManager::PostOperation:
+        method = "POST";
+        break;
+    case QNetworkAccessManager::DeleteOperation:
+        method = "DELETE";
+        break;
+    default:
+        method = request.attribute(QNetworkRequest::CustomVerbAttribute).toByteArray();
+        break;
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(method);
+    hash.addData("\n", 1);
+    hash.addData(request.url().toEncoded());
+    hash.addData("\n", 1);
+
+    // The same request gets a different response once the page has logged in, for example.
+    hash.addData(request.rawHeader("Cookie"));
+    foreach (QNetworkCookie cookie, cookies) {
+        hash.addData("; ", 2);
+        hash.addData(cookie.toRawForm(QNetworkCookie::NameAndValueOnly));
+    }
+    hash.addData("\n", 1);
+
+    hash.addData(body);
+    return hash.result().toHex();
+}
+
+bool NetworkCache::isCacheable(QNetworkAccessManager::Operation op, const QNetworkRequest& request)
+{
+    QString scheme = request.url().scheme();
+    if (scheme != "http" && scheme != "https") {
+        return false; // Local files, data: URLs etc. are already reproducible.
+    }
+
+    return op == QNetworkAccessManager::GetOperation ||
+           op == QNetworkAccessManager::PostOperation ||
+           op == QNetworkAccessManager::HeadOperation;
+}
+
+bool NetworkCache::isReplayable(QNetworkAccessManager::Operation op, CachedResponseConstPtr response)
+{
+    if (op != QNetworkAccessManager::GetOperation && op != QNetworkAccessManager::HeadOperation) {
+        return false;
+    }
+
+    return !response.isNull() && response->statusCode != 0;
+}
+
+CachedResponseConstPtr NetworkCache::lookup(const QByteArray& key)
+{
+    if (mMemory.contains(key)) {
+        return mMemory.value(key);
+    }
+
+    CachedResponseConstPtr response = readEntry(key);
+    if (!response.isNull()) {
+        mMemory.insert(key, response);
+    }
+
+    return response;
+}
+
+void NetworkCache::store(const QByteArray& key, CachedResponseConstPtr response)
+{
+    mMemory.insert(key, response);
+
+    if (!writeEntry(key, response)) {
+        Log::warning("NetworkCache: Could not write cache entry to " + entryPath(key).toStdString());
+    }
+}
+
+QString NetworkCache::entryPath(const QByteArray& key) const
+{
+    return mDirectory + "/entries/" + QString::fromAscii(key);
+}
+
+QString NetworkCache::objectPath(const QByteArray& contentHash) const
+{
+    return mDirectory + "/objects/" + QString::fromAscii(contentHash);
+}
+
+CachedResponseConstPtr NetworkCache::readEntry(const QByteArray& key) const
+{
+    QFile entryFile(entryPath(key));
+    if (!entryFile.open(QIODevice::ReadOnly)) {
+        return CachedResponseConstPtr();
+    }
+
+    QDataStream in(&entryFile);
+    in.setVersion(QDataStream::Qt_4_8);
+
+    quint32 version;
+    qint32 statusCode;
+    qint32 error;
+    QByteArray contentHash;
+    QSharedPointer<CachedResponse> response(new CachedResponse());
+
+    in >> version;
+    if (version != ENTRY_FORMAT_VERSION) {
+        return CachedResponseConstPtr();
+    }
+
+    in >> statusCode >> error >> response->errorString >> response->reasonPhrase >> response->redirectTarget
+       >> response->headers >> contentHash;
+    if (in.status() != QDataStream::Ok) {
+        return CachedResponseConstPtr();
+    }
+    response->statusCode = statusCode;
+    response->error = (QNetworkReply::NetworkError)error;
+
+    QFile objectFile(objectPath(contentHash));
+    if (!objectFile.open(QIODevice::ReadOnly)) {
+        return CachedResponseConstPtr();
+    }
+
+    response->body = objectFile.readAll();
+
+    // The store is content addressed, so a truncated or modified object is detected here instead of being replayed.
+    if (QCryptographicHash::hash(response->body, QCryptographicHash::Sha1).toHex() != contentHash) {
+        Log::warning("NetworkCache: Ignoring corrupt object " + objectPath(contentHash).toStdString());
+        return CachedResponseConstPtr();
+    }
+
+    return response;
+}
+
+bool NetworkCache::writeEntry(const QByteArray& key, CachedResponseConstPtr response) const
+{
+    QByteArray contentHash = QCryptographicHash::hash(response->body, QCryptographicHash::Sha1).toHex();
+
+    // Objects and entries are written to a temporary file and renamed into place, so a run which is killed part way
+    // through never leaves a partial file which a later run would pick up.
+
+    QString object = objectPath(contentHash);
+    if (!QFile::exists(object)) {
+        QFile objectFile(object + ".tmp");
+        if (!objectFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            return false;
+        }
+        objectFile.write(response->body);
+        objectFile.close();
+
+        if (!QFile::rename(object + ".tmp", object)) {
+            QFile::remove(object + ".tmp");
+            return QFile::exists(object);
+        }
+    }
+
+    QString entry = entryPath(key);
+    QFile entryFile(entry + ".tmp");
+    if (!entryFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    QDataStream out(&entryFile);
+    out.setVersion(QDataStream::Qt_4_8);
+    out << ENTRY_FORMAT_VERSION << (qint32)response->statusCode << (qint32)response->error << response->errorString
+        << response->reasonPhrase << response->redirectTarget << response->headers << contentHash;
+    entryFile.close();
+
+    QFile::remove(entry);
+    return QFile::rename(entry + ".tmp", entry);
+}
+
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NETWORKCACHE_H
+#define NETWORKCACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QSharedPointer>
+#include <QString>
+#include <QNetworkAccessManager>
+#include <QNetworkCookie>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+
+namespace artemis
+{
+
+/**
+ * A single recorded HTTP response, as it will be replayed to WebKit.
+ */
+struct CachedResponse
+{
+    CachedResponse() : statusCode(0), error(QNetworkReply::NoError) {}
+
+    int statusCode; // 0 if there was no HTTP response, e.g. the host was not found.
+    QNetworkReply::NetworkError error;
+    QString errorString;
+    QByteArray reasonPhrase;
+    QByteArray redirectTarget;
+    QList<QPair<QByteArray, QByteArray> > headers;
+    QByteArray body;
+};
+
+typedef QSharedPointer<const CachedResponse> CachedResponseConstPtr;
+
+/**
+ * Record/replay store for network responses.
+ *
+ * Responses are keyed by (method, URL, cookies, request body). On disk the store is content-addressed: response bodies live in
+ * <dir>/objects/<sha1 of body> and each request key has a small entry in <dir>/entries/<sha1 of key> pointing to its
+ * body and holding the status line and headers. Identical bodies (e.g. the same library served from several URLs) are
+ * only stored once.
+ *
+ * Every entry which is recorded or read from disk is kept in memory, so later iterations never touch the disk again.
+ */
+class NetworkCache
+{
+public:
+    NetworkCache(QString directory);
+
+    // cookies are the ones QNetworkAccessManager will add to the request from its cookie jar.
+    static QByteArray requestKey(QNetworkAccessManager::Operation op, const QNetworkRequest& request, const QByteArray& body,
+                                 const QList<QNetworkCookie>& cookies);
+    static bool isCacheable(QNetworkAccessManager::Operation op, const QNetworkRequest& request);
+    // Whether a recorded response may be served instead of going to the network outside offline mode: only for
+    // idempotent requests, and only if the server answered, so a failed connection is retried.
+    static bool isReplayable(QNetworkAccessManager::Operation op, CachedResponseConstPtr response);
+
+    CachedResponseConstPtr lookup(const QByteArray& key);
+    void store(const QByteArray& key, CachedResponseConstPtr response);
+
+protected:
+    QString entryPath(const QByteArray& key) const;
+    QString objectPath(const QByteArray& contentHash) const;
+
+    CachedResponseConstPtr readEntry(const QByteArray& key) const;
+    bool writeEntry(const QByteArray& key, CachedResponseConstPtr response) const;
+
+    QString mDirectory;
+    QHash<QByteArray, CachedResponseConstPtr> mMemory;
+};
+
+typedef QSharedPointer<NetworkCache> NetworkCachePtr;
+
+}
+
+#endif // NETWORKCACHE_H
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+
+#include "statistics/statsstorage.h"
+#include "util/javascriptprettifier.h"
+
+#include "prettifycache.h"
+
+namespace artemis
+{
+
+// Bumped whenever the prettifier output or the entry format changes, so old entries are regenerated.
+static const quint32 PRETTIFY_ENTRY_VERSION = 1;
+
+PrettifyCache::PrettifyCache(QString directory)
+    : mDirectory(directory)
+{
+    QDir().mkpath(mDirectory);
+}
+
+QByteArray PrettifyCache::prettify(const QUrl& url, const QByteArray& source)
+{
+    QString text = QString::fromUtf8(source.constData(), source.size());
+
+    // Only touch scripts which survive a round trip, anything else would be corrupted by re-encoding.
+    if (text.toUtf8() != source) {
+        Statistics::statistics()->accumulate("AjaxRequestListener::Prettify::Skipped", 1);
+        return source;
+    }
+
+    QByteArray contentHash = QCryptographicHash::hash(source, QCryptographicHash::Sha1).toHex();
+    PrettifyMappingConstPtr mapping = lookup(contentHash, text);
+
+    if (mapping.isNull()) {
+        mUrlMappings.remove(url.toString());
+        Statistics::statistics()->accumulate("AjaxRequestListener::Prettify::Skipped", 1);
+        return source;
+    }
+
+    mUrlMappings.insert(url.toString(), mapping);
+    return mapping->getPrettySource().toUtf8();
+}
+
+PrettifyMappingConstPtr PrettifyCache::getMapping(const QString& url) const
+{
+    return mUrlMappings.value(url);
+}
+
+PrettifyMappingConstPtr PrettifyCache::lookup(const QByteArray& contentHash, const QString& source)
+{
+    if (mMappings.contains(contentHash)) {
+        Statistics::statistics()->accumulate("AjaxRequestListener::Prettify::CacheHits", 1);
+        return mMappings.value(contentHash);
+    }
+
+    PrettifyMappingConstPtr mapping;
+    if (readEntry(contentHash, source, mapping)) {
+        Statistics::statistics()->accumulate("AjaxRequestListener::Prettify::CacheHits", 1);
+        mMappings.insert(contentHash, mapping);
+        return mapping;
+    }
+
+    mapping = JavaScriptPrettifier::prettify(source);
+    Statistics::statistics()->accumulate("AjaxRequestListener::Prettify::Prettified", 1);
+
+    mMappings.insert(contentHash, mapping);
+    writeEntry(contentHash, mapping);
+
+    return mapping;
+}
+
+bool PrettifyCache::readEntry(const QByteArray& contentHash, const QString& source, PrettifyMappingConstPtr& mapping) const
+{
+    QFile file(mDirectory + "/" + QString::fromAscii(contentHash));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_4_8);
+
+    quint32 version;
+    bool prettified;
+    in >> version >> prettified;
+    if (in.status() != QDataStream::Ok || version != PRETTIFY_ENTRY_VERSION) {
+        return false;
+    }
+
+    if (!prettified) {
+        mapping = PrettifyMappingConstPtr(); // This script is known to be left unmodified.
+        return true;
+    }
+
+    QString prettySource;
+    QVector<int> segmentPrettyOffsets;
+    QVector<int> segmentOriginalOffsets;
+    in >> prettySource >> segmentPrettyOffsets >> segmentOriginalOffsets;
+    if (in.status() != QDataStream::Ok || segmentPrettyOffsets.size() != segmentOriginalOffsets.size()) {
+        return false;
+    }
+
+    mapping = PrettifyMappingConstPtr(new PrettifyMapping(source, prettySource, segmentPrettyOffsets, segmentOriginalOffsets));
+    return true;
+}
+
+void PrettifyCache::writeEntry(const QByteArray& contentHash, PrettifyMappingConstPtr mapping) const
+{
+    QString path = mDirectory + "/" + QString::fromAscii(contentHash);
+    QFile file(path + ".tmp");
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_4_8);
+    out << PRETTIFY_ENTRY_VERSION << !mapping.isNull();
+    if (!mapping.isNull()) {
+        out << mapping->getPrettySource() << mapping->getSegmentPrettyOffsets() << mapping->getSegmentOriginalOffsets();
+    }
+    file.close();
+
+    QFile::remove(path);
+    QFile::rename(path + ".tmp", path);
+}
+
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PRETTIFYCACHE_H
+#define PRETTIFYCACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QSharedPointer>
+#include <QString>
+#include <QUrl>
+
+#include "model/coverage/prettifymapping.h"
+
+namespace artemis
+{
+
+/**
+ * Prettifies JavaScript responses as they are loaded, replacing the external prettify proxy.
+ *
+ * Results are cached by a hash of the original content, in memory for the rest of the run and in the given directory
+ * for later runs, so each distinct bundle is only prettified once.
+ *
+ * The mapping for the most recent script loaded from each URL is kept, so coverage can be related back to the
+ * original (minified) source.
+ */
+class PrettifyCache
+{
+public:
+    PrettifyCache(QString directory);
+
+    QByteArray prettify(const QUrl& url, const QByteArray& source);
+
+    PrettifyMappingConstPtr getMapping(const QString& url) const;
+
+protected:
+    PrettifyMappingConstPtr lookup(const QByteArray& contentHash, const QString& source);
+    bool readEntry(const QByteArray& contentHash, const QString& source, PrettifyMappingConstPtr& mapping) const;
+    void writeEntry(const QByteArray& contentHash, PrettifyMappingConstPtr mapping) const;
+
+    QString mDirectory;
+
+    QHash<QByteArray, PrettifyMappingConstPtr> mMappings; // Content hash -> mapping, null if the script is left as is.
+    QHash<QString, PrettifyMappingConstPtr> mUrlMappings;
+};
+
+typedef QSharedPointer<PrettifyCache> PrettifyCachePtr;
+
+}
+
+#endif // PRETTIFYCACHE_H
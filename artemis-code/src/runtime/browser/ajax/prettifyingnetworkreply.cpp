@@ -0,0 +1,127 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include <QUrl>
+
+#include "prettifyingnetworkreply.h"
+
+namespace artemis
+{
+
+PrettifyingNetworkReply::PrettifyingNetworkReply(QObject* parent, QNetworkReply* reply, PrettifyCachePtr prettifier)
+    : QNetworkReply(parent)
+    , mReply(reply)
+    , mPrettifier(prettifier)
+    , mOffset(0)
+{
+    mReply->setParent(this);
+
+    setRequest(mReply->request());
+    setUrl(mReply->url());
+    setOperation(mReply->operation());
+
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+    // Meta data and progress are not forwarded, as the content length is only known once the body is prettified.
+    QObject::connect(mReply, SIGNAL(readyRead()),
+                     this, SLOT(slReadyRead()));
+    QObject::connect(mReply, SIGNAL(finished()),
+                     this, SLOT(slFinished()));
+    QObject::connect(mReply, SIGNAL(uploadProgress(qint64, qint64)),
+                     this, SIGNAL(uploadProgress(qint64, qint64)));
+}
+
+bool PrettifyingNetworkReply::isJavaScript(const QNetworkReply* reply)
+{
+    QString contentType = reply->header(QNetworkRequest::ContentTypeHeader).toString().toLower();
+
+    if (contentType.contains("javascript") || contentType.contains("ecmascript")) {
+        return true;
+    }
+
+    // Same guess as the prettify proxy for servers which do not send a useful content type.
+    return (contentType.isEmpty() || contentType.startsWith("text/plain")) && reply->url().path().endsWith(".js");
+}
+
+void PrettifyingNetworkReply::slReadyRead()
+{
+    mBody.append(mReply->readAll());
+}
+
+void PrettifyingNetworkReply::slFinished()
+{
+    mBody.append(mReply->readAll());
+
+    setUrl(mReply->url());
+    setAttribute(QNetworkRequest::HttpStatusCodeAttribute, mReply->attribute(QNetworkRequest::HttpStatusCodeAttribute));
+    setAttribute(QNetworkRequest::HttpReasonPhraseAttribute, mReply->attribute(QNetworkRequest::HttpReasonPhraseAttribute));
+    setAttribute(QNetworkRequest::RedirectionTargetAttribute, mReply->attribute(QNetworkRequest::RedirectionTargetAttribute));
+    foreach (QByteArray name, mReply->rawHeaderList()) {
+        setRawHeader(name, mReply->rawHeader(name));
+    }
+
+    if (mReply->error() == QNetworkReply::NoError && !mBody.isEmpty() && isJavaScript(mReply)) {
+        mBody = mPrettifier->prettify(mReply->url(), mBody);
+        setHeader(QNetworkRequest::ContentLengthHeader, mBody.size());
+    }
+
+    if (mReply->error() != QNetworkReply::NoError) {
+        setError(mReply->error(), mReply->errorString());
+        emit error(mReply->error());
+    }
+
+    emit metaDataChanged();
+    if (!mBody.isEmpty()) {
+        emit downloadProgress(mBody.size(), mBody.size());
+        emit readyRead();
+    }
+    setFinished(true);
+    emit finished();
+}
+
+void PrettifyingNetworkReply::abort()
+{
+    mReply->abort();
+}
+
+qint64 PrettifyingNetworkReply::bytesAvailable() const
+{
+    return (isFinished() ? mBody.size() - mOffset : 0) + QIODevice::bytesAvailable();
+}
+
+bool PrettifyingNetworkReply::isSequential() const
+{
+    return true;
+}
+
+qint64 PrettifyingNetworkReply::readData(char* data, qint64 maxSize)
+{
+    if (!isFinished()) {
+        return 0;
+    }
+    if (mOffset >= mBody.size()) {
+        return -1;
+    }
+
+    qint64 count = qMin(maxSize, mBody.size() - mOffset);
+    memcpy(data, mBody.constData() + mOffset, count);
+    mOffset += count;
+    return count;
+}
+
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PRETTIFYINGNETWORKREPLY_H
+#define PRETTIFYINGNETWORKREPLY_H
+
+#include <QByteArray>
+#include <QNetworkReply>
+
+#include "prettifycache.h"
+
+namespace artemis
+{
+
+/**
+ * Wraps a network reply and holds back the response until it is complete. JavaScript responses are then passed
+ * through the PrettifyCache before WebKit sees them, everything else is delivered unchanged.
+ */
+class PrettifyingNetworkReply : public QNetworkReply
+{
+    Q_OBJECT
+
+public:
+    PrettifyingNetworkReply(QObject* parent, QNetworkReply* reply, PrettifyCachePtr prettifier);
+
+    void abort();
+    qint64 bytesAvailable() const;
+    bool isSequential() const;
+
+    static bool isJavaScript(const QNetworkReply* reply);
+
+protected:
+    qint64 readData(char* data, qint64 maxSize);
+
+    QNetworkReply* mReply;
+    PrettifyCachePtr mPrettifier;
+
+    QByteArray mBody;
+    qint64 mOffset;
+
+private slots:
+    void slReadyRead();
+    void slFinished();
+};
+
+}
+
+#endif // PRETTIFYINGNETWORKREPLY_H
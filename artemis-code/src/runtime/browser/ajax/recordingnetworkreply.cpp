@@ -0,0 +1,142 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include <QUrl>
+
+#include "statistics/statsstorage.h"
+
+#include "recordingnetworkreply.h"
+
+namespace artemis
+{
+
+RecordingNetworkReply::RecordingNetworkReply(QObject* parent, QNetworkReply* reply, NetworkCachePtr cache, const QByteArray& key)
+    : QNetworkReply(parent)
+    , mReply(reply)
+    , mCache(cache)
+    , mKey(key)
+{
+    mReply->setParent(this);
+
+    setRequest(mReply->request());
+    setUrl(mReply->url());
+    setOperation(mReply->operation());
+
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+    QObject::connect(mReply, SIGNAL(metaDataChanged()),
+                     this, SLOT(slMetaDataChanged()));
+    QObject::connect(mReply, SIGNAL(readyRead()),
+                     this, SLOT(slReadyRead()));
+    QObject::connect(mReply, SIGNAL(error(QNetworkReply::NetworkError)),
+                     this, SLOT(slError(QNetworkReply::NetworkError)));
+    QObject::connect(mReply, SIGNAL(finished()),
+                     this, SLOT(slFinished()));
+    QObject::connect(mReply, SIGNAL(downloadProgress(qint64, qint64)),
+                     this, SIGNAL(downloadProgress(qint64, qint64)));
+    QObject::connect(mReply, SIGNAL(uploadProgress(qint64, qint64)),
+                     this, SIGNAL(uploadProgress(qint64, qint64)));
+}
+
+void RecordingNetworkReply::copyMetaData()
+{
+    setUrl(mReply->url());
+
+    setAttribute(QNetworkRequest::HttpStatusCodeAttribute, mReply->attribute(QNetworkRequest::HttpStatusCodeAttribute));
+    setAttribute(QNetworkRequest::HttpReasonPhraseAttribute, mReply->attribute(QNetworkRequest::HttpReasonPhraseAttribute));
+    setAttribute(QNetworkRequest::RedirectionTargetAttribute, mReply->attribute(QNetworkRequest::RedirectionTargetAttribute));
+
+    foreach (QByteArray name, mReply->rawHeaderList()) {
+        setRawHeader(name, mReply->rawHeader(name));
+    }
+}
+
+void RecordingNetworkReply::slMetaDataChanged()
+{
+    copyMetaData();
+    emit metaDataChanged();
+}
+
+void RecordingNetworkReply::slReadyRead()
+{
+    QByteArray data = mReply->readAll();
+    mPending.append(data);
+    mRecorded.append(data);
+    emit readyRead();
+}
+
+void RecordingNetworkReply::slError(QNetworkReply::NetworkError code)
+{
+    setError(code, mReply->errorString());
+    emit error(code);
+}
+
+void RecordingNetworkReply::slFinished()
+{
+    copyMetaData();
+
+    // Error responses (e.g. 404, or a host which was not found) are recorded too, so offline runs see the same failures.
+    // Requests which were cancelled have no response to replay.
+    if (mReply->error() != QNetworkReply::OperationCanceledError) {
+        QSharedPointer<CachedResponse> response(new CachedResponse());
+        response->statusCode = mReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        response->error = mReply->error();
+        response->errorString = response->error == QNetworkReply::NoError ? QString() : mReply->errorString();
+        response->reasonPhrase = mReply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toByteArray();
+        response->redirectTarget = mReply->attribute(QNetworkRequest::RedirectionTargetAttribute).toUrl().toEncoded();
+        foreach (QByteArray name, mReply->rawHeaderList()) {
+            response->headers.append(QPair<QByteArray, QByteArray>(name, mReply->rawHeader(name)));
+        }
+        response->body = mRecorded;
+
+        mCache->store(mKey, response);
+        Statistics::statistics()->accumulate("AjaxRequestListener::NetworkCache::Recorded", 1);
+    }
+
+    setFinished(true);
+    emit finished();
+}
+
+void RecordingNetworkReply::abort()
+{
+    mReply->abort();
+}
+
+qint64 RecordingNetworkReply::bytesAvailable() const
+{
+    return mPending.size() + QIODevice::bytesAvailable();
+}
+
+bool RecordingNetworkReply::isSequential() const
+{
+    return true;
+}
+
+qint64 RecordingNetworkReply::readData(char* data, qint64 maxSize)
+{
+    if (mPending.isEmpty()) {
+        return isFinished() ? -1 : 0;
+    }
+
+    qint64 count = qMin(maxSize, (qint64)mPending.size());
+    memcpy(data, mPending.constData(), count);
+    mPending.remove(0, count);
+    return count;
+}
+
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RECORDINGNETWORKREPLY_H
+#define RECORDINGNETWORKREPLY_H
+
+#include <QByteArray>
+#include <QNetworkReply>
+
+#include "networkcache.h"
+
+namespace artemis
+{
+
+/**
+ * Wraps a real network reply, passing everything through to WebKit unchanged while keeping a copy of the response.
+ * When the wrapped reply finishes (successfully or with an error) the copy is stored in the NetworkCache.
+ */
+class RecordingNetworkReply : public QNetworkReply
+{
+    Q_OBJECT
+
+public:
+    RecordingNetworkReply(QObject* parent, QNetworkReply* reply, NetworkCachePtr cache, const QByteArray& key);
+
+    void abort();
+    qint64 bytesAvailable() const;
+    bool isSequential() const;
+
+protected:
+    qint64 readData(char* data, qint64 maxSize);
+    void copyMetaData();
+
+    QNetworkReply* mReply;
+    NetworkCachePtr mCache;
+    QByteArray mKey;
+
+    QByteArray mPending;  // Received but not yet read by WebKit.
+    QByteArray mRecorded; // The complete body so far.
+
+private slots:
+    void slMetaDataChanged();
+    void slReadyRead();
+    void slError(QNetworkReply::NetworkError code);
+    void slFinished();
+};
+
+}
+
+#endif // RECORDINGNETWORKREPLY_H
@@ -15,6 +15,7 @@
  */
 
 #include <QDebug>
+#include <QSet>
 #include <QWebFrame>
 #include <QWebView>
 
@@ -168,9 +169,16 @@ QList<QWebElement> ArtemisWebPage::getAllUserClickableElementsAndAncestors()
     QList<QWebElement> result = clickable;
     QWebElement cur;
 
+    // The elements are identified by their WebCore::Element, so the ancestor walks stop in constant time.
+    QSet<WebCore::Element*> seen;
+    foreach (QWebElement elt, clickable) {
+        seen.insert(elt.getElement());
+    }
+
     foreach (QWebElement elt, clickable) {
         cur = elt.parent();
-        while (!cur.isNull() && !result.contains(cur)) {
+        while (!cur.isNull() && !seen.contains(cur.getElement())) {
+            seen.insert(cur.getElement());
             result.append(cur);
             cur = cur.parent();
         }
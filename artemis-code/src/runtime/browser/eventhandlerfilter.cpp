@@ -0,0 +1,76 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eventhandlerfilter.h"
+
+namespace artemis
+{
+
+EventHandlerFilter::EventHandlerFilter()
+    : mFilterVisibility(false)
+    , mFilterArea(false)
+{
+}
+
+void EventHandlerFilter::setVisibleElements(const QSet<WebCore::Element*>& elements)
+{
+    mFilterVisibility = true;
+    mVisibleElements = elements;
+}
+
+void EventHandlerFilter::setFilterAreaElements(const QSet<WebCore::Element*>& elements)
+{
+    mFilterArea = true;
+    mFilterAreaElements = elements;
+}
+
+bool EventHandlerFilter::needsElements() const
+{
+    return mFilterVisibility || mFilterArea;
+}
+
+EventHandlerFilter::Verdict EventHandlerFilter::check(WebCore::Element* element)
+{
+    if (mFilterVisibility && !mVisibleElements.contains(element)) {
+        return NOT_VISIBLE;
+    }
+
+    if (mFilterArea && !mFilterAreaElements.contains(element)) {
+        return OUTSIDE_FILTER_AREA;
+    }
+
+    return ACCEPTED;
+}
+
+void EventHandlerFilter::reset()
+{
+    mFilterVisibility = false;
+    mVisibleElements.clear();
+    mFilterArea = false;
+    mFilterAreaElements.clear();
+}
+
+QSet<WebCore::Element*> EventHandlerFilter::elementSet(QList<QWebElement> elements)
+{
+    QSet<WebCore::Element*> result;
+    result.reserve(elements.size());
+    foreach (QWebElement element, elements) {
+        result.insert(element.getElement());
+    }
+    return result;
+}
+
+}
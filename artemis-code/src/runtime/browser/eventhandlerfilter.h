@@ -0,0 +1,72 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EVENTHANDLERFILTER_H
+#define EVENTHANDLERFILTER_H
+
+#include <QList>
+#include <QSet>
+#include <QWebElement>
+
+namespace WebCore {
+    class Element;
+}
+
+namespace artemis
+{
+
+/**
+ * Decides which of the registered event handlers are reported, when the current handlers are gathered.
+ *
+ * A handler is rejected if its element is not visible or not inside the event filter area. Every other handler is
+ * reported, including repeated listeners for the same event on the same element. All checks are hash lookups, so the
+ * handlers are filtered in a single linear pass and keep their registration order.
+ *
+ * The DOM elements are only used for their identity and never dereferenced.
+ */
+class EventHandlerFilter
+{
+public:
+    enum Verdict {
+        ACCEPTED, NOT_VISIBLE, OUTSIDE_FILTER_AREA
+    };
+
+    EventHandlerFilter();
+
+    // If set, only handlers on these elements are accepted.
+    void setVisibleElements(const QSet<WebCore::Element*>& elements);
+    void setFilterAreaElements(const QSet<WebCore::Element*>& elements);
+
+    bool needsElements() const;
+
+    // The DOM element is only used (and only needs to be looked up) if needsElements() is true.
+    Verdict check(WebCore::Element* element);
+
+    void reset();
+
+    static QSet<WebCore::Element*> elementSet(QList<QWebElement> elements);
+
+protected:
+    bool mFilterVisibility;
+    QSet<WebCore::Element*> mVisibleElements;
+
+    bool mFilterArea;
+    QSet<WebCore::Element*> mFilterAreaElements;
+};
+
+}
+
+#endif // EVENTHANDLERFILTER_H
@@ -21,6 +21,7 @@
 #include "statistics/statsstorage.h"
 #include "util/loggingutil.h"
 
+#include "eventhandlerfilter.h"
 #include "executionresultbuilder.h"
 
 namespace artemis
@@ -88,18 +89,17 @@ QList<EventHandlerDescriptorConstPtr> ExecutionResultBuilder::getCurrentEventHan
 {
     QList<EventHandlerDescriptorConstPtr> handlerList;
 
-    QList<QWebElement> userClickableElements;
+    EventHandlerFilter filter;
     if (mEnableEventVisibilityFiltering) {
-        userClickableElements = mPage->getAllUserClickableElementsAndAncestors();
+        filter.setVisibleElements(EventHandlerFilter::elementSet(mPage->getAllUserClickableElementsAndAncestors()));
     }
-    QList<QWebElement> elementsAllowedByFilter;
     if (mEnableEventFilterArea) {
         QWebElement filterAreaRoot = mPage->getSingleElementByXPath(mEventFilterAreaXPath);
         if (filterAreaRoot.isNull()) {
             Log::error("Could not identify a single root element for the event filter area.");
             exit(1);
         }
-        elementsAllowedByFilter = filterAreaRoot.findAll("*").toList();
+        filter.setFilterAreaElements(EventHandlerFilter::elementSet(filterAreaRoot.findAll("*").toList()));
     }
 
     QPair<QWebElement*, QString> p;
@@ -124,36 +124,36 @@ QList<EventHandlerDescriptorConstPtr> ExecutionResultBuilder::getCurrentEventHan
 
         // sometimes a handler is registered on a NULL element? and the descriptor infrastructure guesses a correct element to replace it
         // check if that guess is visible
-        if (mEnableEventVisibilityFiltering) {
-            QWebElement actualSource = handler->getDomElement()->getElement(mPage);
-
-            // TODO: There are three visibility check methods available to use here.
-            // !userClickableElements.contains(actualSource)    - Checks if the viewport includes a pixel of this element (slow and only works in the viewport).
-            // !actualSource.isUserVisible()                    - Checks if the element has a bounding box.
-            // !actualSource.isUserVisibleIncludingChildren()   - As above but including children and text nodes.
-            // The ideal solution would be some combination of these.
-
-            if (!userClickableElements.contains(actualSource)) {
-                Statistics::statistics()->accumulate("WebKit::events::skipped::visibility", 1);
-                qDebug() << "Skipping EVENTHANDLER event (not user visible) =" << p.second
-                         << "tag = " << actualSource.tagName()
-                         << "id = " << actualSource.attribute(QString("id"))
-                         << "title = " << actualSource.attribute(QString("title"))
-                         << "class = " << actualSource.attribute("class")
-                         << "visible = " << actualSource.isUserVisible()
-                         << "xpath = " << actualSource.xPath();
-                continue;
-            }
+        QWebElement actualSource;
+        if (filter.needsElements()) {
+            actualSource = handler->getDomElement()->getElement(mPage);
         }
 
-        if (mEnableEventFilterArea) {
-            // TODO: It would be even better if we could use the event-filter-area to filter the event targets. But that is not implemented here, we filter the elements on which the events are registered.
-            QWebElement actualSource = handler->getDomElement()->getElement(mPage);
+        // TODO: There are three visibility check methods available to use here.
+        // !userClickableElements.contains(actualSource)    - Checks if the viewport includes a pixel of this element (slow and only works in the viewport).
+        // !actualSource.isUserVisible()                    - Checks if the element has a bounding box.
+        // !actualSource.isUserVisibleIncludingChildren()   - As above but including children and text nodes.
+        // The ideal solution would be some combination of these.
+        // TODO: It would be even better if we could use the event-filter-area to filter the event targets. But that is not implemented here, we filter the elements on which the events are registered.
+
+        switch (filter.check(actualSource.getElement())) {
+        case EventHandlerFilter::NOT_VISIBLE:
+            Statistics::statistics()->accumulate("WebKit::events::skipped::visibility", 1);
+            qDebug() << "Skipping EVENTHANDLER event (not user visible) =" << p.second
+                     << "tag = " << actualSource.tagName()
+                     << "id = " << actualSource.attribute(QString("id"))
+                     << "title = " << actualSource.attribute(QString("title"))
+                     << "class = " << actualSource.attribute("class")
+                     << "visible = " << actualSource.isUserVisible()
+                     << "xpath = " << actualSource.xPath();
+            continue;
 
-            if (!elementsAllowedByFilter.contains(actualSource)) {
-                Statistics::statistics()->accumulate("WebKit::events::skipped::eventfilterarea", 1);
-                continue;
-            }
+        case EventHandlerFilter::OUTSIDE_FILTER_AREA:
+            Statistics::statistics()->accumulate("WebKit::events::skipped::eventfilterarea", 1);
+            continue;
+
+        case EventHandlerFilter::ACCEPTED:
+            break;
         }
 
         Statistics::statistics()->accumulate("WebKit::events::added", 1);
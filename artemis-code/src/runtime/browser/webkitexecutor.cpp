@@ -31,6 +31,7 @@
 #include "util/loggingutil.h"
 #include "concolic/executiontree/tracebuilder.h"
 #include "concolic/pathcondition.h"
+#include "model/samplingprofiler.h"
 
 #include "statistics/statsstorage.h"
 
@@ -181,7 +182,10 @@ WebKitExecutor::WebKitExecutor(QObject* parent,
 
     // The event marker detector is created and connected in the concolic runtime.
 
+    // The DOM indicator word detector is created in enableDomIndicatorDetection().
+
     // The DOM modification "detector".
+    // This compares DOM snapshots and is replaced by the indicator word detector.
     /* Disable for now, we are running out of memory on large pages
     QSharedPointer<TraceDomModDetector> domModDetector(new TraceDomModDetector());
     QObject::connect(mResultBuilder.data(), SIGNAL(sigDomModified(QString, QString)),
@@ -196,6 +200,17 @@ WebKitExecutor::~WebKitExecutor()
 {
 }
 
+void WebKitExecutor::enableDomIndicatorDetection(const QList<QString>& words)
+{
+    QSharedPointer<TraceDomIndicatorDetector> domIndicatorDetector(new TraceDomIndicatorDetector(words));
+    QObject::connect(mWebkitListener, SIGNAL(sigDomTextInserted(QString)),
+                     domIndicatorDetector.data(), SLOT(slDomTextInserted(QString)));
+    mTraceBuilder->addDetector(domIndicatorDetector);
+
+    // WebKit only reports the inserted text once this is enabled, as it is frequent.
+    mWebkitListener->enableDomTextReporting(true);
+}
+
 void WebKitExecutor::detach() {
     mWebkitListener->endSymbolicSession();
     mTraceBuilder->endRecording();
@@ -217,6 +232,7 @@ void WebKitExecutor::executeSequence(ExecutableConfigurationConstPtr conf, SYMBO
     notifyNewSequence();
 
     qDebug() << "--------------- FETCH PAGE --------------" << endl;
+    SamplingProfiler::setPhase(SamplingProfiler::PAGE_LOAD);
     mPage->mainFrame()->load(conf->getUrl());
 }
 
@@ -266,6 +282,8 @@ void WebKitExecutor::slLoadFinished(bool ok)
 {
     assert(!currentConf.isNull());
 
+    SamplingProfiler::setPhase(SamplingProfiler::ARTEMIS);
+
     if(mNextOpCanceled){
         mNextOpCanceled = false;
         qDebug() << "Page load cancelled";
@@ -287,6 +305,8 @@ void WebKitExecutor::slLoadFinished(bool ok)
 
     // Populate forms (preset)
 
+    SamplingProfiler::setPhase(SamplingProfiler::INJECTION);
+
     foreach(QString f , mPresetFields.keys()) {
         QWebElement elm = mPage->mainFrame()->findFirstElement(f);
 
@@ -302,6 +322,8 @@ void WebKitExecutor::slLoadFinished(bool ok)
 
     // Execute input sequence
 
+    SamplingProfiler::setPhase(SamplingProfiler::ARTEMIS);
+
     qDebug() << "\n------------ EXECUTE SEQUENCE -----------" << endl;
 
     if (mSymbolicMode != MODE_CONCOLIC_LAST_EVENT && mSymbolicMode != MODE_CONCOLIC_NO_TRACE) {
@@ -325,7 +347,9 @@ void WebKitExecutor::slLoadFinished(bool ok)
 
         mPage->updateFormIdentifiers();
 
+        SamplingProfiler::setPhase(SamplingProfiler::EVENT);
         input->apply(this->mPage, this->mWebkitListener);
+        SamplingProfiler::setPhase(SamplingProfiler::ARTEMIS);
     }
     emit sigPostFinalActionExecution();
 
@@ -71,6 +71,9 @@ public:
                    bool enableExternalNavigationRequests);
     ~WebKitExecutor();
 
+    // Adds DOM modification nodes with the given indicator words in text added to the page to the concolic traces.
+    void enableDomIndicatorDetection(const QList<QString>& words);
+
     void executeSequence(ExecutableConfigurationConstPtr conf);
     void executeSequence(ExecutableConfigurationConstPtr conf, SYMBOLIC_MODE symbolicMode);
     void notifyNewSequence(bool noNewSymbolicSession = false);
@@ -47,6 +47,11 @@ int AjaxInput::hashCode() const
     return 7 * mCallbackId;
 }
 
+QString AjaxInput::identity() const
+{
+    return QString("AjaxInput(%1)").arg(mCallbackId);
+}
+
 QString AjaxInput::toString() const
 {
     return QString("AjaxInput");
@@ -46,6 +46,9 @@ public:
                                                            const ExecutionResultConstPtr& result) const = 0;
 
     virtual int hashCode() const = 0;
+    // Identifies the input exactly, where hashCode() may collide: two inputs have the same identity iff they are
+    // built from the same values as hashCode() is.
+    virtual QString identity() const = 0;
     virtual QString toString() const = 0;
 protected:
     EventExecutionStatistics* mExecStat;
@@ -62,6 +62,11 @@ int ClickInput::hashCode() const
     return qHash(mTargetXPath);
 }
 
+QString ClickInput::identity() const
+{
+    return QString("ClickInput(%1)").arg(mTargetXPath);
+}
+
 QString ClickInput::toString() const
 {
     return QString("ClickInput(%1)").arg(mTargetXPath);
@@ -43,6 +43,7 @@ public:
                                      const ExecutionResultConstPtr& result) const;
 
     int hashCode() const;
+    QString identity() const;
     QString toString() const;
 
 private:
@@ -99,6 +99,11 @@ int DomInput::hashCode() const
     return 107 * mEventHandler->hashCode();
 }
 
+QString DomInput::identity() const
+{
+    return QString("DomInput(") + mEventHandler->identity() + QString(")");
+}
+
 QString DomInput::toString() const
 {
 
@@ -51,6 +51,7 @@ public:
                                      const ExecutionResultConstPtr& result) const;
 
     int hashCode() const;
+    QString identity() const;
     QString toString() const;
     TargetDescriptorConstPtr getTarget() const;
 
@@ -223,6 +223,32 @@ uint DOMElementDescriptor::hashCode() const {
     return 29 * element_hash + 13 * frame_hash;
 }
 
+// The frame and element paths, as used by hashCode().
+QString DOMElementDescriptor::identity() const
+{
+    QStringList frame;
+    if (mIsMainframe) {
+        frame.append("main");
+    } else {
+        foreach (int fpath, mFramePath) {
+            frame.append(QString::number(fpath));
+        }
+    }
+
+    QStringList element;
+    if (mIsDocument) {
+        element.append("document");
+    } else if (mIsBody) {
+        element.append("body");
+    } else {
+        foreach (int epath, mElementPath) {
+            element.append(QString::number(epath));
+        }
+    }
+
+    return frame.join("/") + ":" + element.join("/");
+}
+
 QString DOMElementDescriptor::toString() const
 {
     QString elmName = "";
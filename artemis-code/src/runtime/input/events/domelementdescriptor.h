@@ -63,6 +63,7 @@ public:
     }
 
     uint hashCode() const;
+    QString identity() const;
     QString toString() const;
 
 private:
@@ -32,6 +32,11 @@ int EventHandlerDescriptor::hashCode() const
     return qHash(this->mEventName) + 7 * this->mElement->hashCode();
 }
 
+QString EventHandlerDescriptor::identity() const
+{
+    return QString(mEventName + "@") + mElement->identity();
+}
+
 QString EventHandlerDescriptor::toString() const
 {
     return QString(mEventName + "@") + mElement->toString();
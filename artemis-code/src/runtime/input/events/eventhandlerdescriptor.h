@@ -52,6 +52,7 @@ public:
     }
 
     int hashCode() const;
+    QString identity() const;
 
     QString toString() const;
 
@@ -14,57 +14,82 @@
  * limitations under the License.
  */
 
+#include <QVector>
+
 #include "inputsequence.h"
 
 namespace artemis
 {
 
 InputSequence::InputSequence()
+    : mLength(0)
 {
 }
 
 InputSequence::InputSequence(const QList<QSharedPointer<const BaseInput> >& sequence)
-    : mSequence(sequence)
+    : mLength(sequence.length())
+{
+    foreach (QSharedPointer<const BaseInput> input, sequence) {
+        mLast = QSharedPointer<const Node>(new Node(input, mLast));
+    }
+}
+
+InputSequence::InputSequence(QSharedPointer<const Node> last, int length)
+    : mLast(last)
+    , mLength(length)
 {
 }
 
 QSharedPointer<const InputSequence> InputSequence::replaceLast(QSharedPointer<const BaseInput> newLast) const
 {
-    QList<QSharedPointer<const BaseInput> > sequence = mSequence;
-    sequence.removeLast();
-    sequence.append(newLast);
+    Q_ASSERT(!isEmpty());
 
-    return QSharedPointer<const InputSequence>(new InputSequence(sequence));
+    QSharedPointer<const Node> last = QSharedPointer<const Node>(new Node(newLast, mLast->previous));
+    return QSharedPointer<const InputSequence>(new InputSequence(last, mLength));
 }
 
 QSharedPointer<const InputSequence> InputSequence::extend(QSharedPointer<const BaseInput> newLast) const
 {
-    QList<QSharedPointer<const BaseInput> > sequence = mSequence;
-    sequence.append(newLast);
+    QSharedPointer<const Node> last = QSharedPointer<const Node>(new Node(newLast, mLast));
+    return QSharedPointer<const InputSequence>(new InputSequence(last, mLength + 1));
+}
 
-    return QSharedPointer<InputSequence>(new InputSequence(sequence));
+QSharedPointer<const InputSequence> InputSequence::removeLast() const
+{
+    Q_ASSERT(!isEmpty());
+
+    return QSharedPointer<const InputSequence>(new InputSequence(mLast->previous, mLength - 1));
 }
 
 bool InputSequence::isEmpty() const
 {
-    return mSequence.empty();
+    return mLength == 0;
 }
 
 QSharedPointer<const BaseInput> InputSequence::getLast() const
 {
-    return mSequence.last();
+    Q_ASSERT(!isEmpty());
+    return mLast->input;
 }
 
 const QList<QSharedPointer<const BaseInput> > InputSequence::toList() const
 {
-    return mSequence;
+    // Fill in from the back, as the nodes are linked from the last input.
+    QVector<QSharedPointer<const BaseInput> > sequence(mLength);
+
+    int i = mLength;
+    for (QSharedPointer<const Node> node = mLast; !node.isNull(); node = node->previous) {
+        sequence[--i] = node->input;
+    }
+
+    return sequence.toList();
 }
 
 QString InputSequence::toString() const
 {
     QString output;
 
-    foreach (QSharedPointer<const BaseInput> input, mSequence) {
+    foreach (QSharedPointer<const BaseInput> input, toList()) {
         output += input->toString() + QString(" => ");
     }
 
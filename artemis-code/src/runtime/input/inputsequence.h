@@ -18,12 +18,20 @@
 #define INPUTSEQUENCE_H
 
 #include <QList>
+#include <QBitArray>
 
 #include "baseinput.h"
 
 namespace artemis
 {
 
+/*
+ * An immutable sequence of inputs.
+ *
+ * The inputs are kept in a linked list from the last input backwards, and sequences built from each other share
+ * their common prefix. This makes extend() and replaceLast() constant time, so the input generators can build long
+ * sequences step by step, and the worklist does not keep a separate copy of every sequence.
+ */
 class InputSequence
 {
 
@@ -33,19 +41,41 @@ public:
 
     QSharedPointer<const InputSequence> replaceLast(QSharedPointer<const BaseInput> newLast) const;
     QSharedPointer<const InputSequence> extend(QSharedPointer<const BaseInput> newLast) const;
+    QSharedPointer<const InputSequence> removeLast() const;
 
     bool isEmpty() const;
     QSharedPointer<const BaseInput> getLast() const;
     const QList<QSharedPointer<const BaseInput> > toList() const;
 
     int length() const {
-        return mSequence.length();
+        return mLength;
     }
 
     QString toString() const;
 
 private:
-    const QList<QSharedPointer<const BaseInput> > mSequence;
+    friend class JavascriptStatistics; // Caches the write sets of prefixes on the nodes.
+
+    struct Node {
+        Node(QSharedPointer<const BaseInput> input, QSharedPointer<const Node> previous)
+            : input(input)
+            , previous(previous)
+            , writtenVersion(0)
+        {}
+
+        const QSharedPointer<const BaseInput> input;
+        const QSharedPointer<const Node> previous;
+
+        // The properties written by the inputs up to and including this one, valid while the write sets in
+        // JavascriptStatistics are at writtenVersion (0 if never computed).
+        mutable QBitArray written;
+        mutable uint writtenVersion;
+    };
+
+    InputSequence(QSharedPointer<const Node> last, int length);
+
+    QSharedPointer<const Node> mLast;
+    int mLength;
 };
 
 typedef QSharedPointer<InputSequence> InputSequencePtr;
@@ -50,6 +50,11 @@ int TimerInput::hashCode() const
     return 31 * mTimer->getId();
 }
 
+QString TimerInput::identity() const
+{
+    return QString("TimerInput(%1)").arg(mTimer->getId());
+}
+
 QString TimerInput::toString() const
 {
     return QString("TimerInput");
@@ -36,6 +36,7 @@ public:
                                      const ExecutionResultConstPtr& result) const;
 
     int hashCode() const;
+    QString identity() const;
     QString toString() const;
 
 private:
@@ -68,7 +68,7 @@ enum ExportEventSequence{
 };
 
 enum SMTSolver {
-    KALUZA, Z3STR, CVC4
+    KALUZA, Z3STR, Z3STR_INPROCESS, CVC4
 };
 
 enum ConcolicSearch {
@@ -85,6 +85,14 @@ enum ConcolicTraceClassifer {
     CLASSIFY_FORM_SUBMISSION, CLASSIFY_JS_ERROR, CLASSIFY_NONE
 };
 
+enum ConcolicReorderingScheduler {
+    SCHEDULE_RANKED, SCHEDULE_ROUND_ROBIN
+};
+
+enum NetworkCacheMode {
+    NETWORK_CACHE_OFF, NETWORK_CACHE_RECORD, NETWORK_CACHE_REPLAY, NETWORK_CACHE_OFFLINE
+};
+
 
 typedef struct OptionsType {
 
@@ -101,8 +109,12 @@ typedef struct OptionsType {
         outputCoverage(NONE),
         majorMode(AUTOMATED),
         reportPathTrace(NO_TRACES),
+        pathTraceMaxItems(0),
+        pathTraceSampling(1),
         concolicTreeOutput(TREE_FINAL),
         concolicTreeOutputOverview(false),
+        concolicTreeOutputIterations(1),
+        concolicTreeOutputSeconds(0),
         concolicTriggerEventHandlers(false),
         concolicEventHandlerReport(false),
         concolicEventHandlerPermutation(""),
@@ -111,6 +123,9 @@ typedef struct OptionsType {
         concolicDfsRestartLimit(3),
         concolicSearchBudget(25),
         concolicTraceClassifier(CLASSIFY_FORM_SUBMISSION),
+        concolicReorderingScheduler(SCHEDULE_ROUND_ROBIN),
+        concolicDomIndicatorDetection(true),
+        concolicTreeMemoryLimit(0),
         solver(CVC4),
         exportEventSequence(DONT_EXPORT),
         reportHeap(NO_CALLS),
@@ -123,6 +138,11 @@ typedef struct OptionsType {
         analysisServerLog(false),
         artemisLoadUrls(false),
         delegationTestingMode(false),
+        networkCacheMode(NETWORK_CACHE_OFF),
+        networkCacheDir("network-cache"),
+        prettifyJavaScript(false),
+        prettifyCacheDir("prettify-cache"),
+        samplingProfilerInterval(1000),
         testingConcolicSendIterationCountToServer(false)
     {}
 
@@ -150,9 +170,13 @@ typedef struct OptionsType {
     MajorMode majorMode;
 
     PathTraceReport reportPathTrace;
+    uint pathTraceMaxItems; // Stop recording path trace items after this many (0 for no limit).
+    uint pathTraceSampling; // Only record one in every n path traces.
 
     ConcolicTreeOutput concolicTreeOutput;
     bool concolicTreeOutputOverview;
+    uint concolicTreeOutputIterations; // Update the tree output at most every n iterations (0 for no limit).
+    uint concolicTreeOutputSeconds; // Update the tree output at most every n seconds (0 for no limit).
     QString concolicEntryPoint;
     QString eventFilterArea;
     bool concolicTriggerEventHandlers;
@@ -167,6 +191,12 @@ typedef struct OptionsType {
     unsigned int concolicSearchBudget;
 
     ConcolicTraceClassifer concolicTraceClassifier;
+    ConcolicReorderingScheduler concolicReorderingScheduler;
+
+    bool concolicDomIndicatorDetection;
+    QList<QString> concolicDomIndicators; // Empty for the default list.
+
+    uint concolicTreeMemoryLimit; // In MB, fully explored parts of the execution tree are spilled to disk above this (0 for no limit).
 
     SMTSolver solver;
 
@@ -195,6 +225,15 @@ typedef struct OptionsType {
 
     QString concolicTestModeJsFile;
 
+    NetworkCacheMode networkCacheMode;
+    QString networkCacheDir;
+
+    bool prettifyJavaScript;
+    QString prettifyCacheDir;
+
+    QString samplingProfilerFile;
+    uint samplingProfilerInterval; // Microseconds
+
     // Instrumentation for the test suites.
     bool testingConcolicSendIterationCountToServer;
 
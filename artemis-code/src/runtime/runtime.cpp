@@ -55,6 +55,7 @@
 #include "concolic/solver/kaluzasolver.h"
 #include "concolic/solver/cvc4solver.h"
 #include "concolic/pathcondition.h"
+#include "concolic/traceeventdetectors.h"
 
 #include "runtime.h"
 
@@ -101,6 +102,11 @@ Runtime::Runtime(QObject* parent, const Options& options, const QUrl& url)
     }
     ajaxRequestListner->setCookieJar(cookieJar);
 
+    if (options.networkCacheMode != NETWORK_CACHE_OFF) {
+        ajaxRequestListner->setNetworkCache(NetworkCachePtr(new NetworkCache(options.networkCacheDir)),
+                                            options.networkCacheMode);
+    }
+
     /** JQuery support **/
 
     JQueryListener* jqueryListener = new JQueryListener(this);
@@ -109,6 +115,12 @@ Runtime::Runtime(QObject* parent, const Options& options, const QUrl& url)
 
     mAppmodel = AppModelPtr(new AppModel(options));
 
+    if (options.prettifyJavaScript) {
+        PrettifyCachePtr prettifier = PrettifyCachePtr(new PrettifyCache(options.prettifyCacheDir));
+        ajaxRequestListner->setPrettifyCache(prettifier);
+        mAppmodel->getCoverageListener()->setPrettifyCache(prettifier);
+    }
+
     bool enableConstantStringInstrumentation = options.formInputGenerationStrategy == ConstantString;
     bool enablePropertyAccessInstrumentation = options.prioritizerStrategy == READWRITE;
     mWebkitExecutor = new WebKitExecutor(this, mAppmodel, options.presetFormfields,
@@ -124,10 +136,21 @@ Runtime::Runtime(QObject* parent, const Options& options, const QUrl& url)
         mWebkitExecutor->getPage()->setCustomUserAgent(options.customUserAgent);
     }
 
+    // Only the form submission classifier uses the DOM modifications in the trace.
+    bool concolicMode = options.majorMode == CONCOLIC || options.majorMode == CONCOLIC_REORDERING || options.majorMode == ANALYSIS_SERVER;
+    if (concolicMode && options.concolicTraceClassifier == CLASSIFY_FORM_SUBMISSION && options.concolicDomIndicatorDetection) {
+        mWebkitExecutor->enableDomIndicatorDetection(options.concolicDomIndicators.isEmpty() ? TraceDomModDetector::getIndicators()
+                                                                                             : options.concolicDomIndicators);
+    }
+
     if(options.reportHeap != NO_CALLS){
         mWebkitExecutor->mWebkitListener->enableHeapReport(options.reportHeap == NAMED_CALLS, 0, options.heapReportFactor);
     }
 
+    if (!options.samplingProfilerFile.isEmpty()) {
+        mAppmodel->getSamplingProfiler()->start(mWebkitExecutor->mWebkitListener, options.samplingProfilerInterval);
+    }
+
     QSharedPointer<FormInputGenerator> formInputGenerator;
     switch (options.formInputGenerationStrategy) {
     case Random:
@@ -294,6 +317,7 @@ void Runtime::done()
             pc->negateLastCondition();
         }
 
+        SamplingProfiler::PhaseScope phase(SamplingProfiler::SOLVER);
         SolverPtr solver = Solver::getSolver(mOptions);
         ReachablePathsConstraintSet nullReachablePaths;
         ReorderingConstraintInfoPtr nullReorderingInfo;
@@ -312,6 +336,11 @@ void Runtime::done()
         Log::info("=== Last pathconditions END ===\n\n");
     }
 
+    if (!mOptions.samplingProfilerFile.isEmpty()) {
+        mAppmodel->getSamplingProfiler()->stop();
+        mAppmodel->getSamplingProfiler()->writeToFile(mOptions.samplingProfilerFile);
+    }
+
     Log::info("\n=== Statistics ===\n");
     Statistics::statistics()->writeToStdOut();
     Log::info("\n=== Statistics END ===\n\n");
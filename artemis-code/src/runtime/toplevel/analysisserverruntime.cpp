@@ -24,6 +24,7 @@
 #include "util/loggingutil.h"
 #include "util/delayutil.h"
 #include "runtime/input/clicksimulator.h"
+#include "runtime/browser/eventhandlerfilter.h"
 #include "concolic/executiontree/tracedisplay.h"
 #include "concolic/executiontree/tracedisplayoverview.h"
 #include "symbolic/directaccesssymbolicvalues.h"
@@ -201,7 +202,7 @@ void AnalysisServerRuntime::execute(HandlersCommand *command)
 
     // Check if a filter was used.
     if (!command->filter.isNull()) {
-        QList<QWebElement> matches = mWebkitExecutor->getPage()->getElementsByXPath(command->filter).toList();
+        QSet<WebCore::Element*> matches = EventHandlerFilter::elementSet(mWebkitExecutor->getPage()->getElementsByXPath(command->filter).toList());
         if (matches.count() < 1) {
             emit sigCommandFinished(errorResponse("No matches were found for the filter."));
             return;
@@ -210,7 +211,7 @@ void AnalysisServerRuntime::execute(HandlersCommand *command)
         QList<EventHandlerDescriptorConstPtr> specifiedElementHandlers;
         foreach (EventHandlerDescriptorConstPtr handler, handlerList) {
             QWebElement handlerElt = handler->getDomElement()->getElement(mWebkitExecutor->getPage());
-            if (matches.contains(handlerElt)) {
+            if (matches.contains(handlerElt.getElement())) {
                 specifiedElementHandlers.append(handler);
             }
         }
@@ -745,6 +746,48 @@ void AnalysisServerRuntime::execute(CoverageCommand *command)
 
 }
 
+void AnalysisServerRuntime::execute(ProfileCommand *command)
+{
+    Log::debug("  Analysis server runtime: executing a profile command.");
+    assert(command);
+
+    SamplingProfilerPtr profiler = mAppmodel->getSamplingProfiler();
+
+    switch (command->action) {
+    case ProfileCommand::Start:
+        profiler->start(mWebkitExecutor->mWebkitListener, command->interval);
+        break;
+
+    case ProfileCommand::Stop:
+        profiler->stop();
+        break;
+
+    case ProfileCommand::Reset:
+        profiler->reset();
+        break;
+
+    case ProfileCommand::Report:
+        break;
+
+    default:
+        emit sigCommandFinished(errorResponse("Unknown profile action."));
+        return;
+    }
+
+    if (!command->file.isEmpty() && !profiler->writeToFile(command->file)) {
+        emit sigCommandFinished(errorResponse(QString("Could not write the profile to %1.").arg(command->file)));
+        return;
+    }
+
+    QVariantMap result;
+    if (command->action == ProfileCommand::Report) {
+        result.insert("profile", profiler->toVariant());
+    } else {
+        result.insert("profile", "done");
+    }
+    emit sigCommandFinished(result);
+}
+
 
 QVariant AnalysisServerRuntime::errorResponse(QString message)
 {
@@ -58,6 +58,7 @@ public:
     void execute(EvaluateJsCommand* command);
     void execute(SetSymbolicValuesCommand* command);
     void execute(CoverageCommand* command);
+    void execute(ProfileCommand* command);
 
 protected:
     virtual void done();
@@ -190,7 +190,8 @@ void ArtemisRuntime::notifyAboutNewIteration(ExecutableConfigurationConstPtr con
     }
 
     // Add the trace into the analysis, passing in the ExplorationHandle which lets the analysis know where this run was expected to exlpore.
-    target->getAnalysis()->addTrace(mWebkitExecutor->getTraceBuilder()->trace(), target->getExplorationTarget());
+    target->getAnalysis()->addTrace(mWebkitExecutor->getTraceBuilder()->trace(), target->getExplorationTarget(),
+                                    mWebkitExecutor->getTraceBuilder()->path());
 }
 
 
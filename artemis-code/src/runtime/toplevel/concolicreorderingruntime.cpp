@@ -34,6 +34,7 @@ ConcolicReorderingRuntime::ConcolicReorderingRuntime(QObject* parent, const Opti
     , mNumIterations(0)
     , mCurrentExplorationHandle(ConcolicAnalysis::NO_EXPLORATION_TARGET)
     , mPreviouslySearchedAction(0)
+    , mScheduler(options.concolicReorderingScheduler)
     , mFoundFullyTerminatingTrace(false)
     , mRunId(QDateTime::currentDateTime().toString("yyyy-MM-dd-hh-mm-ss"))
 {
@@ -138,8 +139,14 @@ void ConcolicReorderingRuntime::postConcreteExecution(ExecutableConfigurationCon
 
     // Execute the current action sequence
     makeAllFieldsSymbolic();
+    uint newTracesBefore = countNewTraces();
     executeCurrentActionSequence();
 
+    // Credit the action which was explored for this run with the new paths it found.
+    if (mPreviouslySearchedAction != 0) {
+        mScheduler.recordNewPaths(mPreviouslySearchedAction, countNewTraces() - newTracesBefore);
+    }
+
     // Choose the new values and actions to test
     chooseNextSequenceAndExplore();
 
@@ -264,7 +271,7 @@ void ConcolicReorderingRuntime::executeCurrentActionSequence()
         }
 
         if (actionIdx == mPreviouslySearchedAction) {
-            action.analysis->addTrace(trace, mCurrentExplorationHandle);
+            action.analysis->addTrace(trace, mCurrentExplorationHandle, mWebkitExecutor->getTraceBuilder()->path());
         } else {
             action.analysis->addTrace(trace, ConcolicAnalysis::NO_EXPLORATION_TARGET);
         }
@@ -297,7 +304,7 @@ void ConcolicReorderingRuntime::executeCurrentActionSequence()
         }
 
         if (mPreviouslySearchedAction == mSubmitButtonIndex) {
-            mSubmitButtonAnalysis->addTrace(trace, mCurrentExplorationHandle);
+            mSubmitButtonAnalysis->addTrace(trace, mCurrentExplorationHandle, mWebkitExecutor->getTraceBuilder()->path());
         } else {
             mSubmitButtonAnalysis->addTrace(trace, ConcolicAnalysis::NO_EXPLORATION_TARGET);
         }
@@ -357,58 +364,62 @@ InjectionValue ConcolicReorderingRuntime::getFieldCurrentValue(FormFieldDescript
 
 void ConcolicReorderingRuntime::chooseNextSequenceAndExplore()
 {
-    // Choose the action to explore next.
-    uint nextActionIdx = chooseNextActionToSearch();
-    if (nextActionIdx == 0) {
-        // No action could be found to explore. N.B. 0 is not a valid index; they start at 1.
-        Log::info("ConcolicReorderingRuntime: There were no actions left to explore. Done.");
-        mWebkitExecutor->detach();
-        done();
-    }
+    // Try actions until one of them gives a new exploration. Each action which fails is not tried again, so this
+    // terminates once all actions are fully explored.
+    while (true) {
+        // Choose the action to explore next.
+        uint nextActionIdx = chooseNextActionToSearch();
+        if (nextActionIdx == 0) {
+            // No action could be found to explore. N.B. 0 is not a valid index; they start at 1.
+            Log::info("ConcolicReorderingRuntime: There were no actions left to explore. Done.");
+            mWebkitExecutor->detach();
+            done();
+            return;
+        }
 
-    ConcolicAnalysisPtr analysis;
-    if (!mSubmitButtonAnalysis.isNull() && nextActionIdx == mSubmitButtonIndex) {
-        Log::debug("ConcolicReorderingRuntime: Exploring submit button");
-        analysis = mSubmitButtonAnalysis;
-    } else {
-        Action nextAction = mAvailableActions[nextActionIdx];
-        Log::debug("ConcolicReorderingRuntime: Exploring action " + std::to_string(nextActionIdx) + " (" + nextAction.variable.toStdString() + ")");
-        analysis = nextAction.analysis;
-    }
+        ConcolicAnalysisPtr analysis = getAnalysis(nextActionIdx);
+        if (!mSubmitButtonAnalysis.isNull() && nextActionIdx == mSubmitButtonIndex) {
+            Log::debug("ConcolicReorderingRuntime: Exploring submit button");
+        } else {
+            Log::debug("ConcolicReorderingRuntime: Exploring action " + std::to_string(nextActionIdx) + " (" + mAvailableActions[nextActionIdx].variable.toStdString() + ")");
+        }
 
-    // Collate the reachable-paths constraints for the other actions.
-    ReachablePathsConstraintSet reachablePaths = getReachablePathsConstraints(nextActionIdx);
+        // Collate the reachable-paths constraints for the other actions.
+        ReachablePathsConstraintSet reachablePaths = getReachablePathsConstraints(nextActionIdx);
 
-    // Select a target branch from the chosen action's concolic tree.
-    analysis->setReachablePathsConstraints(reachablePaths);
-    analysis->setReorderingInfo(getReorderingConstraintInfo(nextActionIdx));
-    ConcolicAnalysis::ExplorationResult result = analysis->nextExploration();
-    if (result.newExploration) {
-        // Succesfully solved a PC in this action.
-        Log::debug("ConcolicReorderingRuntime: exploration succeeded.");
+        // Select a target branch from the chosen action's concolic tree.
+        analysis->setReachablePathsConstraints(reachablePaths);
+        analysis->setReorderingInfo(getReorderingConstraintInfo(nextActionIdx));
+        ConcolicAnalysis::ExplorationResult result = analysis->nextExploration();
+        recordExplorationAttempt(nextActionIdx, result);
 
-        // Decode the variables to be injected.
-        mSolvedInjectionValues = decodeSolvedInjectionValues(result.solution);
+        if (result.newExploration) {
+            // Succesfully solved a PC in this action.
+            Log::debug("ConcolicReorderingRuntime: exploration succeeded.");
 
-        // Decode the ordering to be used.
-        mCurrentActionOrder = decodeSolvedActionOrder(result.solution);
-        Log::debug("Solved action sequence:");
-        printCurrentActionSequence();
+            // Decode the variables to be injected.
+            mSolvedInjectionValues = decodeSolvedInjectionValues(result.solution);
 
-        QStringList orderingSummary;
-        foreach (uint x, mCurrentActionOrder) {
-            orderingSummary.append(QString::number(x));
-        }
-        if (!mSubmitButtonSelector.isNull()) {
-            orderingSummary.append("Btn");
-        }
-        mOrderingLog.append(orderingSummary.join(", "));
+            // Decode the ordering to be used.
+            mCurrentActionOrder = decodeSolvedActionOrder(result.solution);
+            Log::debug("Solved action sequence:");
+            printCurrentActionSequence();
 
-        // Prepare the next execution.
-        mCurrentExplorationHandle = result.target;
-        preConcreteExecution();
+            QStringList orderingSummary;
+            foreach (uint x, mCurrentActionOrder) {
+                orderingSummary.append(QString::number(x));
+            }
+            if (!mSubmitButtonSelector.isNull()) {
+                orderingSummary.append("Btn");
+            }
+            mOrderingLog.append(orderingSummary.join(", "));
+
+            // Prepare the next execution.
+            mCurrentExplorationHandle = result.target;
+            preConcreteExecution();
+            return;
+        }
 
-    } else {
         // Couldn't explore in this action. Try another one.
         Log::debug("ConcolicReorderingRuntime: exploration failed.");
         // Do not return to this action.
@@ -417,10 +428,17 @@ void ConcolicReorderingRuntime::chooseNextSequenceAndExplore()
         } else {
             mAvailableActions[nextActionIdx].fullyExplored = true;
         }
-        chooseNextSequenceAndExplore();
     }
 }
 
+ConcolicAnalysisPtr ConcolicReorderingRuntime::getAnalysis(uint actionIdx)
+{
+    if (!mSubmitButtonAnalysis.isNull() && actionIdx == mSubmitButtonIndex) {
+        return mSubmitButtonAnalysis;
+    }
+    return mAvailableActions[actionIdx].analysis;
+}
+
 uint ConcolicReorderingRuntime::chooseNextActionToSearch()
 {
     // Check which actions are not fully explored.
@@ -438,35 +456,38 @@ uint ConcolicReorderingRuntime::chooseNextActionToSearch()
         return 0; // N.B. 0 is not a valid index; they start at 1.
     }
 
-    // Use round-robin to select an action to search.
-    qSort(actionsToExplore);
-    // On the first run, choose the first action.
-    if (mPreviouslySearchedAction == 0) {
-        mPreviouslySearchedAction = actionsToExplore[0];
-        return actionsToExplore[0];
-    }
-    // If we are in the middle of the action sequence, choose the next action.
+    // The frontier sizes are kept up to date by the analyses, so this does not visit the trees.
+    QMap<uint, uint> frontiers;
     foreach (uint actionIdx, actionsToExplore) {
-        if (actionIdx > mPreviouslySearchedAction) {
-            mPreviouslySearchedAction = actionIdx;
-            return actionIdx;
-        }
+        frontiers.insert(actionIdx, getAnalysis(actionIdx)->getFrontierSize());
+    }
+
+    mPreviouslySearchedAction = mScheduler.chooseNextAction(actionsToExplore, frontiers);
+    return mPreviouslySearchedAction;
+}
+
+void ConcolicReorderingRuntime::recordExplorationAttempt(uint actionIdx, const ConcolicAnalysis::ExplorationResult& result)
+{
+    Statistics::statistics()->accumulate("Concolic::Reordering::ExplorationSolverCalls", (int)result.solverCalls);
+    mScheduler.recordExplorationAttempt(actionIdx, result.newExploration, result.solverCalls);
+}
+
+uint ConcolicReorderingRuntime::countNewTraces()
+{
+    uint total = 0;
+    foreach (Action action, mAvailableActions) {
+        total += action.analysis->getNumNewTraces();
     }
-    // If we overflow the actions list, the submit button is next.
-    // N.B. This check works because we guarantee the submit button has a higher index than all the other actions.
-    if (actionsToExplore.contains(mSubmitButtonIndex) && mSubmitButtonIndex > mPreviouslySearchedAction) {
-        mPreviouslySearchedAction = mSubmitButtonIndex;
-        return mSubmitButtonIndex;
+    if (!mSubmitButtonAnalysis.isNull()) {
+        total += mSubmitButtonAnalysis->getNumNewTraces();
     }
-    // Otherwise we have wrapped around to the start again.
-    mPreviouslySearchedAction = actionsToExplore[0];
-    return actionsToExplore[0];
+    return total;
 }
 
 ReachablePathsConstraintSet ConcolicReorderingRuntime::getReachablePathsConstraints(uint ignoreIdx)
 {
     // Collate the reachable-paths constraints for the actions other than ignoreIdx.
-    // TODO: Ideally this would be maintained and updated dynamically as-needed, and not re-built on every iteration.
+    // The constraints are cached, and only rebuilt for the actions whose trees have changed since.
 
     ReachablePathsConstraintSet constraintSet;
     foreach (uint actionIdx, mAvailableActions.keys()) {
@@ -474,7 +495,7 @@ ReachablePathsConstraintSet ConcolicReorderingRuntime::getReachablePathsConstrai
             Action action = mAvailableActions[actionIdx];
             NamedReachablePathsConstraint constraint;
             constraint.first = QPair<QString, uint>(QString("Action %1 (%2)").arg(actionIdx).arg(action.variable), action.index);
-            constraint.second = ReachablePathsConstraintGenerator::generateConstraint(action.analysis->getExecutionTree());
+            constraint.second = getReachablePathsConstraint(actionIdx, action.analysis);
             constraintSet.insert(constraint);
         }
     }
@@ -483,13 +504,30 @@ ReachablePathsConstraintSet ConcolicReorderingRuntime::getReachablePathsConstrai
     if (!mSubmitButtonSelector.isNull() && mSubmitButtonIndex != ignoreIdx) {
         NamedReachablePathsConstraint constraint;
         constraint.first = QPair<QString, uint>("submit button", mSubmitButtonIndex);
-        constraint.second = ReachablePathsConstraintGenerator::generateConstraint(mSubmitButtonAnalysis->getExecutionTree());
+        constraint.second = getReachablePathsConstraint(mSubmitButtonIndex, mSubmitButtonAnalysis);
         constraintSet.insert(constraint);
     }
 
     return constraintSet;
 }
 
+ReachablePathsConstraintPtr ConcolicReorderingRuntime::getReachablePathsConstraint(uint actionIdx, ConcolicAnalysisPtr analysis)
+{
+    uint version = analysis->getExecutionTreeVersion();
+
+    QMap<uint, QPair<uint, ReachablePathsConstraintPtr> >::const_iterator cached = mReachablePathsConstraintCache.constFind(actionIdx);
+    if (cached != mReachablePathsConstraintCache.constEnd() && cached->first == version) {
+        Statistics::statistics()->accumulate("Concolic::Reordering::ReachablePathsConstraintsReused", 1);
+        return cached->second;
+    }
+
+    ReachablePathsConstraintPtr constraint = ReachablePathsConstraintGenerator::generateConstraint(analysis->getExecutionTree());
+    mReachablePathsConstraintCache.insert(actionIdx, QPair<uint, ReachablePathsConstraintPtr>(version, constraint));
+    Statistics::statistics()->accumulate("Concolic::Reordering::ReachablePathsConstraintsGenerated", 1);
+
+    return constraint;
+}
+
 ReorderingConstraintInfoPtr ConcolicReorderingRuntime::getReorderingConstraintInfo(uint actionIdx)
 {
     // Create the concolic renaming/reordering info for this concolic analysis.
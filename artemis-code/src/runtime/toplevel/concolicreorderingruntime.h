@@ -27,6 +27,7 @@
 #include "concolic/executiontree/classifier/traceclassifier.h"
 
 #include "concolic/concolicanalysis.h"
+#include "concolic/reordering/reorderingscheduler.h"
 
 
 namespace artemis
@@ -68,7 +69,15 @@ protected:
     ConcolicAnalysis::ExplorationHandle mCurrentExplorationHandle;
     uint chooseNextActionToSearch();
     uint mPreviouslySearchedAction;
+    ConcolicAnalysisPtr getAnalysis(uint actionIdx);
+    ReorderingScheduler mScheduler;
+    void recordExplorationAttempt(uint actionIdx, const ConcolicAnalysis::ExplorationResult& result);
+    uint countNewTraces();
     ReachablePathsConstraintSet getReachablePathsConstraints(uint ignoreIdx);
+    ReachablePathsConstraintPtr getReachablePathsConstraint(uint actionIdx, ConcolicAnalysisPtr analysis);
+    // The reachable-paths constraint of each action (and the submit button), with the version of the action's
+    // execution tree it was generated from.
+    QMap<uint, QPair<uint, ReachablePathsConstraintPtr> > mReachablePathsConstraintCache;
     ReorderingConstraintInfoPtr getReorderingConstraintInfo(uint actionIdx);
     QMap<uint, InjectionValue> decodeSolvedInjectionValues(SolutionPtr solution);
     QMap<uint, InjectionValue> mSolvedInjectionValues;
@@ -35,8 +35,7 @@ ConcolicRuntime::ConcolicRuntime(QObject* parent, const Options& options, const
     : Runtime(parent, options, url)
     , mConcolicAnalysis(new ConcolicAnalysis(options, ConcolicAnalysis::CONCOLIC_RUNTIME))
     , mFoundSuccessTrace(false)
-    , mTraceDisplay(options.outputCoverage != NONE)
-    , mTraceDisplayOverview(options.outputCoverage != NONE)
+    , mTreeOutput(options)
     , mHandlerTracker(options.concolicEventHandlerReport)
     , mNumIterations(0)
 {
@@ -102,8 +101,9 @@ void ConcolicRuntime::run(const QUrl& url)
 
     mNextConfiguration = QSharedPointer<ExecutableConfiguration>(new ExecutableConfiguration(QSharedPointer<InputSequence>(new InputSequence()), url));
 
-    mGraphOutputIndex = 1;
-    mGraphOutputNameFormat = QString("tree-%1_%2%3-%4.gv").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd-hh-mm-ss"));
+    QString date = QDateTime::currentDateTime().toString("yyyy-MM-dd-hh-mm-ss");
+    mGraphOutputNameFormat = QString("tree-%1_%2%3.gv").arg(date);
+    mTreeOutput.open(QString("tree-%1.gvlog").arg(date), QString("tree-%1_min.gvlog").arg(date));
 
     std::ofstream constraintLog;
     constraintLog.open("/tmp/constraintlog", std::ofstream::out | std::ofstream::app);
@@ -269,40 +269,19 @@ void ConcolicRuntime::slExecutionTreeUpdated(TraceNodePtr tree, QString name)
 }
 
 // Utility method to output the tree graph at each step.
+// Only the changes are written (and not necessarily at every step), the full graph is written by outputFinalTreeGraph().
 void ConcolicRuntime::outputTreeGraph()
 {
-    if(mOptions.concolicTreeOutput == TREE_NONE){
-        return;
-    }
-    // Output the graphs, and if we are in TREE_FINAL mode, then delete the older ones.
-    // We do it like this to make sure there is always an up-to-date version of the tree saved out either for
-    // viewing the progress or in case of crashes.
-
-    // We want all the graphs from a certain run to have the same "base" name and an increasing index, so they can be easily grouped.
-    QString name = mGraphOutputNameFormat.arg("").arg(mNumIterations).arg(mGraphOutputIndex);
-    QString name_min = mGraphOutputNameFormat.arg("min_").arg(mNumIterations).arg(mGraphOutputIndex);
-    Log::debug(QString("CONCOLIC-INFO: Writing tree to file %1").arg(name).toStdString());
-    mGraphOutputIndex++;
-
-    QString previous_name = mGraphOutputPreviousName;
-    QString previous_name_min = mGraphOutputOverviewPreviousName;
+    mTreeOutput.update(mConcolicAnalysis->getExecutionTree(), mNumIterations);
+}
 
-    mTraceDisplay.writeGraphFile(mConcolicAnalysis->getExecutionTree(), name, false);
-    mGraphOutputPreviousName = name;
-    if(mOptions.concolicTreeOutputOverview){
-        mTraceDisplayOverview.writeGraphFile(mConcolicAnalysis->getExecutionTree(), name_min, false);
-        mGraphOutputOverviewPreviousName = name_min;
-    }
+void ConcolicRuntime::outputFinalTreeGraph()
+{
+    // We want all the graphs from a certain run to have the same "base" name, so they can be easily grouped.
+    QString name = mGraphOutputNameFormat.arg("").arg(mNumIterations);
+    QString name_min = mGraphOutputNameFormat.arg("min_").arg(mNumIterations);
 
-    if(mOptions.concolicTreeOutput == TREE_FINAL){
-        // Delete the older graph files.
-        if(!previous_name.isEmpty()){ // Empty if we have not written a graph yet.
-            QFile::remove(previous_name);
-        }
-        if(!previous_name_min.isEmpty()){ // Empty if we have not written a graph yet.
-            QFile::remove(previous_name_min);
-        }
-    }
+    mTreeOutput.finish(mConcolicAnalysis->getExecutionTree(), mNumIterations, name, name_min);
 }
 
 
@@ -565,7 +544,7 @@ void ConcolicRuntime::mergeTraceIntoTree()
     logInjectionValues(classification);
 
     ConcolicAnalysis::ExplorationHandle exploration = mRunningWithInitialValues ? ConcolicAnalysis::NO_EXPLORATION_TARGET : mExplorationResult.target;
-    mConcolicAnalysis->addTrace(trace, exploration);
+    mConcolicAnalysis->addTrace(trace, exploration, mWebkitExecutor->getTraceBuilder()->path());
 
     // Once we have done at least one merge, the we are now into the "main" analysis.
     mRunningWithInitialValues = false;
@@ -989,6 +968,7 @@ void ConcolicRuntime::logInjectionValues(TraceClassificationResult classificatio
 
 void ConcolicRuntime::done()
 {
+    outputFinalTreeGraph();
     reportStatistics();
     Runtime::done();
 }
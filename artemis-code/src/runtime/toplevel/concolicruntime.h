@@ -25,8 +25,7 @@
 #include "concolic/entrypoints.h"
 #include "concolic/mockentrypointdetector.h"
 #include "concolic/executiontree/traceprinter.h"
-#include "concolic/executiontree/tracedisplay.h"
-#include "concolic/executiontree/tracedisplayoverview.h"
+#include "concolic/executiontree/tracedisplaywriter.h"
 #include "concolic/executiontree/classifier/traceclassifier.h"
 #include "concolic/tracestatistics.h"
 #include "concolic/handlerdependencytracker.h"
@@ -89,12 +88,9 @@ protected:
 
     // Method and variables for generating a graphviz graph of the execution tree.
     void outputTreeGraph();
-    TraceDisplay mTraceDisplay;
-    TraceDisplayOverview mTraceDisplayOverview;
+    void outputFinalTreeGraph();
+    TraceDisplayWriter mTreeOutput;
     QString mGraphOutputNameFormat;
-    int mGraphOutputIndex;
-    QString mGraphOutputPreviousName;
-    QString mGraphOutputOverviewPreviousName;
 
     // Helper methods for postConcreteExecution.
     void setupNextConfiguration(QSharedPointer<FormInputCollection> formInput);
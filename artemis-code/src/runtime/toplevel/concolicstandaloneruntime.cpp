@@ -20,8 +20,6 @@
 
 #include "util/loggingutil.h"
 #include "symbolic/directaccesssymbolicvalues.h"
-#include "concolic/executiontree/tracedisplay.h"
-#include "concolic/executiontree/tracedisplayoverview.h"
 #include "concolic/tracestatistics.h"
 #include "util/fileutil.h"
 
@@ -33,6 +31,7 @@ ConcolicStandaloneRuntime::ConcolicStandaloneRuntime(QObject* parent, const Opti
     : Runtime(parent, options, url)
     , mConcolicAnalysis(new ConcolicAnalysis(options, ConcolicAnalysis::CONCOLIC_RUNTIME))
     , mNumIterations(0)
+    , mTreeOutput(options)
 {
     QObject::connect(mWebkitExecutor, SIGNAL(sigExecutedSequence(ExecutableConfigurationConstPtr, QSharedPointer<ExecutionResult>)),
                      this, SLOT(slExecutedSequence(ExecutableConfigurationConstPtr, QSharedPointer<ExecutionResult>)));
@@ -49,6 +48,8 @@ void ConcolicStandaloneRuntime::run(const QUrl &url)
         exit(1);
     }
 
+    mTreeOutput.open("concolic-test-tree.gvlog", "concolic-test-tree_overview.gvlog", QFileInfo(mJsFilename).fileName());
+
     // Run the analysis
     newConcolicIteration(); // Runs until done, then calls done().
 }
@@ -129,7 +130,7 @@ void ConcolicStandaloneRuntime::doneConcolicIteration(TraceNodePtr trace)
     } else {
         target = mExplorationResult.target;
     }
-    mConcolicAnalysis->addTrace(trace, target);
+    mConcolicAnalysis->addTrace(trace, target, mWebkitExecutor->getTraceBuilder()->path());
     concolicOutputTree();
 
     // Check if we have reached the iteration limit.
@@ -181,42 +182,19 @@ void ConcolicStandaloneRuntime::doneConcolicIteration(TraceNodePtr trace)
 
 void ConcolicStandaloneRuntime::concolicOutputTree()
 {
-    if(mOptions.concolicTreeOutput == TREE_NONE){
-        return;
-    }
-
-    QString previous_name = mGraphOutputPreviousName;
-    QString previous_name_min = mGraphOutputOverviewPreviousName;
+    mTreeOutput.update(mConcolicAnalysis->getExecutionTree(), mNumIterations + 1);
+}
 
+void ConcolicStandaloneRuntime::concolicOutputFinalTree()
+{
     int iter_id = mNumIterations + 1;
     QString jsFile = QFileInfo(mJsFilename).fileName();
     QString title = QString("%1, iteration %2").arg(jsFile).arg(iter_id);
 
     QString filename = QString("concolic-test-tree_%1.gv").arg(iter_id);
-    QString filenameOverview = QString("concolic-test-tree_%1_overview.gv").arg(iter_id);;
-
-    TraceDisplay display(mOptions.outputCoverage != NONE);
-    TraceDisplayOverview displayOverview(mOptions.outputCoverage != NONE);
+    QString filenameOverview = QString("concolic-test-tree_%1_overview.gv").arg(iter_id);
 
-    display.writeGraphFile(mConcolicAnalysis->getExecutionTree(), filename, false, title);
-    mGraphOutputPreviousName = filename;
-
-    if(mOptions.concolicTreeOutputOverview){
-        displayOverview.writeGraphFile(mConcolicAnalysis->getExecutionTree(), filenameOverview, false, title);
-        mGraphOutputOverviewPreviousName = filenameOverview;
-    }
-
-    // If only the final tree is required, then delete the previous tree.
-    // We do it this way to always have the latest tree on disk in case of a crash.
-    if(mOptions.concolicTreeOutput == TREE_FINAL){
-        // Delete the older graph files.
-        if(!previous_name.isEmpty()){ // Empty if we have not written a graph yet.
-            QFile::remove(previous_name);
-        }
-        if(!previous_name_min.isEmpty()){ // Empty if we have not written a graph yet.
-            QFile::remove(previous_name_min);
-        }
-    }
+    mTreeOutput.finish(mConcolicAnalysis->getExecutionTree(), iter_id, filename, filenameOverview, title);
 }
 
 
@@ -225,7 +203,7 @@ void ConcolicStandaloneRuntime::done()
     // Output a final version of the tree.
     // This is needed because there may be an unsat/missed/etc. node created in the last iteration which we need to
     // display even though there is no future iteration.
-    concolicOutputTree();
+    concolicOutputFinalTree();
 
     // Save some statistics about the tree.
     reportStatistics();
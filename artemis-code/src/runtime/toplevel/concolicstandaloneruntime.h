@@ -23,6 +23,7 @@
 #include "runtime/runtime.h"
 #include "runtime/options.h"
 #include "concolic/concolicanalysis.h"
+#include "concolic/executiontree/tracedisplaywriter.h"
 
 namespace artemis
 {
@@ -57,8 +58,8 @@ protected:
     // Logging part
     // TODO: The common parts of tree output from here, Concolic Runtime, and AnalysisServerRuntime (from feature-server-mode) should be merged. Maybe ConcolicAnalysis could handle this?
     void concolicOutputTree();
-    QString mGraphOutputPreviousName;
-    QString mGraphOutputOverviewPreviousName;
+    void concolicOutputFinalTree();
+    TraceDisplayWriter mTreeOutput;
 
     void done();
     void reportStatistics();
@@ -16,6 +16,8 @@
 
 #include <stdlib.h>
 
+#include "statistics/statsstorage.h"
+
 #include "deterministicworklist.h"
 
 namespace artemis
@@ -23,20 +25,32 @@ namespace artemis
 
 DeterministicWorkList::DeterministicWorkList(PrioritizerStrategyPtr prioritizer) :
     WorkList(),
-    mPrioritizer(prioritizer)
+    mPrioritizer(prioritizer),
+    mCoverageChangeCount(0),
+    mJavascriptChangeCount(0)
+{
+}
+
+quint64 DeterministicWorkList::inputMask(int inputHash)
 {
+    return Q_UINT64_C(1) << ((uint)inputHash % 64);
 }
 
 void DeterministicWorkList::add(ExecutableConfigurationConstPtr configuration, AppModelConstPtr appmodel)
 {
-    mQueue.push(WorkListItem(mPrioritizer->prioritize(configuration, appmodel), configuration));
+    quint64 inputs = 0;
+    foreach (QSharedPointer<const BaseInput> input, configuration->getInputSequence()->toList()) {
+        inputs |= inputMask(input->hashCode());
+    }
+
+    mQueue.push(WorkListItem(mPrioritizer->prioritize(configuration, appmodel), configuration, inputs));
 }
 
 ExecutableConfigurationConstPtr DeterministicWorkList::remove()
 {
     Q_ASSERT(!mQueue.empty());
 
-    ExecutableConfigurationConstPtr configuration = mQueue.top().second;
+    ExecutableConfigurationConstPtr configuration = mQueue.top().configuration;
     mQueue.pop();
 
     return configuration;
@@ -44,17 +58,59 @@ ExecutableConfigurationConstPtr DeterministicWorkList::remove()
 
 void DeterministicWorkList::reprioritize(AppModelConstPtr appmodel)
 {
-    QList<WorkListItem> tmps;
+    // For stable prioritizers, only the configurations containing an input whose coverage or read/write sets changed
+    // since the last reprioritisation can get a new priority, so the others keep their priority.
+    bool rescoreAll = !mPrioritizer->isStable();
+
+    QSet<int> changedInputs;
+    if (!rescoreAll) {
+        changedInputs = appmodel->getCoverageListener()->getInputsChangedSince(mCoverageChangeCount);
+        changedInputs.unite(appmodel->getJavascriptStatistics()->getInputsChangedSince(mJavascriptChangeCount));
+    }
+    mCoverageChangeCount = appmodel->getCoverageListener()->getChangeCount();
+    mJavascriptChangeCount = appmodel->getJavascriptStatistics()->getChangeCount();
+
+    if (!rescoreAll && changedInputs.isEmpty()) {
+        return;
+    }
+
+    quint64 changedMask = 0;
+    foreach (int inputHash, changedInputs) {
+        changedMask |= inputMask(inputHash);
+    }
+
+    vector<WorkListItem> items;
+    items.reserve(mQueue.size());
 
     while (!mQueue.empty()) {
-        tmps.append(mQueue.top());
+        items.push_back(mQueue.top());
         mQueue.pop();
     }
 
-    foreach (WorkListItem item, tmps) {
-        item.first = mPrioritizer->prioritize(item.second, appmodel);
-        mQueue.push(item);
+    int rescored = 0;
+
+    for (vector<WorkListItem>::iterator item = items.begin(); item != items.end(); item++) {
+        bool rescore = rescoreAll;
+
+        if (!rescore && (item->inputs & changedMask) != 0) {
+            foreach (QSharedPointer<const BaseInput> input, item->configuration->getInputSequence()->toList()) {
+                if (changedInputs.contains(input->hashCode())) {
+                    rescore = true;
+                    break;
+                }
+            }
+        }
+
+        if (rescore) {
+            item->priority = mPrioritizer->prioritize(item->configuration, appmodel);
+            rescored++;
+        }
     }
+
+    Statistics::statistics()->accumulate("Worklist::Reprioritized", rescored);
+    Statistics::statistics()->accumulate("Worklist::ReprioritizationSkipped", (int)items.size() - rescored);
+
+    mQueue = priority_queue<WorkListItem, vector<WorkListItem>, WorkListItemComperator>(WorkListItemComperator(), items);
 }
 
 int DeterministicWorkList::size()
@@ -83,7 +139,7 @@ QString DeterministicWorkList::toString() const
 
     foreach (WorkListItem item, tmps) {
         mQueue.push(item);
-        output += QString::number(item.first) + QString(" => ") + item.second->toString() + QString("\n");
+        output += QString::number(item.priority) + QString(" => ") + item.configuration->toString() + QString("\n");
     }
 
     return output;
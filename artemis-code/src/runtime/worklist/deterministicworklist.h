@@ -21,6 +21,7 @@
 #include <vector>
 
 #include <QPair>
+#include <QSet>
 #include <QSharedPointer>
 
 #include "strategies/prioritizer/prioritizerstrategy.h"
@@ -32,13 +33,25 @@ using namespace std;
 namespace artemis
 {
 
-typedef QPair<double, ExecutableConfigurationConstPtr> WorkListItem;
+struct WorkListItem
+{
+    WorkListItem(double priority, ExecutableConfigurationConstPtr configuration, quint64 inputs)
+        : priority(priority)
+        , configuration(configuration)
+        , inputs(inputs)
+    {}
+
+    double priority;
+    ExecutableConfigurationConstPtr configuration;
+    // One bit per input hash code (modulo 64) in the configuration, see DeterministicWorkList::reprioritize().
+    quint64 inputs;
+};
 
 struct WorkListItemComperator
 {
     bool operator() (const WorkListItem& lhs, const WorkListItem& rhs)
     {
-        return lhs.first < rhs.first;
+        return lhs.priority < rhs.priority;
     }
 };
 
@@ -62,6 +75,12 @@ private:
     mutable priority_queue<WorkListItem, vector<WorkListItem>, WorkListItemComperator> mQueue;
     PrioritizerStrategyPtr mPrioritizer;
 
+    // The change counts of the coverage and the JavaScript statistics at the last reprioritisation.
+    uint mCoverageChangeCount;
+    uint mJavascriptChangeCount;
+
+    static quint64 inputMask(int inputHash);
+
 };
 
 typedef QSharedPointer<DeterministicWorkList> DeterministicWorkListPtr;
@@ -37,38 +37,50 @@ void JQueryListener::reset()
     }
 
     jqueryEvents.clear();
+    mExactIndex.clear();
+    mFragmentIndex.clear();
 }
 
 QList<QString> JQueryListener::lookup(QString elementSignature, QString event)
 {
     QList<QString> result;
 
-    jqueryEvent* e;
-    foreach(e, jqueryEvents) {
+    // Matches from both indexes are merged back into registration order, as returned by the original linear scan.
+    const QList<int>* exact = NULL;
+    const QList<QPair<QString, int> >* fragments = NULL;
 
-        if (e->event == event) {
-
-            qDebug() << "Comparing " << elementSignature << " with " << e->elementSignature << endl;
-
-            // The following adds support for fuzzy matching. If an event handler
-            // is added at runtime to an element, which are not yet linked to the
-            // dom tree, then its "root" is called #document-fragment... Thus we
-            // can't get a full signature. These "signatures" are matched using
-            // best effort principles
-            if (e->elementSignature.indexOf(QString("#document-fragment")) != -1) {
-                QString trimmed = QString(e->elementSignature).replace(QString("#document-fragment"), QString(""));
+    QHash<QString, QHash<QString, QList<int> > >::const_iterator exactForEvent = mExactIndex.constFind(event);
+    if (exactForEvent != mExactIndex.constEnd()) {
+        QHash<QString, QList<int> >::const_iterator match = exactForEvent.value().constFind(elementSignature);
+        if (match != exactForEvent.value().constEnd()) {
+            exact = &match.value();
+        }
+    }
 
-                if (elementSignature.indexOf(trimmed) != -1) {
-                    qDebug() << "Found match (fuzzy)" << endl;
-                    result.append(e->selector);
-                }
-            }
+    QHash<QString, QList<QPair<QString, int> > >::const_iterator fragmentsForEvent = mFragmentIndex.constFind(event);
+    if (fragmentsForEvent != mFragmentIndex.constEnd()) {
+        fragments = &fragmentsForEvent.value();
+    }
 
-            else if (e->elementSignature == elementSignature) {
-                result.append(e->selector);
-                qDebug() << "Found match" << endl;
+    int exactPos = 0;
+    int fragmentPos = 0;
+    int exactSize = exact ? exact->size() : 0;
+    int fragmentSize = fragments ? fragments->size() : 0;
+
+    while (exactPos < exactSize || fragmentPos < fragmentSize) {
+
+        // The following adds support for fuzzy matching. If an event handler
+        // is added at runtime to an element, which are not yet linked to the
+        // dom tree, then its "root" is called #document-fragment... Thus we
+        // can't get a full signature. These "signatures" are matched using
+        // best effort principles
+        if (fragmentPos < fragmentSize && (exactPos >= exactSize || fragments->at(fragmentPos).second < exact->at(exactPos))) {
+            const QPair<QString, int>& fragment = fragments->at(fragmentPos++);
+            if (elementSignature.contains(fragment.first)) {
+                result.append(jqueryEvents.at(fragment.second)->selector);
             }
-
+        } else {
+            result.append(jqueryEvents.at(exact->at(exactPos++))->selector);
         }
     }
 
@@ -92,7 +104,16 @@ void JQueryListener::slEventAdded(QString elementSignature, QString event, QStri
     QStringList parts = event.split(QString("."));
     e->event = parts[0];
 
+    int index = jqueryEvents.size();
     jqueryEvents.append(e);
+
+    if (elementSignature.contains(QString("#document-fragment"))) {
+        QString trimmed = QString(elementSignature).replace(QString("#document-fragment"), QString(""));
+        mFragmentIndex[e->event].append(QPair<QString, int>(trimmed, index));
+    } else {
+        mExactIndex[e->event][elementSignature].append(index);
+    }
+
     qDebug() << "Jquery::Eventhandler registered for event " << event << " and selector " << selector << " on dom node with signature " << elementSignature << endl;
 }
 
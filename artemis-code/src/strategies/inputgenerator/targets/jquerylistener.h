@@ -16,6 +16,9 @@
 
 #include <QObject>
 #include <QList>
+#include <QHash>
+#include <QPair>
+#include <QString>
 
 #ifndef JQUERYLISTENER_H
 #define JQUERYLISTENER_H
@@ -41,6 +44,12 @@ public:
 protected:
     QList<jqueryEvent*> jqueryEvents;
 
+    // Indexes into jqueryEvents, so lookup does not have to scan every registered handler.
+    // event -> element signature -> indices of handlers registered with exactly that signature
+    QHash<QString, QHash<QString, QList<int> > > mExactIndex;
+    // event -> (signature with #document-fragment removed, index) for handlers registered outside the document
+    QHash<QString, QList<QPair<QString, int> > > mFragmentIndex;
+
 public slots:
     void slEventAdded(QString elementSignature, QString event, QString selector);
 };
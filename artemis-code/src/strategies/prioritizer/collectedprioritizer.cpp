@@ -39,4 +39,15 @@ void CollectedPrioritizer::addPrioritizer(PrioritizerStrategy* strategy){
     strategies->push_front(strategy);
 }
 
+bool CollectedPrioritizer::isStable() const
+{
+    list<PrioritizerStrategy*>::const_iterator iter;
+    for(iter = strategies->begin(); iter != strategies->end(); iter++){
+        if (!(*iter)->isStable()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 }
@@ -13,6 +13,7 @@ public:
     double prioritize(QSharedPointer<const ExecutableConfiguration> newConf,
                       AppModelConstPtr);
     void addPrioritizer(PrioritizerStrategy* strategy);
+    bool isStable() const;
 private:
     list<PrioritizerStrategy*>* strategies;
 };
@@ -34,6 +34,12 @@ public:
 
     virtual double prioritize(QSharedPointer<const ExecutableConfiguration> newConf,
                               AppModelConstPtr appmodel) = 0;
+
+    // True if the priority of a configuration only changes when the coverage or the properties read and written of
+    // one of its inputs change. The worklist then only rescores the configurations with such an input.
+    virtual bool isStable() const {
+        return true;
+    }
 };
 
 typedef QSharedPointer<PrioritizerStrategy> PrioritizerStrategyPtr;
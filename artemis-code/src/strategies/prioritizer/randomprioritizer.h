@@ -30,6 +30,10 @@ public:
     double prioritize(QSharedPointer<const ExecutableConfiguration> newConf,
                       AppModelConstPtr);
 
+    bool isStable() const {
+        return false;
+    }
+
 };
 
 }
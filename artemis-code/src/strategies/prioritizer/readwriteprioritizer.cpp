@@ -19,6 +19,7 @@
 #include <QSharedPointer>
 #include <QList>
 #include <QString>
+#include <QBitArray>
 
 #include "readwriteprioritizer.h"
 
@@ -36,18 +37,16 @@ double ReadWritePrioritizer::prioritize(QSharedPointer<const ExecutableConfigura
         return 0;
     }
 
-    QList<QSharedPointer<const BaseInput> > inputSequence = configuration->getInputSequence()->toList();
-    QSharedPointer<const BaseInput> last = inputSequence.last();
-    inputSequence.removeLast();
+    InputSequenceConstPtr inputSequence = configuration->getInputSequence();
+    QSharedPointer<const BaseInput> last = inputSequence->getLast();
 
-    QSet<QString> propertiesReadByLast = appmodel->getJavascriptStatistics()->getPropertiesRead(last);
-    QSet<QString> properitesWrittenBeforeLast;
+    QBitArray propertiesReadByLast = appmodel->getJavascriptStatistics()->getPropertyIdsRead(last);
+    QBitArray properitesWrittenBeforeLast = appmodel->getJavascriptStatistics()->getPropertyIdsWritten(inputSequence->removeLast());
 
-    foreach(QSharedPointer<const BaseInput> input, inputSequence) {
-        properitesWrittenBeforeLast.unite(appmodel->getJavascriptStatistics()->getPropertiesWritten(input));
-    }
+    // Only the properties read by last matter for the intersection.
+    properitesWrittenBeforeLast.resize(propertiesReadByLast.size());
 
-    return float(properitesWrittenBeforeLast.intersect(propertiesReadByLast).size() + 1) / float(propertiesReadByLast.size() + 1);
+    return float((properitesWrittenBeforeLast & propertiesReadByLast).count(true) + 1) / float(propertiesReadByLast.count(true) + 1);
 }
 
 }
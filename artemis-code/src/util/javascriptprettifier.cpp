@@ -0,0 +1,371 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "javascriptprettifier.h"
+
+namespace artemis
+{
+
+static const int INDENT_WIDTH = 4;
+
+PrettifyMappingPtr JavaScriptPrettifier::prettify(const QString& source)
+{
+    JavaScriptPrettifier prettifier(source);
+
+    if (!prettifier.run()) {
+        return PrettifyMappingPtr();
+    }
+
+    return PrettifyMappingPtr(new PrettifyMapping(source, prettifier.mOutput,
+                                                  prettifier.mSegmentPrettyOffsets, prettifier.mSegmentOriginalOffsets));
+}
+
+JavaScriptPrettifier::JavaScriptPrettifier(const QString& source)
+    : mSource(source)
+    , mIndent(0)
+    , mPendingNewline(false)
+{
+    mOutput.reserve(source.length() + source.length() / 4);
+}
+
+bool JavaScriptPrettifier::run()
+{
+    const int length = mSource.length();
+
+    // Open parentheses in each enclosing brace, so the ';' in for(;;) does not break the line.
+    QVector<int> parenDepth;
+    parenDepth.append(0);
+
+    // Whether each open parenthesis holds the condition of an if, while, for or with. After such a ')' a statement
+    // follows, so a '/' starts a regular expression. After any other ')' it is a division.
+    QVector<bool> parenIsCondition;
+    bool afterConditionKeyword = false;
+
+    bool regexAllowed = true;
+    int i = 0;
+
+    while (i < length) {
+        QChar c = mSource.at(i);
+        QChar next = i + 1 < length ? mSource.at(i + 1) : QChar();
+
+        // Whitespace
+
+        if (isWhitespace(c) || isLineTerminator(c)) {
+            int j = i;
+            while (j < length && (isWhitespace(mSource.at(j)) || isLineTerminator(mSource.at(j)))) {
+                j++;
+            }
+            whitespace(i, j);
+            i = j;
+            continue;
+        }
+
+        // Comments
+
+        if (c == '/' && next == '/') {
+            int j = i + 2;
+            while (j < length && !isLineTerminator(mSource.at(j))) {
+                j++;
+            }
+            copy(i, j);
+            i = j;
+            continue;
+        }
+
+        if (c == '/' && next == '*') {
+            int j = mSource.indexOf("*/", i + 2);
+            if (j < 0) {
+                return false;
+            }
+            copy(i, j + 2);
+            i = j + 2;
+            continue;
+        }
+
+        // Constructs we do not tokenize, leave these scripts alone.
+
+        if (c == '`' || mSource.midRef(i, 4) == QLatin1String("<!--") || mSource.midRef(i, 3) == QLatin1String("-->")) {
+            return false;
+        }
+
+        // String literals
+
+        if (c == '"' || c == '\'') {
+            int j = i + 1;
+            while (true) {
+                if (j >= length || isLineTerminator(mSource.at(j))) {
+                    return false;
+                }
+                if (mSource.at(j) == '\\') {
+                    j += (j + 2 < length && mSource.at(j + 1) == '\r' && mSource.at(j + 2) == '\n') ? 3 : 2;
+                } else if (mSource.at(j) == c) {
+                    j++;
+                    break;
+                } else {
+                    j++;
+                }
+            }
+            copy(i, j);
+            i = j;
+            regexAllowed = false;
+            afterConditionKeyword = false;
+            continue;
+        }
+
+        // Regular expression literals
+
+        if (c == '/' && regexAllowed) {
+            int j = i + 1;
+            bool inClass = false;
+            while (true) {
+                if (j >= length || isLineTerminator(mSource.at(j))) {
+                    return false;
+                }
+                QChar d = mSource.at(j);
+                if (d == '\\') {
+                    j += 2;
+                    continue;
+                }
+                j++;
+                if (d == '[') {
+                    inClass = true;
+                } else if (d == ']') {
+                    inClass = false;
+                } else if (d == '/' && !inClass) {
+                    break;
+                }
+            }
+            while (j < length && isIdentifierChar(mSource.at(j))) {
+                j++; // flags
+            }
+            copy(i, j);
+            i = j;
+            regexAllowed = false;
+            afterConditionKeyword = false;
+            continue;
+        }
+
+        // Identifiers, keywords and numbers
+
+        if (isIdentifierChar(c)) {
+            int j = i;
+            while (j < length && isIdentifierChar(mSource.at(j))) {
+                j++;
+            }
+            QString word = mSource.mid(i, j - i);
+            copy(i, j);
+            regexAllowed = keywordAllowsRegex(word);
+            afterConditionKeyword = word == "if" || word == "while" || word == "for" || word == "with";
+            i = j;
+            continue;
+        }
+
+        // Punctuators
+
+        bool conditionParen = afterConditionKeyword;
+        afterConditionKeyword = false;
+
+        if (c == '{') {
+            copy(i, i + 1);
+            mIndent++;
+            parenDepth.append(0);
+            mPendingNewline = nextSignificant(i + 1) != '}';
+            regexAllowed = true;
+            i++;
+            continue;
+        }
+
+        if (c == '}') {
+            if (parenDepth.size() <= 1) {
+                return false;
+            }
+            parenDepth.pop_back();
+            mIndent--;
+
+            // Closing braces always start their own line, except for empty blocks.
+            mPendingNewline = false;
+            if (!atLineStart() && lastSignificantOutput() != '{') {
+                newline(mIndent);
+            }
+            copy(i, i + 1);
+            i++;
+
+            // Break after the block if a new statement follows directly, but keep "} else", "});" etc. together.
+            int j = i;
+            while (j < length && isWhitespace(mSource.at(j))) {
+                j++;
+            }
+            int k = j;
+            while (k < length && isIdentifierChar(mSource.at(k))) {
+                k++;
+            }
+            QString word = mSource.mid(j, k - j);
+            if (!word.isEmpty() && word != "else" && word != "catch" && word != "finally" && word != "while") {
+                mPendingNewline = true;
+            }
+
+            regexAllowed = true;
+            continue;
+        }
+
+        if (c == ';') {
+            copy(i, i + 1);
+            if (parenDepth.last() == 0) {
+                mPendingNewline = true;
+            }
+            regexAllowed = true;
+            i++;
+            continue;
+        }
+
+        if ((c == '+' || c == '-') && next == c) {
+            copy(i, i + 2);
+            regexAllowed = false;
+            i += 2;
+            continue;
+        }
+
+        if (c == '(') {
+            parenDepth.last()++;
+            parenIsCondition.append(conditionParen);
+            copy(i, i + 1);
+            regexAllowed = true;
+            i++;
+            continue;
+        }
+
+        if (c == ')') {
+            if (parenIsCondition.isEmpty()) {
+                return false;
+            }
+            if (parenDepth.last() > 0) {
+                parenDepth.last()--;
+            }
+            copy(i, i + 1);
+            regexAllowed = parenIsCondition.last();
+            parenIsCondition.pop_back();
+            i++;
+            continue;
+        }
+
+        copy(i, i + 1);
+        regexAllowed = c != ']';
+        i++;
+    }
+
+    return parenDepth.size() == 1 && parenIsCondition.isEmpty();
+}
+
+void JavaScriptPrettifier::copy(int from, int to)
+{
+    if (mPendingNewline) {
+        newline(mIndent);
+        mPendingNewline = false;
+    }
+
+    int delta = mOutput.length() - from;
+    if (mSegmentPrettyOffsets.isEmpty() || delta != mSegmentPrettyOffsets.last() - mSegmentOriginalOffsets.last()) {
+        mSegmentPrettyOffsets.append(mOutput.length());
+        mSegmentOriginalOffsets.append(from);
+    }
+
+    mOutput.append(mSource.midRef(from, to - from));
+}
+
+void JavaScriptPrettifier::newline(int level)
+{
+    mOutput.append(QChar('\n'));
+    mOutput.append(QString(INDENT_WIDTH * qMax(level, 0), QChar(' ')));
+}
+
+void JavaScriptPrettifier::whitespace(int from, int to)
+{
+    bool containsLineTerminator = false;
+    for (int i = from; i < to; i++) {
+        if (isLineTerminator(mSource.at(i))) {
+            containsLineTerminator = true;
+            break;
+        }
+    }
+
+    // A line break in the original is replaced by a (re-indented) line break before the next token, never removed.
+    if (containsLineTerminator) {
+        mPendingNewline = true;
+        return;
+    }
+
+    if (!mPendingNewline && !mOutput.isEmpty()) {
+        copy(from, to);
+    }
+}
+
+bool JavaScriptPrettifier::atLineStart() const
+{
+    for (int i = mOutput.length() - 1; i >= 0; i--) {
+        if (mOutput.at(i) == '\n') {
+            return true;
+        }
+        if (mOutput.at(i) != ' ') {
+            return false;
+        }
+    }
+    return true;
+}
+
+QChar JavaScriptPrettifier::lastSignificantOutput() const
+{
+    for (int i = mOutput.length() - 1; i >= 0; i--) {
+        if (mOutput.at(i) != ' ' && mOutput.at(i) != '\n') {
+            return mOutput.at(i);
+        }
+    }
+    return QChar();
+}
+
+QChar JavaScriptPrettifier::nextSignificant(int from) const
+{
+    for (int i = from; i < mSource.length(); i++) {
+        if (!isWhitespace(mSource.at(i)) && !isLineTerminator(mSource.at(i))) {
+            return mSource.at(i);
+        }
+    }
+    return QChar();
+}
+
+bool JavaScriptPrettifier::isIdentifierChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == '_' || c == '$' || c == '\\';
+}
+
+bool JavaScriptPrettifier::isLineTerminator(QChar c)
+{
+    return c == '\n' || c == '\r' || c.unicode() == 0x2028 || c.unicode() == 0x2029;
+}
+
+bool JavaScriptPrettifier::isWhitespace(QChar c)
+{
+    return c == ' ' || c == '\t' || c == '\v' || c == '\f' || c.unicode() == 0xFEFF ||
+           (c.category() == QChar::Separator_Space);
+}
+
+bool JavaScriptPrettifier::keywordAllowsRegex(const QString& word)
+{
+    return word == "return" || word == "typeof" || word == "instanceof" || word == "in" || word == "of" ||
+           word == "new" || word == "delete" || word == "void" || word == "throw" || word == "case" ||
+           word == "do" || word == "else" || word == "yield";
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JAVASCRIPTPRETTIFIER_H
+#define JAVASCRIPTPRETTIFIER_H
+
+#include <QString>
+#include <QVector>
+
+#include "model/coverage/prettifymapping.h"
+
+namespace artemis
+{
+
+/**
+ * A small, conservative JavaScript pretty-printer, used in place of the js-beautify based prettify proxy.
+ *
+ * It only breaks lines after '{', ';' (outside parentheses) and around '}', and re-indents existing line breaks.
+ * Whitespace is the only thing ever changed, and a line break is never removed, so automatic semicolon insertion
+ * behaves exactly as in the original.
+ *
+ * A '/' starts a regular expression where an expression may start, including after the ')' closing the condition of
+ * an if, while, for or with. Scripts which the tokenizer cannot handle safely (unterminated literals, template strings,
+ * unbalanced braces or parentheses, HTML comments) are not modified and a null mapping is returned.
+ */
+class JavaScriptPrettifier
+{
+public:
+    static PrettifyMappingPtr prettify(const QString& source);
+
+protected:
+    JavaScriptPrettifier(const QString& source);
+
+    bool run();
+
+    void copy(int from, int to);
+    void newline(int level);
+    void whitespace(int from, int to);
+
+    bool atLineStart() const;
+    QChar lastSignificantOutput() const;
+    QChar nextSignificant(int from) const;
+
+    static bool isIdentifierChar(QChar c);
+    static bool isLineTerminator(QChar c);
+    static bool isWhitespace(QChar c);
+    static bool keywordAllowsRegex(const QString& word);
+
+    const QString& mSource;
+    QString mOutput;
+
+    QVector<int> mSegmentPrettyOffsets;
+    QVector<int> mSegmentOriginalOffsets;
+
+    int mIndent;
+    bool mPendingNewline;
+};
+
+}
+
+#endif // JAVASCRIPTPRETTIFIER_H
@@ -1,57 +1,361 @@
 #!/usr/bin/env python
 
-import sys
+"""
+Crawls a list of sites with Artemis, keeping several Artemis processes busy at once.
+
+Usage:
+    run.py <alexalist.csv> <top-x-sites> <iterations> [options] [-- <extra artemis arguments>]
+    run.py --fixtures ../system/fixtures <iterations> [options] [-- <extra artemis arguments>]
+
+Each site is run in its own output directory (so coverage reports etc. do not clash) under a wall-clock and
+memory budget. A site which crashes, hangs or runs out of memory is retried, and quarantined once it has used up
+its retries. Quarantined sites are remembered in a file and skipped by later crawls, until they are removed from it.
+
+When the crawl is done, the Artemis statistics (including the coverage) of every site are collected into
+summary.json and summary.csv in the output directory.
+
+With --fixtures the crawl runs fully offline: every .html page under the given directory (e.g. the fixtures used by
+tests/system) is served by a local web server and crawled as a site.
+"""
+
+from __future__ import print_function
+
+import argparse
+import csv
+import json
+import multiprocessing
+import os
+import re
+import shutil
+import signal
 import subprocess
-import shlex
+import sys
+import threading
+import time
 
-if __name__ == '__main__':
-    failures = []
-    if len(sys.argv) < 4:
-        print 'Usage: %s <alexalist.csv> <top-x-sites> <iterations>' % sys.argv[0]
-        exit(1)
+try:
+    from http.server import HTTPServer, SimpleHTTPRequestHandler
+    from socketserver import ThreadingMixIn
+except ImportError:
+    from BaseHTTPServer import HTTPServer
+    from SimpleHTTPServer import SimpleHTTPRequestHandler
+    from SocketServer import ThreadingMixIn
 
-    top_x_sites = int(sys.argv[2])
-    iterations = int(sys.argv[3])
+ARTEMIS_EXEC = '/usr/local/bin/artemis'
 
-    success = 0
-    failure = 0
+STATS_START = '=== Statistics ==='
+STATS_END = '=== Statistics END ==='
+RE_STATS_LINE = re.compile(r'^(.*):(.*)$')
 
-    with open(sys.argv[1], 'r') as fp:
-        for line in fp:
+COVERAGE_KEY = 'WebKit::coverage::covered-unique'
 
-            if top_x_sites <= 0:
-                break
+# How often the workers are checked for timeouts and memory use.
+POLL_INTERVAL = 0.5
+
+
+class Site(object):
+
+    def __init__(self, index, url, key=None):
+        self.index = index
+        self.url = url
+        self.key = key or url  # Identifies the site in the quarantine file.
+        self.name = '%04d_%s' % (index, re.sub(r'[^A-Za-z0-9.-]+', '_', url.split('://', 1)[-1]).strip('_')[:80])
+        self.attempts = []  # One (status, runtime, peak memory in MB) per run.
+        self.statistics = {}
+
+    def status(self):
+        return self.attempts[-1][0] if self.attempts else 'not-run'
+
+
+class Worker(object):
+    """A single running Artemis process."""
+
+    def __init__(self, site, cmd, output_dir):
+        self.site = site
+        self.output_dir = output_dir
+        self.start = time.time()
+        self.peak_memory = 0
+        self.killed_for = None
+
+        if os.path.isdir(output_dir):
+            shutil.rmtree(output_dir)
+        os.makedirs(output_dir)
+
+        self.stdout = open(os.path.join(output_dir, 'stdout.txt'), 'wb')
+        # A new process group, so a hung Artemis can be killed together with anything it started.
+        self.process = subprocess.Popen(cmd, cwd=output_dir, stdout=self.stdout, stderr=subprocess.STDOUT,
+                                        preexec_fn=os.setsid)
+
+    def runtime(self):
+        return time.time() - self.start
+
+    def memory(self):
+        """The resident set size in MB, or 0 if it can not be read (e.g. the process has just exited)."""
+        try:
+            with open('/proc/%d/status' % self.process.pid) as status:
+                for line in status:
+                    if line.startswith('VmRSS:'):
+                        return int(line.split()[1]) // 1024
+        except (IOError, OSError, ValueError):
+            pass
+        return 0
+
+    def check_budget(self, timeout, memory_limit):
+        """Kills the process if it is over budget. Returns True while it is still running."""
+        if self.process.poll() is not None:
+            return False
+
+        self.peak_memory = max(self.peak_memory, self.memory())
+
+        if timeout and self.runtime() > timeout:
+            self.kill('timeout')
+        elif memory_limit and self.peak_memory > memory_limit:
+            self.kill('memory')
+
+        return self.process.poll() is None
+
+    def kill(self, reason):
+        self.killed_for = reason
+        try:
+            os.killpg(self.process.pid, signal.SIGKILL)
+        except OSError:
+            pass
+        self.process.wait()
+
+    def finish(self):
+        self.stdout.close()
+
+        if self.killed_for is not None:
+            status = self.killed_for
+        elif self.process.returncode == 0:
+            status = 'success'
+        else:
+            status = 'crash'
+
+        self.site.attempts.append((status, round(self.runtime(), 1), self.peak_memory))
+        if status == 'success':
+            self.site.statistics = read_statistics(os.path.join(self.output_dir, 'stdout.txt'))
+
+        return status
+
+
+def read_statistics(stdout_file):
+    with open(stdout_file, 'rb') as fp:
+        stdout = fp.read().decode('utf-8', 'replace')
+
+    start = stdout.find(STATS_START)
+    end = stdout.find(STATS_END)
+    if start < 0 or end < 0:
+        return {}
+
+    report = {}
+    for line in stdout[start + len(STATS_START):end].splitlines():
+        match = RE_STATS_LINE.match(line)
+        if match is not None:
+            key = match.group(1).strip()
+            value = match.group(2).strip()
+            try:
+                value = int(value.replace(' ', ''))
+            except ValueError:
+                try:
+                    value = float(value)
+                except ValueError:
+                    pass
+            report[key] = value
+    return report
+
+
+class QuietRequestHandler(SimpleHTTPRequestHandler):
+
+    def log_message(self, format, *args):
+        pass
 
-            top_x_sites -= 1
 
-            index, url = line.split(',')
+class ThreadingHTTPServer(ThreadingMixIn, HTTPServer):
+    daemon_threads = True
+
+
+def serve_fixtures(root):
+    """Serves the fixtures directory on a free local port, returns the base URL and the server."""
+    os.chdir(root)
+    server = ThreadingHTTPServer(('localhost', 0), QuietRequestHandler)
+    thread = threading.Thread(target=server.serve_forever)
+    thread.daemon = True
+    thread.start()
+    return 'http://localhost:%d/' % server.server_address[1], server
+
+
+def fixture_sites(root, base_url):
+    pages = []
+    for directory, dirnames, filenames in os.walk(root):
+        dirnames.sort()
+        for filename in sorted(filenames):
+            if filename.endswith('.html') or filename.endswith('.htm'):
+                pages.append(os.path.relpath(os.path.join(directory, filename), root))
+    # The port of the server changes between crawls, so fixtures are quarantined by their path.
+    return [Site(i + 1, base_url + page.replace(os.sep, '/'), page.replace(os.sep, '/')) for i, page in enumerate(pages)]
+
+
+def alexa_sites(site_list, top_x_sites):
+    sites = []
+    with open(site_list, 'r') as fp:
+        for line in fp:
+            if len(sites) >= top_x_sites:
+                break
+            if not line.strip():
+                continue
+            index, url = line.split(',', 1)
             url = url.strip()
-            print '=========================='
-            print 'Visit %s' % url
-            print '=========================='
-            print ''
-
-            cmd = '/usr/local/bin/artemis http://%s/ -i %s > /dev/null 2>/dev/null' % (url, iterations)
-            process = subprocess.Popen(shlex.split(cmd))
-            process.wait()
-
-            print '=========================='
-
-            if process.returncode == 0:
-                print ' success'
-                success += 1
-            else:
-                failures.append(url)
-                print ' failed'
-                failure += 1
-
-                print '=========================='
-                print ''
-
-    print 'Statistics'
-    print 'Success: %s' % success
-    print 'Failure: %s' % failure
-    if failure > 0:
-        print 'Failed sites'
-        for f in failures:
-            print "  %s" % f
+            if '://' not in url:
+                url = 'http://%s/' % url
+            sites.append(Site(int(index), url))
+    return sites
+
+
+def load_quarantine(filename):
+    if filename is None or not os.path.exists(filename):
+        return set()
+    with open(filename) as fp:
+        return set(line.strip() for line in fp if line.strip())
+
+
+def crawl(sites, args, extra_args):
+    queue = list(sites)
+    running = []
+
+    def log(message):
+        print('[%s] %s' % (time.strftime('%H:%M:%S'), message))
+        sys.stdout.flush()
+
+    while queue or running:
+        while queue and len(running) < args.workers:
+            site = queue.pop(0)
+            cmd = [args.artemis, site.url, '-i', str(args.iterations)] + extra_args
+            output_dir = os.path.join(args.output, site.name)
+            log('Start %s (attempt %d)' % (site.url, len(site.attempts) + 1))
+            running.append(Worker(site, cmd, output_dir))
+
+        time.sleep(POLL_INTERVAL)
+
+        for worker in list(running):
+            if worker.check_budget(args.timeout, args.memory):
+                continue
+
+            running.remove(worker)
+            status = worker.finish()
+            site = worker.site
+            log('%s %s after %.1fs, %dMB' % (status.capitalize(), site.url, worker.runtime(), worker.peak_memory))
+
+            if status != 'success':
+                if len(site.attempts) <= args.retries:
+                    queue.append(site)
+                else:
+                    log('Quarantined %s' % site.url)
+
+
+def write_summary(sites, output):
+    results = []
+    for site in sites:
+        results.append({
+            'url': site.url,
+            'output': site.name,
+            'status': site.status(),
+            'attempts': [{'status': a[0], 'runtime': a[1], 'memory': a[2]} for a in site.attempts],
+            'coverage': site.statistics.get(COVERAGE_KEY),
+            'statistics': site.statistics,
+        })
+
+    with open(os.path.join(output, 'summary.json'), 'w') as fp:
+        json.dump(results, fp, indent=2, sort_keys=True)
+
+    keys = sorted(set(key for site in sites for key in site.statistics))
+    with open(os.path.join(output, 'summary.csv'), 'w') as fp:
+        writer = csv.writer(fp)
+        writer.writerow(['Site', 'Status', 'Attempts', 'Runtime', 'Peak memory (MB)'] + keys)
+        for site in sites:
+            last = site.attempts[-1] if site.attempts else ('not-run', '', '')
+            writer.writerow([site.url, site.status(), len(site.attempts), last[1], last[2]] +
+                            [site.statistics.get(key, '') for key in keys])
+
+
+def main():
+    argv = sys.argv[1:]
+    extra_args = []
+    if '--' in argv:
+        extra_args = argv[argv.index('--') + 1:]
+        argv = argv[:argv.index('--')]
+
+    parser = argparse.ArgumentParser(description='Crawls a list of sites with several Artemis processes at once.')
+    parser.add_argument('arguments', nargs='+', metavar='ARG',
+                        help='<alexalist.csv> <top-x-sites> <iterations>, or just <iterations> with --fixtures.')
+    parser.add_argument('--fixtures', metavar='DIR',
+                        help='Crawl every .html page under DIR from a local web server instead of the site list.')
+    parser.add_argument('-j', '--workers', type=int, default=multiprocessing.cpu_count(),
+                        help='The number of Artemis processes to run at once. Default: the number of cores.')
+    parser.add_argument('--timeout', type=float, default=600, metavar='SECONDS',
+                        help='Wall-clock budget per site, 0 for none. Default: 600.')
+    parser.add_argument('--memory', type=int, default=4096, metavar='MB',
+                        help='Resident memory budget per site, 0 for none. Default: 4096.')
+    parser.add_argument('--retries', type=int, default=1,
+                        help='How often a crashed, hung or out of memory site is retried before it is quarantined.')
+    parser.add_argument('--quarantine', metavar='FILE',
+                        help='Skip the sites listed in FILE, and add newly quarantined sites to it.')
+    parser.add_argument('--output', default='crawl-%s' % time.strftime('%Y-%m-%d_%H-%M-%S'),
+                        help='Directory for the per-site output and the summary.')
+    parser.add_argument('--artemis', default=ARTEMIS_EXEC, help='The Artemis executable.')
+    args = parser.parse_args(argv)
+
+    if args.fixtures:
+        if len(args.arguments) != 1:
+            parser.error('expected <iterations> with --fixtures')
+        args.iterations = int(args.arguments[0])
+    else:
+        if len(args.arguments) != 3:
+            parser.error('expected <alexalist.csv> <top-x-sites> <iterations>')
+        args.iterations = int(args.arguments[2])
+
+    args.workers = max(1, args.workers)
+    args.output = os.path.abspath(args.output)
+    args.artemis = os.path.abspath(args.artemis) if os.path.exists(args.artemis) else args.artemis
+    if args.quarantine:
+        args.quarantine = os.path.abspath(args.quarantine)
+
+    if args.fixtures:
+        base_url, server = serve_fixtures(os.path.abspath(args.fixtures))
+        sites = fixture_sites(os.getcwd(), base_url)
+    else:
+        sites = alexa_sites(args.arguments[0], int(args.arguments[1]))
+
+    quarantined = load_quarantine(args.quarantine)
+    skipped = [site for site in sites if site.key in quarantined]
+    sites = [site for site in sites if site.key not in quarantined]
+    if skipped:
+        print('Skipping %d quarantined site(s)' % len(skipped))
+
+    if not os.path.isdir(args.output):
+        os.makedirs(args.output)
+
+    crawl(sites, args, extra_args)
+    write_summary(sites, args.output)
+
+    failed = [site for site in sites if site.status() != 'success']
+    if args.quarantine and failed:
+        with open(args.quarantine, 'a') as fp:
+            for site in failed:
+                fp.write(site.key + '\n')
+
+    print('==========================')
+    print('Statistics')
+    print('Success: %d' % (len(sites) - len(failed)))
+    print('Failure: %d' % len(failed))
+    if failed:
+        print('Quarantined sites')
+        for site in failed:
+            print('  %s (%s)' % (site.url, ', '.join(a[0] for a in site.attempts)))
+    print('Summary written to %s' % args.output)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,50 @@
+
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+CONFIG += static
+
+LIBS += -pthread
+
+DEFINES += ARTEMIS=1
+
+LIBS += ../../../WebKit/WebKitBuild/Release/lib/libQtWebKit.so
+LIBS += -lqjson
+LIBS += -lqhttpserver
+
+INCLUDEPATH += ../../../WebKit/WebKitBuild/Release/include/ \
+    ../../../WebKit/WebKitBuild/Release/include/QtWebKit/ \
+    ../../../WebKit/Source/JavaScriptCore/runtime/ \
+    ../../../WebKit/Source/JavaScriptCore/ \
+    ../../../WebKit/Source/WebCore/ \
+    ../../../WebKit/Source/WTF/ \
+    ../../../WebKit/Source/ \
+    ../../src/ \
+    ../unit/
+
+VPATH += ../../
+
+include(../../artemis-core.pri)
+# Override some options set in artemis-core.pri, as gtest has some warnings.
+QMAKE_CXXFLAGS += -Wno-error
+
+QMAKE_LFLAGS += '-Wl,-rpath,\'$$PWD/../../../WebKit/WebKitBuild/Release/lib\''
+
+# The gtest sources are shared with the unit tests, the benchmarks only replace gtest_main.
+HEADERS += \
+    ../unit/include/gtest/gtest.h \
+    src/benchmark.h \
+    src/synthetictrees.h
+
+SOURCES += \
+    ../unit/src/gtest/gtest-all.cc \
+    src/benchmark.cpp \
+    src/benchmarkmain.cpp \
+    src/synthetictrees.cpp \
+    src/concolic/executiontree/tracemergerbenchmark.cpp \
+    src/concolic/search/randomaccesssearchbenchmark.cpp \
+    src/concolic/pathconditionbenchmark.cpp \
+    src/concolic/solver/cvc4constraintwriterbenchmark.cpp \
+    src/concolic/solver/cvc4regexcompilerbenchmark.cpp \
+    src/model/coverage/coveragelistenerbenchmark.cpp
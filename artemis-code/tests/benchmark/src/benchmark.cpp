@@ -0,0 +1,250 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <time.h>
+#include <stdio.h>
+
+#include <QDateTime>
+#include <QFile>
+#include <QThread>
+#include <QVariantMap>
+
+#include <qjson/serializer.h>
+
+#include "benchmark.h"
+
+namespace artemis
+{
+
+// Never run a body more often than this, even if it is too fast to measure.
+static const quint64 MAX_ITERATIONS = 1000000000;
+
+BenchmarkState::BenchmarkState(quint64 iterations, uint size)
+    : mIterations(iterations)
+    , mRemaining(iterations)
+    , mSize(size)
+    , mItemsProcessed(0)
+    , mStarted(false)
+    , mRunning(false)
+    , mRealNanoseconds(0)
+    , mCpuStart(0)
+    , mCpuNanoseconds(0)
+{
+}
+
+bool BenchmarkState::keepRunning()
+{
+    if (!mStarted) {
+        mStarted = true;
+        resumeTiming();
+    }
+
+    if (mRemaining == 0) {
+        pauseTiming();
+        return false;
+    }
+
+    mRemaining--;
+    return true;
+}
+
+void BenchmarkState::pauseTiming()
+{
+    if (!mRunning) {
+        return;
+    }
+
+    mRealNanoseconds += mRealTimer.nsecsElapsed();
+    mCpuNanoseconds += cpuNow() - mCpuStart;
+    mRunning = false;
+}
+
+void BenchmarkState::resumeTiming()
+{
+    if (mRunning) {
+        return;
+    }
+
+    mRunning = true;
+    mCpuStart = cpuNow();
+    mRealTimer.start();
+}
+
+uint BenchmarkState::size() const
+{
+    return mSize;
+}
+
+void BenchmarkState::setItemsProcessed(quint64 items)
+{
+    mItemsProcessed = items;
+}
+
+quint64 BenchmarkState::getIterations() const
+{
+    return mIterations;
+}
+
+quint64 BenchmarkState::getItemsProcessed() const
+{
+    return mItemsProcessed;
+}
+
+qint64 BenchmarkState::getRealNanoseconds() const
+{
+    return mRealNanoseconds;
+}
+
+qint64 BenchmarkState::getCpuNanoseconds() const
+{
+    return mCpuNanoseconds;
+}
+
+qint64 BenchmarkState::cpuNow()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return (qint64)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+
+QList<uint> Benchmark::mSizes = QList<uint>() << 1000;
+uint Benchmark::mDepth = 32;
+uint Benchmark::mSeed = 1;
+double Benchmark::mMinTime = 0.5;
+QString Benchmark::mOutputFile;
+QVariantList Benchmark::mResults;
+
+void Benchmark::run(const QString& name, std::function<void (BenchmarkState&)> body)
+{
+    foreach (uint size, mSizes) {
+        QString runName = QString("%1/%2").arg(name).arg(size);
+
+        // Same strategy as Google Benchmark: grow the iteration count (by at most 10x) until a run takes long enough.
+        quint64 iterations = 1;
+        while (true) {
+            BenchmarkState state(iterations, size);
+            body(state);
+
+            double seconds = state.getRealNanoseconds() / 1e9;
+            if (seconds >= mMinTime || iterations >= MAX_ITERATIONS) {
+                double realTime = (double)state.getRealNanoseconds() / iterations;
+                double cpuTime = (double)state.getCpuNanoseconds() / iterations;
+
+                QVariantMap result;
+                result.insert("name", runName);
+                result.insert("run_name", runName);
+                result.insert("run_type", "iteration");
+                result.insert("iterations", iterations);
+                result.insert("real_time", realTime);
+                result.insert("cpu_time", cpuTime);
+                result.insert("time_unit", "ns");
+                result.insert("size", size);
+                if (state.getItemsProcessed() > 0 && state.getCpuNanoseconds() > 0) {
+                    result.insert("items_per_second", state.getItemsProcessed() * 1e9 / state.getCpuNanoseconds());
+                }
+                mResults.append(result);
+
+                printf("%-60s %15.0f ns %15.0f ns %12llu\n", runName.toStdString().c_str(), realTime, cpuTime, iterations);
+                fflush(stdout);
+                break;
+            }
+
+            double multiplier = seconds <= mMinTime / 10 ? 10 : mMinTime * 1.4 / seconds;
+            iterations = qMin(MAX_ITERATIONS, qMax(iterations + 1, (quint64)(iterations * multiplier)));
+        }
+    }
+}
+
+QList<uint> Benchmark::sizes()
+{
+    return mSizes;
+}
+
+uint Benchmark::depth()
+{
+    return mDepth;
+}
+
+uint Benchmark::seed()
+{
+    return mSeed;
+}
+
+void Benchmark::setSizes(const QList<uint>& sizes)
+{
+    mSizes = sizes;
+}
+
+void Benchmark::setDepth(uint depth)
+{
+    mDepth = depth;
+}
+
+void Benchmark::setSeed(uint seed)
+{
+    mSeed = seed;
+}
+
+void Benchmark::setMinTime(double seconds)
+{
+    mMinTime = seconds;
+}
+
+void Benchmark::setOutputFile(const QString& path)
+{
+    mOutputFile = path;
+}
+
+bool Benchmark::writeResults(const QString& executable)
+{
+    if (mOutputFile.isEmpty()) {
+        return true;
+    }
+
+    QVariantList sizes;
+    foreach (uint size, mSizes) {
+        sizes.append(size);
+    }
+
+    QVariantMap context;
+    context.insert("date", QDateTime::currentDateTime().toString(Qt::ISODate));
+    context.insert("executable", executable);
+    context.insert("build_commit", QString(EXE_BUILD_COMMIT));
+    context.insert("num_cpus", QThread::idealThreadCount());
+    context.insert("sizes", sizes);
+    context.insert("depth", mDepth);
+    context.insert("seed", mSeed);
+
+    QVariantMap report;
+    report.insert("context", context);
+    report.insert("benchmarks", mResults);
+
+    QJson::Serializer serializer;
+    bool ok;
+    QByteArray json = serializer.serialize(report, &ok);
+
+    QFile file(mOutputFile);
+    if (!ok || !file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    file.write(json);
+    file.close();
+    return true;
+}
+
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <functional>
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+#include <QVariantList>
+
+namespace artemis
+{
+
+/**
+ * The timing state passed to a benchmark body, in the style of Google Benchmark:
+ *
+ *     Benchmark::run("Name", [](BenchmarkState& state) {
+ *         // setup
+ *         while (state.keepRunning()) {
+ *             // measured code
+ *         }
+ *     });
+ *
+ * Work which must be redone for each iteration but should not be measured goes between pauseTiming() and
+ * resumeTiming().
+ */
+class BenchmarkState
+{
+public:
+    BenchmarkState(quint64 iterations, uint size);
+
+    bool keepRunning();
+
+    void pauseTiming();
+    void resumeTiming();
+
+    // The problem size this run was started with (see Benchmark::sizes()).
+    uint size() const;
+
+    // Optional, used to report a throughput (e.g. traces merged per second) along with the time per iteration.
+    void setItemsProcessed(quint64 items);
+
+    quint64 getIterations() const;
+    quint64 getItemsProcessed() const;
+    qint64 getRealNanoseconds() const;
+    qint64 getCpuNanoseconds() const;
+
+protected:
+    static qint64 cpuNow();
+
+    quint64 mIterations;
+    quint64 mRemaining;
+    uint mSize;
+    quint64 mItemsProcessed;
+
+    bool mStarted;
+    bool mRunning;
+
+    QElapsedTimer mRealTimer;
+    qint64 mRealNanoseconds;
+    qint64 mCpuStart;
+    qint64 mCpuNanoseconds;
+};
+
+/**
+ * Runs benchmark bodies with an increasing number of iterations until they take at least the minimum time, and
+ * collects the results so they can be written as JSON (in the same layout as Google Benchmark's --benchmark_out).
+ *
+ * The benchmarks themselves are gtest tests, so they can be selected with --gtest_filter and use the gtest
+ * assertions to check that the measured code did what was expected.
+ */
+class Benchmark
+{
+public:
+    static void run(const QString& name, std::function<void (BenchmarkState&)> body);
+
+    // Configuration, set from the command line in benchmarkmain.cpp.
+    static QList<uint> sizes();
+    static uint depth();
+    static uint seed();
+
+    static void setSizes(const QList<uint>& sizes);
+    static void setDepth(uint depth);
+    static void setSeed(uint seed);
+    static void setMinTime(double seconds);
+    static void setOutputFile(const QString& path);
+
+    static bool writeResults(const QString& executable);
+
+private:
+    static QList<uint> mSizes;
+    static uint mDepth;
+    static uint mSeed;
+    static double mMinTime;
+    static QString mOutputFile;
+
+    static QVariantList mResults;
+};
+
+}
+
+#endif // BENCHMARK_H
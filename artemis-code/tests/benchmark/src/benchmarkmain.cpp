@@ -0,0 +1,111 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+
+#include <QString>
+#include <QStringList>
+
+#include "include/gtest/gtest.h"
+
+#include "benchmark.h"
+
+using namespace std;
+
+namespace
+{
+
+void usage()
+{
+    cout << "Usage: benchmark [gtest options] [options]\n"
+            "\n"
+            "--benchmark_out=<file>       : Write the results to <file> as JSON.\n"
+            "--benchmark_size=<n>[,<n>..] : Problem sizes to run each benchmark with, e.g. the number of traces\n"
+            "                               merged into the execution tree. Default: 1000.\n"
+            "--benchmark_depth=<n>        : Number of symbolic branches in each synthetic trace. Default: 32.\n"
+            "--benchmark_seed=<n>         : Seed for the synthetic traces. The same seed always replays the same\n"
+            "                               sequence of traces. Default: 1.\n"
+            "--benchmark_min_time=<s>     : Minimum time in seconds to run each benchmark for. Default: 0.5.\n"
+            "\n"
+            "Use --gtest_filter to select benchmarks, e.g. --gtest_filter=TraceMergerBenchmark.*\n";
+}
+
+bool parseUint(const QString& value, uint* result)
+{
+    bool ok;
+    *result = value.toUInt(&ok);
+    return ok && *result > 0;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv); // Removes the gtest options from argv.
+
+    for (int i = 1; i < argc; i++) {
+        QString arg = QString::fromLocal8Bit(argv[i]);
+        QString value = arg.section('=', 1);
+        bool valid = true;
+        uint number;
+
+        if (arg.startsWith("--benchmark_out=")) {
+            artemis::Benchmark::setOutputFile(value);
+
+        } else if (arg.startsWith("--benchmark_size=")) {
+            QList<uint> sizes;
+            foreach (QString size, value.split(',')) {
+                valid = valid && parseUint(size, &number);
+                sizes.append(number);
+            }
+            artemis::Benchmark::setSizes(sizes);
+
+        } else if (arg.startsWith("--benchmark_depth=")) {
+            valid = parseUint(value, &number);
+            artemis::Benchmark::setDepth(number);
+
+        } else if (arg.startsWith("--benchmark_seed=")) {
+            valid = parseUint(value, &number);
+            artemis::Benchmark::setSeed(number);
+
+        } else if (arg.startsWith("--benchmark_min_time=")) {
+            double seconds = value.toDouble(&valid);
+            artemis::Benchmark::setMinTime(seconds);
+
+        } else if (arg == "--help" || arg == "-h") {
+            usage();
+            return 0;
+
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            cerr << "ERROR: Invalid benchmark option " << argv[i] << endl;
+            usage();
+            return 1;
+        }
+    }
+
+    int result = RUN_ALL_TESTS();
+
+    if (!artemis::Benchmark::writeResults(QString::fromLocal8Bit(argv[0]))) {
+        cerr << "ERROR: Could not write the benchmark results." << endl;
+        return 1;
+    }
+
+    return result;
+}
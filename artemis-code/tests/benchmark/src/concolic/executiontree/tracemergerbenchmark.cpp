@@ -0,0 +1,122 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "include/gtest/gtest.h"
+
+#include "concolic/executiontree/tracemerger.h"
+
+#include "benchmark.h"
+#include "synthetictrees.h"
+
+using namespace artemis;
+
+// The branch a concolic run which recorded `trace` was aimed at: the last branch on its path which is not explored in
+// the tree yet.
+static TraceSymbolicBranchPtr targetOf(TraceNodePtr tree, TraceNodePtr trace)
+{
+    TraceSymbolicBranchPtr target;
+    TraceNodePtr node = tree;
+
+    foreach (PathBranch branch, SyntheticTrees::branchesOf(trace)) {
+        while (!node.dynamicCast<TraceAnnotation>().isNull()) {
+            node = node.dynamicCast<TraceAnnotation>()->next;
+        }
+
+        TraceSymbolicBranchPtr treeBranch = node.dynamicCast<TraceSymbolicBranch>();
+        if (treeBranch.isNull()) {
+            break;
+        }
+
+        node = branch.second ? treeBranch->getTrueBranch() : treeBranch->getFalseBranch();
+        if (TraceVisitor::isImmediatelyUnexplored(node)) {
+            target = treeBranch;
+            break;
+        }
+    }
+
+    return target;
+}
+
+// Rebuilds the whole execution tree from the recorded traces, as a concolic run of that length does.
+TEST(TraceMergerBenchmark, Replay) {
+    Benchmark::run("TraceMerger_Replay", [](BenchmarkState& state) {
+        SyntheticTrees generator(Benchmark::depth(), Benchmark::seed());
+        quint64 merged = 0;
+
+        while (state.keepRunning()) {
+            state.pauseTiming();
+            QList<TraceNodePtr> traces;
+            for (uint i = 0; i < state.size(); i++) {
+                traces.append(generator.trace(i));
+            }
+            TraceMerger merger;
+            TraceNodePtr tree;
+            state.resumeTiming();
+
+            foreach (TraceNodePtr trace, traces) {
+                tree = merger.merge(trace, tree, &tree);
+            }
+            merged += traces.size();
+
+            ASSERT_FALSE(tree.isNull());
+        }
+
+        state.setItemsProcessed(merged);
+    });
+}
+
+// Merges one new trace into a tree which already holds size() traces.
+TEST(TraceMergerBenchmark, MergeIntoTree) {
+    Benchmark::run("TraceMerger_MergeIntoTree", [](BenchmarkState& state) {
+        SyntheticTrees generator(Benchmark::depth(), Benchmark::seed());
+        TraceNodePtr tree = generator.replay(state.size());
+        TraceMerger merger;
+        uint next = state.size();
+
+        while (state.keepRunning()) {
+            state.pauseTiming();
+            TraceNodePtr trace = generator.trace(next++);
+            state.resumeTiming();
+
+            tree = merger.merge(trace, tree, &tree);
+        }
+
+        state.setItemsProcessed(state.getIterations());
+    });
+}
+
+// As MergeIntoTree, but with the target the run was aimed at, as ConcolicAnalysis merges.
+TEST(TraceMergerBenchmark, MergeAtTarget) {
+    Benchmark::run("TraceMerger_MergeAtTarget", [](BenchmarkState& state) {
+        SyntheticTrees generator(Benchmark::depth(), Benchmark::seed());
+        TraceMerger merger;
+        TraceNodePtr tree;
+        for (uint i = 0; i < state.size(); i++) {
+            tree = merger.merge(generator.trace(i), tree, &tree); // Also builds the merger's index of the tree.
+        }
+        uint next = state.size();
+
+        while (state.keepRunning()) {
+            state.pauseTiming();
+            TraceNodePtr trace = generator.trace(next++);
+            TraceSymbolicBranchPtr target = targetOf(tree, trace);
+            state.resumeTiming();
+
+            tree = merger.merge(trace, tree, &tree, target);
+        }
+
+        state.setItemsProcessed(state.getIterations());
+    });
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "include/gtest/gtest.h"
+
+#include "concolic/pathcondition.h"
+
+#include "benchmark.h"
+#include "synthetictrees.h"
+
+using namespace artemis;
+
+// Builds the path conditions for size() different traces, the depth of each is set by --benchmark_depth.
+TEST(PathConditionBenchmark, CreateFromBranchList) {
+    Benchmark::run("PathCondition_CreateFromBranchList", [](BenchmarkState& state) {
+        SyntheticTrees generator(Benchmark::depth(), Benchmark::seed());
+
+        QList<TraceNodePtr> traces;
+        QList<PathBranchList> paths;
+        for (uint i = 0; i < state.size(); i++) {
+            traces.append(generator.trace(i)); // Keeps the branches in paths alive.
+            paths.append(SyntheticTrees::branchesOf(traces.last()));
+        }
+
+        while (state.keepRunning()) {
+            foreach (PathBranchList branches, paths) {
+                PathConditionPtr pc = PathCondition::createFromBranchList(branches);
+                ASSERT_EQ(Benchmark::depth(), pc->size());
+            }
+        }
+
+        state.setItemsProcessed(state.getIterations() * paths.size());
+    });
+}
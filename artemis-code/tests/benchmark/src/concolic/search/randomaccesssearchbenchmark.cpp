@@ -0,0 +1,37 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "include/gtest/gtest.h"
+
+#include "concolic/search/randomaccesssearch.h"
+#include "concolic/search/dfsselector.h"
+
+#include "benchmark.h"
+#include "synthetictrees.h"
+
+using namespace artemis;
+
+// Each call re-analyses the whole tree to find the open exploration targets, so this scales with the tree size.
+TEST(RandomAccessSearchBenchmark, ChooseNextTarget) {
+    Benchmark::run("RandomAccessSearch_ChooseNextTarget", [](BenchmarkState& state) {
+        SyntheticTrees generator(Benchmark::depth(), Benchmark::seed());
+        TraceNodePtr tree = generator.replay(state.size());
+        RandomAccessSearch search(tree, AbstractSelectorPtr(new DFSSelector()), 0);
+
+        while (state.keepRunning()) {
+            ASSERT_TRUE(search.chooseNextTarget());
+        }
+    });
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <QDir>
+
+#include "include/gtest/gtest.h"
+
+#include "concolic/solver/constraintwriter/cvc4.h"
+
+#include "benchmark.h"
+#include "synthetictrees.h"
+
+using namespace artemis;
+
+// Writes the constraints for size() different path conditions, as the solver does for each exploration attempt.
+TEST(CVC4ConstraintWriterBenchmark, Write) {
+    Benchmark::run("CVC4ConstraintWriter_Write", [](BenchmarkState& state) {
+        SyntheticTrees generator(Benchmark::depth(), Benchmark::seed());
+        std::string outputFile = QDir::temp().filePath("artemis-benchmark-cvc4input").toStdString();
+
+        QList<TraceNodePtr> traces;
+        QList<PathConditionPtr> pcs;
+        for (uint i = 0; i < state.size(); i++) {
+            traces.append(generator.trace(i)); // Keeps the branches referenced by the PCs alive.
+            pcs.append(PathCondition::createFromBranchList(SyntheticTrees::branchesOf(traces.last())));
+        }
+
+        FormRestrictions formRestrictions;
+        DomSnapshotStoragePtr domSnapshots = DomSnapshotStoragePtr(new DomSnapshotStorage());
+
+        while (state.keepRunning()) {
+            foreach (PathConditionPtr pc, pcs) {
+                CVC4ConstraintWriterPtr writer = CVC4ConstraintWriterPtr(new CVC4ConstraintWriter(ConcolicBenchmarkFeatures()));
+                ASSERT_TRUE(writer->write(pc, formRestrictions, domSnapshots, ReachablePathsConstraintSet(), ReorderingConstraintInfoPtr(), outputFile));
+            }
+        }
+
+        state.setItemsProcessed(state.getIterations() * pcs.size());
+    });
+}
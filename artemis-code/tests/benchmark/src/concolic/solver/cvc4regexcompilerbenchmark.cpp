@@ -0,0 +1,62 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "include/gtest/gtest.h"
+
+#include "concolic/solver/constraintwriter/cvc4regexcompiler.h"
+
+#include "benchmark.h"
+
+using namespace artemis;
+
+namespace
+{
+
+// Typical form validation patterns.
+const char* PATTERNS[] = {
+    "^[a-zA-Z]{3}$",
+    "^[0-9]{4}$",
+    "^[0-9]{1,2}/[0-9]{1,2}/[0-9]{4}$",
+    "^\\w+@\\w+\\.[a-z]{2,3}$",
+    "^[A-Z]{2}[0-9]{3,4}$",
+    "^(mr|mrs|ms|dr)$",
+    "^\\+?[0-9]{8,12}$",
+    "^[a-z0-9]+(-[a-z0-9]+)*$"
+};
+const uint NUM_PATTERNS = sizeof(PATTERNS) / sizeof(PATTERNS[0]);
+
+}
+
+// Compiles size() patterns, cycling through the list above.
+TEST(CVC4RegexCompilerBenchmark, Compile) {
+    for (uint i = 0; i < NUM_PATTERNS; i++) {
+        bool bol, eol = false;
+        ASSERT_NO_THROW(CVC4RegexCompiler::compile(PATTERNS[i], bol, eol)) << PATTERNS[i];
+    }
+
+    Benchmark::run("CVC4RegexCompiler_Compile", [](BenchmarkState& state) {
+        size_t length = 0;
+
+        while (state.keepRunning()) {
+            for (uint i = 0; i < state.size(); i++) {
+                bool bol, eol = false;
+                length += CVC4RegexCompiler::compile(PATTERNS[i % NUM_PATTERNS], bol, eol).size();
+            }
+        }
+
+        ASSERT_LT((size_t)0, length);
+        state.setItemsProcessed(state.getIterations() * state.size());
+    });
+}
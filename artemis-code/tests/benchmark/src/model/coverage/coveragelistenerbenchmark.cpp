@@ -0,0 +1,71 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <QSource>
+#include <QWebExecutionListener>
+
+#include "include/gtest/gtest.h"
+
+#include "model/coverage/coveragelistener.h"
+
+#include "benchmark.h"
+
+using namespace artemis;
+
+namespace
+{
+
+// Number of bytecodes executed per function call.
+const uint BYTECODES_PER_CALL = 16;
+
+}
+
+// Feeds the listener size() function calls over a script of size() lines, with the bytecode notifications the
+// instrumentation sends for each of them.
+TEST(CoverageListenerBenchmark, Updates) {
+    Benchmark::run("CoverageListener_Updates", [](BenchmarkState& state) {
+        CoverageListener listener((QSet<QUrl>()));
+        QSource source(0, "http://benchmark.fake/coverage.js", 1);
+
+        QString sourceCode;
+        for (uint line = 0; line < state.size(); line++) {
+            sourceCode += QString("var v%1 = f(v%1);\n").arg(line);
+        }
+        listener.slJavascriptScriptParsed(sourceCode, &source);
+
+        ByteCodeInfoStruct binfo;
+        binfo.opcodeId = (JSC::OpcodeID)0;
+        binfo.isSymbolic = false;
+
+        while (state.keepRunning()) {
+            for (uint call = 0; call < state.size(); call++) {
+                uint functionOffset = (call % 64) * 100;
+                listener.slJavascriptFunctionCalled("f", BYTECODES_PER_CALL, call + 1, functionOffset, &source);
+
+                for (uint bytecode = 0; bytecode < BYTECODES_PER_CALL; bytecode++) {
+                    binfo.linenumber = call + 1;
+                    binfo.bytecodeOffset = bytecode;
+                    binfo.divot = call * 20 + bytecode;
+                    binfo.startOffset = 1;
+                    binfo.endOffset = 2;
+                    listener.slJavascriptBytecodeExecuted(binfo, functionOffset, &source);
+                }
+            }
+        }
+
+        ASSERT_EQ((size_t)state.size(), listener.getNumCoveredLines());
+        state.setItemsProcessed(state.getIterations() * state.size() * (BYTECODES_PER_CALL + 1));
+    });
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <assert.h>
+
+#include "concolic/executiontree/tracemerger.h"
+
+#include "synthetictrees.h"
+
+namespace artemis
+{
+
+// A marker (i.e. a new event in the sequence) is added before every MARKER_INTERVAL branches.
+static const uint MARKER_INTERVAL = 8;
+// The number of distinct form fields used in the conditions.
+static const uint NUM_FIELDS = 6;
+
+QSource SyntheticTrees::mSource(0, "http://benchmark.fake/synthetic.js", 1);
+QList<Symbolic::Expression*> SyntheticTrees::mConditions;
+
+SyntheticTrees::SyntheticTrees(uint depth, uint seed)
+    : mDepth(depth)
+    , mSeed(seed)
+{
+}
+
+TraceNodePtr SyntheticTrees::trace(uint index) const
+{
+    // xorshift32, seeded from the seed and trace index so each trace can be regenerated independently.
+    quint32 state = (mSeed * 2654435761u) ^ (index * 2246822519u) ^ 0x9e3779b9u;
+    if (state == 0) {
+        state = 1;
+    }
+
+    TraceEndPtr end = TraceEndPtr(new TraceEndSuccess());
+    end->traceIndices.insert(index);
+    TraceNodePtr current = end;
+
+    // The directions are drawn from the root down, but the trace itself is built from the leaf upwards.
+    QList<bool> directions;
+    for (uint level = 0; level < mDepth; level++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        directions.append(state & 1);
+    }
+
+    for (int level = mDepth - 1; level >= 0; level--) {
+        TraceBranchPtr branch = TraceBranchPtr(new TraceSymbolicBranch(condition(level), level * 10, &mSource, level + 1));
+        if (directions.at(level)) {
+            branch->setTrueBranch(current);
+        } else {
+            branch->setFalseBranch(current);
+        }
+        current = branch;
+
+        if (level % MARKER_INTERVAL == 0) {
+            TraceMarkerPtr marker = TraceMarkerPtr(new TraceMarker());
+            marker->label = "Synthetic event";
+            marker->index = QString::number(level / MARKER_INTERVAL);
+            marker->isSelectRestriction = false;
+            marker->next = current;
+            current = marker;
+        }
+    }
+
+    return current;
+}
+
+TraceNodePtr SyntheticTrees::replay(uint count) const
+{
+    TraceMerger merger;
+    TraceNodePtr tree;
+
+    for (uint i = 0; i < count; i++) {
+        tree = merger.merge(trace(i), tree, &tree);
+    }
+
+    return tree;
+}
+
+PathBranchList SyntheticTrees::branchesOf(TraceNodePtr trace)
+{
+    PathBranchList branches;
+
+    TraceNodePtr current = trace;
+    while (current.dynamicCast<TraceEnd>().isNull()) {
+        TraceAnnotationPtr annotation = current.dynamicCast<TraceAnnotation>();
+        if (!annotation.isNull()) {
+            current = annotation->next;
+            continue;
+        }
+
+        TraceSymbolicBranchPtr branch = current.dynamicCast<TraceSymbolicBranch>();
+        assert(!branch.isNull());
+
+        bool direction = !branch->getFalseBranch().dynamicCast<TraceUnexplored>().isNull();
+        branches.append(PathBranch(branch.data(), direction));
+        current = direction ? branch->getTrueBranch() : branch->getFalseBranch();
+    }
+
+    return branches;
+}
+
+Symbolic::Expression* SyntheticTrees::condition(uint level)
+{
+    while ((uint)mConditions.size() <= level) {
+        uint next = mConditions.size();
+        Symbolic::SymbolicSource source(Symbolic::TEXT, Symbolic::INPUT_NAME, QString("field%1").arg(next % NUM_FIELDS).toStdString());
+        Symbolic::StringExpression* field = new Symbolic::SymbolicString(source);
+
+        // Alternate between string comparisons and length checks, the two most common conditions in form validation.
+        if (next % 2 == 0) {
+            mConditions.append(new Symbolic::StringBinaryOperation(field, Symbolic::STRING_EQ,
+                                                                   new Symbolic::ConstantString(new std::string(QString("value%1").arg(next).toStdString()))));
+        } else {
+            mConditions.append(new Symbolic::IntegerBinaryOperation(new Symbolic::StringLength(field), Symbolic::INT_GT,
+                                                                    new Symbolic::ConstantInteger(next)));
+        }
+    }
+
+    return mConditions.at(level);
+}
+
+}
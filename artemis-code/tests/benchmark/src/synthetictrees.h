@@ -0,0 +1,67 @@
+/*
+ * Copyright 2012 Aarhus University
+ *
+ * Licensed under the GNU General Public License, Version 3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *          http://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHETICTREES_H
+#define SYNTHETICTREES_H
+
+#include <QSource>
+
+#include "JavaScriptCore/symbolic/expr.h"
+
+#include "concolic/executiontree/tracenodes.h"
+#include "concolic/pathcondition.h"
+
+namespace artemis
+{
+
+/**
+ * Generates synthetic traces and execution trees for the benchmarks.
+ *
+ * Each trace is a chain of `depth` symbolic branches over a handful of text fields, with a TraceMarker every few
+ * branches (as if a new event was fired) and a TraceEndSuccess at the end. The direction taken at each branch is a
+ * pseudo-random function of the seed and the trace index, so traces share prefixes near the root like the traces of
+ * a real concolic run do.
+ *
+ * The same seed always produces the same sequence of traces, so replay() rebuilds exactly the same execution tree on
+ * every run and on every commit.
+ */
+class SyntheticTrees
+{
+public:
+    SyntheticTrees(uint depth, uint seed);
+
+    // A single recorded trace, a new one is built on each call as merging takes ownership of the nodes.
+    TraceNodePtr trace(uint index) const;
+
+    // The execution tree after merging the traces [0, count) in order, as ConcolicAnalysis would.
+    TraceNodePtr replay(uint count) const;
+
+    // The symbolic branches along a single trace, from the root, as used to build a path condition.
+    static PathBranchList branchesOf(TraceNodePtr trace);
+
+protected:
+    static Symbolic::Expression* condition(uint level);
+
+    uint mDepth;
+    uint mSeed;
+
+    static QSource mSource;
+    static QList<Symbolic::Expression*> mConditions; // Shared by all traces, the trace nodes do not own them.
+};
+
+}
+
+#endif // SYNTHETICTREES_H
@@ -0,0 +1,50 @@
+#include "include/gtest/gtest.h"
+
+#include "concolic/concolicanalysis.h"
+#include "concolic/executiontree/tracenodes.h"
+#include "concolic/tracestatistics.h"
+
+namespace artemis
+{
+
+static TraceNodePtr end()
+{
+    return QSharedPointer<TraceEndSuccess>(new TraceEndSuccess());
+}
+
+// A recorded symbolic branch, which took the given direction.
+static TraceNodePtr branch(bool direction, TraceNodePtr next)
+{
+    TraceSymbolicBranchPtr node = TraceSymbolicBranchPtr(new TraceSymbolicBranch(NULL, 0, NULL, 0));
+    node->setFalseBranch(direction ? TraceNodePtr(TraceUnexplored::getInstance()) : next);
+    node->setTrueBranch(direction ? next : TraceNodePtr(TraceUnexplored::getInstance()));
+    return node;
+}
+
+static int frontierOf(TraceNodePtr tree)
+{
+    TraceStatistics statistics;
+    statistics.processTrace(tree);
+    return statistics.mNumUnexploredSymbolicChild;
+}
+
+TEST(ConcolicAnalysisTest, FRONTIER_SIZE_MATCHES_TRACE_STATISTICS) {
+    ConcolicAnalysis analysis(Options(), ConcolicAnalysis::QUIET);
+
+    QList<TraceNodePtr> traces;
+    traces << branch(true, branch(true, end()))
+           << branch(true, branch(true, end())) // Already in the tree.
+           << branch(true, branch(false, branch(false, end())))
+           << branch(false, end())
+           << branch(true, branch(false, branch(true, end())));
+
+    foreach (TraceNodePtr trace, traces) {
+        analysis.addTrace(trace, ConcolicAnalysis::NO_EXPLORATION_TARGET);
+        ASSERT_EQ(frontierOf(analysis.getExecutionTree()), (int)analysis.getFrontierSize());
+    }
+
+    // Everything is explored now.
+    ASSERT_EQ(0u, analysis.getFrontierSize());
+}
+
+}
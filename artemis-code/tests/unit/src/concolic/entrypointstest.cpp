@@ -0,0 +1,118 @@
+#include "include/gtest/gtest.h"
+
+#include "concolic/entrypoints.h"
+
+namespace artemis
+{
+
+// An element as seen by the old per-handler detection: its tag, its type attribute and the tags of its ancestors,
+// innermost first.
+struct OldElement
+{
+    QString tagName;
+    QString type;
+    QStringList ancestors;
+};
+
+// The decision of the old detector, which looked up the element of each handler and read it through QWebElement.
+// A handler whose element was not found got a null element, whose tag name and attributes are empty.
+static bool oldIsEntryPoint(const QString& eventName, const QString& tagName, const OldElement* element)
+{
+    if (eventName.compare("click", Qt::CaseInsensitive) == 0 &&
+            tagName.compare("button", Qt::CaseInsensitive) == 0) {
+        return true;
+
+    } else if (eventName.compare("click", Qt::CaseInsensitive) == 0 &&
+               tagName.compare("a", Qt::CaseInsensitive) == 0) {
+        if (element == NULL) {
+            return false;
+        }
+        QStringList chain = QStringList(element->tagName) + element->ancestors;
+        foreach (QString tag, chain) {
+            if (tag.compare("form", Qt::CaseInsensitive) == 0) {
+                return true;
+            }
+        }
+        return false;
+
+    } else if (eventName.compare("click", Qt::CaseInsensitive) == 0 &&
+               tagName.compare("input", Qt::CaseInsensitive) == 0) {
+        QString type = element == NULL ? QString() : element->type;
+        return type.compare("button", Qt::CaseInsensitive) == 0 ||
+               type.compare("submit", Qt::CaseInsensitive) == 0 ||
+               type.compare("image", Qt::CaseInsensitive) == 0;
+
+    } else if (eventName.compare("submit", Qt::CaseInsensitive) == 0 &&
+               tagName.compare("form", Qt::CaseInsensitive) == 0) {
+        return true;
+    }
+
+    return false;
+}
+
+// The target QWebElement::findEventTargets() reports for an element.
+static QWebEventTarget targetFor(const OldElement& element)
+{
+    QWebEventTarget target;
+    target.tagName = element.tagName;
+    target.type = element.type;
+    foreach (QString tag, QStringList(element.tagName) + element.ancestors) {
+        if (tag.compare("form", Qt::CaseInsensitive) == 0) {
+            target.insideForm = true;
+        }
+    }
+    return target;
+}
+
+TEST(EntryPointDetectorTest, DEFAULT_TARGET_IS_OUTSIDE_FORM)
+{
+    QWebEventTarget target;
+    target.tagName = "a";
+
+    ASSERT_FALSE(target.insideForm);
+    ASSERT_FALSE(EntryPointDetector::isEntryPoint("click", "a", &target));
+}
+
+TEST(EntryPointDetectorTest, SAME_AS_PER_HANDLER_DETECTION)
+{
+    QStringList eventNames = QStringList() << "click" << "CLICK" << "submit" << "mouseover";
+    QStringList tagNames = QStringList() << "button" << "a" << "A" << "input" << "INPUT" << "form" << "div";
+    QStringList types = QStringList() << QString() << "button" << "Submit" << "image" << "text";
+    QList<QStringList> ancestorChains = QList<QStringList>()
+            << QStringList()
+            << (QStringList() << "div" << "body" << "html")
+            << (QStringList() << "form" << "body" << "html")
+            << (QStringList() << "span" << "FORM" << "div" << "body" << "html");
+
+    int accepted = 0;
+    foreach (QString eventName, eventNames) {
+        foreach (QString tagName, tagNames) {
+            // A handler whose XPath matched no target.
+            ASSERT_EQ(oldIsEntryPoint(eventName, tagName, NULL),
+                      EntryPointDetector::isEntryPoint(eventName, tagName, NULL))
+                    << eventName.toStdString() << " on missing " << tagName.toStdString();
+
+            foreach (QString type, types) {
+                foreach (QStringList ancestors, ancestorChains) {
+                    OldElement element;
+                    element.tagName = tagName;
+                    element.type = type;
+                    element.ancestors = ancestors;
+                    QWebEventTarget target = targetFor(element);
+
+                    bool expected = oldIsEntryPoint(eventName, tagName, &element);
+                    ASSERT_EQ(expected, EntryPointDetector::isEntryPoint(eventName, tagName, &target))
+                            << eventName.toStdString() << " on " << tagName.toStdString()
+                            << " type=" << type.toStdString()
+                            << " ancestors=" << ancestors.join("/").toStdString();
+                    accepted += expected ? 1 : 0;
+                }
+            }
+        }
+    }
+
+    // Every rule accepts some handlers.
+    ASSERT_GT(accepted, 0);
+}
+
+} // namespace artemis
@@ -0,0 +1,268 @@
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QPair>
+#include <QSource>
+#include <QStringList>
+#include <QTextStream>
+
+#include "include/gtest/gtest.h"
+
+#include "concolic/executiontree/tracenodes.h"
+#include "concolic/executiontree/tracemerger.h"
+#include "concolic/executiontree/tracedisplay.h"
+
+namespace artemis
+{
+
+// Exposes the state of the graph log.
+class TestTraceDisplay : public TraceDisplay
+{
+public:
+    int loggedNodes() const
+    {
+        return mLoggedNodes.size();
+    }
+};
+
+// The parts of a graph which are compared: each node's subgraph and declaration, and its children in slot order.
+struct ParsedGraph {
+    QHash<QString, QString> nodes;
+    QHash<QString, QMap<uint, QPair<QString, QString> > > edges;
+};
+
+static void declare(ParsedGraph* graph, QString group, QString declaration)
+{
+    QString name = declaration.section(' ', 0, 0);
+    graph->nodes.insert(name, group + declaration.mid(name.length()));
+}
+
+static QString unescapeLogField(QString field)
+{
+    QString result;
+    for (int i = 0; i < field.length(); i++) {
+        if (field.at(i) == '\\' && i + 1 < field.length()) {
+            QChar next = field.at(i + 1);
+            if (next == '\\' || next == 't' || next == 'n') {
+                result += next == '\\' ? QChar('\\') : (next == 't' ? QChar('\t') : QChar('\n'));
+                i++;
+                continue;
+            }
+        }
+        result += field.at(i);
+    }
+    return result;
+}
+
+// Rebuilds the graph from a graph log, in the same way as TreeLog in scripts/gvlog2gv.py.
+static ParsedGraph readGraphLog(QString path)
+{
+    ParsedGraph graph;
+    QFile file(path);
+    EXPECT_TRUE(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    QTextStream in(&file);
+
+    while (!in.atEnd()) {
+        QStringList fields = in.readLine().split("\t");
+        if (fields.at(0) == "node") {
+            declare(&graph, fields.at(1), unescapeLogField(fields.at(2)));
+        } else if (fields.at(0) == "marker") {
+            declare(&graph, "markers " + unescapeLogField(fields.at(1)), unescapeLogField(fields.at(2)));
+        } else if (fields.at(0) == "edge") {
+            graph.edges[fields.at(1)].insert(fields.at(2).toUInt(),
+                                             QPair<QString, QString>(fields.at(3), unescapeLogField(fields.at(4))));
+        }
+    }
+
+    return graph;
+}
+
+// Reads a graph written by writeGraphFile(). The slots of a node's children are the order of its edges.
+static ParsedGraph readGraphFile(QString path)
+{
+    ParsedGraph graph;
+    QFile file(path);
+    EXPECT_TRUE(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    QTextStream in(&file);
+
+    QString group;
+    QString markerIndex;
+    bool inMarkers = false;
+
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        if (line.endsWith(";")) {
+            line.chop(1);
+        }
+
+        if (line.startsWith("subgraph ")) {
+            group = line.section(' ', 1, 1);
+        } else if (!group.isNull()) {
+            if (line == "{") {
+                inMarkers = true;
+            } else if (line == "}") {
+                if (inMarkers) {
+                    inMarkers = false;
+                } else {
+                    group = QString();
+                }
+            } else if (inMarkers && line.startsWith("node [label = ")) {
+                markerIndex = line.section('"', 1, 1);
+            } else if (!line.isEmpty() && !line.startsWith("node ") && !line.startsWith("rank ")) {
+                declare(&graph, inMarkers ? group + " " + markerIndex : group, line);
+            }
+        } else if (line.contains(" -> ")) {
+            QString from = line.section(' ', 0, 0);
+            QMap<uint, QPair<QString, QString> >& children = graph.edges[from];
+            children.insert(children.size(), QPair<QString, QString>(line.section(' ', 2, 2), line.section(' ', 3)));
+        }
+    }
+
+    return graph;
+}
+
+// Lists the tree reachable from the start in slot order, leaving out the node names, which differ between the outputs.
+static void describe(const ParsedGraph& graph, QString node, QString indent, QStringList* result)
+{
+    typedef QPair<QString, QString> Child;
+    foreach (Child child, graph.edges.value(node)) {
+        result->append(indent + child.second + " -> " + graph.nodes.value(child.first, "undeclared"));
+        describe(graph, child.first, indent + "  ", result);
+    }
+}
+
+static QStringList describe(const ParsedGraph& graph)
+{
+    QStringList result;
+    describe(graph, "start", "", &result);
+    return result;
+}
+
+// A trace with a marker, then concrete branches taking the given directions, then a successful end.
+static TraceNodePtr recordTrace(QSource* source, QList<bool> directions, uint traceIndex)
+{
+    QSharedPointer<TraceEndSuccess> end = QSharedPointer<TraceEndSuccess>(new TraceEndSuccess());
+    end->traceIndices.insert(traceIndex);
+
+    TraceNodePtr trace = end;
+    for (int i = directions.length() - 1; i >= 0; i--) {
+        TraceBranchPtr branch = TraceBranchPtr(new TraceConcreteBranch(i, source, i + 1));
+        if (directions.at(i)) {
+            branch->setTrueBranch(trace);
+            branch->setFalseBranch(TraceUnexplored::getInstance());
+        } else {
+            branch->setTrueBranch(TraceUnexplored::getInstance());
+            branch->setFalseBranch(trace);
+        }
+        trace = branch;
+    }
+
+    TraceMarkerPtr marker = TraceMarkerPtr(new TraceMarker());
+    marker->index = "1";
+    marker->label = "Initial page load";
+    marker->isSelectRestriction = false;
+    marker->next = trace;
+    return marker;
+}
+
+// The graph rebuilt from the log so far, compared to the graph of the whole tree.
+static QStringList checkLogMatchesGraph(QString logPath, TraceNodePtr tree)
+{
+    QString graphPath = QDir::tempPath() + "/artemis-tracedisplaytest.gv";
+    TraceDisplay display;
+    display.writeGraphFile(tree, graphPath, false);
+
+    QStringList expected = describe(readGraphFile(graphPath));
+    QStringList logged = describe(readGraphLog(logPath));
+    QFile::remove(graphPath);
+
+    EXPECT_FALSE(expected.isEmpty());
+    EXPECT_EQ(expected.join("\n").toStdString(), logged.join("\n").toStdString());
+    return logged;
+}
+
+TEST(TraceDisplayTest, GRAPH_LOG_MATCHES_GRAPH_AFTER_EACH_MERGE) {
+    QSource source(0, "http://www.example.com/app.js", 1);
+    QString logPath = QDir::tempPath() + "/artemis-tracedisplaytest.gvlog";
+
+    TestTraceDisplay display;
+    ASSERT_TRUE(display.openGraphLog(logPath));
+
+    TraceMerger merger;
+    TraceNodePtr tree = merger.merge(recordTrace(&source, QList<bool>() << true << true, 1), TraceNodePtr(), NULL);
+    display.appendGraphLog(tree, 1);
+    QStringList logged = checkLogMatchesGraph(logPath, tree);
+
+    // The unexplored singleton is in two slots, and is shown as two nodes.
+    ASSERT_EQ(2, logged.filter(QRegExp("-> unexplored$")).size());
+
+    // The unexplored node below the first branch is replaced by a new subtree.
+    tree = merger.merge(recordTrace(&source, QList<bool>() << false << true, 2), tree, &tree);
+    display.appendGraphLog(tree, 2);
+    logged = checkLogMatchesGraph(logPath, tree);
+    ASSERT_EQ(2, logged.filter(QRegExp("-> unexplored$")).size());
+
+    tree = merger.merge(recordTrace(&source, QList<bool>() << true << false, 3), tree, &tree);
+    display.appendGraphLog(tree, 3);
+    checkLogMatchesGraph(logPath, tree);
+
+    // The same trace again only changes the trace indices of its end node, which is declared again.
+    tree = merger.merge(recordTrace(&source, QList<bool>() << true << true, 4), tree, &tree);
+    display.appendGraphLog(tree, 4);
+    logged = checkLogMatchesGraph(logPath, tree);
+    ASSERT_EQ(1, logged.filter("xlabel = \"1, 4\"").size());
+
+    tree = merger.merge(recordTrace(&source, QList<bool>() << false << false, 5), tree, &tree);
+    display.appendGraphLog(tree, 5);
+    logged = checkLogMatchesGraph(logPath, tree);
+    ASSERT_EQ(0, logged.filter(QRegExp("-> unexplored$")).size());
+
+    display.closeGraphLog();
+    QFile::remove(logPath);
+}
+
+TEST(TraceDisplayTest, GRAPH_LOG_PRUNES_DELETED_NODES) {
+    QSource source(0, "http://www.example.com/app.js", 1);
+    QString logPath = QDir::tempPath() + "/artemis-tracedisplaytest.gvlog";
+
+    TestTraceDisplay display;
+    ASSERT_TRUE(display.openGraphLog(logPath));
+
+    TraceNodePtr tree;
+    {
+        TraceMerger merger;
+        for (uint i = 0; i < 6; i++) {
+            QList<bool> directions;
+            for (uint j = 0; j < 6; j++) {
+                directions.append(((i >> j) & 1) != 0);
+            }
+            tree = merger.merge(recordTrace(&source, directions, i + 1), tree, &tree);
+        }
+        display.appendGraphLog(tree, 1);
+        checkLogMatchesGraph(logPath, tree);
+    }
+
+    // A new tree replaces the old one, whose nodes are deleted. Only the nodes of the new tree are remembered:
+    // the marker, two branches, the end and the unexplored node in two slots.
+    TraceMerger merger;
+    tree = merger.merge(recordTrace(&source, QList<bool>() << true << false, 7), TraceNodePtr(), NULL);
+    display.appendGraphLog(tree, 2);
+    ASSERT_EQ(6, display.loggedNodes());
+    checkLogMatchesGraph(logPath, tree);
+
+    // Updates after pruning still refer to the nodes by their logged names.
+    tree = merger.merge(recordTrace(&source, QList<bool>() << true << true, 8), tree, &tree);
+    display.appendGraphLog(tree, 3);
+    checkLogMatchesGraph(logPath, tree);
+
+    tree = merger.merge(recordTrace(&source, QList<bool>() << true << false, 9), tree, &tree);
+    display.appendGraphLog(tree, 4);
+    QStringList logged = checkLogMatchesGraph(logPath, tree);
+    ASSERT_EQ(1, logged.filter("xlabel = \"7, 9\"").size());
+
+    display.closeGraphLog();
+    QFile::remove(logPath);
+}
+
+} // namespace artemis
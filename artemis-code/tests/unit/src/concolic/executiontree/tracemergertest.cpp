@@ -0,0 +1,152 @@
+#include <typeinfo>
+
+#include "include/gtest/gtest.h"
+
+#include "concolic/executiontree/tracenodes.h"
+#include "concolic/executiontree/tracemerger.h"
+#include "concolic/executiontree/tracepath.h"
+
+namespace artemis
+{
+
+// Records a trace of symbolic branches taking the given directions, and its path as TraceBuilder would.
+static TraceNodePtr recordTrace(QList<bool> directions, TracePath* path)
+{
+    TraceNodePtr trace = TraceNodePtr(new TraceEndSuccess());
+    for (int i = directions.length() - 1; i >= 0; i--) {
+        TraceBranchPtr branch = TraceBranchPtr(new TraceSymbolicBranch(NULL, i, NULL, i));
+        if (directions.at(i)) {
+            branch->setTrueBranch(trace);
+            branch->setFalseBranch(TraceUnexplored::getInstance());
+        } else {
+            branch->setTrueBranch(TraceUnexplored::getInstance());
+            branch->setFalseBranch(trace);
+        }
+        trace = branch;
+    }
+
+    path->clear();
+    int direction;
+    for (TraceNodePtr node = trace; !node.isNull(); node = TracePath::nextOnTrace(node, &direction)) {
+        path->append(node);
+    }
+
+    return trace;
+}
+
+static TraceNodePtr recordTrace(QList<bool> directions)
+{
+    TracePath path;
+    return recordTrace(directions, &path);
+}
+
+static bool sameShape(TraceNodePtr a, TraceNodePtr b)
+{
+    if (a.isNull() || b.isNull()) {
+        return a.isNull() && b.isNull();
+    }
+    if (typeid(*a) != typeid(*b)) {
+        return false;
+    }
+
+    TraceBranchPtr branchA = a.dynamicCast<TraceBranch>();
+    if (!branchA.isNull()) {
+        TraceBranchPtr branchB = b.dynamicCast<TraceBranch>();
+        return sameShape(branchA->getFalseBranch(), branchB->getFalseBranch()) &&
+                sameShape(branchA->getTrueBranch(), branchB->getTrueBranch());
+    }
+
+    return true;
+}
+
+// The branch reached from the root by taking the given directions.
+static TraceSymbolicBranchPtr branchAt(TraceNodePtr tree, QList<bool> directions)
+{
+    foreach (bool direction, directions) {
+        TraceBranchPtr branch = tree.dynamicCast<TraceBranch>();
+        tree = direction ? branch->getTrueBranch() : branch->getFalseBranch();
+    }
+    return tree.dynamicCast<TraceSymbolicBranch>();
+}
+
+TEST(TraceMergerTest, PATH_FINGERPRINTS) {
+    TracePath path;
+    TraceNodePtr trace = recordTrace(QList<bool>() << true << false, &path);
+
+    ASSERT_EQ(4u, path.length());
+    ASSERT_EQ(trace, path.nodeAt(0));
+    ASSERT_EQ(TracePath::EMPTY_PREFIX, path.prefixFingerprintAt(0));
+
+    // Two traces only differing in the directions taken differ in the fingerprints below that point.
+    TracePath other;
+    recordTrace(QList<bool>() << true << true, &other);
+    ASSERT_EQ(path.prefixFingerprintAt(1), other.prefixFingerprintAt(1));
+    ASSERT_NE(path.prefixFingerprintAt(2), other.prefixFingerprintAt(2));
+}
+
+TEST(TraceMergerTest, MERGE_FROM_TARGET_MATCHES_MERGE_FROM_ROOT) {
+    QList<QList<bool> > traces;
+    traces << (QList<bool>() << true << true << true)
+           << (QList<bool>() << true << false << true)
+           << (QList<bool>() << true << false << false)
+           << (QList<bool>() << false << true << true)  // Diverges from the target above it.
+           << (QList<bool>() << true << true << false);
+
+    // The branch each trace after the first was aimed at, as directions from the root.
+    QList<QList<bool> > targets;
+    targets << (QList<bool>() << true)
+            << (QList<bool>() << true << false)
+            << (QList<bool>() << true)
+            << (QList<bool>() << true << true);
+
+    TraceMerger fromTarget;
+    TraceMerger fromRoot;
+    TraceNodePtr targetTree = fromTarget.merge(recordTrace(traces.at(0)), TraceNodePtr(), NULL);
+    TraceNodePtr rootTree = fromRoot.merge(recordTrace(traces.at(0)), TraceNodePtr(), NULL);
+
+    for (int i = 1; i < traces.length(); i++) {
+        TracePath path;
+        TraceNodePtr trace = recordTrace(traces.at(i), &path);
+        TraceSymbolicBranchPtr target = branchAt(targetTree, targets.at(i - 1));
+        ASSERT_FALSE(target.isNull());
+
+        targetTree = fromTarget.merge(trace, targetTree, &targetTree, target, path);
+        rootTree = fromRoot.merge(recordTrace(traces.at(i)), rootTree, &rootTree);
+
+        ASSERT_EQ(fromRoot.changedTree(), fromTarget.changedTree());
+        ASSERT_TRUE(sameShape(rootTree, targetTree));
+    }
+
+    // The new suffixes were attached below the targets.
+    ASSERT_FALSE(branchAt(targetTree, QList<bool>() << true << false)->getFalseBranch().dynamicCast<TraceEndSuccess>().isNull());
+    ASSERT_FALSE(branchAt(targetTree, QList<bool>() << false << true).isNull());
+}
+
+TEST(TraceMergerTest, TARGET_OF_ANOTHER_TYPE_MERGES_FROM_ROOT) {
+    TraceMerger merger;
+    TraceNodePtr tree = merger.merge(recordTrace(QList<bool>() << true << true), TraceNodePtr(), NULL);
+    TraceSymbolicBranchPtr target = branchAt(tree, QList<bool>() << true);
+
+    // A trace with an alert where the tree has the target branch. The merge must not start at the target, which
+    // would leave no parent to insert the divergence into and replace the root instead.
+    QSharedPointer<TraceAlert> alert = QSharedPointer<TraceAlert>(new TraceAlert());
+    alert->next = TraceNodePtr(new TraceEndSuccess());
+    TraceBranchPtr root = TraceBranchPtr(new TraceSymbolicBranch(NULL, 0, NULL, 0));
+    root->setTrueBranch(alert);
+    root->setFalseBranch(TraceUnexplored::getInstance());
+
+    TracePath path;
+    path.append(root);
+    path.append(alert);
+    path.append(alert->next);
+
+    TraceNodePtr rootBefore = tree;
+    tree = merger.merge(root, tree, &tree, target, path);
+
+    ASSERT_EQ(rootBefore, tree);
+    ASSERT_TRUE(merger.changedTree());
+    TraceBranchPtr treeRoot = tree.dynamicCast<TraceBranch>();
+    ASSERT_FALSE(treeRoot->getTrueBranch().dynamicCast<TraceDivergence>().isNull());
+}
+
+}
@@ -0,0 +1,214 @@
+#include "include/gtest/gtest.h"
+
+#include "concolic/executiontree/tracenodes.h"
+#include "concolic/executiontree/tracemerger.h"
+#include "concolic/executiontree/tracespillstore.h"
+#include "concolic/executiontree/tracespiller.h"
+#include "concolic/tracestatistics.h"
+
+namespace artemis
+{
+
+// A fully explored chain of concrete branches, ending in a successful trace.
+static TraceNodePtr exploredChain(int length, TraceNodePtr* last)
+{
+    QSharedPointer<TraceEndSuccess> end = QSharedPointer<TraceEndSuccess>(new TraceEndSuccess());
+    end->traceIndices.insert(1);
+
+    TraceNodePtr chain = end;
+    for (int i = 0; i < length; i++) {
+        TraceBranchPtr branch = TraceBranchPtr(new TraceConcreteBranch(i, NULL, i));
+        branch->setFalseBranch(TraceUnexploredUnsat::getInstance());
+        branch->setTrueBranch(chain);
+        chain = branch;
+
+        if (i == 0) {
+            *last = branch;
+        }
+    }
+    return chain;
+}
+
+TEST(TraceSpillerTest, STORE_ROUND_TRIP) {
+    TraceSymbolicBranchPtr root = TraceSymbolicBranchPtr(new TraceSymbolicBranch(NULL, 7, NULL, 3));
+    root->markExploration(4, true);
+
+    QSharedPointer<TraceAlert> alert = QSharedPointer<TraceAlert>(new TraceAlert());
+    alert->message = "Hello";
+
+    TraceConcreteSummarisationPtr summary = TraceConcreteSummarisationPtr(new TraceConcreteSummarisation());
+    QList<TraceConcreteSummarisation::EventType> events;
+    events << TraceConcreteSummarisation::FUNCTION_CALL << TraceConcreteSummarisation::BRANCH_TRUE;
+    summary->executions.append(TraceConcreteSummarisation::SingleExecution(events, TraceUnexploredQueued::getInstance()));
+    QSharedPointer<TraceEndFailure> failure = QSharedPointer<TraceEndFailure>(new TraceEndFailure());
+    failure->traceIndices << 2 << 5;
+    summary->executions.append(TraceConcreteSummarisation::SingleExecution(QList<TraceConcreteSummarisation::EventType>(), failure));
+
+    alert->next = summary;
+    root->setTrueBranch(alert);
+    root->setFalseBranch(TraceUnexplored::getInstance());
+
+    TraceSpillStorePtr store = TraceSpillStore::create();
+    qint64 offset = store->write(root);
+    ASSERT_LE(0, offset);
+
+    TraceSymbolicBranchPtr copy = store->read(offset).dynamicCast<TraceSymbolicBranch>();
+    ASSERT_FALSE(copy.isNull());
+    ASSERT_NE(root.data(), copy.data());
+    ASSERT_EQ(7u, copy->getSourceOffset());
+    ASSERT_EQ(3u, copy->getLinenumber());
+    ASSERT_EQ(4u, copy->getExplorationIndex());
+    ASSERT_FALSE(copy->isDifficult());
+    ASSERT_TRUE(TraceVisitor::isImmediatelyNotAttempted(copy->getFalseBranch()));
+
+    QSharedPointer<TraceAlert> alertCopy = copy->getTrueBranch().dynamicCast<TraceAlert>();
+    ASSERT_FALSE(alertCopy.isNull());
+    ASSERT_EQ(QString("Hello"), alertCopy->message);
+
+    TraceConcreteSummarisationPtr summaryCopy = alertCopy->next.dynamicCast<TraceConcreteSummarisation>();
+    ASSERT_FALSE(summaryCopy.isNull());
+    ASSERT_EQ(2, summaryCopy->executions.size());
+    ASSERT_EQ(events, summaryCopy->executions.at(0).first);
+    ASSERT_TRUE(TraceVisitor::isImmediatelyQueued(summaryCopy->executions.at(0).second));
+
+    QSharedPointer<TraceEndFailure> failureCopy = summaryCopy->executions.at(1).second.dynamicCast<TraceEndFailure>();
+    ASSERT_FALSE(failureCopy.isNull());
+    ASSERT_EQ(failure->traceIndices, failureCopy->traceIndices);
+}
+
+TEST(TraceSpillerTest, SPILLS_ONLY_EXPLORED_SUBTREES) {
+    // About 1MB of fully explored branches, next to an unexplored one.
+    TraceNodePtr last;
+    TraceSymbolicBranchPtr root = TraceSymbolicBranchPtr(new TraceSymbolicBranch(NULL, 0, NULL, 0));
+    root->setFalseBranch(TraceUnexplored::getInstance());
+    root->setTrueBranch(exploredChain(12000, &last));
+
+    TraceStatistics before;
+    before.processTrace(root);
+
+    // The chain is kept while the search may still refer to the end of it.
+    TraceSpiller pinned(1);
+    pinned.addedToTree(root);
+    ASSERT_FALSE(pinned.spillIfNeeded(root, last));
+    ASSERT_TRUE(root->getTrueBranch().dynamicCast<TraceSpilled>().isNull());
+
+    TraceSpiller spiller(1);
+    spiller.addedToTree(root);
+    ASSERT_TRUE(spiller.spillIfNeeded(root, TraceNodePtr()));
+    ASSERT_FALSE(root->getTrueBranch().dynamicCast<TraceSpilled>().isNull());
+    ASSERT_TRUE(TraceVisitor::isImmediatelyNotAttempted(root->getFalseBranch()));
+
+    // Other visitors still see the whole tree.
+    TraceStatistics after;
+    after.processTrace(root);
+    ASSERT_EQ(before.mNumConcreteBranches, after.mNumConcreteBranches);
+    ASSERT_EQ(before.mNumUnexploredUnsat, after.mNumUnexploredUnsat);
+    ASSERT_EQ(before.mNumEndSuccess, after.mNumEndSuccess);
+    ASSERT_EQ(before.mNumUnexplored, after.mNumUnexplored);
+}
+
+TEST(TraceSpillerTest, MERGE_THROUGH_SPILLED_SUBTREE) {
+    TraceNodePtr last;
+    TraceSymbolicBranchPtr root = TraceSymbolicBranchPtr(new TraceSymbolicBranch(NULL, 0, NULL, 0));
+    root->setFalseBranch(TraceUnexplored::getInstance());
+    root->setTrueBranch(exploredChain(200, &last));
+
+    TraceSpiller spiller(1);
+    spiller.addedToTree(root);
+    ASSERT_TRUE(spiller.spillIfNeeded(root, TraceNodePtr()));
+    ASSERT_FALSE(root->getTrueBranch().dynamicCast<TraceSpilled>().isNull());
+
+    TraceStatistics before;
+    before.processTrace(root);
+
+    // A trace which follows the chain down to its fifth branch, then takes the unsat side.
+    TraceNodePtr traceEnd = TraceNodePtr(new TraceEndFailure());
+    TraceNodePtr trace = traceEnd;
+    for (int i = 0; i < 5; i++) {
+        TraceBranchPtr branch = TraceBranchPtr(new TraceConcreteBranch(0, NULL, 0));
+        branch->setTrueBranch(i == 0 ? TraceNodePtr(TraceUnexplored::getInstance()) : trace);
+        branch->setFalseBranch(i == 0 ? trace : TraceNodePtr(TraceUnexplored::getInstance()));
+        trace = branch;
+    }
+    TraceBranchPtr traceRoot = TraceBranchPtr(new TraceSymbolicBranch(NULL, 0, NULL, 0));
+    traceRoot->setTrueBranch(trace);
+    traceRoot->setFalseBranch(TraceUnexplored::getInstance());
+
+    TraceMerger merger;
+    TraceNodePtr tree = root;
+    tree = merger.merge(traceRoot, tree, &tree);
+    ASSERT_EQ(root, tree);
+    ASSERT_TRUE(merger.changedTree());
+
+    // The spilled subtree was put back in place of the placeholder, and the new path added to it.
+    TraceNodePtr node = root->getTrueBranch();
+    ASSERT_TRUE(node.dynamicCast<TraceSpilled>().isNull());
+    for (int i = 0; i < 4; i++) {
+        TraceBranchPtr branch = node.dynamicCast<TraceConcreteBranch>();
+        ASSERT_FALSE(branch.isNull());
+        ASSERT_TRUE(TraceVisitor::isImmediatelyUnsat(branch->getFalseBranch()));
+        node = branch->getTrueBranch();
+    }
+    TraceBranchPtr diverging = node.dynamicCast<TraceConcreteBranch>();
+    ASSERT_FALSE(diverging.isNull());
+    ASSERT_EQ(traceEnd, diverging->getFalseBranch());
+
+    TraceStatistics after;
+    after.processTrace(root);
+    ASSERT_EQ(before.mNumConcreteBranches, after.mNumConcreteBranches);
+    ASSERT_EQ(before.mNumUnexploredUnsat - 1, after.mNumUnexploredUnsat);
+    ASSERT_EQ(before.mNumEndSuccess, after.mNumEndSuccess);
+    ASSERT_EQ(before.mNumEndFailure + 1, after.mNumEndFailure);
+}
+
+TEST(TraceSpillerTest, STATISTICS_OF_SPILLED_SUBTREES) {
+    // Symbolic branches above and below an event marker, both inside and outside the part which is spilled.
+    TraceNodePtr last;
+    TraceNodePtr chain = exploredChain(100, &last);
+    for (int i = 0; i < 3; i++) {
+        TraceBranchPtr branch = TraceBranchPtr(new TraceSymbolicBranch(NULL, 0, NULL, 0));
+        branch->setFalseBranch(TraceUnexploredUnsat::getInstance());
+        branch->setTrueBranch(chain);
+        chain = branch;
+    }
+    TraceMarkerPtr marker = TraceMarkerPtr(new TraceMarker());
+    marker->label = "click";
+    marker->index = "1";
+    marker->isSelectRestriction = false;
+    marker->next = chain;
+    TraceBranchPtr inner = TraceBranchPtr(new TraceSymbolicBranch(NULL, 0, NULL, 0));
+    inner->setFalseBranch(TraceUnexploredUnsat::getInstance());
+    inner->setTrueBranch(marker);
+
+    TraceSymbolicBranchPtr root = TraceSymbolicBranchPtr(new TraceSymbolicBranch(NULL, 0, NULL, 0));
+    root->setFalseBranch(TraceUnexplored::getInstance());
+    TraceBranchPtr concrete = TraceBranchPtr(new TraceConcreteBranch(0, NULL, 0));
+    concrete->setFalseBranch(TraceUnexploredUnsat::getInstance());
+    concrete->setTrueBranch(inner);
+    root->setTrueBranch(concrete);
+
+    TraceStatistics before;
+    before.processTrace(root);
+
+    TraceSpiller spiller(1);
+    spiller.addedToTree(root);
+    ASSERT_TRUE(spiller.spillIfNeeded(root, TraceNodePtr()));
+    ASSERT_FALSE(root->getTrueBranch().dynamicCast<TraceSpilled>().isNull());
+
+    // The second pass uses the counts kept with the placeholder.
+    for (int pass = 0; pass < 2; pass++) {
+        TraceStatistics after;
+        after.processTrace(root);
+        ASSERT_EQ(before.mNumNodes, after.mNumNodes);
+        ASSERT_EQ(before.mNumSymBranches, after.mNumSymBranches);
+        ASSERT_EQ(before.mNumSymBranchesFullyExplored, after.mNumSymBranchesFullyExplored);
+        ASSERT_EQ(before.mNumConcreteBranches, after.mNumConcreteBranches);
+        ASSERT_EQ(before.mNumEventMarkers, after.mNumEventMarkers);
+        ASSERT_EQ(before.mNumEventSequenceSymBranches, after.mNumEventSequenceSymBranches);
+        ASSERT_EQ(before.mNumEventSequenceSymBranchesFullyExplored, after.mNumEventSequenceSymBranchesFullyExplored);
+        ASSERT_EQ(before.mNumUnexploredSymbolicChild, after.mNumUnexploredSymbolicChild);
+        ASSERT_EQ(before.mNumEndSuccess, after.mNumEndSuccess);
+    }
+}
+
+}
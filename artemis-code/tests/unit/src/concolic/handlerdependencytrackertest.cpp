@@ -0,0 +1,92 @@
+#include "include/gtest/gtest.h"
+
+#include <QTextStream>
+
+#include "concolic/handlerdependencytracker.h"
+
+namespace artemis
+{
+
+static QString graphviz(HandlerDependencyTracker& tracker, QList<int> permutation)
+{
+    QString result;
+    QTextStream out(&result);
+    tracker.writeGraphviz(out, permutation);
+    out.flush();
+    return result;
+}
+
+static QString json(HandlerDependencyTracker& tracker, QList<int> permutation)
+{
+    QString result;
+    QTextStream out(&result);
+    tracker.writeJson(out, permutation);
+    out.flush();
+    return result;
+}
+
+TEST(HandlerDependencyTrackerTest, GRAPHVIZ) {
+    HandlerDependencyTracker tracker(true);
+
+    tracker.slJavascriptSymbolicFieldRead("SYM_IN_name", true);
+    tracker.beginHandler("name");
+    tracker.slJavascriptSymbolicFieldRead("SYM_IN_name", true);
+    tracker.slJavascriptSymbolicFieldRead("SYM_IN_name", true);
+    tracker.slJavascriptSymbolicFieldRead("SYM_IN_INT_age", false);
+    tracker.beginHandler("age");
+    tracker.slJavascriptSymbolicFieldRead("SYM_IN_BOOL_other", true);
+
+    QList<int> permutation;
+    permutation << 2 << 1;
+
+    QString expected =
+            "digraph {\n  node [shape = \"rectangle\", style = \"filled\", fillcolor = \"forestgreen\"];\n\n"
+            "  no_source [label = \"[none]\", fillcolor = \"lightgray\"];\n"
+            "  event_1 [label = \"name\", xlabel = \"2\"];\n"
+            "  event_2 [label = \"age\", xlabel = \"B\"];\n"
+            "  unknown_3 [label = \"other\", fillcolor = \"red\"];\n"
+            "\n"
+            "  no_source -> event_1 [style = \"invis\", weight = \"100\"];\n"
+            "  event_1 -> event_2 [style = \"invis\", weight = \"100\"];\n"
+            "\n"
+            "  no_source -> event_1 [label = \" 1\" color = \"gray\"];\n"
+            "  event_1 -> event_1 [label = \" 2\" color = \"blue\"];\n"
+            "  event_1 -> event_2 [label = \" 1\" color = \"red\"];\n"
+            "  event_2 -> unknown_3 [label = \" 1\" color = \"blue\"];\n"
+            "\n}\n";
+
+    ASSERT_EQ(expected.toStdString(), graphviz(tracker, permutation).toStdString());
+
+    // Writing the graph does not change it.
+    ASSERT_EQ(expected.toStdString(), graphviz(tracker, permutation).toStdString());
+}
+
+TEST(HandlerDependencyTrackerTest, JSON_ADJACENCY_LIST) {
+    HandlerDependencyTracker tracker(true);
+
+    tracker.beginHandler("first \"field\"");
+    tracker.slJavascriptSymbolicFieldRead("SYM_IN_second", true);
+    tracker.slJavascriptSymbolicFieldRead("SYM_IN_second", false);
+    tracker.beginHandler("second");
+
+    QString expected =
+            "{\n  \"nodes\": [\n"
+            "    {\"name\": \"event_1\", \"label\": \"first \\\"field\\\"\", \"kind\": \"event\", \"position\": \"1\"},\n"
+            "    {\"name\": \"event_2\", \"label\": \"second\", \"kind\": \"event\", \"position\": \"B\"}\n"
+            "  ],\n  \"edges\": {\n"
+            "    \"event_1\": [\n"
+            "      {\"target\": \"event_2\", \"symbolic\": false, \"count\": 1},\n"
+            "      {\"target\": \"event_2\", \"symbolic\": true, \"count\": 1}\n"
+            "    ]\n"
+            "  }\n}\n";
+
+    ASSERT_EQ(expected.toStdString(), json(tracker, QList<int>() << 1 << 2).toStdString());
+}
+
+TEST(HandlerDependencyTrackerTest, EMPTY) {
+    HandlerDependencyTracker tracker(true);
+
+    ASSERT_EQ("{\n  \"nodes\": [\n  ],\n  \"edges\": {\n  }\n}\n", json(tracker, QList<int>()).toStdString());
+}
+
+}
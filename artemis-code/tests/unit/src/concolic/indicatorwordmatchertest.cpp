@@ -0,0 +1,63 @@
+#include "include/gtest/gtest.h"
+
+#include "concolic/indicatorwordmatcher.h"
+#include "concolic/traceeventdetectors.h"
+
+namespace artemis
+{
+
+// The counts found by the old DOM modification detector: tokens which are equal to a word, ignoring case.
+static QMap<int, int> tokenMatches(const QList<QString>& words, const QString& text)
+{
+    QMap<int, int> counts;
+    foreach (QString token, TraceDomModDetector::tokenise(text)) {
+        for (int i = 0; i < words.length(); i++) {
+            if (token.compare(words.at(i), Qt::CaseInsensitive) == 0) {
+                counts.insert(i, 1 + counts.value(i, 0));
+                break;
+            }
+        }
+    }
+    return counts;
+}
+
+TEST(IndicatorWordMatcherTest, WHOLE_TOKENS_IGNORING_CASE) {
+    QList<QString> words;
+    words << "Error" << "Required" << "Require";
+    IndicatorWordMatcher matcher(words);
+
+    QMap<int, int> counts;
+    ASSERT_EQ(4, matcher.match("<span class=\"error\">ERROR: this field is required. Errors: required-field</span>", &counts));
+    ASSERT_EQ(2, counts.value(0));
+    ASSERT_EQ(2, counts.value(1));
+    ASSERT_FALSE(counts.contains(2));
+
+    counts.clear();
+    ASSERT_EQ(0, matcher.match("Errors are not required_ here, nor Requires", &counts));
+    ASSERT_TRUE(counts.isEmpty());
+
+    counts.clear();
+    ASSERT_EQ(0, matcher.match("", &counts));
+    ASSERT_EQ(1, matcher.match("require", &counts));
+    ASSERT_EQ(1, counts.value(2));
+}
+
+TEST(IndicatorWordMatcherTest, SAME_AS_TOKENISED_COMPARISON) {
+    QList<QString> words = TraceDomModDetector::getIndicators();
+    IndicatorWordMatcher matcher(words);
+
+    QList<QString> texts;
+    texts << "Please enter a valid e-mail address."
+          << "<div id='msg'>Sorry! The field 'Name' is required; please correct it.</div>"
+          << "Invalid\tinvalid\nINVALID  Selected/select?selection"
+          << "Important:warning,Problem.problemS"
+          << "-- -- ::: no indicators at all here ...";
+
+    foreach (QString text, texts) {
+        QMap<int, int> counts;
+        matcher.match(text, &counts);
+        EXPECT_EQ(tokenMatches(words, text), counts) << text.toStdString();
+    }
+}
+
+}
@@ -0,0 +1,166 @@
+#include <sstream>
+
+#include <QRegExp>
+#include <QStringList>
+
+#include "include/gtest/gtest.h"
+
+#include "concolic/executiontree/tracenodes.h"
+#include "concolic/reordering/reachablepathsconstraintgenerator.h"
+#include "concolic/solver/constraintwriter/smt.h"
+#include "concolic/pathcondition.h"
+
+#include <JavaScriptCore/symbolic/expr.h>
+
+namespace artemis
+{
+
+static Symbolic::Expression* checkbox(const char* name)
+{
+    return new Symbolic::SymbolicBoolean(Symbolic::SymbolicSource(Symbolic::CHECKBOX, Symbolic::INPUT_NAME, name));
+}
+
+static TraceNodePtr branch(Symbolic::Expression* condition, TraceNodePtr trueBranch, TraceNodePtr falseBranch)
+{
+    TraceBranchPtr node = TraceBranchPtr(new TraceSymbolicBranch(condition, 0, NULL, 0));
+    node->setTrueBranch(trueBranch);
+    node->setFalseBranch(falseBranch);
+    return node;
+}
+
+static TraceNodePtr concreteBranch(TraceNodePtr trueBranch, TraceNodePtr falseBranch)
+{
+    TraceBranchPtr node = TraceBranchPtr(new TraceConcreteBranch(0, NULL, 0));
+    node->setTrueBranch(trueBranch);
+    node->setFalseBranch(falseBranch);
+    return node;
+}
+
+static TraceNodePtr success()
+{
+    return TraceNodePtr(new TraceEndSuccess());
+}
+
+static TraceNodePtr failure()
+{
+    return TraceNodePtr(new TraceEndFailure());
+}
+
+// A new copy of the same subtree on each call, as for two traces which reach the same branch by different paths.
+static TraceNodePtr check(Symbolic::Expression* condition)
+{
+    return branch(condition, success(), failure());
+}
+
+static QSharedPointer<ReachablePathsITE> asITE(ReachablePathsConstraintPtr constraint)
+{
+    return constraint.dynamicCast<ReachablePathsITE>();
+}
+
+TEST(ReachablePathsConstraintGeneratorTest, ITE_WITH_EQUAL_SIDES_COLLAPSES) {
+    Symbolic::Expression* a = checkbox("a");
+    Symbolic::Expression* b = checkbox("b");
+
+    // Both sides of a are copies of the same subtree X, so (ite a X X) is just X.
+    QSharedPointer<ReachablePathsITE> collapsed = asITE(ReachablePathsConstraintGenerator::generateConstraint(
+                                                            branch(a, check(b), check(b))));
+    ASSERT_FALSE(collapsed.isNull());
+    ASSERT_EQ(b, collapsed->condition);
+    ASSERT_TRUE(collapsed->thenConstraint->isAlwaysTerminating());
+    ASSERT_TRUE(collapsed->elseConstraint->isAlwaysAborting());
+
+    // The same for (or X X) below a concrete branch.
+    collapsed = asITE(ReachablePathsConstraintGenerator::generateConstraint(concreteBranch(check(b), check(b))));
+    ASSERT_FALSE(collapsed.isNull());
+    ASSERT_EQ(b, collapsed->condition);
+}
+
+TEST(ReachablePathsConstraintGeneratorTest, IDENTICAL_SUBTREES_ARE_INTERNED) {
+    Symbolic::Expression* a = checkbox("a");
+    Symbolic::Expression* b = checkbox("b");
+    Symbolic::Expression* c = checkbox("c");
+    Symbolic::Expression* d = checkbox("d");
+
+    // (ite a (ite c X true) (ite d X false)) with a single X.
+    QSharedPointer<ReachablePathsITE> root = asITE(ReachablePathsConstraintGenerator::generateConstraint(
+                                                       branch(a, branch(c, check(b), success()), branch(d, check(b), failure()))));
+    ASSERT_FALSE(root.isNull());
+    ASSERT_EQ(a, root->condition);
+
+    QSharedPointer<ReachablePathsITE> left = asITE(root->thenConstraint);
+    QSharedPointer<ReachablePathsITE> right = asITE(root->elseConstraint);
+    ASSERT_FALSE(left.isNull());
+    ASSERT_FALSE(right.isNull());
+    ASSERT_EQ(c, left->condition);
+    ASSERT_EQ(d, right->condition);
+    ASSERT_FALSE(asITE(left->thenConstraint).isNull());
+    ASSERT_EQ(left->thenConstraint.data(), right->thenConstraint.data());
+
+    // Disjunctions are interned in the same way: (ite a Y (ite d Y false)) with Y = (or X Z).
+    root = asITE(ReachablePathsConstraintGenerator::generateConstraint(
+                     branch(a, concreteBranch(check(b), check(c)), branch(d, concreteBranch(check(b), check(c)), failure()))));
+    ASSERT_FALSE(root.isNull());
+    QSharedPointer<ReachablePathsDisjunction> disjunction = root->thenConstraint.dynamicCast<ReachablePathsDisjunction>();
+    ASSERT_FALSE(disjunction.isNull());
+    ASSERT_EQ(2, disjunction->children.length());
+    ASSERT_EQ(disjunction.data(), asITE(root->elseConstraint)->thenConstraint.data());
+}
+
+TEST(ReachablePathsConstraintGeneratorTest, SHARED_NODES_ARE_DEFINED_ONCE) {
+    Symbolic::Expression* a = checkbox("a");
+    Symbolic::Expression* b = checkbox("b");
+    Symbolic::Expression* c = checkbox("c");
+    Symbolic::Expression* d = checkbox("d");
+
+    ReachablePathsConstraintPtr constraint = ReachablePathsConstraintGenerator::generateConstraint(
+                branch(a, branch(c, check(b), success()), branch(d, check(b), failure())));
+
+    // The same constraint for two actions. Without a renaming, their definitions are shared as well.
+    ReachablePathsConstraintSet reachablePaths;
+    reachablePaths.insert(NamedReachablePathsConstraint(QPair<QString, uint>("first", 1), constraint));
+    reachablePaths.insert(NamedReachablePathsConstraint(QPair<QString, uint>("second", 2), constraint));
+
+    SMTConstraintWriter writer((ConcolicBenchmarkFeatures()));
+    std::ostringstream output;
+    ASSERT_TRUE(writer.writeToStream(PathConditionPtr(new PathCondition()), FormRestrictions(), DomSnapshotStoragePtr(),
+                                     reachablePaths, ReorderingConstraintInfoPtr(), output));
+
+    // Each RP_<n> is defined once, and only refers to definitions written before it.
+    QStringList lines = QString::fromStdString(output.str()).split("\n");
+    QRegExp reference("RP_\\d+");
+    QStringList defined;
+    QStringList asserted;
+    QString shared;
+    foreach (QString line, lines) {
+        if (line.startsWith("(define-fun RP_")) {
+            QString name = line.section(' ', 1, 1);
+            ASSERT_FALSE(defined.contains(name));
+
+            QString body = line.section(' ', 4);
+            for (int pos = reference.indexIn(body); pos >= 0; pos = reference.indexIn(body, pos + 1)) {
+                ASSERT_TRUE(defined.contains(reference.cap(0)));
+            }
+            if (body.endsWith(" true false))")) {
+                shared = name;
+            }
+            defined.append(name);
+
+        } else if (line.startsWith("(assert RP_")) {
+            QString name = line.mid(QString("(assert ").length());
+            name.chop(1);
+            ASSERT_TRUE(defined.contains(name));
+            asserted.append(name);
+        }
+    }
+
+    // X, (ite c X true), (ite d X false) and the root.
+    ASSERT_EQ(4, defined.size());
+    ASSERT_EQ(2, asserted.size());
+    ASSERT_EQ(asserted.at(0).toStdString(), asserted.at(1).toStdString());
+
+    // X is written once and referenced from the two nodes above it.
+    ASSERT_FALSE(shared.isEmpty());
+    ASSERT_EQ(3, lines.filter(QRegExp("\\b" + shared + "\\b")).size());
+}
+
+} // namespace artemis
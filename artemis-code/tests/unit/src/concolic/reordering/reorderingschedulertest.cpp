@@ -0,0 +1,95 @@
+#include "include/gtest/gtest.h"
+
+#include "concolic/reordering/reorderingscheduler.h"
+
+namespace artemis
+{
+
+static QMap<uint, uint> frontiers(uint a, uint b, uint c)
+{
+    QMap<uint, uint> result;
+    result.insert(1, a);
+    result.insert(2, b);
+    result.insert(3, c);
+    return result;
+}
+
+TEST(ReorderingSchedulerTest, ROUND_ROBIN) {
+    ReorderingScheduler scheduler(SCHEDULE_ROUND_ROBIN);
+    QList<uint> actions;
+    actions << 3 << 1 << 2;
+
+    // The frontiers are ignored.
+    ASSERT_EQ(1u, scheduler.chooseNextAction(actions, frontiers(0, 0, 10)));
+    ASSERT_EQ(2u, scheduler.chooseNextAction(actions, frontiers(0, 0, 10)));
+    ASSERT_EQ(3u, scheduler.chooseNextAction(actions, frontiers(0, 0, 10)));
+    ASSERT_EQ(1u, scheduler.chooseNextAction(actions, frontiers(0, 0, 10)));
+
+    // Actions which are fully explored are skipped.
+    actions.removeAll(2);
+    ASSERT_EQ(3u, scheduler.chooseNextAction(actions, frontiers(0, 0, 10)));
+    ASSERT_EQ(1u, scheduler.chooseNextAction(actions, frontiers(0, 0, 10)));
+}
+
+TEST(ReorderingSchedulerTest, RANKED_TIES_ARE_ROUND_ROBIN) {
+    ReorderingScheduler scheduler(SCHEDULE_RANKED);
+    QList<uint> actions;
+    actions << 1 << 2 << 3;
+
+    ASSERT_EQ(1u, scheduler.chooseNextAction(actions, frontiers(4, 4, 4)));
+    scheduler.recordExplorationAttempt(1, true, 1);
+    scheduler.recordNewPaths(1, 1);
+
+    ASSERT_EQ(2u, scheduler.chooseNextAction(actions, frontiers(4, 4, 4)));
+    scheduler.recordExplorationAttempt(2, true, 1);
+    scheduler.recordNewPaths(2, 1);
+
+    ASSERT_EQ(3u, scheduler.chooseNextAction(actions, frontiers(4, 4, 4)));
+}
+
+TEST(ReorderingSchedulerTest, RANKED_PREFERS_LARGE_FRONTIER) {
+    ReorderingScheduler scheduler(SCHEDULE_RANKED);
+    QList<uint> actions;
+    actions << 1 << 2 << 3;
+
+    ASSERT_EQ(2u, scheduler.chooseNextAction(actions, frontiers(1, 10, 2)));
+}
+
+TEST(ReorderingSchedulerTest, RANKED_PREFERS_FEW_SOLVER_CALLS) {
+    ReorderingScheduler scheduler(SCHEDULE_RANKED);
+
+    scheduler.recordExplorationAttempt(1, true, 1);
+    scheduler.recordExplorationAttempt(2, true, 4);
+    scheduler.recordExplorationAttempt(3, false, 4);
+
+    ASSERT_GT(scheduler.actionScore(1, 5), scheduler.actionScore(2, 5));
+    ASSERT_GT(scheduler.actionScore(2, 5), scheduler.actionScore(3, 5));
+    ASSERT_GT(scheduler.actionScore(3, 5), 0);
+}
+
+TEST(ReorderingSchedulerTest, RANKED_PREFERS_NEW_PATHS) {
+    ReorderingScheduler scheduler(SCHEDULE_RANKED);
+
+    scheduler.recordNewPaths(1, 3);
+    scheduler.recordNewPaths(2, 0);
+
+    ASSERT_GT(scheduler.actionScore(1, 5), scheduler.actionScore(2, 5));
+}
+
+TEST(ReorderingSchedulerTest, RANKED_DOES_NOT_STARVE) {
+    ReorderingScheduler scheduler(SCHEDULE_RANKED);
+    QList<uint> actions;
+    actions << 1 << 2;
+
+    QMap<uint, uint> sizes;
+    sizes.insert(1, 0);
+    sizes.insert(2, 5);
+
+    bool chosen = false;
+    for (int i = 0; i < 100 && !chosen; i++) {
+        chosen = scheduler.chooseNextAction(actions, sizes) == 1;
+    }
+    ASSERT_TRUE(chosen);
+}
+
+}
@@ -0,0 +1,294 @@
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <QString>
+
+#include "include/gtest/gtest.h"
+
+#include "concolic/solver/solvermodelparser.h"
+
+namespace artemis
+{
+
+// The solver outputs in fixtures/solveroutput, one string per line.
+static std::vector<std::string> fixture(const char* name)
+{
+    std::vector<std::string> lines;
+    std::ifstream file((std::string(UNIT_FIXTURES_DIR) + "/solveroutput/" + name).c_str());
+    EXPECT_TRUE(file.is_open()) << name;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+static SolverModelEntry defineFun(const std::string& line)
+{
+    SolverModelEntry entry;
+    EXPECT_TRUE(SolverModelParser::parseDefineFun(line, &entry)) << line;
+    return entry;
+}
+
+TEST(SolverModelParserTest, CVC4_MODEL) {
+    std::vector<std::string> lines = fixture("cvc4-sat.txt");
+    ASSERT_EQ(13u, lines.size());
+    ASSERT_EQ("sat", lines[0]);
+
+    SolverModelEntry entry = defineFun(lines[2]);
+    ASSERT_EQ("SYM_IN_name", entry.symbol);
+    ASSERT_EQ("String", entry.sort);
+    ASSERT_EQ(SolverModelEntry::STRING, entry.kind);
+    ASSERT_EQ("hello world", entry.text);
+
+    entry = defineFun(lines[3]);
+    ASSERT_EQ("Int", entry.sort);
+    ASSERT_EQ(SolverModelEntry::INTEGER, entry.kind);
+    ASSERT_EQ(-5, entry.integer);
+    ASSERT_EQ("-5", entry.text);
+
+    entry = defineFun(lines[4]);
+    ASSERT_EQ(SolverModelEntry::BOOLEAN, entry.kind);
+    ASSERT_TRUE(entry.boolean);
+
+    entry = defineFun(lines[5]);
+    ASSERT_EQ(SolverModelEntry::INTEGER, entry.kind);
+    ASSERT_EQ(8000, entry.integer);
+    ASSERT_EQ("8000", entry.text);
+
+    // Parentheses and escapes inside strings do not end the value.
+    entry = defineFun(lines[6]);
+    ASSERT_EQ("SYM_IN_comment", entry.symbol);
+    ASSERT_EQ("say \"(hi)\"; a\\b) it's", entry.text);
+
+    entry = defineFun(lines[7]);
+    ASSERT_EQ(SolverModelEntry::STRING, entry.kind);
+    ASSERT_EQ("", entry.text);
+
+    entry = defineFun(lines[8]);
+    ASSERT_EQ("//form[1]/input[@name=\"q\"]", entry.text);
+
+    entry = defineFun(lines[9]);
+    ASSERT_EQ("SYM_ORDERING_1", entry.symbol);
+    ASSERT_EQ(2, entry.integer);
+
+    entry = defineFun(lines[10]);
+    ASSERT_EQ("SYM_IN_quoted name", entry.symbol);
+    ASSERT_EQ("x", entry.text);
+
+    entry = defineFun(lines[11]);
+    ASSERT_EQ("RP_1", entry.symbol);
+    ASSERT_FALSE(entry.boolean);
+
+    ASSERT_EQ(")", lines[12]);
+
+    SolverModelEntry unused;
+    ASSERT_FALSE(SolverModelParser::parseDefineFun(lines[1], &unused));
+    ASSERT_FALSE(SolverModelParser::parseDefineFun(lines[12], &unused));
+
+    std::vector<std::string> unsat = fixture("cvc4-unsat.txt");
+    ASSERT_EQ("unsat", unsat[0]);
+    ASSERT_FALSE(SolverModelParser::parseDefineFun(unsat[1], &unused));
+}
+
+TEST(SolverModelParserTest, SMTLIB_VALUES) {
+    SolverModelEntry entry;
+
+    ASSERT_EQ(8u, SolverModelParser::parseValue("  \"a\\nb\"", 0, &entry));
+    ASSERT_EQ("a\nb", entry.text);
+
+    ASSERT_NE(std::string::npos, SolverModelParser::parseValue("\"tab\\there \\x41\\u0042\\u{43}\"", 0, &entry));
+    ASSERT_EQ("tab\there ABC", entry.text);
+
+    // Strings are read back as Latin-1, so code points up to 0xFF are single bytes and larger ones keep their escape.
+    ASSERT_NE(std::string::npos, SolverModelParser::parseValue("\"\\u{e9}\\u00FF\\xe9\"", 0, &entry));
+    ASSERT_EQ("\xE9\xFF\xE9", entry.text);
+    ASSERT_EQ(QString::fromUtf8("\xC3\xA9\xC3\xBF\xC3\xA9"), QString::fromStdString(entry.text));
+
+    ASSERT_NE(std::string::npos, SolverModelParser::parseValue("\"\\u{100}\\u20AC\"", 0, &entry));
+    ASSERT_EQ("\\u{100}\\u20AC", entry.text);
+
+    // SMT-LIB 2.5 escapes quotes by doubling them.
+    ASSERT_NE(std::string::npos, SolverModelParser::parseValue("\"say \"\"hi\"\"\"", 0, &entry));
+    ASSERT_EQ("say \"hi\"", entry.text);
+
+    // Unknown escapes are kept as they are.
+    ASSERT_NE(std::string::npos, SolverModelParser::parseValue("\"\\q\\x4\"", 0, &entry));
+    ASSERT_EQ("\\q\\x4", entry.text);
+
+    ASSERT_EQ(std::string::npos, SolverModelParser::parseValue("\"unterminated", 0, &entry));
+    ASSERT_EQ(std::string::npos, SolverModelParser::parseValue("\"escaped end\\\"", 0, &entry));
+    ASSERT_EQ(std::string::npos, SolverModelParser::parseValue("(- 5", 0, &entry));
+    ASSERT_EQ(std::string::npos, SolverModelParser::parseValue("   ", 0, &entry));
+
+    ASSERT_EQ(10u, SolverModelParser::parseValue("( -   12 ) rest", 0, &entry));
+    ASSERT_EQ(SolverModelEntry::INTEGER, entry.kind);
+    ASSERT_EQ(-12, entry.integer);
+
+    ASSERT_NE(std::string::npos, SolverModelParser::parseValue("(- (- 1))", 0, &entry));
+    ASSERT_EQ(SolverModelEntry::OTHER, entry.kind);
+    ASSERT_EQ("(- (- 1))", entry.text);
+
+    ASSERT_NE(std::string::npos, SolverModelParser::parseValue("((as const (Array Int Int)) 0)", 0, &entry));
+    ASSERT_EQ(SolverModelEntry::OTHER, entry.kind);
+    ASSERT_EQ("((as const (Array Int Int)) 0)", entry.text);
+
+    // Integers saturate instead of overflowing.
+    ASSERT_NE(std::string::npos, SolverModelParser::parseValue("123456789012345678901234567890", 0, &entry));
+    ASSERT_EQ(SolverModelEntry::INTEGER, entry.kind);
+    ASSERT_EQ(2147483647, entry.integer);
+    ASSERT_EQ("123456789012345678901234567890", entry.text);
+
+    ASSERT_NE(std::string::npos, SolverModelParser::parseValue("(- 2147483648)", 0, &entry));
+    ASSERT_EQ(-2147483647 - 1, entry.integer);
+
+    ASSERT_NE(std::string::npos, SolverModelParser::parseValue("(- 99999999999)", 0, &entry));
+    ASSERT_EQ(-2147483647 - 1, entry.integer);
+}
+
+TEST(SolverModelParserTest, Z3STR_MODEL) {
+    std::vector<std::string> lines = fixture("z3str-sat.txt");
+    ASSERT_EQ(">> SAT", lines[1]);
+
+    SolverModelEntry entry;
+    ASSERT_TRUE(SolverModelParser::parseZ3StrAssignment(lines[3], &entry));
+    ASSERT_EQ("SYM_IN_name", entry.symbol);
+    ASSERT_EQ("hello world", entry.text);
+
+    ASSERT_TRUE(SolverModelParser::parseZ3StrAssignment(lines[4], &entry));
+    ASSERT_EQ(SolverModelEntry::STRING, entry.kind);
+    ASSERT_EQ("", entry.text);
+
+    ASSERT_TRUE(SolverModelParser::parseZ3StrAssignment(lines[5], &entry));
+    ASSERT_EQ(SolverModelEntry::INTEGER, entry.kind);
+    ASSERT_EQ("-12", entry.text);
+    ASSERT_EQ(-12, entry.integer);
+
+    // Only a whole (- N) value is a negative number.
+    ASSERT_TRUE(SolverModelParser::parseZ3StrAssignment(lines[6], &entry));
+    ASSERT_EQ(SolverModelEntry::STRING, entry.kind);
+    ASSERT_EQ("(- x)", entry.text);
+
+    ASSERT_TRUE(SolverModelParser::parseZ3StrAssignment(lines[7], &entry));
+    ASSERT_EQ("8000", entry.text);
+
+    ASSERT_FALSE(SolverModelParser::parseZ3StrAssignment(lines[0], &entry));
+    ASSERT_FALSE(SolverModelParser::parseZ3StrAssignment(lines[2], &entry));
+    ASSERT_FALSE(SolverModelParser::parseZ3StrAssignment("", &entry));
+    ASSERT_FALSE(SolverModelParser::parseZ3StrAssignment("SYM_IN_x = y", &entry));
+
+    ASSERT_TRUE(SolverModelParser::parseZ3StrAssignment("SYM_IN_x :", &entry));
+    ASSERT_EQ("", entry.text);
+}
+
+TEST(SolverModelParserTest, KALUZA_MODEL) {
+    std::vector<std::string> lines = fixture("kaluza-sat.txt");
+    ASSERT_EQ(5u, lines.size());
+
+    SolverModelEntry entry;
+    ASSERT_TRUE(SolverModelParser::parseKaluzaAssignment(lines[0], &entry));
+    ASSERT_EQ("SYM_IN_INT_age", entry.symbol);
+    ASSERT_EQ(SolverModelEntry::INTEGER, entry.kind);
+    ASSERT_EQ(42, entry.integer);
+
+    ASSERT_TRUE(SolverModelParser::parseKaluzaAssignment(lines[1], &entry));
+    ASSERT_EQ(SolverModelEntry::BOOLEAN, entry.kind);
+    ASSERT_FALSE(entry.boolean);
+
+    ASSERT_FALSE(SolverModelParser::parseKaluzaAssignment(lines[2], &entry));
+
+    ASSERT_TRUE(SolverModelParser::parseKaluzaAssignment(lines[3], &entry));
+    ASSERT_EQ(-7, entry.integer);
+
+    ASSERT_TRUE(SolverModelParser::parseKaluzaAssignment(lines[4], &entry));
+    ASSERT_EQ(2147483647, entry.integer);
+}
+
+// Escapes a string the way CVC4 prints string constants.
+static std::string cvc4Escape(const std::string& value)
+{
+    std::string result = "\"";
+    for (size_t i = 0; i < value.size(); i++) {
+        unsigned char c = value[i];
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if (c < 0x20 || c >= 0x7F) {
+            const char* hex = "0123456789abcdef";
+            result += "\\x";
+            result += hex[c >> 4];
+            result += hex[c & 0xF];
+        } else {
+            result += c;
+        }
+    }
+    return result + "\"";
+}
+
+TEST(SolverModelParserTest, FUZZ_STRING_ROUND_TRIP) {
+    std::srand(1);
+    const char alphabet[] = "ab ()\"\\'|;-x0u{}";
+
+    SolverModelEntry entry;
+    for (int i = 0; i < 2000; i++) {
+        std::string value;
+        int length = std::rand() % 20;
+        for (int j = 0; j < length; j++) {
+            value += (std::rand() % 8 == 0) ? (char)(std::rand() % 256) : alphabet[std::rand() % (sizeof(alphabet) - 1)];
+        }
+
+        std::string line = "(define-fun SYM_IN_x () String " + cvc4Escape(value) + ")";
+        ASSERT_TRUE(SolverModelParser::parseDefineFun(line, &entry)) << line;
+        ASSERT_EQ(SolverModelEntry::STRING, entry.kind);
+        ASSERT_EQ(value, entry.text) << line;
+    }
+}
+
+TEST(SolverModelParserTest, FUZZ_MUTATED_OUTPUTS) {
+    // Truncated and corrupted solver output must be rejected or parsed, but never read out of bounds.
+    std::vector<std::string> lines = fixture("cvc4-sat.txt");
+    std::vector<std::string> z3 = fixture("z3str-sat.txt");
+    std::vector<std::string> kaluza = fixture("kaluza-sat.txt");
+    lines.insert(lines.end(), z3.begin(), z3.end());
+    lines.insert(lines.end(), kaluza.begin(), kaluza.end());
+
+    std::srand(2);
+    SolverModelEntry entry;
+    for (int i = 0; i < 20000; i++) {
+        std::string line = lines[std::rand() % lines.size()];
+
+        switch (std::rand() % 4) {
+        case 0:
+            line = line.substr(0, line.empty() ? 0 : std::rand() % line.size());
+            break;
+        case 1:
+            if (!line.empty()) {
+                line[std::rand() % line.size()] = "()\"\\| -x"[std::rand() % 8];
+            }
+            break;
+        case 2:
+            line.insert(line.empty() ? 0 : std::rand() % line.size(), 1, (char)(std::rand() % 256));
+            break;
+        default:
+            if (!line.empty()) {
+                line.erase(std::rand() % line.size(), 1);
+            }
+        }
+
+        if (SolverModelParser::parseDefineFun(line, &entry)) {
+            ASSERT_FALSE(entry.symbol.empty()) << line;
+            ASSERT_FALSE(entry.sort.empty()) << line;
+        }
+        SolverModelParser::parseZ3StrAssignment(line, &entry);
+        SolverModelParser::parseKaluzaAssignment(line, &entry);
+        for (size_t pos = 0; pos <= line.size(); pos++) {
+            size_t end = SolverModelParser::parseValue(line, pos, &entry);
+            ASSERT_TRUE(end == std::string::npos || (end > pos && end <= line.size())) << line;
+        }
+    }
+}
+
+}
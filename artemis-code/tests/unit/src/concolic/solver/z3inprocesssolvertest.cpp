@@ -0,0 +1,152 @@
+#include <iostream>
+
+#include "include/gtest/gtest.h"
+
+#include "concolic/solver/z3solver.h"
+#include "concolic/solver/z3inprocesssolver.h"
+#include "concolic/pathcondition.h"
+
+#include <JavaScriptCore/symbolic/expr.h>
+
+namespace artemis
+{
+
+static Symbolic::StringExpression* field(const char* name)
+{
+    return new Symbolic::SymbolicString(Symbolic::SymbolicSource(Symbolic::TEXT, Symbolic::INPUT_NAME, name));
+}
+
+static Symbolic::StringExpression* constant(const char* value)
+{
+    return new Symbolic::ConstantString(new std::string(value));
+}
+
+static Symbolic::Expression* equals(Symbolic::StringExpression* lhs, Symbolic::StringExpression* rhs)
+{
+    return new Symbolic::StringBinaryOperation(lhs, Symbolic::STRING_EQ, rhs);
+}
+
+static Symbolic::Expression* longerThan(Symbolic::StringExpression* string, int length)
+{
+    return new Symbolic::IntegerBinaryOperation(new Symbolic::StringLength(string), Symbolic::INT_GT, new Symbolic::ConstantInteger(length));
+}
+
+static SolutionPtr solve(Solver* solver, PathConditionPtr pc)
+{
+    return solver->solve(pc, FormRestrictions(), DomSnapshotStoragePtr(), ReachablePathsConstraintSet(), ReorderingConstraintInfoPtr());
+}
+
+// Solves the PC in-process, and checks the verdict against Z3-str.py if it is available (i.e. ARTEMISDIR is set and
+// the solver is built).
+static SolutionPtr solveAndCompare(PathConditionPtr pc)
+{
+    ConcolicBenchmarkFeatures features;
+
+    Z3InProcessSolver inProcess(features);
+    SolutionPtr solution = solve(&inProcess, pc);
+
+    Z3Solver external(features);
+    SolutionPtr expected = solve(&external, pc);
+
+    if (expected->isSolved() || expected->isUnsat()) {
+        EXPECT_EQ(expected->isSolved(), solution->isSolved());
+        EXPECT_EQ(expected->isUnsat(), solution->isUnsat());
+    } else {
+        std::cerr << "Z3-str.py is not available, not comparing: " << expected->getUnsolvableReason().toStdString() << std::endl;
+    }
+
+    return solution;
+}
+
+// The value of the only input in a solution.
+static std::string onlyValue(SolutionPtr solution)
+{
+    EXPECT_EQ(1, solution->symbols().size());
+    return solution->symbols().isEmpty() ? "" : solution->findSymbol(solution->symbols().first()).string;
+}
+
+TEST(Z3InProcessSolverTest, CONVERTS_STRING_CONSTANTS_LIKE_Z3STR_PY) {
+    std::string result;
+
+    ASSERT_TRUE(Z3InProcessSolver::convertConstraints("; The PC\n(assert (= (= a \"x y\") true))\n(assert (= (= a \"x y\") (= b \"\")))\n", &result));
+    ASSERT_EQ("(declare-const __cOnStStR_x_aScIi_040y String)\n"
+              "(declare-const __cOnStStR_ String)\n"
+              "\n"
+              "(assert (= (= a __cOnStStR_x_aScIi_040y) true))\n"
+              "(assert (= (= a __cOnStStR_x_aScIi_040y) (= b __cOnStStR_)))\n", result);
+
+    ASSERT_TRUE(Z3InProcessSolver::convertConstraints("(assert (= a \"say \\\"(hi)\\\"\"))\n", &result));
+    ASSERT_EQ("(declare-const __cOnStStR_say_aScIi_040_aScIi_042_aScIi_050hi_aScIi_051_aScIi_042 String)\n"
+              "\n"
+              "(assert (= a __cOnStStR_say_aScIi_040_aScIi_042_aScIi_050hi_aScIi_051_aScIi_042))\n", result);
+
+    // An escaped backslash before a quote: the quote ends the constant only after an even number of backslashes.
+    ASSERT_TRUE(Z3InProcessSolver::convertConstraints("(assert (= (= a \"a\\\\\\\"\") (= b \"b\\\\\")))\n", &result));
+    ASSERT_EQ("(declare-const __cOnStStR_a_aScIi_134_aScIi_042 String)\n"
+              "(declare-const __cOnStStR_b_aScIi_134 String)\n"
+              "\n"
+              "(assert (= (= a __cOnStStR_a_aScIi_134_aScIi_042) (= b __cOnStStR_b_aScIi_134)))\n", result);
+
+    ASSERT_FALSE(Z3InProcessSolver::convertConstraints("(assert (= a \"unterminated))\n", &result));
+}
+
+TEST(Z3InProcessSolverTest, SAT) {
+    PathConditionPtr equal = PathConditionPtr(new PathCondition());
+    equal->addCondition(equals(field("name"), constant("hello world")), true, NULL);
+
+    SolutionPtr solution = solveAndCompare(equal);
+    ASSERT_TRUE(solution->isSolved());
+    ASSERT_EQ("hello world", onlyValue(solution));
+
+    PathConditionPtr concat = PathConditionPtr(new PathCondition());
+    concat->addCondition(equals(new Symbolic::StringBinaryOperation(field("name"), Symbolic::CONCAT, constant("(x)")), constant("y(x)")), true, NULL);
+
+    solution = solveAndCompare(concat);
+    ASSERT_TRUE(solution->isSolved());
+    ASSERT_EQ("y", onlyValue(solution));
+
+    PathConditionPtr length = PathConditionPtr(new PathCondition());
+    length->addCondition(longerThan(field("name"), 3), true, NULL);
+    length->addCondition(equals(field("name"), constant("")), false, NULL);
+
+    solution = solveAndCompare(length);
+    ASSERT_TRUE(solution->isSolved());
+    ASSERT_LT(3u, onlyValue(solution).size());
+}
+
+TEST(Z3InProcessSolverTest, UNSAT) {
+    PathConditionPtr contradiction = PathConditionPtr(new PathCondition());
+    contradiction->addCondition(equals(field("name"), constant("a")), true, NULL);
+    contradiction->addCondition(equals(field("name"), constant("b")), true, NULL);
+
+    SolutionPtr solution = solveAndCompare(contradiction);
+    ASSERT_FALSE(solution->isSolved());
+    ASSERT_TRUE(solution->isUnsat());
+
+    PathConditionPtr length = PathConditionPtr(new PathCondition());
+    length->addCondition(longerThan(field("name"), 3), true, NULL);
+    length->addCondition(equals(field("name"), constant("ab")), true, NULL);
+
+    solution = solveAndCompare(length);
+    ASSERT_FALSE(solution->isSolved());
+    ASSERT_TRUE(solution->isUnsat());
+}
+
+TEST(Z3InProcessSolverTest, SCOPES_ARE_INDEPENDENT) {
+    // The context is shared, so an UNSAT constraint must not leak into the next one.
+    PathConditionPtr contradiction = PathConditionPtr(new PathCondition());
+    contradiction->addCondition(equals(field("name"), constant("a")), true, NULL);
+    contradiction->addCondition(equals(field("name"), constant("a")), false, NULL);
+    ASSERT_TRUE(solveAndCompare(contradiction)->isUnsat());
+
+    for (int i = 0; i < 3; i++) {
+        PathConditionPtr equal = PathConditionPtr(new PathCondition());
+        equal->addCondition(equals(field("name"), constant("a")), true, NULL);
+
+        SolutionPtr solution = solveAndCompare(equal);
+        ASSERT_TRUE(solution->isSolved());
+        ASSERT_EQ("a", onlyValue(solution));
+    }
+}
+
+}
@@ -0,0 +1,97 @@
+#include <QSource>
+
+#include "include/gtest/gtest.h"
+
+#include "model/javascriptstatistics.h"
+#include "runtime/input/inputsequence.h"
+#include "runtime/input/ajaxinput.h"
+
+namespace artemis
+{
+
+// The write set of a sequence as the union of the write sets of its inputs.
+static QSet<QString> unionOfWriteSets(const JavascriptStatistics& statistics, InputSequenceConstPtr sequence)
+{
+    QSet<QString> written;
+    foreach (BaseInputConstPtr input, sequence->toList()) {
+        written.unite(statistics.getPropertiesWritten(input));
+    }
+    return written;
+}
+
+static QSet<QString> propertyNames(const JavascriptStatistics& statistics, const QBitArray& ids)
+{
+    QSet<QString> names;
+    for (int id = 0; id < ids.size(); id++) {
+        if (ids.testBit(id)) {
+            names.insert(statistics.getPropertyName(id));
+        }
+    }
+    return names;
+}
+
+TEST(JavascriptStatisticsTest, WRITE_SETS_OF_SEQUENCES) {
+    JavascriptStatistics statistics;
+    QSource source(0, "http://www.example.com/app.js", 1);
+
+    QList<BaseInputConstPtr> inputs;
+    for (int i = 0; i < 6; i++) {
+        inputs.append(BaseInputConstPtr(new AjaxInput(i)));
+    }
+
+    // Sequences sharing prefixes, as built by the input generators.
+    QList<InputSequenceConstPtr> sequences;
+    sequences.append(InputSequenceConstPtr(new InputSequence()));
+
+    uint random = 1;
+    for (int step = 0; step < 300; step++) {
+        random = random * 1103515245 + 12345;
+
+        // Execute an input, which writes a few properties, sometimes new ones.
+        BaseInputConstPtr input = inputs.at((random >> 8) % inputs.size());
+        statistics.notifyStartingEvent(input);
+        for (uint i = 0; i < (random >> 12) % 3; i++) {
+            statistics.slJavascriptPropertyWritten(QString("p%1").arg((random >> (14 + i)) % (step / 4 + 2)), 0, 0, &source);
+        }
+
+        // Grow the set of sequences from a random existing one.
+        InputSequenceConstPtr base = sequences.at((random >> 16) % sequences.size());
+        if (!base->isEmpty() && (random >> 20) % 3 == 0) {
+            sequences.append(base->replaceLast(input));
+        } else if (base->length() < 12) {
+            sequences.append(base->extend(input));
+        }
+
+        // Query a few sequences, so some cached prefixes are used after the write sets have changed.
+        for (int i = 0; i < 3; i++) {
+            InputSequenceConstPtr sequence = sequences.at((random >> (4 * i + 3)) % sequences.size());
+            ASSERT_EQ(unionOfWriteSets(statistics, sequence),
+                      propertyNames(statistics, statistics.getPropertyIdsWritten(sequence)));
+            if (!sequence->isEmpty()) {
+                ASSERT_EQ(unionOfWriteSets(statistics, sequence->removeLast()),
+                          propertyNames(statistics, statistics.getPropertyIdsWritten(sequence->removeLast())));
+            }
+        }
+    }
+
+    foreach (InputSequenceConstPtr sequence, sequences) {
+        ASSERT_EQ(unionOfWriteSets(statistics, sequence), propertyNames(statistics, statistics.getPropertyIdsWritten(sequence)));
+    }
+}
+
+TEST(JavascriptStatisticsTest, SEQUENCES_SHARED_BETWEEN_INSTANCES) {
+    QSource source(0, "http://www.example.com/app.js", 1);
+    BaseInputConstPtr input = BaseInputConstPtr(new AjaxInput(1));
+    InputSequenceConstPtr sequence = InputSequenceConstPtr(new InputSequence())->extend(input);
+
+    JavascriptStatistics first;
+    first.notifyStartingEvent(input);
+    first.slJavascriptPropertyWritten("a", 0, 0, &source);
+    ASSERT_EQ(QSet<QString>() << "a", propertyNames(first, first.getPropertyIdsWritten(sequence)));
+
+    // The write set cached by the first instance is not used by the second.
+    JavascriptStatistics second;
+    ASSERT_EQ(QSet<QString>(), propertyNames(second, second.getPropertyIdsWritten(sequence)));
+}
+
+}
@@ -0,0 +1,61 @@
+#include <QFile>
+#include <QTextStream>
+
+#include "include/gtest/gtest.h"
+
+#include "model/pathtracelogreader.h"
+
+namespace artemis
+{
+
+static void writeFile(QString path, QString contents)
+{
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text));
+    QTextStream(&file) << contents;
+}
+
+static QString readFile(QString path)
+{
+    QFile file(path);
+    EXPECT_TRUE(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    return QTextStream(&file).readAll();
+}
+
+TEST(PathTraceLogReaderTest, HTML_REPORT_FROM_LOG) {
+    writeFile("pathtracelogreadertest.log",
+              "trace\tload\tStarting Page Load\n"
+              "source\t7\thttp://example.com/js/app.js?v=1\n"
+              "call\tinit()\t12\t7\n"
+              "call\ta<b>()\t20\t7\n"
+              "alert\tline 1\\nline\\t2 \\\\ end\n"
+              "return\ta<b>()\n"
+              "trace\tclick\tReceived Event: 'click' on 'A'\n"
+              "call\tonClick()\t40\t7\n"
+              "limit\t4\n");
+
+    PathTraceLogReader reader("pathtracelogreadertest.log");
+    ASSERT_TRUE(reader.writeHTML("pathtracelogreadertest.html", true, "coverage.html"));
+
+    QString html = readFile("pathtracelogreadertest.html");
+
+    ASSERT_TRUE(html.contains("<li class=\"trace load collapsed\">"));
+    ASSERT_TRUE(html.contains("<li class=\"trace click collapsed\">"));
+    ASSERT_TRUE(html.contains("<span class=\"itemname\">a&lt;b&gt;()</span>"));
+    ASSERT_TRUE(html.contains("File: <a href=\"http://example.com/js/app.js?v=1\">app.js?...</a>, Line: 12"));
+    ASSERT_TRUE(html.contains("coverage.html?code=ID7&line=40"));
+    ASSERT_TRUE(html.contains("line 1\\nline\t2 \\ end"));
+    ASSERT_TRUE(html.contains("only the first 4 trace items were recorded"));
+
+    // The call to init() and onClick() never returned, they are closed at the end of their trace.
+    ASSERT_EQ(html.count("<ol"), html.count("</ol>"));
+    ASSERT_EQ(html.count("<li"), html.count("</li>"));
+}
+
+TEST(PathTraceLogReaderTest, MISSING_LOG_HAS_NO_TRACES) {
+    PathTraceLogReader reader("");
+    ASSERT_TRUE(reader.writeHTML("pathtracelogreadertest-empty.html", false, ""));
+    ASSERT_TRUE(readFile("pathtracelogreadertest-empty.html").contains("No traces were recorded."));
+}
+
+}
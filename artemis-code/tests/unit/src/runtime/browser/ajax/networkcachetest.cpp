@@ -0,0 +1,205 @@
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QUrl>
+
+#include "include/gtest/gtest.h"
+
+#include "runtime/browser/ajax/networkcache.h"
+
+namespace artemis
+{
+
+// A fresh cache directory for each test, removed again by the destructor.
+class NetworkCacheDirectory
+{
+public:
+    NetworkCacheDirectory(QString name)
+        : path(QString("%1/artemis-networkcachetest-%2-%3").arg(QDir::tempPath()).arg(QCoreApplication::applicationPid()).arg(name))
+    {
+        remove();
+    }
+
+    ~NetworkCacheDirectory()
+    {
+        remove();
+    }
+
+    QStringList files(QString subdirectory) const
+    {
+        return QDir(path + "/" + subdirectory).entryList(QDir::Files);
+    }
+
+    const QString path;
+
+private:
+    void remove()
+    {
+        foreach (QString subdirectory, QStringList() << "entries" << "objects") {
+            QDir dir(path + "/" + subdirectory);
+            foreach (QString file, dir.entryList(QDir::Files)) {
+                dir.remove(file);
+            }
+            QDir().rmdir(dir.path());
+        }
+        QDir().rmdir(path);
+    }
+};
+
+static QByteArray key(QNetworkAccessManager::Operation op, QString url, QByteArray body = QByteArray(),
+                      QList<QNetworkCookie> cookies = QList<QNetworkCookie>())
+{
+    return NetworkCache::requestKey(op, QNetworkRequest(QUrl(url)), body, cookies);
+}
+
+static CachedResponseConstPtr response(int statusCode, QByteArray body)
+{
+    QSharedPointer<CachedResponse> response(new CachedResponse());
+    response->statusCode = statusCode;
+    response->reasonPhrase = statusCode == 200 ? "OK" : "Not Found";
+    response->headers.append(QPair<QByteArray, QByteArray>("Content-Type", "text/html"));
+    response->body = body;
+    return response;
+}
+
+TEST(NetworkCacheTest, REQUEST_KEYS) {
+    QByteArray get = key(QNetworkAccessManager::GetOperation, "http://example.com/a");
+
+    ASSERT_EQ(get, key(QNetworkAccessManager::GetOperation, "http://example.com/a"));
+    ASSERT_NE(get, key(QNetworkAccessManager::PostOperation, "http://example.com/a"));
+    ASSERT_NE(get, key(QNetworkAccessManager::GetOperation, "http://example.com/b"));
+
+    QByteArray post = key(QNetworkAccessManager::PostOperation, "http://example.com/a", "x=1");
+    ASSERT_NE(post, key(QNetworkAccessManager::PostOperation, "http://example.com/a", "x=2"));
+
+    // The same request before and after logging in.
+    QList<QNetworkCookie> session;
+    session.append(QNetworkCookie("session", "1234"));
+    QByteArray loggedIn = key(QNetworkAccessManager::GetOperation, "http://example.com/a", QByteArray(), session);
+    ASSERT_NE(get, loggedIn);
+
+    QList<QNetworkCookie> otherSession;
+    otherSession.append(QNetworkCookie("session", "5678"));
+    ASSERT_NE(loggedIn, key(QNetworkAccessManager::GetOperation, "http://example.com/a", QByteArray(), otherSession));
+
+    // Cookies set on the request itself count as well.
+    QNetworkRequest request(QUrl("http://example.com/a"));
+    request.setRawHeader("Cookie", "session=1234");
+    ASSERT_NE(get, NetworkCache::requestKey(QNetworkAccessManager::GetOperation, request, QByteArray(), QList<QNetworkCookie>()));
+}
+
+TEST(NetworkCacheTest, IS_CACHEABLE) {
+    ASSERT_TRUE(NetworkCache::isCacheable(QNetworkAccessManager::GetOperation, QNetworkRequest(QUrl("http://example.com/"))));
+    ASSERT_TRUE(NetworkCache::isCacheable(QNetworkAccessManager::PostOperation, QNetworkRequest(QUrl("https://example.com/"))));
+    ASSERT_FALSE(NetworkCache::isCacheable(QNetworkAccessManager::PutOperation, QNetworkRequest(QUrl("http://example.com/"))));
+    ASSERT_FALSE(NetworkCache::isCacheable(QNetworkAccessManager::GetOperation, QNetworkRequest(QUrl("file:///tmp/a.html"))));
+}
+
+TEST(NetworkCacheTest, IS_REPLAYABLE) {
+    CachedResponseConstPtr ok = response(200, "body");
+
+    QSharedPointer<CachedResponse> notFound(new CachedResponse(*response(404, "Not here")));
+    notFound->error = QNetworkReply::ContentNotFoundError;
+
+    QSharedPointer<CachedResponse> hostNotFound(new CachedResponse());
+    hostNotFound->error = QNetworkReply::HostNotFoundError;
+
+    ASSERT_TRUE(NetworkCache::isReplayable(QNetworkAccessManager::GetOperation, ok));
+    ASSERT_TRUE(NetworkCache::isReplayable(QNetworkAccessManager::HeadOperation, ok));
+    ASSERT_TRUE(NetworkCache::isReplayable(QNetworkAccessManager::GetOperation, notFound));
+
+    // POSTs always reach the server, and connection failures are retried.
+    ASSERT_FALSE(NetworkCache::isReplayable(QNetworkAccessManager::PostOperation, ok));
+    ASSERT_FALSE(NetworkCache::isReplayable(QNetworkAccessManager::GetOperation, hostNotFound));
+    ASSERT_FALSE(NetworkCache::isReplayable(QNetworkAccessManager::GetOperation, CachedResponseConstPtr()));
+}
+
+TEST(NetworkCacheTest, ROUND_TRIP_THROUGH_DISK) {
+    NetworkCacheDirectory directory("roundtrip");
+    QByteArray page = key(QNetworkAccessManager::GetOperation, "http://example.com/");
+
+    {
+        NetworkCache cache(directory.path);
+        ASSERT_TRUE(cache.lookup(page).isNull());
+        cache.store(page, response(200, "<html>Hello</html>"));
+    }
+
+    // A new cache (i.e. a later run) reads the entry back from disk.
+    NetworkCache cache(directory.path);
+    CachedResponseConstPtr replayed = cache.lookup(page);
+    ASSERT_FALSE(replayed.isNull());
+    ASSERT_EQ(200, replayed->statusCode);
+    ASSERT_EQ(QNetworkReply::NoError, replayed->error);
+    ASSERT_EQ(QByteArray("OK"), replayed->reasonPhrase);
+    ASSERT_EQ(1, replayed->headers.size());
+    ASSERT_EQ(QByteArray("text/html"), replayed->headers.at(0).second);
+    ASSERT_EQ(QByteArray("<html>Hello</html>"), replayed->body);
+}
+
+TEST(NetworkCacheTest, ERROR_RESPONSES) {
+    NetworkCacheDirectory directory("errors");
+    QByteArray missing = key(QNetworkAccessManager::GetOperation, "http://example.com/missing");
+    QByteArray unreachable = key(QNetworkAccessManager::GetOperation, "http://unreachable.example.com/");
+
+    {
+        NetworkCache cache(directory.path);
+
+        QSharedPointer<CachedResponse> notFound(new CachedResponse(*response(404, "Not here")));
+        notFound->error = QNetworkReply::ContentNotFoundError;
+        notFound->errorString = "Not Found";
+        cache.store(missing, notFound);
+
+        QSharedPointer<CachedResponse> hostNotFound(new CachedResponse());
+        hostNotFound->error = QNetworkReply::HostNotFoundError;
+        hostNotFound->errorString = "Host unreachable.example.com not found";
+        cache.store(unreachable, hostNotFound);
+    }
+
+    NetworkCache cache(directory.path);
+
+    CachedResponseConstPtr notFound = cache.lookup(missing);
+    ASSERT_FALSE(notFound.isNull());
+    ASSERT_EQ(404, notFound->statusCode);
+    ASSERT_EQ(QNetworkReply::ContentNotFoundError, notFound->error);
+    ASSERT_EQ(QByteArray("Not here"), notFound->body);
+
+    CachedResponseConstPtr hostNotFound = cache.lookup(unreachable);
+    ASSERT_FALSE(hostNotFound.isNull());
+    ASSERT_EQ(0, hostNotFound->statusCode);
+    ASSERT_EQ(QNetworkReply::HostNotFoundError, hostNotFound->error);
+    ASSERT_EQ(QString("Host unreachable.example.com not found"), hostNotFound->errorString);
+    ASSERT_TRUE(hostNotFound->body.isEmpty());
+}
+
+TEST(NetworkCacheTest, IDENTICAL_BODIES_ARE_STORED_ONCE) {
+    NetworkCacheDirectory directory("dedupe");
+    NetworkCache cache(directory.path);
+
+    cache.store(key(QNetworkAccessManager::GetOperation, "http://a.example.com/jquery.js"), response(200, "library"));
+    cache.store(key(QNetworkAccessManager::GetOperation, "http://b.example.com/jquery.js"), response(200, "library"));
+
+    ASSERT_EQ(2, directory.files("entries").size());
+    ASSERT_EQ(1, directory.files("objects").size());
+}
+
+TEST(NetworkCacheTest, CORRUPT_OBJECTS_ARE_IGNORED) {
+    NetworkCacheDirectory directory("corrupt");
+    QByteArray page = key(QNetworkAccessManager::GetOperation, "http://example.com/");
+
+    {
+        NetworkCache cache(directory.path);
+        cache.store(page, response(200, "<html>Hello</html>"));
+    }
+
+    QStringList objects = directory.files("objects");
+    ASSERT_EQ(1, objects.size());
+    QFile object(directory.path + "/objects/" + objects.at(0));
+    ASSERT_TRUE(object.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    object.write("<html>Hel");
+    object.close();
+
+    NetworkCache cache(directory.path);
+    ASSERT_TRUE(cache.lookup(page).isNull());
+}
+
+}
@@ -0,0 +1,95 @@
+#include <QList>
+#include <QSet>
+
+#include "include/gtest/gtest.h"
+
+#include "runtime/browser/eventhandlerfilter.h"
+
+namespace artemis
+{
+
+// The filter only uses the elements for their identity, so the synthetic handlers use fake element pointers.
+static WebCore::Element* fakeElement(int i)
+{
+    return reinterpret_cast<WebCore::Element*>((quintptr)(i + 1) * 16);
+}
+
+TEST(EventHandlerFilterTest, KEEPS_REPEATED_HANDLERS) {
+    EventHandlerFilter filter;
+
+    // Handlers which are not on an element have no element to check.
+    ASSERT_EQ(EventHandlerFilter::ACCEPTED, filter.check(NULL));
+
+    QSet<WebCore::Element*> visible;
+    visible << fakeElement(0);
+    filter.setVisibleElements(visible);
+
+    // A second listener for the same event on the same element is reported again.
+    ASSERT_EQ(EventHandlerFilter::ACCEPTED, filter.check(fakeElement(0)));
+    ASSERT_EQ(EventHandlerFilter::ACCEPTED, filter.check(fakeElement(0)));
+    ASSERT_EQ(EventHandlerFilter::NOT_VISIBLE, filter.check(fakeElement(1)));
+    ASSERT_EQ(EventHandlerFilter::NOT_VISIBLE, filter.check(fakeElement(1)));
+}
+
+TEST(EventHandlerFilterTest, VISIBILITY_AND_FILTER_AREA) {
+    EventHandlerFilter filter;
+    ASSERT_FALSE(filter.needsElements());
+
+    QSet<WebCore::Element*> visible;
+    visible << fakeElement(0) << fakeElement(1);
+    filter.setVisibleElements(visible);
+
+    QSet<WebCore::Element*> area;
+    area << fakeElement(1) << fakeElement(2);
+    filter.setFilterAreaElements(area);
+
+    ASSERT_TRUE(filter.needsElements());
+    ASSERT_EQ(EventHandlerFilter::OUTSIDE_FILTER_AREA, filter.check(fakeElement(0)));
+    ASSERT_EQ(EventHandlerFilter::ACCEPTED, filter.check(fakeElement(1)));
+    ASSERT_EQ(EventHandlerFilter::NOT_VISIBLE, filter.check(fakeElement(2)));
+
+    // reset() removes the filters.
+    filter.reset();
+    ASSERT_FALSE(filter.needsElements());
+    ASSERT_EQ(EventHandlerFilter::ACCEPTED, filter.check(fakeElement(0)));
+}
+
+// Microbenchmark, timed by the test runner: a large delegated table with 10k handlers, of which every third is
+// invisible and every fifth is a second listener for the same event on the same element.
+TEST(EventHandlerFilterTest, BENCHMARK_10K_HANDLERS) {
+    const int handlers = 10000;
+
+    QSet<WebCore::Element*> visible;
+    for (int i = 0; i < handlers; i++) {
+        if (i % 3 != 0) {
+            visible.insert(fakeElement(i));
+        }
+    }
+
+    QList<int> expected;
+    for (int i = 0; i < handlers; i++) {
+        if (i % 3 != 0) {
+            expected.append(i);
+            if (i % 5 == 0) {
+                expected.append(i);
+            }
+        }
+    }
+
+    EventHandlerFilter filter;
+    filter.setVisibleElements(visible);
+
+    QList<int> accepted;
+    for (int i = 0; i < handlers; i++) {
+        if (filter.check(fakeElement(i)) == EventHandlerFilter::ACCEPTED) {
+            accepted.append(i);
+        }
+        if (i % 5 == 0 && filter.check(fakeElement(i)) == EventHandlerFilter::ACCEPTED) {
+            accepted.append(i);
+        }
+    }
+
+    ASSERT_EQ(expected, accepted);
+}
+
+}
@@ -0,0 +1,73 @@
+#include "include/gtest/gtest.h"
+
+#include "runtime/input/inputsequence.h"
+#include "runtime/input/ajaxinput.h"
+
+namespace artemis
+{
+
+static BaseInputConstPtr input(int id)
+{
+    return BaseInputConstPtr(new AjaxInput(id));
+}
+
+TEST(InputSequenceTest, EMPTY) {
+    InputSequence sequence;
+    ASSERT_TRUE(sequence.isEmpty());
+    ASSERT_EQ(0, sequence.length());
+    ASSERT_TRUE(sequence.toList().isEmpty());
+}
+
+TEST(InputSequenceTest, FROM_LIST) {
+    QList<BaseInputConstPtr> inputs;
+    inputs << input(1) << input(2) << input(3);
+
+    InputSequence sequence(inputs);
+    ASSERT_FALSE(sequence.isEmpty());
+    ASSERT_EQ(3, sequence.length());
+    ASSERT_EQ(inputs, sequence.toList());
+    ASSERT_EQ(inputs.last(), sequence.getLast());
+}
+
+TEST(InputSequenceTest, EXTEND_AND_REPLACE_LAST_SHARE_THE_PREFIX) {
+    BaseInputConstPtr first = input(1);
+    BaseInputConstPtr second = input(2);
+    BaseInputConstPtr replacement = input(3);
+
+    InputSequenceConstPtr empty = InputSequenceConstPtr(new InputSequence());
+    InputSequenceConstPtr one = empty->extend(first);
+    InputSequenceConstPtr two = one->extend(second);
+    InputSequenceConstPtr replaced = two->replaceLast(replacement);
+
+    // The sequences they were built from are unchanged.
+    ASSERT_TRUE(empty->isEmpty());
+    ASSERT_EQ(QList<BaseInputConstPtr>() << first, one->toList());
+
+    ASSERT_EQ(2, two->length());
+    ASSERT_EQ(QList<BaseInputConstPtr>() << first << second, two->toList());
+    ASSERT_EQ(second, two->getLast());
+
+    ASSERT_EQ(2, replaced->length());
+    ASSERT_EQ(QList<BaseInputConstPtr>() << first << replacement, replaced->toList());
+    ASSERT_EQ(replacement, replaced->getLast());
+
+    // Building on an older sequence gives a separate branch.
+    InputSequenceConstPtr branch = one->extend(replacement)->extend(second);
+    ASSERT_EQ(QList<BaseInputConstPtr>() << first << replacement << second, branch->toList());
+    ASSERT_EQ(QList<BaseInputConstPtr>() << first << second, two->toList());
+}
+
+TEST(InputSequenceTest, LONG_SEQUENCE) {
+    QList<BaseInputConstPtr> inputs;
+    InputSequenceConstPtr sequence = InputSequenceConstPtr(new InputSequence());
+
+    for (int i = 0; i < 1000; i++) {
+        inputs.append(input(i));
+        sequence = sequence->extend(inputs.last());
+    }
+
+    ASSERT_EQ(1000, sequence->length());
+    ASSERT_EQ(inputs, sequence->toList());
+}
+
+}
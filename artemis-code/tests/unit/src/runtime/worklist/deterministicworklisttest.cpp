@@ -0,0 +1,180 @@
+#include <QSource>
+
+#include "include/gtest/gtest.h"
+
+#include "runtime/worklist/deterministicworklist.h"
+#include "runtime/input/ajaxinput.h"
+
+namespace artemis
+{
+
+// Scores a configuration by the properties read and written by its inputs, like the read/write prioritizer. Each
+// configuration also gets a distinct fraction of the score, so the order of the worklist does not depend on ties.
+class ReadWriteCountPrioritizer : public PrioritizerStrategy
+{
+public:
+    ReadWriteCountPrioritizer(bool stable)
+        : mStable(stable)
+        , mCalls(0)
+    {}
+
+    double prioritize(QSharedPointer<const ExecutableConfiguration> newConf, AppModelConstPtr appmodel)
+    {
+        mCalls++;
+
+        if (!mIds.contains(newConf.data())) {
+            mIds.insert(newConf.data(), mIds.size());
+        }
+
+        int score = 0;
+        foreach (BaseInputConstPtr input, newConf->getInputSequence()->toList()) {
+            score += appmodel->getJavascriptStatistics()->getPropertiesRead(input).size();
+            score += 2 * appmodel->getJavascriptStatistics()->getPropertiesWritten(input).size();
+        }
+
+        return score + mIds.value(newConf.data()) / 1000.0;
+    }
+
+    bool isStable() const
+    {
+        return mStable;
+    }
+
+    int calls() const
+    {
+        return mCalls;
+    }
+
+private:
+    bool mStable;
+    int mCalls;
+    QHash<const ExecutableConfiguration*, int> mIds;
+};
+
+static ExecutableConfigurationConstPtr configuration(const QList<BaseInputConstPtr>& inputs)
+{
+    return ExecutableConfigurationConstPtr(new ExecutableConfiguration(InputSequenceConstPtr(new InputSequence(inputs)),
+                                                                       QUrl("http://www.example.com")));
+}
+
+static void execute(AppModelPtr appmodel, BaseInputConstPtr input, const QString& property, bool write)
+{
+    static QSource source(0, "http://www.example.com/app.js", 1);
+
+    appmodel->getJavascriptStatistics()->notifyStartingEvent(input);
+    if (write) {
+        appmodel->getJavascriptStatistics()->slJavascriptPropertyWritten(property, 0, 0, &source);
+    } else {
+        appmodel->getJavascriptStatistics()->slJavascriptPropertyRead(property, 0, 0, &source);
+    }
+}
+
+TEST(DeterministicWorkListTest, INPUT_MASK_COLLISIONS_ARE_NOT_RESCORED)
+{
+    AppModelPtr appmodel = AppModelPtr(new AppModel(Options()));
+    QSharedPointer<ReadWriteCountPrioritizer> selectivePrioritizer(new ReadWriteCountPrioritizer(true));
+    QSharedPointer<ReadWriteCountPrioritizer> fullPrioritizer(new ReadWriteCountPrioritizer(false));
+    DeterministicWorkList selective(selectivePrioritizer);
+    DeterministicWorkList full(fullPrioritizer);
+
+    // The hash codes of b and d are equal to the hash code of a modulo 64, so they share its bit in the input masks.
+    BaseInputConstPtr a(new AjaxInput(0));
+    BaseInputConstPtr b(new AjaxInput(64));
+    BaseInputConstPtr c(new AjaxInput(1));
+    BaseInputConstPtr d(new AjaxInput(-64));
+
+    QList<QList<BaseInputConstPtr> > sequences;
+    sequences << (QList<BaseInputConstPtr>() << b)
+              << (QList<BaseInputConstPtr>() << b << c)
+              << (QList<BaseInputConstPtr>() << d)
+              << (QList<BaseInputConstPtr>() << a)
+              << (QList<BaseInputConstPtr>() << c << a);
+
+    foreach (QList<BaseInputConstPtr> sequence, sequences) {
+        ExecutableConfigurationConstPtr conf = configuration(sequence);
+        selective.add(conf, appmodel);
+        full.add(conf, appmodel);
+    }
+
+    execute(appmodel, a, "x", true);
+
+    int callsBefore = selectivePrioritizer->calls();
+    selective.reprioritize(appmodel);
+    full.reprioritize(appmodel);
+
+    // Only [a] and [c, a] contain the changed input.
+    ASSERT_EQ(2, selectivePrioritizer->calls() - callsBefore);
+    ASSERT_EQ(full.toString(), selective.toString());
+
+    // Nothing changed since the last reprioritisation.
+    callsBefore = selectivePrioritizer->calls();
+    selective.reprioritize(appmodel);
+    full.reprioritize(appmodel);
+
+    ASSERT_EQ(0, selectivePrioritizer->calls() - callsBefore);
+    ASSERT_EQ(full.toString(), selective.toString());
+
+    // A change to a colliding input rescores its own configurations, but not [a] or [c, a].
+    execute(appmodel, b, "y", false);
+
+    callsBefore = selectivePrioritizer->calls();
+    selective.reprioritize(appmodel);
+    full.reprioritize(appmodel);
+
+    ASSERT_EQ(2, selectivePrioritizer->calls() - callsBefore);
+    ASSERT_EQ(full.toString(), selective.toString());
+}
+
+TEST(DeterministicWorkListTest, SELECTIVE_RESCORING_EQUALS_FULL_RESCORING)
+{
+    AppModelPtr appmodel = AppModelPtr(new AppModel(Options()));
+    DeterministicWorkList selective(PrioritizerStrategyPtr(new ReadWriteCountPrioritizer(true)));
+    DeterministicWorkList full(PrioritizerStrategyPtr(new ReadWriteCountPrioritizer(false)));
+
+    // Callback ids 64 apart give hash codes which are equal modulo 64, so many inputs share a bit of the input masks.
+    QList<BaseInputConstPtr> inputs;
+    for (int i = -2; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            inputs.append(BaseInputConstPtr(new AjaxInput(64 * i + j)));
+        }
+    }
+
+    uint random = 1;
+    for (int step = 0; step < 400; step++) {
+        random = random * 1103515245 + 12345;
+
+        // Add a configuration of up to four inputs.
+        QList<BaseInputConstPtr> sequence;
+        for (uint i = 0; i <= (random >> 8) % 4; i++) {
+            sequence.append(inputs.at((random >> (10 + 3 * i)) % inputs.size()));
+        }
+        ExecutableConfigurationConstPtr conf = configuration(sequence);
+        selective.add(conf, appmodel);
+        full.add(conf, appmodel);
+
+        // Execute an input, which sometimes reads or writes a new property.
+        random = random * 1103515245 + 12345;
+        execute(appmodel, inputs.at((random >> 8) % inputs.size()),
+                QString("p%1").arg((random >> 12) % 20), (random >> 20) % 2 == 0);
+
+        if ((random >> 22) % 3 == 0) {
+            selective.reprioritize(appmodel);
+            full.reprioritize(appmodel);
+            ASSERT_EQ(full.toString(), selective.toString()) << "step " << step;
+        }
+
+        if ((random >> 24) % 4 == 0) {
+            ASSERT_EQ(full.remove(), selective.remove()) << "step " << step;
+        }
+    }
+
+    selective.reprioritize(appmodel);
+    full.reprioritize(appmodel);
+
+    ASSERT_EQ(full.size(), selective.size());
+    while (!full.empty()) {
+        ASSERT_EQ(full.remove(), selective.remove());
+    }
+}
+
+} // namespace artemis
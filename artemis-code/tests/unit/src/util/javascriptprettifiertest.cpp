@@ -0,0 +1,47 @@
+#include "include/gtest/gtest.h"
+
+#include "util/javascriptprettifier.h"
+
+namespace artemis
+{
+
+static QString prettify(QString source)
+{
+    PrettifyMappingPtr mapping = JavaScriptPrettifier::prettify(source);
+    return mapping.isNull() ? QString() : mapping->getPrettySource();
+}
+
+TEST(JavaScriptPrettifierTest, REGEX_AFTER_CONDITION) {
+    // The ';' and '{' are part of the regular expression, so they must not break the line.
+    ASSERT_EQ(QString("if(a)/;{/.test(b);\nx=1;"), prettify("if(a)/;{/.test(b);x=1;"));
+    ASSERT_EQ(QString("while(a)/x;/.exec(b);\nx=1;"), prettify("while(a)/x;/.exec(b);x=1;"));
+    ASSERT_EQ(QString("if(f(a))/;/.test(b);\nx=1;"), prettify("if(f(a))/;/.test(b);x=1;"));
+}
+
+TEST(JavaScriptPrettifierTest, DIVISION_AFTER_PARENTHESES) {
+    ASSERT_EQ(QString("x=(a)/2;\ny=b/1;"), prettify("x=(a)/2;y=b/1;"));
+    ASSERT_EQ(QString("x=f(a)/2;\ny=b/1;"), prettify("x=f(a)/2;y=b/1;"));
+    ASSERT_EQ(QString("x=a[0]/2;\ny=b/1;"), prettify("x=a[0]/2;y=b/1;"));
+}
+
+TEST(JavaScriptPrettifierTest, LINE_BREAKS_AND_ASI) {
+    // No semicolon is inserted after b, as the next line can continue the expression: this is a division.
+    ASSERT_EQ(QString("a=b\n/1;\nc=2/d;"), prettify("a=b\n/1;c=2/d;"));
+
+    // A semicolon is inserted after return, so this is a regular expression.
+    ASSERT_EQ(QString("return\n/;/.test(x);\ny();"), prettify("return\n/;/.test(x);y();"));
+}
+
+TEST(JavaScriptPrettifierTest, FOR_LOOPS) {
+    ASSERT_EQ(QString("for(;;){\n    x();\n}"), prettify("for(;;){x();}"));
+    ASSERT_EQ(QString("for(i=0;i<n;i++){\n    x();\n}"), prettify("for(i=0;i<n;i++){x();}"));
+}
+
+TEST(JavaScriptPrettifierTest, UNSUPPORTED_SCRIPTS_ARE_NOT_MODIFIED) {
+    ASSERT_TRUE(JavaScriptPrettifier::prettify("a);").isNull());
+    ASSERT_TRUE(JavaScriptPrettifier::prettify("f(a;").isNull());
+    ASSERT_TRUE(JavaScriptPrettifier::prettify("x=`a`;").isNull());
+    ASSERT_TRUE(JavaScriptPrettifier::prettify("x='a;").isNull());
+}
+
+}
@@ -9,6 +9,9 @@ LIBS += -pthread
 
 DEFINES += ARTEMIS=1
 
+# Files read by the tests, e.g. solver outputs.
+DEFINES += UNIT_FIXTURES_DIR=\\\"$$PWD/fixtures\\\"
+
 LIBS += ../../../WebKit/WebKitBuild/Release/lib/libQtWebKit.so
 
 INCLUDEPATH += ../../../WebKit/WebKitBuild/Release/include/ \
@@ -22,6 +25,10 @@ INCLUDEPATH += ../../../WebKit/WebKitBuild/Release/include/ \
 
 VPATH += ../../
 
+z3inprocess {
+    SOURCES += src/concolic/solver/z3inprocesssolvertest.cpp
+}
+
 include(../../artemis-core.pri)
 # Override some options set in artemis-core.pri, as gmock has some warnings.
 QMAKE_CXXFLAGS += -Wno-error
@@ -38,4 +45,22 @@ SOURCES += \
     src/gmock/gmock-all.cc \
     src/strategies/inputgenerator/form/constantstringforminputgeneratortest.cpp \
     src/concolic/solver/cvc4regextest.cpp \
-    src/concolic/solver/cvc4solvertest.cpp
+    src/concolic/solver/cvc4solvertest.cpp \
+    src/concolic/solver/slicingsolvertest.cpp \
+    src/concolic/solver/solvermodelparsertest.cpp \
+    src/concolic/indicatorwordmatchertest.cpp \
+    src/concolic/handlerdependencytrackertest.cpp \
+    src/concolic/entrypointstest.cpp \
+    src/concolic/concolicanalysistest.cpp \
+    src/concolic/reordering/reorderingschedulertest.cpp \
+    src/concolic/reordering/reachablepathsconstraintgeneratortest.cpp \
+    src/concolic/executiontree/tracespillertest.cpp \
+    src/concolic/executiontree/tracemergertest.cpp \
+    src/concolic/executiontree/tracedisplaytest.cpp \
+    src/model/pathtracelogreadertest.cpp \
+    src/model/javascriptstatisticstest.cpp \
+    src/runtime/browser/ajax/networkcachetest.cpp \
+    src/runtime/browser/eventhandlerfiltertest.cpp \
+    src/runtime/worklist/deterministicworklisttest.cpp \
+    src/runtime/input/inputsequencetest.cpp \
+    src/util/javascriptprettifiertest.cpp
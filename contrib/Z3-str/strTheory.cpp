@@ -5247,6 +5247,54 @@ void cb_delete(Z3_theory t)
   free(td);
 }
 
+/*
+ * Forgets everything the theory has cached about the current problem, so that the same context can be used to solve
+ * another one (after a Z3_pop). The caches are keyed on AST nodes, which Z3 reclaims when their scope is popped.
+ */
+void reset_str_theory()
+{
+  searchStart = 0;
+  concatInit = 0;
+  tmpStringVarCount = 0;
+  tmpIntVarCount = 0;
+  tmpXorVarCount = 0;
+  tmpBoolVarCount = 0;
+  tmpConcatCount = 0;
+
+  constStr_astNode_map.clear();
+  concat_astNode_map.clear();
+  length_astNode_map.clear();
+  contains_astNode_map.clear();
+  containsReduced_bool_str_map.clear();
+  containsReduced_bool_subStr_map.clear();
+  basicStrVarAxiom_added.clear();
+  concat_eqc_index.clear();
+  initAxiom.clear();
+  varForBreakConcat.clear();
+
+  std::map<Z3_ast, std::stack<T_cut *> >::iterator sfxItor;
+  for (sfxItor = cut_SuffixMap.begin(); sfxItor != cut_SuffixMap.end(); sfxItor++)
+  {
+    while (sfxItor->second.size() > 0)
+    {
+      delete sfxItor->second.top();
+      sfxItor->second.pop();
+    }
+  }
+  cut_SuffixMap.clear();
+
+  std::map<Z3_ast, std::stack<T_cut *> >::iterator varItor;
+  for (varItor = cut_VARMap.begin(); varItor != cut_VARMap.end(); varItor++)
+  {
+    while (varItor->second.size() > 0)
+    {
+      delete varItor->second.top();
+      varItor->second.pop();
+    }
+  }
+  cut_VARMap.clear();
+}
+
 int check(Z3_context ctx)
 {
   int isSAT = -1;
@@ -216,6 +216,8 @@ Z3_context mk_context_custom(Z3_config cfg);
 
 Z3_context mk_my_context();
 
+void reset_str_theory();
+
 void markVarAppeared(Z3_theory t, Z3_ast node, std::map<Z3_ast, int> & varAppearMap);
 
 void markStrVarForFrontend(Z3_theory t, Z3_ast node, std::map<Z3_ast, int> & varAppearMap);